@@ -37,6 +37,7 @@ Texture2D gDiffuseMap : DiffuseMap;
 Texture2D gNormalMap : NormalMap;
 Texture2D gSpecularMap : SpecularMap;
 Texture2D gGlossMap : GlossMap;
+Texture2D gMaterialMap : MaterialMap; // specular in rgb and gloss in alpha, instead of both maps
 SamplerState gSampler : Sampler;
 
 // -----------
@@ -48,7 +49,16 @@ struct VS_INPUT
 	float3 Color : COLOR;
 	float2 UV : TEXCOORD;
 	float3 Normal : NORMAL;
-	float3 Tangent : TANGENT;
+	float4 Tangent : TANGENT; // w is the handedness
+};
+
+// Packed vertices, see VertexLayout::CreatePacked
+// Positions can be float32 or float16 and UVs UNORM16 or float16, the input assembler turns all of them into floats
+struct VS_PACKED_INPUT
+{
+	float3 Position : POSITION;
+	float4 NormalTangent : NORMAL; // octahedral normal in xy, tangent angle around the normal in z, handedness in w
+	float2 UV : TEXCOORD;
 };
 
 struct VS_OUTPUT
@@ -58,7 +68,7 @@ struct VS_OUTPUT
 	float3 Color : COLOR;
 	float2 UV : TEXCOORD;
 	float3 Normal : NORMAL;
-	float3 Tangent : TANGENT;
+	float4 Tangent : TANGENT;
 };
 
 // ---------
@@ -69,17 +79,43 @@ float3 GetToCamera(float3 origin)
 	return normalize(gCameraOrigin.xyz - origin);
 }
 
-float3 GetSampledNormal(float2 uv, float3 normal, float3 tangent)
+float3 GetSampledNormal(float2 uv, float3 normal, float4 tangent)
 {
-	float3 sampledNormal = gNormalMap.Sample(gSampler, uv).rgb;
-	sampledNormal = 2.f * sampledNormal - float3(1.f, 1.f, 1.f); // remap normal
+	// The map only stores x and y (BC5), z is rebuilt from the unit length
+	const float2 sampledXY = 2.f * gNormalMap.Sample(gSampler, uv).rg - float2(1.f, 1.f); // remap normal
+	const float3 sampledNormal = float3(sampledXY, sqrt(saturate(1.f - dot(sampledXY, sampledXY))));
 
-	const float3 binormal = cross(normal, tangent);
-	const float3x3 TBN = float3x3(tangent, binormal, normal);
+	// Mirrored UVs flip the bitangent
+	const float3 binormal = cross(normal, tangent.xyz) * tangent.w;
+	const float3x3 TBN = float3x3(tangent.xyz, binormal, normal);
 
 	return mul(sampledNormal, TBN);
 }
 
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 direction = float3(encoded, 1.f - abs(encoded.x) - abs(encoded.y));
+	if (direction.z < 0.f)
+	{
+		direction.xy = (1.f - abs(encoded.yx)) * (encoded >= 0.f ? 1.f : -1.f);
+	}
+	return normalize(direction);
+}
+
+// Same basis as packing::BuildTangentBasis, the packed tangent is an angle from the first axis towards the second
+float3 DecodeTangent(float3 normal, float encodedAngle)
+{
+	const float sign = normal.z >= 0.f ? 1.f : -1.f;
+	const float a = -1.f / (sign + normal.z);
+	const float b = normal.x * normal.y * a;
+	const float3 axisX = float3(1.f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+	const float3 axisY = float3(b, sign + normal.y * normal.y * a, -normal.y);
+
+	float sine, cosine;
+	sincos(encodedAngle * pi, sine, cosine);
+	return axisX * cosine + axisY * sine;
+}
+
 float3 MultColor(float3 a, float3 b)
 {
 	return float3(a.r * b.r, a.g * b.g, a.b * b.b);
@@ -117,12 +153,23 @@ VS_OUTPUT VtxShader(VS_INPUT input)
 	output.Color = input.Color;
 	output.UV = input.UV;
 	output.Normal = normalize( mul( input.Normal, (float3x3)gWorld ).xyz );
-	output.Tangent = normalize( mul( input.Tangent, (float3x3)gWorld ).xyz );
+	output.Tangent = float4( normalize( mul( input.Tangent.xyz, (float3x3)gWorld ).xyz ), input.Tangent.w );
 	return output;
 }
 
+VS_OUTPUT PackedVtxShader(VS_PACKED_INPUT input)
+{
+	VS_INPUT unpacked = (VS_INPUT)0;
+	unpacked.Position = input.Position;
+	unpacked.UV = input.UV;
+	unpacked.Normal = DecodeOctahedral(input.NormalTangent.xy);
+	const float handedness = input.NormalTangent.w >= 0.f ? 1.f : -1.f;
+	unpacked.Tangent = float4(DecodeTangent(unpacked.Normal, input.NormalTangent.z), handedness);
+	return VtxShader(unpacked);
+}
+
 // Pixel Shader
-float4 PxlShader(VS_OUTPUT input) : SV_TARGET
+float4 ShadePixel(VS_OUTPUT input, float3 sampledSpecular, float sampledGloss)
 {
 	// Calculate view direction
 	const float3 originToCamera = GetToCamera(input.WorldPosition.xyz);
@@ -135,8 +182,6 @@ float4 PxlShader(VS_OUTPUT input) : SV_TARGET
 	const float3 lambertDiffuse = CalculateLambert(sampledColor, lightIntensity);
 
 	// Calculate phong
-	const float3 sampledSpecular = gSpecularMap.Sample(gSampler, input.UV).rgb;
-	const float sampledGloss = gGlossMap.Sample(gSampler, input.UV).r;
 	const float phongExponent = sampledGloss * shininess;
 	const float3 phongSpecular = CalculatePhong(sampledSpecular, phongExponent, lightDirection, originToCamera, normal);
 
@@ -148,6 +193,20 @@ float4 PxlShader(VS_OUTPUT input) : SV_TARGET
 	return float4(finalColor, 1.f);
 }
 
+float4 PxlShader(VS_OUTPUT input) : SV_TARGET
+{
+	const float3 sampledSpecular = gSpecularMap.Sample(gSampler, input.UV).rgb;
+	const float sampledGloss = gGlossMap.Sample(gSampler, input.UV).r;
+	return ShadePixel(input, sampledSpecular, sampledGloss);
+}
+
+// Three samples instead of four, the material map holds what the specular and gloss maps do
+float4 MaterialMapPxlShader(VS_OUTPUT input) : SV_TARGET
+{
+	const float4 sampledMaterial = gMaterialMap.Sample(gSampler, input.UV);
+	return ShadePixel(input, sampledMaterial.rgb, sampledMaterial.a);
+}
+
 // --------------
 // | Techniques |
 // --------------
@@ -164,3 +223,42 @@ technique11 DefaultTechnique
 		SetPixelShader( CompileShader( ps_5_0, PxlShader() ) );
 	}
 }
+
+technique11 PackedTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerState);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), -1);
+		SetVertexShader( CompileShader( vs_5_0, PackedVtxShader() ) );
+		SetGeometryShader( NULL );
+		SetPixelShader( CompileShader( ps_5_0, PxlShader() ) );
+	}
+}
+
+technique11 MaterialMapTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerState);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), -1);
+		SetVertexShader( CompileShader( vs_5_0, VtxShader() ) );
+		SetGeometryShader( NULL );
+		SetPixelShader( CompileShader( ps_5_0, MaterialMapPxlShader() ) );
+	}
+}
+
+technique11 PackedMaterialMapTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerState);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), -1);
+		SetVertexShader( CompileShader( vs_5_0, PackedVtxShader() ) );
+		SetGeometryShader( NULL );
+		SetPixelShader( CompileShader( ps_5_0, MaterialMapPxlShader() ) );
+	}
+}
@@ -42,7 +42,16 @@ struct VS_INPUT
 	float3 Color : COLOR;
 	float2 UV : TEXCOORD;
 	float3 Normal : NORMAL;
-	float3 Tangent : TANGENT;
+	float4 Tangent : TANGENT;
+};
+
+// Packed vertices, see VertexLayout::CreatePacked
+// Only the UVs are used, the normal and tangent are left encoded
+struct VS_PACKED_INPUT
+{
+	float3 Position : POSITION;
+	float4 NormalTangent : NORMAL;
+	float2 UV : TEXCOORD;
 };
 
 struct VS_OUTPUT
@@ -63,6 +72,14 @@ VS_OUTPUT VtxShader(VS_INPUT input)
 	return output;
 }
 
+VS_OUTPUT PackedVtxShader(VS_PACKED_INPUT input)
+{
+	VS_OUTPUT output = (VS_OUTPUT)0;
+	output.Position = mul( float4( input.Position, 1.f ), gWorldViewProj );
+	output.UV = input.UV;
+	return output;
+}
+
 // Pixel Shader
 float4 PxlShader(VS_OUTPUT input) : SV_TARGET
 {
@@ -85,3 +102,16 @@ technique11 DefaultTechnique
 		SetPixelShader( CompileShader( ps_5_0, PxlShader() ) );
 	}
 }
+
+technique11 PackedTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerState);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), -1);
+		SetVertexShader( CompileShader( vs_5_0, PackedVtxShader() ) );
+		SetGeometryShader( NULL );
+		SetPixelShader( CompileShader( ps_5_0, PxlShader() ) );
+	}
+}
@@ -0,0 +1,408 @@
+// Headless asset cooker, builds the cooked files and manifest the renderer loads instead of the sources
+// Usage: asset-cooker <resources directory> [output directory, defaults to <resources directory>/cooked]
+// An asset is only rebuilt when its source content or its cook options changed since the last run, independent
+// assets are cooked in parallel
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "AssetManifest.h"
+#include "BlockCompressor.h"
+#include "CookedMesh.h"
+#include "CookedTexture.h"
+#include "Error.h"
+#include "Hash.h"
+#include "MipGenerator.h"
+#include "ThreadPool.h"
+
+using namespace dae;
+
+namespace
+{
+namespace fs = std::filesystem;
+
+// Bumped when effects get more than a copy
+constexpr uint32_t EffectPipelineVersion{ 1 };
+
+// Optional, one asset per line followed by its flags:
+//	keep-order	meshes blended without depth writes, where the authored triangle order is visible
+//	normal-map	textures holding tangent-space normals, renormalized on every mip level
+//	data		textures that aren't colors, their mips are averaged without gamma correction
+//	box-filter	textures whose mips average 2x2 texels instead of using the Kaiser filter
+//	bc1, bc3, bc4, bc5, bc7	textures stored block-compressed in that format instead of 8-bit RGBA
+//	r8, rg8		textures stored uncompressed with only their first one or two channels
+//	fast, high	block-compression quality, normal when neither is given
+// A texture line whose path is two sources joined by a '+' cooks a map packed from them, the first one's rgb with the
+// second one's first channel as alpha (see cooked::texture::GetPackedSourcePath); the sources are only cooked on their
+// own as well when they have a line of their own
+constexpr std::string_view SettingsFileName{ "cook.txt" };
+
+constexpr std::pair<std::string_view, TextureData::Format> FormatFlags[]{
+	{ "bc1", TextureData::Format::bc1 },
+	{ "bc3", TextureData::Format::bc3 },
+	{ "bc4", TextureData::Format::bc4 },
+	{ "bc5", TextureData::Format::bc5 },
+	{ "bc7", TextureData::Format::bc7 },
+	{ "r8", TextureData::Format::r8 },
+	{ "rg8", TextureData::Format::rg8 },
+};
+
+struct AssetSettings
+{
+	std::string sourcePath{};
+	std::vector<std::string> flags{};
+};
+
+struct Job
+{
+	manifest::Entry entry{};
+	bool keepOrder{};
+	cooked::texture::Options textureOptions{};
+	std::string colorSourcePath{}; // only for packed maps, whose source path is both of these
+	std::string alphaSourcePath{};
+	bool isUpToDate{};
+	bool failed{};
+	double ms{};
+};
+
+obj::ParseOptions GetParseOptions()
+{
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+	return options;
+}
+
+cooked::CookOptions GetCookOptions( bool keepOrder )
+{
+	cooked::CookOptions options{};
+	options.packVertices = true;
+	if ( keepOrder )
+	{
+		options.optimizeVertexCache = false;
+		options.optimizeOverdraw = false;
+		options.buildMeshlets = false;
+		options.buildLods = false;
+	}
+	return options;
+}
+
+uint64_t GetOptionsHash( const Job& job )
+{
+	switch ( job.entry.kind )
+	{
+	case manifest::AssetKind::mesh:
+		return cooked::HashOptions( GetParseOptions(), GetCookOptions( job.keepOrder ) );
+
+	case manifest::AssetKind::texture:
+		return cooked::texture::HashOptions( job.textureOptions );
+
+	default:
+		return hash::Combine( hash::DefaultSeed, EffectPipelineVersion );
+	}
+}
+
+std::vector<AssetSettings> ReadSettings( const fs::path& settingsPath )
+{
+	std::vector<AssetSettings> settings{};
+	std::ifstream file{ settingsPath };
+	std::string line{};
+	while ( std::getline( file, line ) )
+	{
+		if ( line.empty() || line.front() == '#' )
+		{
+			continue;
+		}
+
+		std::istringstream words{ line };
+		AssetSettings asset{};
+		words >> asset.sourcePath;
+		for ( std::string flag{}; words >> flag; )
+		{
+			asset.flags.push_back( flag );
+		}
+		settings.push_back( std::move( asset ) );
+	}
+	return settings;
+}
+
+bool HasFlag( const std::vector<AssetSettings>& settings, const std::string& sourcePath, std::string_view flag )
+{
+	return std::any_of( settings.begin(), settings.end(), [&]( const AssetSettings& asset ) {
+		return asset.sourcePath == sourcePath && std::find( asset.flags.begin(), asset.flags.end(), flag ) !=
+													 asset.flags.end();
+	} );
+}
+
+bool IsOnlyPackedSource( const std::vector<AssetSettings>& settings, const std::string& sourcePath )
+{
+	bool isPackedSource{};
+	for ( const AssetSettings& asset : settings )
+	{
+		if ( asset.sourcePath == sourcePath )
+		{
+			return false;
+		}
+		const size_t separatorIdx{ asset.sourcePath.find( '+' ) };
+		isPackedSource |= separatorIdx != std::string::npos &&
+						  ( asset.sourcePath.compare( 0, separatorIdx, sourcePath ) == 0 ||
+							asset.sourcePath.compare( separatorIdx + 1, std::string::npos, sourcePath ) == 0 );
+	}
+	return isPackedSource;
+}
+
+void ApplySettings( const std::vector<AssetSettings>& settings, Job& job )
+{
+	job.keepOrder = HasFlag( settings, job.entry.sourcePath, "keep-order" );
+	if ( HasFlag( settings, job.entry.sourcePath, "normal-map" ) )
+	{
+		job.textureOptions.mip.content = mip::Content::normal;
+	}
+	else if ( HasFlag( settings, job.entry.sourcePath, "data" ) )
+	{
+		job.textureOptions.mip.content = mip::Content::data;
+	}
+	if ( HasFlag( settings, job.entry.sourcePath, "box-filter" ) )
+	{
+		job.textureOptions.mip.filter = mip::Filter::box;
+	}
+	for ( const auto& [flag, format] : FormatFlags )
+	{
+		if ( HasFlag( settings, job.entry.sourcePath, flag ) )
+		{
+			job.textureOptions.format = format;
+		}
+	}
+	if ( HasFlag( settings, job.entry.sourcePath, "fast" ) )
+	{
+		job.textureOptions.quality = bc::Quality::fast;
+	}
+	else if ( HasFlag( settings, job.entry.sourcePath, "high" ) )
+	{
+		job.textureOptions.quality = bc::Quality::high;
+	}
+	job.entry.optionsHash = GetOptionsHash( job );
+}
+
+// Every asset below the resources directory the renderer knows how to load and every packed map resources/cook.txt
+// asks for, in path order; textures only read through a packed map are left out
+std::vector<Job> FindAssets( const fs::path& resourcesDir, const fs::path& outputDir )
+{
+	const std::vector<AssetSettings> settings{ ReadSettings( resourcesDir / SettingsFileName ) };
+
+	std::vector<Job> jobs{};
+	for ( const fs::directory_entry& file : fs::recursive_directory_iterator{ resourcesDir } )
+	{
+		const fs::path relativeOutput{ fs::relative( file.path(), outputDir ) };
+		if ( !file.is_regular_file() || ( !relativeOutput.empty() && *relativeOutput.begin() != ".." ) )
+		{
+			continue;
+		}
+
+		Job job{};
+		const fs::path sourcePath{ fs::relative( file.path(), resourcesDir ) };
+		const std::string extension{ sourcePath.extension().string() };
+		if ( extension == ".obj" )
+		{
+			job.entry.kind = manifest::AssetKind::mesh;
+			job.entry.cookedPath = cooked::GetCachePath( sourcePath.generic_string() );
+		}
+		else if ( extension == ".png" || extension == ".jpg" )
+		{
+			if ( IsOnlyPackedSource( settings, sourcePath.generic_string() ) )
+			{
+				continue;
+			}
+			job.entry.kind = manifest::AssetKind::texture;
+			job.entry.cookedPath = cooked::texture::GetCachePath( sourcePath.generic_string() );
+		}
+		else if ( extension == ".fx" )
+		{
+			job.entry.kind = manifest::AssetKind::effect;
+			job.entry.cookedPath = sourcePath.generic_string();
+		}
+		else
+		{
+			continue;
+		}
+
+		job.entry.sourcePath = sourcePath.generic_string();
+		ApplySettings( settings, job );
+		jobs.push_back( std::move( job ) );
+	}
+
+	// Packed maps have no file of their own, only their line
+	for ( const AssetSettings& asset : settings )
+	{
+		const size_t separatorIdx{ asset.sourcePath.find( '+' ) };
+		if ( separatorIdx == std::string::npos )
+		{
+			continue;
+		}
+
+		Job job{};
+		job.entry.kind = manifest::AssetKind::texture;
+		job.entry.sourcePath = asset.sourcePath;
+		job.entry.cookedPath = cooked::texture::GetCachePath( asset.sourcePath );
+		job.colorSourcePath = asset.sourcePath.substr( 0, separatorIdx );
+		job.alphaSourcePath = asset.sourcePath.substr( separatorIdx + 1 );
+		ApplySettings( settings, job );
+		jobs.push_back( std::move( job ) );
+	}
+
+	std::sort( jobs.begin(), jobs.end(), []( const Job& lhs, const Job& rhs ) {
+		return lhs.entry.sourcePath < rhs.entry.sourcePath;
+	} );
+	return jobs;
+}
+
+void Cook( const fs::path& resourcesDir,
+		   const fs::path& outputDir,
+		   const std::vector<manifest::Entry>& previousEntries,
+		   ThreadPool& pool,
+		   Job& job )
+{
+	const bool isPacked{ !job.alphaSourcePath.empty() };
+	const fs::path relativeSourcePath{ isPacked ? job.colorSourcePath : job.entry.sourcePath };
+	const std::string sourcePath{ ( resourcesDir / relativeSourcePath ).string() };
+	const std::string cookedPath{ ( outputDir / job.entry.cookedPath ).string() };
+
+	// A packed map changes with either of its sources
+	const MappedFile sourceFile{ sourcePath };
+	const MappedFile alphaSourceFile{ isPacked ? MappedFile{ ( resourcesDir / job.alphaSourcePath ).string() }
+											   : MappedFile{} };
+	job.entry.sourceHash = hash::HashBytes( sourceFile.GetView() );
+	if ( isPacked )
+	{
+		job.entry.sourceHash = hash::HashBytes( alphaSourceFile.GetView(), job.entry.sourceHash );
+	}
+
+	// Timestamps aren't trusted here, a checkout or copy touches them without changing a byte
+	const manifest::Entry* pPrevious{ manifest::Find( previousEntries, job.entry.sourcePath ) };
+	job.isUpToDate = pPrevious && pPrevious->kind == job.entry.kind && pPrevious->sourceHash == job.entry.sourceHash &&
+					 pPrevious->optionsHash == job.entry.optionsHash && pPrevious->cookedPath == job.entry.cookedPath &&
+					 fs::exists( cookedPath );
+	if ( job.isUpToDate )
+	{
+		return;
+	}
+
+	std::error_code errorCode{};
+	fs::create_directories( fs::path{ cookedPath }.parent_path(), errorCode );
+
+	cooked::SourceInfo source{ cooked::ReadSourceInfo( sourcePath ) };
+	source.hash = job.entry.sourceHash;
+
+	switch ( job.entry.kind )
+	{
+	case manifest::AssetKind::mesh:
+	{
+		const MeshData mesh{ cooked::CookOBJ( sourceFile.GetView(), GetParseOptions(), GetCookOptions( job.keepOrder ) ) };
+		cooked::Write( cookedPath, mesh, source, job.entry.optionsHash );
+		break;
+	}
+
+	case manifest::AssetKind::texture:
+	{
+		// Compressing dwarfs everything else a job does, its blocks are spread over the pool too
+		const cooked::texture::Options& options{ job.textureOptions };
+		const TextureData texture{ mip::Generate(
+			isPacked ? cooked::texture::DecodePacked( sourceFile.GetView(), alphaSourceFile.GetView() )
+					 : cooked::texture::Decode( sourceFile.GetView() ),
+			options.mip ) };
+		cooked::texture::Write( cookedPath,
+								bc::Compress( texture, options.format, options.quality, &pool ),
+								source,
+								job.entry.optionsHash );
+		break;
+	}
+
+	case manifest::AssetKind::effect:
+		if ( !fs::copy_file( sourcePath, cookedPath, fs::copy_options::overwrite_existing, errorCode ) )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+		break;
+	}
+}
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+	if ( argc < 2 )
+	{
+		std::cout << "Usage: asset-cooker <resources directory> [output directory]\n";
+		return 1;
+	}
+
+	const fs::path resourcesDir{ argv[1] };
+	const fs::path outputDir{ argc > 2 ? fs::path{ argv[2] } : resourcesDir / "cooked" };
+	if ( !fs::is_directory( resourcesDir ) )
+	{
+		std::cout << resourcesDir.string() << " is not a directory\n";
+		return 1;
+	}
+
+	const auto start{ std::chrono::steady_clock::now() };
+
+	std::error_code errorCode{};
+	fs::create_directories( outputDir, errorCode );
+	const std::string manifestPath{ ( outputDir / manifest::FileName ).string() };
+	const std::vector<manifest::Entry> previousEntries{ manifest::Read( manifestPath ) };
+
+	std::vector<Job> jobs{ FindAssets( resourcesDir, outputDir ) };
+
+	ThreadPool pool{};
+	pool.ParallelFor( jobs.size(), [&]( size_t jobIdx ) {
+		Job& job{ jobs[jobIdx] };
+		const auto jobStart{ std::chrono::steady_clock::now() };
+		job.failed = error::utils::HandleThrowingFunction(
+			[&]() { Cook( resourcesDir, outputDir, previousEntries, pool, job ); } );
+		const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - jobStart };
+		job.ms = elapsed.count();
+	} );
+
+	// Failed assets are left out, the renderer falls back to their sources
+	std::vector<manifest::Entry> entries{};
+	size_t cookedCount{};
+	size_t failedCount{};
+	for ( const Job& job : jobs )
+	{
+		std::cout << job.entry.sourcePath << ": "
+				  << ( job.failed ? "FAILED" : job.isUpToDate ? "up to date" : "cooked" ) << " in " << job.ms << " ms\n";
+		if ( job.failed )
+		{
+			++failedCount;
+			continue;
+		}
+
+		cookedCount += !job.isUpToDate;
+		entries.push_back( job.entry );
+	}
+
+	// Cooked files of sources that disappeared would otherwise stay around forever
+	for ( const manifest::Entry& previous : previousEntries )
+	{
+		const bool isStale{ std::none_of( entries.begin(), entries.end(), [&]( const manifest::Entry& entry ) {
+			return entry.cookedPath == previous.cookedPath;
+		} ) };
+		if ( isStale )
+		{
+			fs::remove( outputDir / previous.cookedPath, errorCode );
+		}
+	}
+
+	const bool failedManifest{ error::utils::HandleThrowingFunction(
+		[&]() { manifest::Write( manifestPath, entries ); } ) };
+
+	const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+	std::cout << cookedCount << " cooked, " << entries.size() - cookedCount << " up to date, " << failedCount
+			  << " failed in " << elapsed.count() << " ms on " << pool.GetThreadCount() << " threads\n";
+
+	return failedCount > 0 || failedManifest ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include "AssetLoader.h"
+#include "Error.h"
+
+namespace dae
+{
+namespace
+{
+// Columns of the timeline's bars
+constexpr uint32_t ChartWidth{ 60 };
+} // namespace
+
+AssetLoader::AssetLoader( uint32_t threadCount )
+	: m_ThreadPool( threadCount )
+{
+}
+
+void AssetLoader::Update()
+{
+	// Counted once linked, so the whole batch pops below
+	if ( m_IsBatched && m_FinishedCount.load( std::memory_order_acquire ) < m_PendingCount )
+	{
+		return;
+	}
+
+	bool handedOver{};
+	while ( std::optional<Finished> finished{ m_Finished.TryPop() } )
+	{
+		--m_PendingCount;
+		m_FinishedCount.fetch_sub( 1, std::memory_order_relaxed );
+		handedOver = true;
+		if ( finished->entryIdx == MaxTimelineCount )
+		{
+			error::utils::HandleThrowingFunction( finished->ready );
+			continue;
+		}
+
+		const size_t workerIdx{ static_cast<size_t>(
+			std::find( m_WorkerIds.begin(), m_WorkerIds.end(), finished->workerId ) - m_WorkerIds.begin() ) };
+		if ( workerIdx == m_WorkerIds.size() )
+		{
+			m_WorkerIds.push_back( finished->workerId );
+		}
+
+		{
+			TimelineEntry& entry{ m_Timeline[finished->entryIdx] };
+			entry.workerIdx = static_cast<uint32_t>( workerIdx );
+			entry.loadBeginMs = finished->loadBeginMs;
+			entry.loadEndMs = finished->loadEndMs;
+			entry.readyBeginMs = GetElapsedMs();
+			entry.updateIdx = m_UpdateCount;
+		}
+
+		// Ready can enqueue more loads, which may move the entries
+		const bool failed{ error::utils::HandleThrowingFunction( finished->ready ) };
+		TimelineEntry& entry{ m_Timeline[finished->entryIdx] };
+		entry.readyEndMs = GetElapsedMs();
+		entry.isDone = true;
+		entry.failed = failed;
+	}
+	m_UpdateCount += handedOver;
+}
+
+void AssetLoader::SetBatched( bool isBatched )
+{
+	m_IsBatched = isBatched;
+}
+
+void AssetLoader::PrintTimeline() const
+{
+	double beginMs{ std::numeric_limits<double>::max() };
+	double endMs{};
+	for ( const TimelineEntry& entry : m_Timeline )
+	{
+		if ( entry.isDone )
+		{
+			beginMs = std::min( beginMs, entry.enqueueMs );
+			endMs = std::max( endMs, entry.readyEndMs );
+		}
+	}
+	if ( endMs <= beginMs )
+	{
+		return;
+	}
+
+	const auto getColumn{ [&]( double ms ) {
+		return std::min( static_cast<uint32_t>( ( ms - beginMs ) / ( endMs - beginMs ) * ChartWidth ), ChartWidth - 1 );
+	} };
+	const auto fill{ []( std::string& bar, uint32_t first, uint32_t last, char mark ) {
+		std::fill( bar.begin() + first, bar.begin() + std::max( last, first + 1 ), mark );
+	} };
+
+	std::cout << "Load timeline over " << endMs - beginMs
+			  << " ms, '.' queued, '#' loading on a worker, '+' creating on the render thread:\n";
+
+	double loadMs{};
+	double createMs{};
+	double firstLoadMs{ std::numeric_limits<double>::max() };
+	double lastLoadMs{};
+	std::vector<std::pair<double, int>> events{}; // +1 when a load begins, -1 when it ends
+	for ( const TimelineEntry& entry : m_Timeline )
+	{
+		if ( !entry.isDone )
+		{
+			continue;
+		}
+
+		std::string bar( ChartWidth, ' ' );
+		fill( bar, getColumn( entry.enqueueMs ), getColumn( entry.loadBeginMs ), '.' );
+		fill( bar, getColumn( entry.loadBeginMs ), getColumn( entry.loadEndMs ), '#' );
+		fill( bar, getColumn( entry.readyBeginMs ), getColumn( entry.readyEndMs ), '+' );
+		std::cout << "  worker " << std::setw( 2 ) << entry.workerIdx << " |" << bar << "| " << std::setw( 9 )
+				  << entry.loadEndMs - entry.loadBeginMs << " ms + " << std::setw( 9 )
+				  << entry.readyEndMs - entry.readyBeginMs << " ms  " << entry.name << ( entry.failed ? " FAILED" : "" )
+				  << "\n";
+
+		loadMs += entry.loadEndMs - entry.loadBeginMs;
+		createMs += entry.readyEndMs - entry.readyBeginMs;
+		firstLoadMs = std::min( firstLoadMs, entry.loadBeginMs );
+		lastLoadMs = std::max( lastLoadMs, entry.loadEndMs );
+		events.push_back( { entry.loadBeginMs, 1 } );
+		events.push_back( { entry.loadEndMs, -1 } );
+	}
+
+	// Ends sort before begins at the same time, touching loads don't overlap
+	std::sort( events.begin(), events.end() );
+	int runningCount{};
+	int maxRunningCount{};
+	for ( const auto& [ms, change] : events )
+	{
+		runningCount += change;
+		maxRunningCount = std::max( maxRunningCount, runningCount );
+	}
+
+	const double wallMs{ lastLoadMs - firstLoadMs };
+	std::cout << "  " << events.size() / 2 << " loads on " << m_WorkerIds.size() << " workers, up to "
+			  << maxRunningCount << " at once: " << loadMs << " ms of loading took " << wallMs
+			  << " ms of wall-clock time, " << loadMs - wallMs << " ms saved ("
+			  << loadMs / std::max( wallMs, 0.001 ) << "x)\n";
+	std::cout << "  GPU objects created in " << m_UpdateCount << " updates, " << createMs << " ms on the render thread"
+			  << std::endl;
+}
+
+size_t AssetLoader::GetPendingCount() const
+{
+	return m_PendingCount;
+}
+
+const std::vector<AssetLoader::TimelineEntry>& AssetLoader::GetTimeline() const
+{
+	return m_Timeline;
+}
+
+double AssetLoader::GetElapsedMs() const
+{
+	return std::chrono::duration<double, std::milli>( Clock::now() - m_StartTime ).count();
+}
+
+LoadBarrier::LoadBarrier( size_t dependencyCount, std::function<void()> create )
+	: m_RemainingCount( dependencyCount )
+	, m_Create( std::move( create ) )
+{
+}
+
+void LoadBarrier::Arrive()
+{
+	if ( --m_RemainingCount == 0 )
+	{
+		m_Create();
+	}
+}
+} // namespace dae
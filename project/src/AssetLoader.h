@@ -0,0 +1,166 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+// Loads assets in the background so the render thread never waits on a file
+// Workers read, parse and decode, the results queue up until the render thread picks them up in Update and creates the
+// GPU objects, which keeps every device call on the render thread; batched, they are picked up all at once
+// Every load is timed on its way through, the timeline shows how much of the loading overlapped
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "MpscQueue.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+class AssetLoader final
+{
+public:
+	// Enough for everything a scene loads at startup, later loads aren't recorded
+	static constexpr size_t MaxTimelineCount{ 1024 };
+
+	// One load's way through the loader, in ms since the loader was created
+	struct TimelineEntry
+	{
+		std::string name{};
+		uint32_t workerIdx{}; // workers are numbered in the order their first load was handed over
+		double enqueueMs{};
+		double loadBeginMs{};
+		double loadEndMs{};
+		double readyBeginMs{}; // handed over by Update, the GPU objects are created until readyEndMs
+		double readyEndMs{};
+		uint32_t updateIdx{}; // counts the Update calls that handed something over
+		bool isDone{};
+		bool failed{};
+	};
+
+	// One core is left to the render thread
+	explicit AssetLoader( uint32_t threadCount = std::max( std::thread::hardware_concurrency(), 2u ) - 1 );
+	AssetLoader( const AssetLoader& ) = delete;
+	AssetLoader( AssetLoader&& ) = delete;
+	AssetLoader& operator=( const AssetLoader& ) = delete;
+	AssetLoader& operator=( AssetLoader&& ) = delete;
+
+	~AssetLoader() noexcept = default;
+
+	// Methods
+	// Runs load on a worker, then ready( result ) on the thread that calls Update; name is what the timeline shows
+	// A load that throws is reported by Update instead, failed runs there and ready is never called
+	// Load and Update are meant to be called from the same thread
+	template <typename Load, typename Ready>
+	void Enqueue( std::string name, Load&& load, Ready&& ready, std::function<void()> failed = {} );
+
+	// Hands every load finished so far to its ready callback
+	void Update();
+	// While batched, Update hands nothing over until every load enqueued so far has finished, then all of them; a
+	// scene's textures are decoded side by side and their GPU objects created together
+	void SetBatched( bool isBatched );
+
+	// One line per finished load with a bar over the time since the first one was enqueued, then how long all of them
+	// took one after the other against the wall-clock time they took here
+	void PrintTimeline() const;
+
+	// Getters
+	// Loads enqueued that Update hasn't handed over yet
+	size_t GetPendingCount() const;
+	const std::vector<TimelineEntry>& GetTimeline() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// What a worker hands to Update
+	struct Finished
+	{
+		size_t entryIdx{}; // MaxTimelineCount when the load isn't recorded
+		std::thread::id workerId{};
+		double loadBeginMs{};
+		double loadEndMs{};
+		std::function<void()> ready{};
+	};
+
+	// SOFTWARE RESOURCES
+	MpscQueue<Finished> m_Finished{};
+	std::atomic<size_t> m_FinishedCount{}; // pushed and not popped yet
+	size_t m_PendingCount{};
+	bool m_IsBatched{};
+	const Clock::time_point m_StartTime{ Clock::now() };
+	std::vector<TimelineEntry> m_Timeline{};
+	std::vector<std::thread::id> m_WorkerIds{}; // in the order of their worker index
+	uint32_t m_UpdateCount{};
+	ThreadPool m_ThreadPool; // last, so the workers are joined before the queue they push to goes away
+	//
+
+	// Safe from any thread
+	double GetElapsedMs() const;
+};
+
+// Holds a resource back until every load it depends on is ready, then creates it
+// Only used from the thread that calls AssetLoader::Update; if a dependency fails, the resource never gets created
+class LoadBarrier final
+{
+public:
+	LoadBarrier( size_t dependencyCount, std::function<void()> create );
+
+	// Methods
+	// Call once per dependency, the last call creates the resource
+	void Arrive();
+
+private:
+	// SOFTWARE RESOURCES
+	size_t m_RemainingCount{};
+	std::function<void()> m_Create{};
+	//
+};
+
+template <typename Load, typename Ready>
+void AssetLoader::Enqueue( std::string name, Load&& load, Ready&& ready, std::function<void()> failed )
+{
+	using Result = std::invoke_result_t<Load>;
+
+	++m_PendingCount;
+	const size_t entryIdx{ std::min( m_Timeline.size(), MaxTimelineCount ) };
+	if ( entryIdx < MaxTimelineCount )
+	{
+		m_Timeline.push_back( { std::move( name ) } );
+		m_Timeline.back().enqueueMs = GetElapsedMs();
+	}
+
+	m_ThreadPool.Enqueue( [this,
+						   entryIdx,
+						   load = std::forward<Load>( load ),
+						   ready = std::forward<Ready>( ready ),
+						   failed = std::move( failed )]() mutable {
+		Finished finished{ entryIdx, std::this_thread::get_id(), GetElapsedMs() };
+
+		// Results are usually move-only, std::function needs something it can copy
+		try
+		{
+			auto pResult{ std::make_shared<Result>( load() ) };
+			finished.ready = [pResult, ready]() mutable { ready( std::move( *pResult ) ); };
+		}
+		catch ( ... )
+		{
+			finished.ready = [pException = std::current_exception(), failed]() {
+				if ( failed )
+				{
+					failed();
+				}
+				std::rethrow_exception( pException );
+			};
+		}
+		finished.loadEndMs = GetElapsedMs();
+		m_Finished.Push( std::move( finished ) );
+		m_FinishedCount.fetch_add( 1, std::memory_order_release );
+	} );
+}
+} // namespace dae
+#endif
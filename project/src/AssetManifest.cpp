@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include "AssetManifest.h"
+#include "Error.h"
+
+namespace dae
+{
+namespace manifest
+{
+namespace
+{
+constexpr std::string_view Header{ "# DAE asset manifest 1" };
+
+constexpr std::string_view KindNames[]{ "mesh", "texture", "effect" };
+
+bool ReadHex( std::string_view text, uint64_t& value )
+{
+	const std::from_chars_result result{ std::from_chars( text.data(), text.data() + text.size(), value, 16 ) };
+	return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+}
+
+// Splits off everything up to the next tab
+std::string_view NextField( std::string_view& line )
+{
+	const size_t tab{ std::min( line.find( '\t' ), line.size() ) };
+	const std::string_view field{ line.substr( 0, tab ) };
+	line.remove_prefix( std::min( tab + 1, line.size() ) );
+	return field;
+}
+
+bool ReadEntry( std::string_view line, Entry& entry )
+{
+	const std::string_view kind{ NextField( line ) };
+	const auto pKind{ std::find( std::begin( KindNames ), std::end( KindNames ), kind ) };
+	if ( pKind == std::end( KindNames ) )
+	{
+		return false;
+	}
+	entry.kind = static_cast<AssetKind>( pKind - std::begin( KindNames ) );
+
+	if ( !ReadHex( NextField( line ), entry.sourceHash ) || !ReadHex( NextField( line ), entry.optionsHash ) )
+	{
+		return false;
+	}
+
+	entry.sourcePath = NextField( line );
+	entry.cookedPath = NextField( line );
+	return !entry.sourcePath.empty() && !entry.cookedPath.empty() && line.empty();
+}
+
+void WriteHex( std::ofstream& file, uint64_t value )
+{
+	char buffer[16]{};
+	const std::to_chars_result result{ std::to_chars( std::begin( buffer ), std::end( buffer ), value, 16 ) };
+	file.write( buffer, result.ptr - buffer );
+}
+} // namespace
+
+std::vector<Entry> Read( const std::string& path )
+{
+	std::ifstream file{ path };
+	std::string line{};
+	if ( !file || !std::getline( file, line ) || line != Header )
+	{
+		return {};
+	}
+
+	std::vector<Entry> entries{};
+	while ( std::getline( file, line ) )
+	{
+		Entry entry{};
+		if ( ReadEntry( line, entry ) )
+		{
+			entries.push_back( std::move( entry ) );
+		}
+	}
+	return entries;
+}
+
+void Write( const std::string& path, const std::vector<Entry>& entries )
+{
+	const std::string tempPath{ path + ".tmp" };
+	{
+		std::ofstream file{ tempPath, std::ios::trunc };
+		if ( !file )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+
+		file << Header << '\n';
+		for ( const Entry& entry : entries )
+		{
+			file << KindNames[static_cast<size_t>( entry.kind )] << '\t';
+			WriteHex( file, entry.sourceHash );
+			file << '\t';
+			WriteHex( file, entry.optionsHash );
+			file << '\t' << entry.sourcePath << '\t' << entry.cookedPath << '\n';
+		}
+
+		if ( !file )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+	}
+
+	std::error_code errorCode{};
+	std::filesystem::rename( tempPath, path, errorCode );
+	if ( errorCode )
+	{
+		std::filesystem::remove( tempPath, errorCode );
+		throw error::file::CouldNotWriteFile();
+	}
+}
+
+const Entry* Find( const std::vector<Entry>& entries, std::string_view sourcePath )
+{
+	const auto pEntry{ std::find_if( entries.begin(), entries.end(), [&]( const Entry& entry ) {
+		return entry.sourcePath == sourcePath;
+	} ) };
+	return pEntry != entries.end() ? &*pEntry : nullptr;
+}
+} // namespace manifest
+} // namespace dae
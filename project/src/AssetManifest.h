@@ -0,0 +1,43 @@
+#ifndef ASSETMANIFEST_H
+#define ASSETMANIFEST_H
+
+// Index of the asset cooker's output, written next to the cooked files
+// One line per asset: kind, source hash and options hash in hex, then the source and cooked paths, tab-separated
+// Paths are relative, sources to the resources directory and cooked files to the manifest
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dae
+{
+namespace manifest
+{
+enum class AssetKind
+{
+	mesh,
+	texture,
+	effect, // copied as-is, the effect framework compiles it at load time
+};
+
+struct Entry
+{
+	AssetKind kind{};
+	uint64_t sourceHash{};
+	uint64_t optionsHash{};
+	std::string sourcePath{};
+	std::string cookedPath{};
+};
+
+constexpr std::string_view FileName{ "manifest.txt" };
+
+// Returns nothing when the file is missing, malformed lines are skipped
+std::vector<Entry> Read( const std::string& path );
+
+// Writes to a temporary file first, so an interrupted write never leaves a truncated manifest behind
+void Write( const std::string& path, const std::vector<Entry>& entries );
+
+const Entry* Find( const std::vector<Entry>& entries, std::string_view sourcePath );
+} // namespace manifest
+} // namespace dae
+#endif
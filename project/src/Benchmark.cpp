@@ -0,0 +1,2302 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include "AssetLoader.h"
+#include "Benchmark.h"
+#include "BlockCompressor.h"
+#include "CookedMesh.h"
+#include "CookedTexture.h"
+#include "Error.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MipGenerator.h"
+#include "Meshlet.h"
+#include "ObjParser.h"
+#include "PixelConverter.h"
+#include "StreamingPlanner.h"
+#include "TangentGenerator.h"
+#include "TextureAtlas.h"
+#include "TextureContainer.h"
+#include "ThreadPool.h"
+#include "VertexPacking.h"
+
+#ifdef _WIN32
+#	include <psapi.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace dae
+{
+namespace benchmark
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+template <typename Function>
+double MeasureBestMs( int runs, Function f )
+{
+	double best{ HUGE_VAL };
+	for ( int run{}; run < runs; ++run )
+	{
+		const Clock::time_point start{ Clock::now() };
+		f();
+		const std::chrono::duration<double, std::milli> elapsed{ Clock::now() - start };
+		best = std::min( best, elapsed.count() );
+	}
+	return best;
+}
+
+// The original ifstream based Utils::ParseOBJ, kept as the baseline
+bool ParseOBJStream( const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices )
+{
+	std::ifstream file( filename );
+	if ( !file )
+		return false;
+
+	std::vector<Vector3> positions{};
+	std::vector<Vector3> normals{};
+	std::vector<Vector2> UVs{};
+
+	vertices.clear();
+	indices.clear();
+
+	std::string sCommand;
+	while ( !file.eof() )
+	{
+		file >> sCommand;
+		if ( sCommand == "v" )
+		{
+			float x, y, z;
+			file >> x >> y >> z;
+			positions.emplace_back( x, y, z );
+		}
+		else if ( sCommand == "vt" )
+		{
+			float u, v;
+			file >> u >> v;
+			UVs.emplace_back( u, 1 - v );
+		}
+		else if ( sCommand == "vn" )
+		{
+			float x, y, z;
+			file >> x >> y >> z;
+			normals.emplace_back( x, y, z );
+		}
+		else if ( sCommand == "f" )
+		{
+			Vertex vertex{};
+			size_t iPosition, iTexCoord, iNormal;
+
+			uint32_t tempIndices[3];
+			for ( size_t iFace = 0; iFace < 3; iFace++ )
+			{
+				file >> iPosition;
+				vertex.position = positions[iPosition - 1];
+
+				if ( '/' == file.peek() )
+				{
+					file.ignore();
+
+					if ( '/' != file.peek() )
+					{
+						file >> iTexCoord;
+						vertex.UV = UVs[iTexCoord - 1];
+					}
+
+					if ( '/' == file.peek() )
+					{
+						file.ignore();
+						file >> iNormal;
+						vertex.normal = normals[iNormal - 1];
+					}
+				}
+
+				vertices.push_back( vertex );
+				tempIndices[iFace] = uint32_t( vertices.size() ) - 1;
+			}
+
+			indices.push_back( tempIndices[0] );
+			indices.push_back( tempIndices[2] );
+			indices.push_back( tempIndices[1] );
+		}
+		file.ignore( 1000, '\n' );
+	}
+
+	for ( size_t i = 0; i < indices.size(); i += 3 )
+	{
+		const Vector3& p0 = vertices[indices[i]].position;
+		const Vector3& p1 = vertices[indices[i + 1]].position;
+		const Vector3& p2 = vertices[indices[i + 2]].position;
+		const Vector2& uv0 = vertices[indices[i]].UV;
+		const Vector2& uv1 = vertices[indices[i + 1]].UV;
+		const Vector2& uv2 = vertices[indices[i + 2]].UV;
+
+		const Vector3 edge0 = p1 - p0;
+		const Vector3 edge1 = p2 - p0;
+		const Vector2 diffX = Vector2( uv1.x - uv0.x, uv2.x - uv0.x );
+		const Vector2 diffY = Vector2( uv1.y - uv0.y, uv2.y - uv0.y );
+		const float r = 1.f / Vector2::Cross( diffX, diffY );
+
+		const Vector3 tangent = ( edge0 * diffY.y - edge1 * diffY.x ) * r;
+		vertices[indices[i]].tangent += Vector4{ tangent, 0.f };
+		vertices[indices[i + 1]].tangent += Vector4{ tangent, 0.f };
+		vertices[indices[i + 2]].tangent += Vector4{ tangent, 0.f };
+	}
+
+	for ( auto& v : vertices )
+	{
+		v.tangent = Vector4{ Vector3::Reject( v.tangent, v.normal ).Normalized(), 1.f };
+		v.position.z *= -1.f;
+		v.normal.z *= -1.f;
+		v.tangent.z *= -1.f;
+	}
+
+	return true;
+}
+
+// Rotates every triangle so its smallest index comes first, then sorts them
+// Two index buffers describe the same triangles with the same winding when the results are equal
+std::vector<std::array<uint32_t, 3>> CanonicalTriangles( const std::vector<uint32_t>& indices )
+{
+	std::vector<std::array<uint32_t, 3>> triangles( indices.size() / 3 );
+	for ( size_t triangleIdx{}; triangleIdx < triangles.size(); ++triangleIdx )
+	{
+		std::array<uint32_t, 3>& triangle{ triangles[triangleIdx] };
+		std::copy_n( indices.begin() + triangleIdx * 3, 3, triangle.begin() );
+		std::rotate( triangle.begin(), std::min_element( triangle.begin(), triangle.end() ), triangle.end() );
+	}
+	std::sort( triangles.begin(), triangles.end() );
+	return triangles;
+}
+
+void CompareParsers( const std::string& objPath, int runs )
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+
+	const double streamMs{ MeasureBestMs( runs, [&]() { ParseOBJStream( objPath, vertices, indices ); } ) };
+	const size_t streamVertexCount{ vertices.size() };
+
+	const double mappedMs{ MeasureBestMs( runs, [&]() {
+		const MappedFile file{ objPath };
+		obj::Parse( file.GetView(), vertices, indices );
+	} ) };
+
+	std::cout << objPath << " (" << vertices.size() << " vertices, " << indices.size() / 3 << " triangles)\n";
+	std::cout << "  ifstream parser: " << streamMs << " ms (" << streamVertexCount << " vertices)\n";
+	std::cout << "  mapped parser:   " << mappedMs << " ms\n";
+	std::cout << "  speedup:         " << streamMs / mappedMs << "x\n";
+}
+
+// One triangle at a time, scattering into the vertices, with the same weighting as tangent::Generate
+// Vertices are expected to be split already, the handedness of the last usable triangle wins
+void GenerateTangentsScalar( std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices )
+{
+	for ( Vertex& vertex : vertices )
+	{
+		vertex.tangent = {};
+	}
+
+	for ( size_t cornerIdx{}; cornerIdx < indices.size(); cornerIdx += 3 )
+	{
+		const Vertex& v0{ vertices[indices[cornerIdx]] };
+		const Vertex& v1{ vertices[indices[cornerIdx + 1]] };
+		const Vertex& v2{ vertices[indices[cornerIdx + 2]] };
+
+		const Vector3 edge1{ v1.position - v0.position };
+		const Vector3 edge2{ v2.position - v0.position };
+		const Vector2 deltaUV1{ v1.UV - v0.UV };
+		const Vector2 deltaUV2{ v2.UV - v0.UV };
+		const float determinant{ deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y };
+		const float tolerance{ 1e-6f * ( std::abs( deltaUV1.x * deltaUV2.y ) + std::abs( deltaUV2.x * deltaUV1.y ) ) };
+		const Vector3 tangent{ edge1 * deltaUV2.y - edge2 * deltaUV1.y };
+		if ( !( std::abs( determinant ) > tolerance ) || tangent.Magnitude() == 0.f )
+		{
+			continue;
+		}
+
+		const float sign{ determinant < 0.f ? -1.f : 1.f };
+		const Vector3 weighted{ tangent.Normalized() * Vector3::Cross( edge1, edge2 ).Magnitude() * sign };
+		for ( size_t cornerOffset{}; cornerOffset < 3; ++cornerOffset )
+		{
+			Vector4& sum{ vertices[indices[cornerIdx + cornerOffset]].tangent };
+			sum += Vector4{ weighted, 0.f };
+			sum.w = sign;
+		}
+	}
+
+	for ( Vertex& vertex : vertices )
+	{
+		const Vector3 normal{ vertex.normal.Normalized() };
+		const Vector3 sum{ vertex.tangent };
+		vertex.tangent = { ( sum - normal * Vector3::Dot( sum, normal ) ).Normalized(), vertex.tangent.w };
+	}
+}
+
+// Bytes a bilinear lookup per pixel pulls in when a level is drawn as a screenSize x screenSize square, counted as
+// unique 64-byte lines holding 4x4 texels, the tiling GPUs store 8-bit RGBA in
+size_t CountFetchedBytes( uint32_t levelWidth, uint32_t levelHeight, uint32_t screenSize )
+{
+	constexpr uint32_t tileSize{ 4 };
+	constexpr size_t lineBytes{ tileSize * tileSize * TextureData::BytesPerPixel };
+
+	const uint32_t tileColumnCount{ ( levelWidth + tileSize - 1 ) / tileSize };
+	const uint32_t tileRowCount{ ( levelHeight + tileSize - 1 ) / tileSize };
+	std::vector<bool> isFetched( size_t{ tileColumnCount } * tileRowCount );
+	const auto wrap{ []( int64_t texel, uint32_t size ) {
+		return static_cast<uint32_t>( ( texel % size + size ) % size );
+	} };
+
+	size_t lineCount{};
+	for ( uint32_t y{}; y < screenSize; ++y )
+	{
+		const double v{ ( y + 0.5 ) * levelHeight / screenSize - 0.5 };
+		for ( uint32_t x{}; x < screenSize; ++x )
+		{
+			const double u{ ( x + 0.5 ) * levelWidth / screenSize - 0.5 };
+			for ( uint32_t cornerIdx{}; cornerIdx < 4; ++cornerIdx )
+			{
+				const uint32_t texelX{ wrap( static_cast<int64_t>( std::floor( u ) ) + ( cornerIdx & 1 ), levelWidth ) };
+				const uint32_t texelY{ wrap( static_cast<int64_t>( std::floor( v ) ) + ( cornerIdx >> 1 ), levelHeight ) };
+				const size_t tileIdx{ size_t{ texelY / tileSize } * tileColumnCount + texelX / tileSize };
+				lineCount += !isFetched[tileIdx];
+				isFetched[tileIdx] = true;
+			}
+		}
+	}
+	return lineCount * lineBytes;
+}
+
+const char* GetFormatName( TextureData::Format format )
+{
+	constexpr const char* names[]{ "RGBA8", "BC1", "BC3", "BC4", "BC5", "BC7", "R8", "RG8" };
+	return names[static_cast<size_t>( format )];
+}
+
+// Channels a format stores, the others decode to constants
+uint32_t GetStoredChannelCount( TextureData::Format format )
+{
+	switch ( format )
+	{
+	case TextureData::Format::bc1:
+		return 3;
+	case TextureData::Format::bc4:
+	case TextureData::Format::r8:
+		return 1;
+	case TextureData::Format::bc5:
+	case TextureData::Format::rg8:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+// Over channelCount channels from firstChannel of the first level, in dB
+double GetPsnr( const TextureData& reference,
+				const TextureData& decoded,
+				uint32_t channelCount,
+				uint32_t firstChannel = 0 )
+{
+	const std::span<const std::byte> expected{ reference.GetLevel( 0 ).pixels };
+	const std::span<const std::byte> actual{ decoded.GetLevel( 0 ).pixels };
+	double squaredError{};
+	for ( size_t offset{}; offset < expected.size(); offset += TextureData::BytesPerPixel )
+	{
+		for ( uint32_t channelIdx{ firstChannel }; channelIdx < firstChannel + channelCount; ++channelIdx )
+		{
+			const int difference{ std::to_integer<int>( expected[offset + channelIdx] ) -
+								  std::to_integer<int>( actual[offset + channelIdx] ) };
+			squaredError += difference * difference;
+		}
+	}
+
+	const double meanSquaredError{ squaredError / ( expected.size() / TextureData::BytesPerPixel * channelCount ) };
+	return meanSquaredError == 0.0 ? std::numeric_limits<double>::infinity()
+								   : 10.0 * std::log10( 255.0 * 255.0 / meanSquaredError );
+}
+
+// The chain from firstLevel down as a texture of its own
+TextureData DropLevels( const TextureData& texture, uint32_t firstLevel )
+{
+	std::vector<std::byte> pixels{};
+	for ( uint32_t levelIdx{ firstLevel }; levelIdx < texture.GetLevelCount(); ++levelIdx )
+	{
+		const std::span<const std::byte> levelPixels{ texture.GetLevel( levelIdx ).pixels };
+		pixels.insert( pixels.end(), levelPixels.begin(), levelPixels.end() );
+	}
+
+	const TextureData::Level first{ texture.GetLevel( firstLevel ) };
+	return TextureData{
+		first.width, first.height, texture.GetLevelCount() - firstLevel, std::move( pixels ), texture.GetFormat() };
+}
+
+// Minimal DDS and KTX2 writers for what container::Open reads, other tools write these files in practice; the KTX2
+// one leaves out the data format descriptor, which the loader ignores
+void WriteDds( const std::string& path, const TextureData& texture )
+{
+	constexpr uint32_t dxgiFormats[]{ 28, 71, 77, 80, 83, 98, 61, 49 };
+	uint32_t header[1 + 31 + 5]{};
+	header[0] = 0x20534444; // "DDS "
+	header[1] = 124;
+	header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; // caps, height, width, pixel format, mip count
+	header[3] = texture.GetHeight();
+	header[4] = texture.GetWidth();
+	header[7] = texture.GetLevelCount();
+	header[19] = 32;
+	header[20] = 0x4;		   // four-character code
+	header[21] = 0x30315844; // "DX10"
+	header[27] = 0x1000 | 0x400000 | 0x8;
+	header[32] = dxgiFormats[static_cast<size_t>( texture.GetFormat() )];
+	header[33] = 3; // 2D
+	header[35] = 1; // array size
+
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	file.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+	for ( uint32_t levelIdx{}; levelIdx < texture.GetLevelCount(); ++levelIdx )
+	{
+		const std::span<const std::byte> pixels{ texture.GetLevel( levelIdx ).pixels };
+		file.write( reinterpret_cast<const char*>( pixels.data() ), static_cast<std::streamsize>( pixels.size() ) );
+	}
+}
+
+void WriteKtx2( const std::string& path, const TextureData& texture )
+{
+	constexpr uint32_t vkFormats[]{ 37, 131, 137, 139, 141, 145, 9, 16 };
+	constexpr uint8_t identifier[12]{ 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	constexpr uint64_t levelAlignment{ 16 };
+	const uint32_t levelCount{ texture.GetLevelCount() };
+
+	const uint32_t header[9]{ vkFormats[static_cast<size_t>( texture.GetFormat() )],
+						1,
+						texture.GetWidth(),
+						texture.GetHeight(),
+						0,
+						0,
+						1,
+						levelCount,
+						0 };
+	const uint32_t indexOffsets[4]{};
+	const uint64_t globalDataOffsets[2]{};
+
+	// The smallest level comes first in the file, the index still lists the largest first
+	std::vector<uint64_t> levelIndex( size_t{ levelCount } * 3 );
+	uint64_t offset{ sizeof( identifier ) + sizeof( header ) + sizeof( indexOffsets ) + sizeof( globalDataOffsets ) +
+					 levelIndex.size() * sizeof( uint64_t ) };
+	for ( uint32_t levelIdx{ levelCount }; levelIdx-- > 0; )
+	{
+		offset = ( offset + levelAlignment - 1 ) / levelAlignment * levelAlignment;
+		const uint64_t byteSize{ texture.GetLevel( levelIdx ).pixels.size() };
+		levelIndex[levelIdx * 3] = offset;
+		levelIndex[levelIdx * 3 + 1] = byteSize;
+		levelIndex[levelIdx * 3 + 2] = byteSize;
+		offset += byteSize;
+	}
+
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	file.write( reinterpret_cast<const char*>( identifier ), sizeof( identifier ) );
+	file.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+	file.write( reinterpret_cast<const char*>( indexOffsets ), sizeof( indexOffsets ) );
+	file.write( reinterpret_cast<const char*>( globalDataOffsets ), sizeof( globalDataOffsets ) );
+	file.write( reinterpret_cast<const char*>( levelIndex.data() ),
+				static_cast<std::streamsize>( levelIndex.size() * sizeof( uint64_t ) ) );
+	for ( uint32_t levelIdx{ levelCount }; levelIdx-- > 0; )
+	{
+		constexpr char zeroes[levelAlignment]{};
+		file.write( zeroes, static_cast<std::streamsize>( levelIndex[levelIdx * 3] - file.tellp() ) );
+		const std::span<const std::byte> pixels{ texture.GetLevel( levelIdx ).pixels };
+		file.write( reinterpret_cast<const char*>( pixels.data() ), static_cast<std::streamsize>( pixels.size() ) );
+	}
+}
+
+// Resident set of the whole process, mapped file pages included
+size_t GetResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+	{
+		return 0;
+	}
+	return counters.WorkingSetSize;
+#else
+	std::ifstream statm{ "/proc/self/statm" };
+	size_t totalPages{};
+	size_t residentPages{};
+	statm >> totalPages >> residentPages;
+	return residentPages * static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+#endif
+}
+} // namespace
+
+bool Run( bool isLargeIncluded )
+{
+	std::cout << "**BENCHMARK STARTED**\n";
+
+	bool isValid{ true };
+	const bool failed{ error::utils::HandleThrowingFunction( [&]() {
+		ParseOBJ( "./resources/vehicle.obj" );
+		ParseSyntheticOBJ( 10'000'000 );
+
+		isValid &= ParseOBJParallel( "./resources/vehicle.obj" );
+		isValid &= ParseOBJParallel( WriteSyntheticOBJ( 10'000'000 ) );
+
+		WeldOBJ( "./resources/vehicle.obj" );
+		WeldOBJ( WriteSyntheticOBJ( 10'000'000 ) );
+
+		isValid &= LoadCookedOBJ( "./resources/vehicle.obj" );
+		isValid &= LoadCookedOBJ( WriteSyntheticOBJ( 10'000'000 ) );
+
+		isValid &= OptimizeVertexCache( "./resources/vehicle.obj" );
+		isValid &= OptimizeVertexCache( WriteSyntheticOBJ( 10'000'000 ) );
+
+		isValid &= OptimizeOverdraw( "./resources/vehicle.obj", 16 );
+
+		isValid &= OptimizeVertexFetch( "./resources/vehicle.obj" );
+		isValid &= OptimizeVertexFetch( WriteSyntheticOBJ( 10'000'000 ) );
+
+		isValid &= PackVertices( "./resources/vehicle.obj" );
+		isValid &= PackVertices( "./resources/fireFX.obj" );
+
+		isValid &= ShortIndices( "./resources/vehicle.obj" );
+		isValid &= ShortIndices( "./resources/fireFX.obj" );
+
+		isValid &= CullMeshlets( "./resources/vehicle.obj" );
+		isValid &= CullMeshlets( WriteSyntheticOBJ( 1'000'000 ) );
+
+		isValid &= SimplifyLods( "./resources/vehicle.obj" );
+		isValid &= SimplifyLods( WriteSyntheticOBJ( 1'000'000 ) );
+
+		isValid &= GenerateTangents( "./resources/vehicle.obj" );
+		isValid &= GenerateTangents( WriteSyntheticOBJ( 10'000'000 ) );
+
+		// A small budget forces many chunks on a file that can still be checked against a whole parse
+		isValid &= StreamOBJ( WriteSyntheticOBJ( 1'000'000 ), size_t{ 16 } << 20 );
+		if ( isLargeIncluded )
+		{
+			// About 17 GB, more than fits in memory on most machines
+			isValid &= StreamOBJ( WriteSyntheticOBJ( 250'000'000 ), size_t{ 512 } << 20 );
+		}
+
+		isValid &= LoadAssetsAsync( "./resources/vehicle.obj",
+									{ "./resources/vehicle_diffuse.png",
+									  "./resources/vehicle_normal.png",
+									  "./resources/vehicle_specular.png",
+									  "./resources/vehicle_gloss.png" } );
+
+		// Every image the vehicle scene decodes when nothing is cooked
+		isValid &= DecodeImagesAsync( { "./resources/vehicle_diffuse.png",
+										"./resources/vehicle_normal.png",
+										"./resources/vehicle_specular.png",
+										"./resources/vehicle_gloss.png",
+										"./resources/fireFX_diffuse.png" } );
+
+		isValid &= DecodePngs( { "./resources/vehicle_diffuse.png",
+								 "./resources/vehicle_normal.png",
+								 "./resources/vehicle_specular.png",
+								 "./resources/vehicle_gloss.png",
+								 "./resources/fireFX_diffuse.png",
+								 "./resources/uv_grid_2.png" } );
+
+		isValid &= GenerateMips( "./resources/vehicle_diffuse.png", mip::Content::color );
+		isValid &= GenerateMips( "./resources/vehicle_normal.png", mip::Content::normal );
+		isValid &= GenerateMips( "./resources/vehicle_gloss.png", mip::Content::data );
+
+		// The formats Mesh gives each map
+		isValid &= CompressBlocks( "./resources/vehicle_diffuse.png", mip::Content::color, TextureData::Format::bc7 );
+		isValid &= CompressBlocks( "./resources/vehicle_normal.png", mip::Content::normal, TextureData::Format::bc5 );
+		isValid &= CompressBlocks( "./resources/vehicle_specular.png", mip::Content::data, TextureData::Format::bc1 );
+		isValid &= CompressBlocks( "./resources/vehicle_gloss.png", mip::Content::data, TextureData::Format::bc4 );
+
+		isValid &= LoadContainers( "./resources/vehicle_diffuse.png", TextureData::Format::bc7 );
+		isValid &= LoadContainers( "./resources/vehicle_normal.png", TextureData::Format::rgba8 );
+
+		isValid &= NarrowTexels( "./resources/vehicle_gloss.png", mip::Content::data, TextureData::Format::r8 );
+		isValid &= NarrowTexels( "./resources/vehicle_normal.png", mip::Content::normal, TextureData::Format::rg8 );
+
+		isValid &= PackMaterial( "./resources/vehicle_specular.png", "./resources/vehicle_gloss.png" );
+
+		// Room for everything, the renderer's default and less than the maps in view need; the last one is below even
+		// the tails
+		isValid &= StreamTextures( 256, size_t{ 512 } << 20 );
+		isValid &= StreamTextures( 256, size_t{ 64 } << 20 );
+		isValid &= StreamTextures( 256, size_t{ 4 } << 20 );
+		isValid &= StreamTextures( 256, size_t{ 1 } << 20 );
+
+		isValid &= BuildTextureArrays(
+			{ "./resources/vehicle_diffuse.png", "./resources/fireFX_diffuse.png", "./resources/uv_grid_2.png" } );
+	} ) };
+
+	std::cout << ( failed || !isValid ? "**BENCHMARK FAILED**\n" : "**BENCHMARK FINISHED**\n" );
+	return !failed && isValid;
+}
+
+void ParseOBJ( const std::string& objPath )
+{
+	CompareParsers( objPath, 10 );
+}
+
+void ParseSyntheticOBJ( size_t faceCount )
+{
+	CompareParsers( WriteSyntheticOBJ( faceCount ), 1 );
+}
+
+bool ParseOBJParallel( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	std::vector<Vertex> serialVertices{};
+	std::vector<uint32_t> serialIndices{};
+	const double serialMs{ MeasureBestMs( 1, [&]() { obj::Parse( file.GetView(), serialVertices, serialIndices ); } ) };
+
+	std::cout << objPath << " (" << file.GetSize() / ( 1024 * 1024 ) << " MB)\n";
+	std::cout << "  serial:     " << serialMs << " ms\n";
+
+	bool isDeterministic{ true };
+	for ( const uint32_t threadCount : { 1u, 2u, 4u, 8u, 16u } )
+	{
+		ThreadPool pool{ threadCount };
+
+		// Forcing tiny chunks makes even small files exercise the chunk boundaries
+		obj::ParseOptions options{};
+		options.pThreadPool = &pool;
+		options.minChunkSize = 1;
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		const double parallelMs{ MeasureBestMs( 1, [&]() { obj::Parse( file.GetView(), vertices, indices, options ); } ) };
+
+		const bool isEqual{ vertices.size() == serialVertices.size() && indices == serialIndices &&
+							std::memcmp( vertices.data(), serialVertices.data(), vertices.size() * sizeof( Vertex ) ) ==
+								0 };
+		isDeterministic &= isEqual;
+
+		std::cout << "  " << threadCount << ( threadCount < 10 ? " threads:  " : " threads: " ) << parallelMs << " ms ("
+				  << serialMs / parallelMs << "x)" << ( isEqual ? "" : " OUTPUT DIFFERS FROM SERIAL" ) << "\n";
+	}
+
+	std::cout << "  determinism: " << ( isDeterministic ? "PASS" : "FAIL" ) << "\n";
+	return isDeterministic;
+}
+
+void WeldOBJ( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	obj::Parse( file.GetView(), vertices, indices );
+	const size_t unweldedCount{ vertices.size() };
+
+	obj::ParseStatistics statistics{};
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+	options.pStatistics = &statistics;
+	const double weldedMs{ MeasureBestMs( 1, [&]() { obj::Parse( file.GetView(), vertices, indices, options ); } ) };
+
+	const double cornersPerSecond{ statistics.records.corners / ( std::max( statistics.weldMs, 0.001 ) / 1000.0 ) };
+	std::cout << objPath << "\n";
+	std::cout << "  positions:        " << statistics.records.positions << "\n";
+	std::cout << "  vertices before:  " << unweldedCount << " (" << unweldedCount * sizeof( Vertex ) / 1024 << " KB)\n";
+	std::cout << "  vertices after:   " << vertices.size() << " (" << vertices.size() * sizeof( Vertex ) / 1024
+			  << " KB)\n";
+	std::cout << "  weld pass:        " << statistics.weldMs << " ms of " << weldedMs << " ms total\n";
+	std::cout << "  hash throughput:  " << cornersPerSecond / 1'000'000.0 << " M corners/s\n";
+}
+
+bool LoadCookedOBJ( const std::string& objPath )
+{
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	// Start cold so the first load has to parse and write the cache
+	const std::string cachePath{ cooked::GetCachePath( objPath ) };
+	std::filesystem::remove( cachePath );
+
+	std::optional<MeshData> parsed{};
+	const double parseMs{ MeasureBestMs( 1, [&]() { parsed.emplace( cooked::LoadOBJ( objPath, options ) ); } ) };
+
+	const cooked::SourceInfo source{ cooked::ReadSourceInfo( objPath ) };
+	const uint64_t optionsHash{ cooked::HashOptions( options, {} ) };
+
+	std::optional<MeshData> cached{};
+	const double openMs{ MeasureBestMs( 10, [&]() {
+		cached = cooked::Open( cachePath, objPath, source, optionsHash );
+	} ) };
+	if ( !cached )
+	{
+		std::cout << objPath << "\n  round trip:        FAIL (cooked file rejected)\n";
+		return false;
+	}
+
+	// Hashing the blobs faults in every page, like the buffer upload would
+	uint64_t checksum{};
+	const double touchMs{ MeasureBestMs( 10, [&]() {
+		checksum = hash::HashBytes( cached->GetVertexData().data(), cached->GetVertexData().size_bytes() );
+		checksum = hash::HashBytes( cached->GetIndexData().data(), cached->GetIndexData().size_bytes(), checksum );
+	} ) };
+
+	const bool isEqual{ cached->IsMapped() &&
+						cached->GetLayout() == parsed->GetLayout() &&
+						cached->GetVertexData().size() == parsed->GetVertexData().size() &&
+						cached->GetIndexSize() == parsed->GetIndexSize() &&
+						cached->GetIndexData().size() == parsed->GetIndexData().size() &&
+						std::memcmp( cached->GetVertexData().data(),
+									 parsed->GetVertexData().data(),
+									 parsed->GetVertexData().size_bytes() ) == 0 &&
+						std::memcmp( cached->GetIndexData().data(),
+									 parsed->GetIndexData().data(),
+									 parsed->GetIndexData().size_bytes() ) == 0 &&
+						std::equal( cached->GetLods().begin(),
+									cached->GetLods().end(),
+									parsed->GetLods().begin(),
+									parsed->GetLods().end(),
+									[]( const LodLevel& lhs, const LodLevel& rhs ) {
+										return lhs.firstIndex == rhs.firstIndex && lhs.indexCount == rhs.indexCount &&
+											   lhs.error == rhs.error;
+									} ) };
+
+	std::cout << objPath << " (" << std::filesystem::file_size( cachePath ) / 1024 << " KB cooked, "
+			  << cached->GetIndexSize() * 8 << "-bit indices)\n";
+	std::cout << "  parse + cook:      " << parseMs << " ms\n";
+	std::cout << "  open cooked:       " << openMs << " ms (" << parseMs / openMs << "x)\n";
+	std::cout << "  open + touch data: " << openMs + touchMs << " ms (" << parseMs / ( openMs + touchMs ) << "x)\n";
+	std::cout << "  round trip:        " << ( isEqual ? "PASS" : "FAIL" ) << " (checksum " << std::hex << checksum
+			  << std::dec << ")\n";
+	return isEqual;
+}
+
+bool OptimizeVertexCache( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> fileOrder{};
+	obj::Parse( file.GetView(), vertices, fileOrder, options );
+
+	// Shuffled triangles are the worst case for the cache and for Tipsify's fallback scan
+	std::vector<uint32_t> shuffled{ fileOrder };
+	{
+		std::vector<uint32_t> triangleOrder( fileOrder.size() / 3 );
+		for ( uint32_t triangleIdx{}; triangleIdx < triangleOrder.size(); ++triangleIdx )
+		{
+			triangleOrder[triangleIdx] = triangleIdx;
+		}
+		std::shuffle( triangleOrder.begin(), triangleOrder.end(), std::mt19937{ 42 } );
+		for ( size_t triangleIdx{}; triangleIdx < triangleOrder.size(); ++triangleIdx )
+		{
+			std::copy_n( fileOrder.begin() + triangleOrder[triangleIdx] * 3, 3, shuffled.begin() + triangleIdx * 3 );
+		}
+	}
+
+	std::cout << objPath << " (" << fileOrder.size() / 3 << " triangles, " << vertices.size() << " vertices)\n";
+
+	bool isValid{ true };
+	for ( const auto& [name, input] : { std::pair{ "file order", &fileOrder }, std::pair{ "shuffled", &shuffled } } )
+	{
+		std::vector<uint32_t> optimized{};
+		const double optimizeMs{ MeasureBestMs( 3, [&]() {
+			optimized = *input;
+			optimize::OptimizeVertexCache( optimized, vertices.size() );
+		} ) };
+
+		const bool isPermutation{ CanonicalTriangles( optimized ) == CanonicalTriangles( *input ) };
+		isValid &= isPermutation;
+
+		std::cout << "  " << name << ": " << optimizeMs << " ms ("
+				  << optimized.size() / 3 / ( std::max( optimizeMs, 0.001 ) * 1000.0 ) << " M triangles/s)"
+				  << ( isPermutation ? "" : " TRIANGLES CHANGED" ) << "\n";
+
+		for ( const uint32_t cacheSize : { 16u, 32u } )
+		{
+			const optimize::VertexCacheStatistics before{
+				optimize::AnalyzeVertexCache( *input, vertices.size(), cacheSize ) };
+			const optimize::VertexCacheStatistics after{
+				optimize::AnalyzeVertexCache( optimized, vertices.size(), cacheSize ) };
+			std::cout << "    cache " << cacheSize << ": ACMR " << before.acmr << " -> " << after.acmr << ", ATVR "
+					  << before.atvr << " -> " << after.atvr << "\n";
+		}
+	}
+
+	return isValid;
+}
+
+bool OptimizeOverdraw( const std::string& objPath, uint32_t viewCount )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> fileOrder{};
+	obj::Parse( file.GetView(), vertices, fileOrder, options );
+
+	std::vector<uint32_t> cacheOptimized{ fileOrder };
+	optimize::OptimizeVertexCache( cacheOptimized, vertices.size() );
+
+	std::cout << objPath << " (" << fileOrder.size() / 3 << " triangles, " << viewCount << " views)\n";
+
+	const auto report{ [&]( const char* name, const std::vector<uint32_t>& indices ) {
+		const optimize::OverdrawStatistics overdraw{ optimize::AnalyzeOverdraw( indices, vertices, viewCount ) };
+		const optimize::VertexCacheStatistics cache{ optimize::AnalyzeVertexCache( indices, vertices.size() ) };
+		std::cout << "  " << name << "overdraw " << overdraw.overdraw << " (" << overdraw.shadedPixels << " shaded / "
+				  << overdraw.coveredPixels << " covered), ACMR " << cache.acmr << "\n";
+	} };
+	report( "file order:      ", fileOrder );
+	report( "vertex cache:    ", cacheOptimized );
+
+	bool isValid{ true };
+	for ( const float threshold : { 1.05f, 1.25f, 2.f } )
+	{
+		std::vector<uint32_t> optimized{};
+		const double optimizeMs{ MeasureBestMs( 3, [&]() {
+			optimized = cacheOptimized;
+			optimize::OptimizeOverdraw( optimized, vertices, threshold );
+		} ) };
+
+		const bool isPermutation{ CanonicalTriangles( optimized ) == CanonicalTriangles( fileOrder ) };
+		isValid &= isPermutation;
+
+		std::cout << "  threshold " << threshold << ( threshold < 2.f ? ":  " : ":     " ) << optimizeMs << " ms"
+				  << ( isPermutation ? "" : " TRIANGLES CHANGED" ) << "\n";
+		report( "                 ", optimized );
+	}
+
+	return isValid;
+}
+
+bool OptimizeVertexFetch( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	obj::Parse( file.GetView(), vertices, indices, options );
+	optimize::OptimizeVertexCache( indices, vertices.size() );
+	optimize::OptimizeOverdraw( indices, vertices );
+
+	std::vector<Vertex> optimizedVertices{};
+	std::vector<uint32_t> optimizedIndices{};
+	const double optimizeMs{ MeasureBestMs( 3, [&]() {
+		optimizedVertices = vertices;
+		optimizedIndices = indices;
+		optimize::OptimizeVertexFetch( optimizedIndices, optimizedVertices );
+	} ) };
+
+	// Renumbering must not change what any index refers to
+	bool isValid{ optimizedIndices.size() == indices.size() };
+	for ( size_t cornerIdx{}; isValid && cornerIdx < indices.size(); ++cornerIdx )
+	{
+		isValid = std::memcmp( &optimizedVertices[optimizedIndices[cornerIdx]],
+							   &vertices[indices[cornerIdx]],
+							   sizeof( Vertex ) ) == 0;
+	}
+
+	const optimize::VertexFetchStatistics before{
+		optimize::AnalyzeVertexFetch( indices, vertices.size(), sizeof( Vertex ) ) };
+	const optimize::VertexFetchStatistics after{
+		optimize::AnalyzeVertexFetch( optimizedIndices, optimizedVertices.size(), sizeof( Vertex ) ) };
+	const optimize::VertexCacheStatistics cacheBefore{ optimize::AnalyzeVertexCache( indices, vertices.size() ) };
+	const optimize::VertexCacheStatistics cacheAfter{
+		optimize::AnalyzeVertexCache( optimizedIndices, optimizedVertices.size() ) };
+
+	std::cout << objPath << " (" << indices.size() / 3 << " triangles, " << sizeof( Vertex ) << "-byte vertices)\n";
+	std::cout << "  lines per triangle: " << before.linesPerTriangle << " -> " << after.linesPerTriangle << "\n";
+	std::cout << "  overfetch:          " << before.overfetch << " -> " << after.overfetch << "\n";
+	std::cout << "  ACMR unchanged:     " << cacheBefore.acmr << " -> " << cacheAfter.acmr << "\n";
+	std::cout << "  remap:              " << optimizeMs << " ms" << ( isValid ? "" : " VERTICES CHANGED" ) << "\n";
+	return isValid;
+}
+
+bool PackVertices( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	obj::Parse( file.GetView(), vertices, indices, options );
+	optimize::OptimizeVertexCache( indices, vertices.size() );
+	optimize::OptimizeVertexFetch( indices, vertices );
+
+	const BoundingBox bounds{ BoundingBox::Create( vertices ) };
+	const float extent{ std::max( { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z } ) };
+	const float maxCoordinate{ std::max( { std::abs( bounds.min.x ),
+										   std::abs( bounds.min.y ),
+										   std::abs( bounds.min.z ),
+										   std::abs( bounds.max.x ),
+										   std::abs( bounds.max.y ),
+										   std::abs( bounds.max.z ) } ) };
+
+	std::cout << objPath << " (" << vertices.size() << " vertices, " << indices.size() / 3 << " triangles, extent "
+			  << extent << ")\n";
+
+	const optimize::VertexFetchStatistics fullFetch{
+		optimize::AnalyzeVertexFetch( indices, vertices.size(), sizeof( Vertex ) ) };
+	std::cout << "  full:   " << sizeof( Vertex ) << " bytes, " << vertices.size() * sizeof( Vertex ) / 1024 << " KB, "
+			  << fullFetch.overfetch * vertices.size() * sizeof( Vertex ) / ( indices.size() / 3 )
+			  << " bytes fetched per triangle\n";
+
+	bool isValid{ true };
+	for ( const bool halfPositions : { false, true } )
+	{
+		const VertexLayout layout{ packing::ChoosePackedLayout( vertices, halfPositions ) };
+
+		std::vector<std::byte> packed{};
+		const double packMs{ MeasureBestMs( 3, [&]() { packed = packing::Pack( vertices, layout ); } ) };
+
+		// Worst-case round-trip errors, angles in degrees
+		float positionError{};
+		float normalError{};
+		float tangentError{};
+		float UVError{};
+		for ( size_t vertexIdx{}; vertexIdx < vertices.size(); ++vertexIdx )
+		{
+			const Vertex& original{ vertices[vertexIdx] };
+			const Vertex decoded{ packing::Unpack( packed.data() + vertexIdx * layout.stride, layout ) };
+
+			positionError = std::max( positionError, ( decoded.position - original.position ).Magnitude() );
+			UVError = std::max( { UVError, std::abs( decoded.UV.x - original.UV.x ), std::abs( decoded.UV.y - original.UV.y ) } );
+
+			const auto angle{ []( const Vector3& a, const Vector3& b ) {
+				return std::acos( std::clamp( Vector3::Dot( a.Normalized(), b.Normalized() ), -1.f, 1.f ) ) * 180.f /
+					   std::numbers::pi_v<float>;
+			} };
+			normalError = std::max( normalError, angle( decoded.normal, original.normal ) );
+
+			// Broken tangents are replaced on encode, there is nothing to compare against
+			if ( std::isfinite( original.tangent.Magnitude() ) && original.tangent.Magnitude() > 1e-6f )
+			{
+				tangentError = std::max( tangentError, angle( decoded.tangent, original.tangent ) );
+			}
+		}
+
+		// Bounds: half of a float16 ulp at the largest coordinate, about a degree for 8-bit octahedral vectors,
+		// half a UNORM16 step or half a float16 ulp at 1.0 for UVs
+		const float positionBound{ halfPositions ? maxCoordinate * std::sqrt( 3.f ) / 2048.f : 0.f };
+		const float angleBound{ 1.5f };
+		const float UVBound{ layout.attributes[2].format == VertexAttributeFormat::unorm16x2 ? 0.5f / 65535.f + 1e-7f
+																						  : 1.f / 2048.f };
+		const bool isWithinBounds{ positionError <= positionBound && normalError <= angleBound &&
+								   tangentError <= angleBound && UVError <= UVBound };
+		isValid &= isWithinBounds;
+
+		const optimize::VertexFetchStatistics fetch{ optimize::AnalyzeVertexFetch( indices, vertices.size(), layout.stride ) };
+		std::cout << "  packed" << ( halfPositions ? " (half positions): " : ":                  " ) << layout.stride
+				  << " bytes, " << packed.size() / 1024 << " KB, "
+				  << fetch.overfetch * packed.size() / ( indices.size() / 3 ) << " bytes fetched per triangle, "
+				  << ( layout.attributes[2].format == VertexAttributeFormat::unorm16x2 ? "UNORM" : "half" )
+				  << " UVs, packed in " << packMs << " ms\n";
+		std::cout << "    max error: position " << positionError << " (bound " << positionBound << "), normal "
+				  << normalError << " deg, tangent " << tangentError << " deg (bound " << angleBound << "), UV "
+				  << UVError << " (bound " << UVBound << ")" << ( isWithinBounds ? "" : " OUT OF BOUNDS" ) << "\n";
+	}
+
+	return isValid;
+}
+
+bool ShortIndices( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> parsedVertices{};
+	std::vector<uint32_t> parsedIndices{};
+	obj::Parse( file.GetView(), parsedVertices, parsedIndices, options );
+	if ( parsedVertices.size() > cooked::MaxShortIndexVertexCount )
+	{
+		std::cout << objPath << " has " << parsedVertices.size() << " vertices, too many for 16-bit indices\n";
+		return true;
+	}
+
+	// Both widths go through the same passes and have to end up with the same indices
+	std::vector<Vertex> longVertices{ parsedVertices };
+	std::vector<uint32_t> longIndices{ parsedIndices };
+	const double longMs{ MeasureBestMs( 1, [&]() {
+		optimize::OptimizeVertexCache( longIndices, longVertices.size() );
+		optimize::OptimizeOverdraw( longIndices, longVertices );
+		optimize::OptimizeVertexFetch( longIndices, longVertices );
+	} ) };
+
+	std::vector<Vertex> shortVertices{ parsedVertices };
+	std::vector<uint16_t> shortIndices( parsedIndices.begin(), parsedIndices.end() );
+	const double shortMs{ MeasureBestMs( 1, [&]() {
+		optimize::OptimizeVertexCache( shortIndices, shortVertices.size() );
+		optimize::OptimizeOverdraw( shortIndices, shortVertices );
+		optimize::OptimizeVertexFetch( shortIndices, shortVertices );
+	} ) };
+
+	const bool isEqual{ std::equal( longIndices.begin(), longIndices.end(), shortIndices.begin(), shortIndices.end() ) };
+
+	const optimize::VertexFetchStatistics longFetch{
+		optimize::AnalyzeVertexFetch( longIndices, longVertices.size(), sizeof( Vertex ) ) };
+	const optimize::VertexFetchStatistics shortFetch{
+		optimize::AnalyzeVertexFetch( shortIndices, shortVertices.size(), sizeof( Vertex ) ) };
+
+	std::cout << objPath << " (" << shortVertices.size() << " vertices, " << shortIndices.size() << " indices)\n";
+	std::cout << "  32-bit: " << longIndices.size() * sizeof( uint32_t ) / 1024 << " KB, optimized in " << longMs
+			  << " ms, overfetch " << longFetch.overfetch << "\n";
+	std::cout << "  16-bit: " << shortIndices.size() * sizeof( uint16_t ) / 1024 << " KB, optimized in " << shortMs
+			  << " ms, overfetch " << shortFetch.overfetch << "\n";
+	std::cout << "  same indices: " << ( isEqual ? "PASS" : "FAIL" ) << "\n";
+	return isEqual;
+}
+
+bool CullMeshlets( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	obj::Parse( file.GetView(), vertices, indices, options );
+	optimize::OptimizeVertexCache( indices, vertices.size() );
+
+	// Same order as the cooker, the overdraw pass moves whole meshlets
+	std::vector<uint32_t> triangleSorted{ indices };
+	optimize::OptimizeOverdraw( triangleSorted, vertices );
+
+	std::vector<meshlet::Meshlet> meshlets{};
+	const double buildMs{ MeasureBestMs( 1, [&]() { meshlets = meshlet::Build( indices, vertices ); } ) };
+	meshlet::SortForOverdraw( indices, vertices, meshlets );
+
+	const optimize::OverdrawStatistics triangleOverdraw{ optimize::AnalyzeOverdraw( triangleSorted, vertices ) };
+	const optimize::OverdrawStatistics meshletOverdraw{ optimize::AnalyzeOverdraw( indices, vertices ) };
+	optimize::OptimizeVertexFetch( indices, vertices );
+
+	// Meshlets have to tile the index buffer in order and stay within their limits
+	bool isValid{ !meshlets.empty() };
+	uint32_t nextIndex{};
+	size_t vertexSum{};
+	for ( const meshlet::Meshlet& meshlet : meshlets )
+	{
+		isValid &= meshlet.firstIndex == nextIndex && meshlet.triangleCount > 0 &&
+				   meshlet.triangleCount <= meshlet::MaxTriangles && meshlet.vertexCount <= meshlet::MaxVertices;
+		nextIndex = meshlet.firstIndex + meshlet.triangleCount * 3;
+		vertexSum += meshlet.vertexCount;
+	}
+	isValid &= nextIndex == indices.size();
+
+	const BoundingBox bounds{ BoundingBox::Create( vertices ) };
+	const Vector3 center{ ( bounds.min + bounds.max ) * 0.5f };
+	const float radius{ ( bounds.max - bounds.min ).Magnitude() * 0.5f };
+
+	const meshlet::Culler culler{ meshlets };
+	std::vector<meshlet::DrawRange> ranges{};
+	std::vector<meshlet::DrawRange> referenceRanges{};
+	meshlet::CullStatistics total{};
+	size_t violationCount{};
+	size_t mismatchCount{};
+	double simdMs{};
+	double scalarMs{};
+
+	// Views orbit the mesh like the scene camera, far ones see all of it, near ones only part
+	constexpr uint32_t viewCount{ 32 };
+	constexpr int cullRuns{ 100 };
+	const Matrix projection{ Matrix::CreatePerspectiveFovLH( std::tan( 22.5f * std::numbers::pi_v<float> / 180.f ),
+															 640.f / 480.f,
+															 0.1f,
+															 100.f ) };
+	for ( uint32_t viewIdx{}; viewIdx < viewCount; ++viewIdx )
+	{
+		const float y{ 1.f - 2.f * ( viewIdx + 0.5f ) / viewCount };
+		const float ringRadius{ std::sqrt( 1.f - y * y ) };
+		const float angle{ viewIdx * std::numbers::pi_v<float> * ( 3.f - std::sqrt( 5.f ) ) };
+		const Vector3 direction{ ringRadius * std::cos( angle ), y, ringRadius * std::sin( angle ) };
+
+		const float distance{ radius * ( viewIdx % 2 == 0 ? 2.5f : 0.8f ) };
+		const Vector3 origin{ center + direction * distance };
+		const Vector3 forward{ -direction };
+		const Vector3 worldUp{ std::abs( forward.y ) < 0.99f ? Vector3{ 0.f, 1.f, 0.f } : Vector3{ 1.f, 0.f, 0.f } };
+		const Matrix view{ Matrix::CreateLookAtLH( origin, forward, worldUp ) };
+
+		const meshlet::CullView cullView{ meshlet::CullView::Create( Matrix::CreateIdentity(), view * projection, origin ) };
+
+		meshlet::CullStatistics statistics{};
+		simdMs += MeasureBestMs( cullRuns, [&]() { statistics = culler.Cull( cullView, ranges ); } );
+		total += statistics;
+
+		// Scalar reference, has to make the same decisions
+		scalarMs += MeasureBestMs( cullRuns, [&]() {
+			referenceRanges.clear();
+			for ( const meshlet::Meshlet& meshlet : meshlets )
+			{
+				if ( meshlet::IsOutsideFrustum( meshlet, cullView ) ||
+					 meshlet::IsBackFacing( meshlet, cullView.cameraPosition ) )
+				{
+					continue;
+				}
+				if ( !referenceRanges.empty() &&
+					 referenceRanges.back().firstIndex + referenceRanges.back().indexCount == meshlet.firstIndex )
+				{
+					referenceRanges.back().indexCount += meshlet.triangleCount * 3;
+				}
+				else
+				{
+					referenceRanges.push_back( { meshlet.firstIndex, meshlet.triangleCount * 3 } );
+				}
+			}
+		} );
+		mismatchCount += ranges.size() != referenceRanges.size() ||
+						 !std::equal( ranges.begin(),
+									  ranges.end(),
+									  referenceRanges.begin(),
+									  []( const meshlet::DrawRange& lhs, const meshlet::DrawRange& rhs ) {
+										  return lhs.firstIndex == rhs.firstIndex && lhs.indexCount == rhs.indexCount;
+									  } );
+
+		// Conservative, every culled triangle faces away or has all three corners behind one plane
+		for ( const meshlet::Meshlet& meshlet : meshlets )
+		{
+			const bool isOutside{ meshlet::IsOutsideFrustum( meshlet, cullView ) };
+			const bool isBackFacing{ meshlet::IsBackFacing( meshlet, cullView.cameraPosition ) };
+			for ( uint32_t cornerIdx{ meshlet.firstIndex }; cornerIdx < meshlet.firstIndex + meshlet.triangleCount * 3;
+				  cornerIdx += 3 )
+			{
+				const Vector3& p0{ vertices[indices[cornerIdx]].position };
+				const Vector3& p1{ vertices[indices[cornerIdx + 1]].position };
+				const Vector3& p2{ vertices[indices[cornerIdx + 2]].position };
+
+				if ( isBackFacing && Vector3::Dot( Vector3::Cross( p1 - p0, p2 - p0 ), p0 - origin ) < -1e-4f )
+				{
+					++violationCount;
+				}
+				if ( isOutside )
+				{
+					const bool isBehindPlane{ std::any_of(
+						std::begin( cullView.planes ), std::end( cullView.planes ), [&]( const float( &plane )[4] ) {
+							const auto distanceTo{ [&]( const Vector3& p ) {
+								return plane[0] * p.x + plane[1] * p.y + plane[2] * p.z + plane[3];
+							} };
+							return distanceTo( p0 ) < 1e-4f && distanceTo( p1 ) < 1e-4f && distanceTo( p2 ) < 1e-4f;
+						} ) };
+					violationCount += !isBehindPlane;
+				}
+			}
+		}
+	}
+	isValid &= violationCount == 0 && mismatchCount == 0;
+
+	const double triangleCount{ static_cast<double>( total.triangleCount ) };
+	std::cout << objPath << " (" << indices.size() / 3 << " triangles)\n";
+	std::cout << "  meshlets:      " << meshlets.size() << ", " << static_cast<double>( vertexSum ) / meshlets.size()
+			  << " vertices and " << indices.size() / 3.0 / meshlets.size() << " triangles on average, built in "
+			  << buildMs << " ms\n";
+	std::cout << "  overdraw:      " << meshletOverdraw.overdraw << " sorting meshlets, " << triangleOverdraw.overdraw
+			  << " sorting triangle clusters\n";
+	std::cout << "  culled:        " << 100.0 * total.backfaceCulledTriangles / triangleCount << "% back-facing, "
+			  << 100.0 * total.frustumCulledTriangles / triangleCount << "% off-screen, "
+			  << static_cast<double>( total.rangeCount ) / viewCount << " draws per view\n";
+	std::cout << "  cull per view: " << 1000.0 * simdMs / viewCount << " us SSE, " << 1000.0 * scalarMs / viewCount
+			  << " us scalar\n";
+	std::cout << "  conservative:  " << ( violationCount == 0 ? "PASS" : "FAIL" ) << " (" << violationCount
+			  << " visible triangles culled), SSE matches scalar: " << ( mismatchCount == 0 ? "PASS" : "FAIL" ) << "\n";
+	return isValid;
+}
+
+bool SimplifyLods( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	obj::Parse( file.GetView(), vertices, indices, options );
+	optimize::OptimizeVertexCache( indices, vertices.size() );
+
+	std::vector<uint32_t> chain{};
+	std::vector<LodLevel> lods{};
+	const double buildMs{ MeasureBestMs( 1, [&]() {
+		chain = indices;
+		lods = simplify::BuildLodChain( chain, vertices );
+	} ) };
+
+	// Levels have to follow each other in the buffer, shrink and only grow in error
+	bool isValid{ lods.size() >= 3 && lods.front().firstIndex == 0 && lods.front().indexCount == indices.size() };
+	uint32_t nextIndex{};
+	for ( size_t lodIdx{}; lodIdx < lods.size(); ++lodIdx )
+	{
+		const LodLevel& lod{ lods[lodIdx] };
+		isValid &= lod.firstIndex == nextIndex && lod.indexCount % 3 == 0 && lod.indexCount > 0;
+		if ( lodIdx > 0 )
+		{
+			isValid &= lod.indexCount < lods[lodIdx - 1].indexCount && lod.error >= lods[lodIdx - 1].error;
+		}
+		nextIndex = lod.firstIndex + lod.indexCount;
+	}
+	isValid &= nextIndex == chain.size();
+
+	// Seams move together, so no triangle may end up with two corners at the same position
+	const auto isSame{ []( const Vector3& a, const Vector3& b ) { return a.x == b.x && a.y == b.y && a.z == b.z; } };
+	size_t degenerateCount{};
+	for ( size_t cornerIdx{}; cornerIdx < chain.size(); cornerIdx += 3 )
+	{
+		if ( chain[cornerIdx] >= vertices.size() || chain[cornerIdx + 1] >= vertices.size() ||
+			 chain[cornerIdx + 2] >= vertices.size() )
+		{
+			isValid = false;
+			break;
+		}
+		const Vector3& p0{ vertices[chain[cornerIdx]].position };
+		const Vector3& p1{ vertices[chain[cornerIdx + 1]].position };
+		const Vector3& p2{ vertices[chain[cornerIdx + 2]].position };
+		degenerateCount += isSame( p0, p1 ) || isSame( p1, p2 ) || isSame( p2, p0 );
+	}
+	isValid &= degenerateCount == 0;
+
+	const BoundingBox bounds{ BoundingBox::Create( vertices ) };
+	const Vector3 extent{ bounds.max - bounds.min };
+	const float size{ std::max( { extent.x, extent.y, extent.z } ) };
+	const float radius{ extent.Magnitude() * 0.5f };
+
+	std::cout << objPath << " (" << indices.size() / 3 << " triangles), chain built in " << buildMs << " ms\n";
+	for ( size_t lodIdx{}; lodIdx < lods.size(); ++lodIdx )
+	{
+		std::cout << "  LOD" << lodIdx << ": " << lods[lodIdx].indexCount / 3 << " triangles, error "
+				  << lods[lodIdx].error << " (" << 100.0 * lods[lodIdx].error / size << "% of the size)\n";
+	}
+
+	// A row of copies receding from a camera with the scene's fov, one radius apart, picked like Scene::Update does
+	constexpr uint32_t instanceCount{ 64 };
+	const float fov{ std::tan( 22.5f * std::numbers::pi_v<float> / 180.f ) };
+	size_t fullTriangles{};
+	size_t lodTriangles{};
+	std::vector<uint32_t> histogram( lods.size(), 0 );
+	for ( uint32_t instanceIdx{}; instanceIdx < instanceCount; ++instanceIdx )
+	{
+		const float distance{ radius * ( 2.f + 2.f * instanceIdx ) - radius };
+		const uint32_t lodIdx{ simplify::SelectLod( lods, distance, fov ) };
+		++histogram[lodIdx];
+		fullTriangles += lods.front().indexCount / 3;
+		lodTriangles += lods[lodIdx].indexCount / 3;
+	}
+
+	std::cout << "  " << instanceCount << " copies: " << fullTriangles << " triangles per frame without LODs, "
+			  << lodTriangles << " with (" << static_cast<double>( fullTriangles ) / lodTriangles
+			  << "x), copies per LOD";
+	for ( const uint32_t count : histogram )
+	{
+		std::cout << " " << count;
+	}
+	std::cout << "\n";
+	std::cout << "  valid chain: " << ( isValid ? "PASS" : "FAIL" ) << " (" << degenerateCount
+			  << " degenerate triangles)\n";
+	return isValid;
+}
+
+bool GenerateTangents( const std::string& objPath )
+{
+	const MappedFile file{ objPath };
+
+	obj::ParseOptions options{};
+	options.weldVertices = true;
+
+	std::vector<Vertex> parsedVertices{};
+	std::vector<uint32_t> parsedIndices{};
+	obj::Parse( file.GetView(), parsedVertices, parsedIndices, options );
+
+	// Parsing already generated tangents and split the mirror seams, start over from the parsed vertices
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	tangent::GenerateStatistics statistics{};
+	const double serialMs{ MeasureBestMs( 3, [&]() {
+		vertices = parsedVertices;
+		indices = parsedIndices;
+		tangent::Generate( vertices, indices, nullptr, &statistics );
+	} ) };
+
+	std::cout << objPath << " (" << vertices.size() << " vertices, " << indices.size() / 3 << " triangles)\n";
+	std::cout << "  " << statistics.degenerateTriangleCount << " degenerate and " << statistics.mirroredTriangleCount
+			  << " mirrored triangles, " << statistics.splitVertexCount << " vertices split on mirror seams\n";
+
+	// Every tangent has to be a unit vector orthogonal to its normal, and every usable triangle has to see its own
+	// handedness at all three corners
+	bool isValid{ indices == parsedIndices };
+	size_t handednessMismatchCount{};
+	for ( size_t cornerIdx{}; cornerIdx < indices.size(); cornerIdx += 3 )
+	{
+		const Vertex& v0{ vertices[indices[cornerIdx]] };
+		const Vertex& v1{ vertices[indices[cornerIdx + 1]] };
+		const Vertex& v2{ vertices[indices[cornerIdx + 2]] };
+		const float determinant{ Vector2::Cross( v1.UV - v0.UV, v2.UV - v0.UV ) };
+		const float tolerance{ 1e-3f * ( v1.UV - v0.UV ).Magnitude() * ( v2.UV - v0.UV ).Magnitude() };
+		const Vector3 normal{ Vector3::Cross( v1.position - v0.position, v2.position - v0.position ) };
+		if ( std::abs( determinant ) <= tolerance || normal.SqrMagnitude() == 0.f )
+		{
+			continue;
+		}
+
+		const float handedness{ determinant < 0.f ? -1.f : 1.f };
+		handednessMismatchCount +=
+			v0.tangent.w != handedness || v1.tangent.w != handedness || v2.tangent.w != handedness;
+	}
+
+	size_t brokenCount{};
+	for ( const Vertex& vertex : vertices )
+	{
+		const Vector3 tangent{ vertex.tangent };
+		const bool isUnit{ std::abs( tangent.Magnitude() - 1.f ) < 1e-4f };
+		const bool isOrthogonal{ std::abs( Vector3::Dot( tangent, vertex.normal.Normalized() ) ) < 1e-4f };
+		brokenCount += !isUnit || !isOrthogonal || std::abs( vertex.tangent.w ) != 1.f;
+	}
+	isValid &= handednessMismatchCount == 0 && brokenCount == 0;
+	std::cout << "  " << brokenCount << " tangents not unit or orthogonal, " << handednessMismatchCount
+			  << " triangles with the wrong handedness" << ( isValid ? "" : " FAIL" ) << "\n";
+
+	// The SSE batches have to agree with a plain scalar loop, up to float rounding in the sums
+	std::vector<Vertex> scalarVertices{};
+	const double scalarMs{ MeasureBestMs( 3, [&]() {
+		scalarVertices = vertices;
+		GenerateTangentsScalar( scalarVertices, indices );
+	} ) };
+
+	float maxAngle{};
+	for ( size_t vertexIdx{}; vertexIdx < vertices.size(); ++vertexIdx )
+	{
+		const Vector4& scalar{ scalarVertices[vertexIdx].tangent };
+		if ( !std::isfinite( scalar.x ) || !std::isfinite( scalar.y ) || !std::isfinite( scalar.z ) )
+		{
+			continue; // nothing usable around it, the fallback is arbitrary
+		}
+		const float cosine{
+			std::clamp( Vector3::Dot( Vector3{ scalar }, Vector3{ vertices[vertexIdx].tangent } ), -1.f, 1.f ) };
+		maxAngle = std::max( maxAngle, std::acos( cosine ) * 180.f / std::numbers::pi_v<float> );
+	}
+	const bool isMatchingScalar{ maxAngle < 0.1f };
+	isValid &= isMatchingScalar;
+	std::cout << "  scalar: " << scalarMs << " ms, SSE: " << serialMs << " ms (" << statistics.triangleMs
+			  << " ms triangles, " << statistics.vertexMs << " ms vertices), max difference " << maxAngle << " deg"
+			  << ( isMatchingScalar ? "" : " FAIL" ) << "\n";
+
+	// Vertices only ever gather, so any thread count has to give the exact same bytes
+	bool isDeterministic{ true };
+	for ( const uint32_t threadCount : { 2u, 4u, 8u, 16u } )
+	{
+		ThreadPool pool{ threadCount };
+
+		std::vector<Vertex> parallelVertices{};
+		std::vector<uint32_t> parallelIndices{};
+		const double parallelMs{ MeasureBestMs( 3, [&]() {
+			parallelVertices = parsedVertices;
+			parallelIndices = parsedIndices;
+			tangent::Generate( parallelVertices, parallelIndices, &pool );
+		} ) };
+
+		const bool isEqual{ parallelIndices == indices && parallelVertices.size() == vertices.size() &&
+							std::memcmp( parallelVertices.data(), vertices.data(), vertices.size() * sizeof( Vertex ) ) ==
+								0 };
+		isDeterministic &= isEqual;
+
+		std::cout << "  " << threadCount << ( threadCount < 10 ? " threads:  " : " threads: " ) << parallelMs << " ms ("
+				  << serialMs / parallelMs << "x)" << ( isEqual ? "" : " OUTPUT DIFFERS FROM SERIAL" ) << "\n";
+	}
+	std::cout << "  determinism: " << ( isDeterministic ? "PASS" : "FAIL" ) << "\n";
+
+	return isValid && isDeterministic;
+}
+
+bool StreamOBJ( const std::string& objPath, size_t memoryBudget )
+{
+	const MappedFile file{ objPath };
+
+	ThreadPool pool{};
+	obj::StreamStatistics statistics{};
+	obj::StreamOptions options{};
+	options.memoryBudget = memoryBudget;
+	options.pThreadPool = &pool;
+	options.pStatistics = &statistics;
+
+	// Hashed a triangle corner at a time, streamed vertices are numbered per chunk and mirror splits land at the end of
+	// their chunk, so the same triangles can come with different indices
+	const auto hashCorner{ []( uint64_t checksum, const Vertex& vertex ) {
+		return hash::HashBytes( &vertex, sizeof( Vertex ), checksum );
+	} };
+
+	const size_t baselineBytes{ GetResidentBytes() };
+	size_t vertexCount{};
+	size_t triangleCount{};
+	size_t peakResidentBytes{};
+	uint64_t checksum{ hash::DefaultSeed };
+	const bool isParsed{ obj::Stream(
+		file,
+		[&]( const obj::StreamChunk& chunk ) {
+			for ( const uint32_t index : chunk.indices )
+			{
+				checksum = hashCorner( checksum, chunk.vertices[index] );
+			}
+			vertexCount += chunk.vertices.size();
+			triangleCount += chunk.indices.size() / 3;
+			peakResidentBytes = std::max( peakResidentBytes, GetResidentBytes() );
+		},
+		options ) };
+
+	const size_t residentGrowth{ peakResidentBytes > baselineBytes ? peakResidentBytes - baselineBytes : 0 };
+	const bool isWithinBudget{ residentGrowth <= memoryBudget && statistics.peakBytes <= memoryBudget };
+
+	constexpr double megabyte{ 1024.0 * 1024.0 };
+	std::cout << objPath << " (" << file.GetSize() / ( 1024 * 1024 ) << " MB, " << memoryBudget / megabyte
+			  << " MB budget)\n";
+	std::cout << "  " << statistics.chunkCount << " chunks, " << vertexCount << " vertices, " << triangleCount
+			  << " triangles\n";
+	std::cout << "  index: " << statistics.indexMs << " ms, parse: " << statistics.parseMs << " ms ("
+			  << file.GetSize() / megabyte / ( ( statistics.indexMs + statistics.parseMs ) / 1000.0 ) << " MB/s), "
+			  << statistics.blockLoadCount << " attribute blocks decoded\n";
+	std::cout << "  peak: " << statistics.peakBytes / megabyte << " MB counted, " << residentGrowth / megabyte
+			  << " MB resident above the start" << ( isWithinBudget ? "" : " OVER BUDGET" ) << "\n";
+
+	// Small files are parsed whole afterwards, every streamed triangle has to match the parsed one corner for corner
+	bool isMatching{ true };
+	if ( isParsed && file.GetSize() <= ( size_t{ 256 } << 20 ) )
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		obj::Parse( file.GetView(), vertices, indices );
+
+		uint64_t parsedChecksum{ hash::DefaultSeed };
+		for ( const uint32_t index : indices )
+		{
+			parsedChecksum = hashCorner( parsedChecksum, vertices[index] );
+		}
+		isMatching = parsedChecksum == checksum && indices.size() == triangleCount * 3;
+		std::cout << "  whole-file parse: " << ( isMatching ? "same triangles" : "FAIL" ) << "\n";
+	}
+
+	return isParsed && isWithinBudget && isMatching;
+}
+
+bool LoadAssetsAsync( const std::string& objPath, const std::vector<std::string>& texturePaths )
+{
+	obj::ParseOptions parseOptions{};
+	parseOptions.weldVertices = true;
+
+	cooked::CookOptions cookOptions{};
+	cookOptions.packVertices = true;
+
+	// Both start cold, like the first launch after the mesh changed
+	const std::string cachePath{ cooked::GetCachePath( objPath ) };
+	std::filesystem::remove( cachePath );
+
+	std::optional<MeshData> blockingMesh{};
+	std::vector<TextureData> blockingTextures{};
+	const double blockingMs{ MeasureBestMs( 1, [&]() {
+		blockingMesh.emplace( cooked::LoadOBJ( objPath, parseOptions, cookOptions ) );
+		for ( const std::string& texturePath : texturePaths )
+		{
+			blockingTextures.push_back( cooked::texture::Load( texturePath ) );
+		}
+	} ) };
+
+	std::filesystem::remove( cachePath );
+
+	AssetLoader loader{};
+	std::optional<MeshData> loadedMesh{};
+	std::vector<TextureData> loadedTextures( texturePaths.size() );
+	const Clock::time_point start{ Clock::now() };
+	double fullyLoadedMs{};
+	const auto pBarrier{ std::make_shared<LoadBarrier>( texturePaths.size() + 1, [&]() {
+		fullyLoadedMs = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+	} ) };
+
+	loader.Enqueue( objPath,
+					[&]() { return cooked::LoadOBJ( objPath, parseOptions, cookOptions ); },
+					[&]( MeshData&& mesh ) {
+						loadedMesh.emplace( std::move( mesh ) );
+						pBarrier->Arrive();
+					} );
+	for ( size_t textureIdx{}; textureIdx < texturePaths.size(); ++textureIdx )
+	{
+		loader.Enqueue( texturePaths[textureIdx],
+						[&, textureIdx]() { return cooked::texture::Load( texturePaths[textureIdx] ); },
+						[&, textureIdx]( TextureData&& texture ) {
+							loadedTextures[textureIdx] = std::move( texture );
+							pBarrier->Arrive();
+						} );
+	}
+	const double firstFrameMs{ std::chrono::duration<double, std::milli>( Clock::now() - start ).count() };
+
+	// Stands in for the render thread, each frame polls the loader once and then renders for a millisecond
+	double longestFrameMs{};
+	size_t frameCount{};
+	while ( loader.GetPendingCount() > 0 )
+	{
+		const Clock::time_point frameStart{ Clock::now() };
+		loader.Update();
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+
+		const std::chrono::duration<double, std::milli> frameTime{ Clock::now() - frameStart };
+		longestFrameMs = std::max( longestFrameMs, frameTime.count() );
+		++frameCount;
+	}
+
+	bool isEqual{ loadedMesh && blockingMesh->GetVertexData().size() == loadedMesh->GetVertexData().size() &&
+				  blockingMesh->GetIndexData().size() == loadedMesh->GetIndexData().size() &&
+				  std::memcmp( blockingMesh->GetVertexData().data(),
+							   loadedMesh->GetVertexData().data(),
+							   loadedMesh->GetVertexData().size_bytes() ) == 0 &&
+				  std::memcmp( blockingMesh->GetIndexData().data(),
+							   loadedMesh->GetIndexData().data(),
+							   loadedMesh->GetIndexData().size_bytes() ) == 0 };
+	for ( size_t textureIdx{}; textureIdx < texturePaths.size(); ++textureIdx )
+	{
+		const std::span<const std::byte> blockingPixels{ blockingTextures[textureIdx].GetPixels() };
+		const std::span<const std::byte> loadedPixels{ loadedTextures[textureIdx].GetPixels() };
+		isEqual &= std::ranges::equal( blockingPixels, loadedPixels );
+	}
+
+	std::cout << objPath << " and " << texturePaths.size() << " textures on " << std::thread::hardware_concurrency()
+			  << " threads\n";
+	std::cout << "  blocking:    first frame after " << blockingMs << " ms\n";
+	std::cout << "  background:  first frame after " << firstFrameMs << " ms, fully loaded after " << fullyLoadedMs
+			  << " ms, longest of " << frameCount << " frames " << longestFrameMs << " ms\n";
+	std::cout << "  same data:   " << ( isEqual ? "PASS" : "FAIL" ) << "\n";
+	loader.PrintTimeline();
+	return isEqual;
+}
+
+bool DecodeImagesAsync( const std::vector<std::string>& texturePaths )
+{
+	// Mapped and read up front, both only decode
+	std::vector<MappedFile> files{};
+	for ( const std::string& texturePath : texturePaths )
+	{
+		files.emplace_back( texturePath );
+		static_cast<void>( hash::HashBytes( files.back().GetView() ) );
+	}
+
+	std::vector<TextureData> serialTextures( files.size() );
+	const double serialMs{ MeasureBestMs( 3, [&]() {
+		for ( size_t fileIdx{}; fileIdx < files.size(); ++fileIdx )
+		{
+			serialTextures[fileIdx] = cooked::texture::Decode( files[fileIdx].GetView() );
+		}
+	} ) };
+
+	// The loader's workers are started before the clock is, like the renderer's are by the time a scene loads
+	std::optional<AssetLoader> loader{};
+	std::vector<TextureData> pooledTextures( files.size() );
+	double pooledMs{ HUGE_VAL };
+	uint32_t batchCount{};
+	for ( int run{}; run < 3; ++run )
+	{
+		loader.emplace();
+		loader->SetBatched( true );
+
+		const Clock::time_point start{ Clock::now() };
+		for ( size_t fileIdx{}; fileIdx < files.size(); ++fileIdx )
+		{
+			loader->Enqueue(
+				std::filesystem::path{ texturePaths[fileIdx] }.filename().string(),
+				[&, fileIdx]() { return cooked::texture::Decode( files[fileIdx].GetView() ); },
+				[&, fileIdx]( TextureData&& texture ) { pooledTextures[fileIdx] = std::move( texture ); } );
+		}
+
+		batchCount = 0;
+		while ( loader->GetPendingCount() > 0 )
+		{
+			const size_t pendingCount{ loader->GetPendingCount() };
+			loader->Update();
+			batchCount += loader->GetPendingCount() != pendingCount;
+			std::this_thread::yield();
+		}
+		const std::chrono::duration<double, std::milli> elapsed{ Clock::now() - start };
+		pooledMs = std::min( pooledMs, elapsed.count() );
+	}
+
+	bool isEqual{ true };
+	for ( size_t fileIdx{}; fileIdx < files.size(); ++fileIdx )
+	{
+		isEqual &= std::ranges::equal( serialTextures[fileIdx].GetPixels(), pooledTextures[fileIdx].GetPixels() );
+	}
+
+	std::cout << texturePaths.size() << " images decoded one after the other and on the "
+			  << std::max( std::thread::hardware_concurrency(), 2u ) - 1 << " workers of a batched asset loader\n";
+	std::cout << "  serial:      " << serialMs << " ms\n";
+	std::cout << "  batched:     " << pooledMs << " ms until handed over in " << batchCount << " updates, "
+			  << serialMs - pooledMs << " ms saved (" << serialMs / pooledMs << "x)\n";
+	std::cout << "  same pixels: " << ( isEqual ? "PASS" : "FAIL" ) << "\n";
+	loader->PrintTimeline();
+	return isEqual && batchCount == 1;
+}
+
+bool DecodePngs( const std::vector<std::string>& texturePaths )
+{
+	constexpr double bytesPerMb{ 1024.0 * 1024.0 };
+	std::cout << texturePaths.size() << " PNGs, in-tree decoder against SDL_image\n";
+
+	bool isValid{ true };
+	double fileMb{};
+	double pixelMb{};
+	double pngMs{};
+	double sdlMs{};
+	for ( const std::string& texturePath : texturePaths )
+	{
+		const MappedFile file{ texturePath };
+		TextureData decoded{};
+		TextureData reference{};
+		const double decodeMs{ MeasureBestMs( 5, [&]() { decoded = cooked::texture::Decode( file.GetView() ); } ) };
+		const double referenceMs{ MeasureBestMs( 5, [&]() {
+			reference = cooked::texture::DecodeWithSdl( file.GetView() );
+		} ) };
+
+		const bool isEqual{ decoded.GetWidth() == reference.GetWidth() &&
+							decoded.GetHeight() == reference.GetHeight() &&
+							std::ranges::equal( decoded.GetPixels(), reference.GetPixels() ) };
+		isValid &= isEqual;
+
+		fileMb += file.GetSize() / bytesPerMb;
+		pixelMb += decoded.GetPixels().size_bytes() / bytesPerMb;
+		pngMs += decodeMs;
+		sdlMs += referenceMs;
+		std::cout << "  " << texturePath << ": " << decodeMs << " ms against " << referenceMs << " ms, "
+				  << ( isEqual ? "same pixels" : "FAIL" ) << "\n";
+	}
+
+	std::cout << "  in-tree:   " << fileMb / ( pngMs / 1000.0 ) << " MB/s of file, " << pixelMb / ( pngMs / 1000.0 )
+			  << " MB/s of pixels\n";
+	std::cout << "  SDL_image: " << fileMb / ( sdlMs / 1000.0 ) << " MB/s of file, " << pixelMb / ( sdlMs / 1000.0 )
+			  << " MB/s of pixels, " << sdlMs / pngMs << "x the time\n";
+	return isValid;
+}
+
+bool GenerateMips( const std::string& texturePath, mip::Content content )
+{
+	const TextureData texture{ cooked::texture::Decode( texturePath ) };
+	const size_t firstLevelBytes{ texture.GetPixels().size_bytes() };
+	std::cout << texturePath << " (" << texture.GetWidth() << "x" << texture.GetHeight() << ", "
+			  << ( content == mip::Content::color    ? "color"
+				   : content == mip::Content::normal ? "normal map"
+													 : "data" )
+			  << ")\n";
+
+	bool isValid{ true };
+	for ( const mip::Filter filter : { mip::Filter::box, mip::Filter::kaiser } )
+	{
+		const mip::Options options{ content, filter };
+		std::optional<TextureData> chain{};
+		const double serialMs{ MeasureBestMs( 3, [&]() { chain.emplace( mip::Generate( texture, options ) ); } ) };
+
+		// Every level halves, rounded down, and the first one is the source as is
+		bool isComplete{ chain->GetLevelCount() ==
+							 TextureData::GetFullLevelCount( texture.GetWidth(), texture.GetHeight() ) &&
+						 std::ranges::equal( chain->GetLevel( 0 ).pixels, texture.GetPixels() ) };
+		const TextureData::Level last{ chain->GetLevel( chain->GetLevelCount() - 1 ) };
+		isComplete &= last.width == 1 && last.height == 1;
+
+		// Renormalized on every level, so only the 8-bit rounding is left
+		float maxNormalError{};
+		if ( content == mip::Content::normal )
+		{
+			for ( uint32_t levelIdx{ 1 }; levelIdx < chain->GetLevelCount(); ++levelIdx )
+			{
+				const std::span<const std::byte> pixels{ chain->GetLevel( levelIdx ).pixels };
+				for ( size_t offset{}; offset < pixels.size(); offset += TextureData::BytesPerPixel )
+				{
+					const auto decode{ [&]( size_t channelIdx ) {
+						return std::to_integer<uint8_t>( pixels[offset + channelIdx] ) / 127.5f - 1.f;
+					} };
+					const Vector3 normal{ decode( 0 ), decode( 1 ), decode( 2 ) };
+					maxNormalError = std::max( maxNormalError, std::abs( normal.Magnitude() - 1.f ) );
+				}
+			}
+			isComplete &= maxNormalError < 0.02f;
+		}
+		isValid &= isComplete;
+
+		const double chainMB{ static_cast<double>( chain->GetPixels().size_bytes() - firstLevelBytes ) / ( 1 << 20 ) };
+		std::cout << "  " << ( filter == mip::Filter::box ? "box:   " : "kaiser:" ) << " " << chain->GetLevelCount()
+				  << " levels in " << serialMs << " ms (" << chainMB / ( serialMs / 1000.0 ) << " MB/s written)";
+		if ( content == mip::Content::normal )
+		{
+			std::cout << ", max normal length error " << maxNormalError;
+		}
+		std::cout << ( isComplete ? "" : " FAIL" ) << "\n";
+
+		// Rows only ever gather from the level above, so any thread count has to give the exact same bytes
+		bool isDeterministic{ true };
+		for ( const uint32_t threadCount : { 2u, 4u, 8u } )
+		{
+			ThreadPool pool{ threadCount };
+			std::optional<TextureData> parallelChain{};
+			const double parallelMs{ MeasureBestMs(
+				3, [&]() { parallelChain.emplace( mip::Generate( texture, options, &pool ) ); } ) };
+
+			const bool isEqual{ std::ranges::equal( parallelChain->GetPixels(), chain->GetPixels() ) };
+			isDeterministic &= isEqual;
+			std::cout << "    " << threadCount << " threads: " << parallelMs << " ms (" << serialMs / parallelMs << "x)"
+					  << ( isEqual ? "" : " OUTPUT DIFFERS FROM SERIAL" ) << "\n";
+		}
+		isValid &= isDeterministic;
+	}
+
+	// A texel-sized checkerboard has to average to middle gray, in linear light for colors; a plain average of the
+	// sRGB bytes would give 128 and darken it
+	constexpr uint32_t patternSize{ 256 };
+	std::vector<std::byte> pattern( size_t{ patternSize } * patternSize * TextureData::BytesPerPixel );
+	for ( size_t texelIdx{}; texelIdx < size_t{ patternSize } * patternSize; ++texelIdx )
+	{
+		const bool isWhite{ ( texelIdx % patternSize + texelIdx / patternSize ) % 2 == 0 };
+		std::fill_n(
+			pattern.begin() + texelIdx * TextureData::BytesPerPixel, 3, static_cast<std::byte>( isWhite ? 255 : 0 ) );
+		pattern[texelIdx * TextureData::BytesPerPixel + 3] = std::byte{ 255 };
+	}
+	const TextureData checkerboard{ patternSize, patternSize, 1, std::move( pattern ) };
+	const int expectedGray{ content == mip::Content::color ? 188 : 128 };
+	if ( content != mip::Content::normal )
+	{
+		for ( const mip::Filter filter : { mip::Filter::box, mip::Filter::kaiser } )
+		{
+			const TextureData chain{ mip::Generate( checkerboard, { content, filter } ) };
+			const std::span<const std::byte> pixels{ chain.GetLevel( 1 ).pixels };
+			int maxGrayError{};
+			for ( size_t offset{}; offset < pixels.size(); offset += TextureData::BytesPerPixel )
+			{
+				for ( size_t channelIdx{}; channelIdx < 3; ++channelIdx )
+				{
+					const int channel{ std::to_integer<int>( pixels[offset + channelIdx] ) };
+					maxGrayError = std::max( maxGrayError, std::abs( channel - expectedGray ) );
+				}
+			}
+			isValid &= maxGrayError <= 1;
+			std::cout << "  checkerboard " << ( filter == mip::Filter::box ? "box:   " : "kaiser:" ) << " expected "
+					  << expectedGray << ", off by up to " << maxGrayError << ( maxGrayError <= 1 ? "" : " FAIL" )
+					  << "\n";
+		}
+	}
+
+	// What sampling the texture costs when it covers a square of fewer and fewer pixels, with only the first level
+	// and with the level whose texels match the pixels, the one trilinear filtering mostly reads
+	std::cout << "  fetched per frame, first level only / mip chain:\n";
+	const uint32_t levelCount{ TextureData::GetFullLevelCount( texture.GetWidth(), texture.GetHeight() ) };
+	for ( uint32_t levelIdx{ 1 }; levelIdx < std::min( 6u, levelCount ); ++levelIdx )
+	{
+		const uint32_t screenSize{ std::max( texture.GetWidth() >> levelIdx, 1u ) };
+		const size_t firstLevelFetchBytes{ CountFetchedBytes( texture.GetWidth(), texture.GetHeight(), screenSize ) };
+		const size_t mipFetchBytes{ CountFetchedBytes( std::max( texture.GetWidth() >> levelIdx, 1u ),
+													   std::max( texture.GetHeight() >> levelIdx, 1u ),
+													   screenSize ) };
+		const double pixelCount{ static_cast<double>( screenSize ) * screenSize };
+		std::cout << "    " << screenSize << " pixels wide: " << firstLevelFetchBytes / 1024.0 << " KB ("
+				  << firstLevelFetchBytes / pixelCount << " B/pixel) / " << mipFetchBytes / 1024.0 << " KB ("
+				  << mipFetchBytes / pixelCount << " B/pixel)\n";
+	}
+
+	return isValid;
+}
+
+bool CompressBlocks( const std::string& texturePath, mip::Content content, TextureData::Format format )
+{
+	const TextureData texture{ mip::Generate( cooked::texture::Decode( texturePath ), { content } ) };
+	const uint32_t channelCount{ GetStoredChannelCount( format ) };
+	std::cout << texturePath << " (" << texture.GetWidth() << "x" << texture.GetHeight() << ", "
+			  << texture.GetLevelCount() << " levels) to " << GetFormatName( format ) << "\n";
+
+	bool isValid{ true };
+	double previousPsnr{};
+	for ( const bc::Quality quality : { bc::Quality::fast, bc::Quality::normal, bc::Quality::high } )
+	{
+		std::optional<TextureData> compressed{};
+		const double serialMs{ MeasureBestMs(
+			1, [&]() { compressed.emplace( bc::Compress( texture, format, quality ) ); } ) };
+
+		// Quantizing to 8 bits alone would already stay above 40 dB, anything below 30 means broken blocks
+		const double psnr{ GetPsnr( texture, bc::Decompress( *compressed ), channelCount ) };
+		const bool isAccurate{ psnr > 30.0 && psnr >= previousPsnr - 0.01 };
+		previousPsnr = psnr;
+		isValid &= isAccurate;
+
+		const double texelCount{ static_cast<double>( texture.GetPixels().size_bytes() / TextureData::BytesPerPixel ) };
+		std::cout << "  "
+				  << ( quality == bc::Quality::fast	  ? "fast:  "
+					   : quality == bc::Quality::normal ? "normal:"
+														: "high:  " )
+				  << " " << serialMs << " ms (" << texelCount / ( serialMs * 1000.0 ) << " Mtexel/s), PSNR " << psnr
+				  << " dB over " << channelCount << " channels" << ( isAccurate ? "" : " FAIL" ) << "\n";
+
+		// Every block is encoded on its own, so any thread count has to give the exact same bytes
+		bool isDeterministic{ true };
+		for ( const uint32_t threadCount : { 2u, 4u, 8u } )
+		{
+			ThreadPool pool{ threadCount };
+			std::optional<TextureData> parallel{};
+			const double parallelMs{ MeasureBestMs(
+				1, [&]() { parallel.emplace( bc::Compress( texture, format, quality, &pool ) ); } ) };
+
+			const bool isEqual{ std::ranges::equal( parallel->GetPixels(), compressed->GetPixels() ) };
+			isDeterministic &= isEqual;
+			std::cout << "    " << threadCount << " threads: " << parallelMs << " ms (" << serialMs / parallelMs << "x)"
+					  << ( isEqual ? "" : " OUTPUT DIFFERS FROM SERIAL" ) << "\n";
+		}
+		isValid &= isDeterministic;
+	}
+
+	const size_t uncompressedBytes{ texture.GetPixels().size_bytes() };
+	const size_t compressedBytes{
+		TextureData::GetByteSize( texture.GetWidth(), texture.GetHeight(), texture.GetLevelCount(), format ) };
+	std::cout << "  video memory: " << uncompressedBytes / 1024.0 << " KB as RGBA8, " << compressedBytes / 1024.0
+			  << " KB as " << GetFormatName( format ) << ", " << ( uncompressedBytes - compressedBytes ) / 1024.0
+			  << " KB saved (" << static_cast<double>( uncompressedBytes ) / compressedBytes << "x)\n";
+
+	return isValid;
+}
+
+bool LoadContainers( const std::string& texturePath, TextureData::Format format )
+{
+	const TextureData texture{ bc::Compress(
+		mip::Generate( cooked::texture::Decode( texturePath ), {} ), format, bc::Quality::fast ) };
+	std::cout << texturePath << " (" << texture.GetWidth() << "x" << texture.GetHeight() << ", "
+			  << texture.GetLevelCount() << " levels, " << GetFormatName( format ) << ")\n";
+
+	// Decoding the source is what every load did before there were containers
+	const double decodeMs{ MeasureBestMs( 3, [&]() { cooked::texture::Decode( texturePath ); } ) };
+	std::cout << "  decode source: " << decodeMs << " ms, without building mips or compressing\n";
+
+	bool isValid{ true };
+	for ( const std::string extension : { ".dds", ".ktx2" } )
+	{
+		// Named after an image that doesn't exist, so loading that image has to find the container in its place
+		const std::string imagePath{ "./container_test.png" };
+		const std::string containerPath{ "./container_test" + extension };
+		if ( extension == ".dds" )
+		{
+			WriteDds( containerPath, texture );
+		}
+		else
+		{
+			WriteKtx2( containerPath, texture );
+		}
+
+		// The upload reads every byte once, the mapping alone hardly costs anything
+		std::optional<TextureData> opened{};
+		const double openMs{ MeasureBestMs( 3, [&]() { opened = container::Open( containerPath ); } ) };
+		const auto hashLevels{ []( const TextureData& levels ) {
+			uint64_t result{ hash::DefaultSeed };
+			for ( uint32_t levelIdx{}; levelIdx < levels.GetLevelCount(); ++levelIdx )
+			{
+				const std::span<const std::byte> pixels{ levels.GetLevel( levelIdx ).pixels };
+				result = hash::HashBytes( pixels.data(), pixels.size(), result );
+			}
+			return result;
+		} };
+		uint64_t openedHash{};
+		const double readMs{ MeasureBestMs( 3, [&]() { openedHash = opened ? hashLevels( *opened ) : 0; } ) };
+
+		const bool isEqual{ opened && opened->IsMapped() && opened->GetFormat() == format &&
+							opened->GetLevelCount() == texture.GetLevelCount() && openedHash == hashLevels( texture ) };
+
+		const TextureData found{ cooked::texture::Load( imagePath ) };
+		const bool isFound{ found.IsMapped() && found.GetLevelCount() == texture.GetLevelCount() };
+		opened.reset();
+
+		// Anything cut short must be turned down rather than read past the end
+		const std::uintmax_t fileSize{ std::filesystem::file_size( containerPath ) };
+		std::filesystem::resize_file( containerPath, fileSize - 1 );
+		bool isTruncatedRejected{ !container::Open( containerPath ) };
+		std::filesystem::resize_file( containerPath, 64 );
+		isTruncatedRejected &= !container::Open( containerPath );
+		std::filesystem::remove( containerPath );
+
+		isValid &= isEqual && isFound && isTruncatedRejected;
+		std::cout << "  " << extension << ( extension == ".dds" ? ": " : ":" ) << " open " << openMs
+				  << " ms, reading every level " << readMs << " ms, same levels " << ( isEqual ? "PASS" : "FAIL" )
+				  << ", found next to the image " << ( isFound ? "PASS" : "FAIL" ) << ", truncated rejected "
+				  << ( isTruncatedRejected ? "PASS" : "FAIL" ) << "\n";
+	}
+
+	return isValid;
+}
+
+bool NarrowTexels( const std::string& texturePath, mip::Content content, TextureData::Format format )
+{
+	const TextureData texture{ mip::Generate( cooked::texture::Decode( texturePath ), { content } ) };
+	const uint32_t channelCount{ GetStoredChannelCount( format ) };
+	std::cout << texturePath << " (" << texture.GetWidth() << "x" << texture.GetHeight() << ", "
+			  << texture.GetLevelCount() << " levels) to " << GetFormatName( format ) << "\n";
+
+	// Byte by byte, what the kernels replace
+	const std::span<const std::byte> source{ texture.GetPixels() };
+	const size_t texelCount{ source.size() / TextureData::BytesPerPixel };
+	std::vector<std::byte> expected( texelCount * channelCount );
+	const double scalarMs{ MeasureBestMs( 5, [&]() {
+		for ( size_t texelIdx{}; texelIdx < texelCount; ++texelIdx )
+		{
+			for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+			{
+				expected[texelIdx * channelCount + channelIdx] =
+					source[texelIdx * TextureData::BytesPerPixel + channelIdx];
+			}
+		}
+	} ) };
+
+	std::optional<TextureData> narrowed{};
+	const double narrowMs{ MeasureBestMs( 5, [&]() { narrowed.emplace( pixel::Convert( texture, format ) ); } ) };
+	const bool isExact{ std::ranges::equal( narrowed->GetPixels(), expected ) };
+
+	// Widened back it has to sample like the GPU does: the stored channels untouched, the others constant
+	std::optional<TextureData> widened{};
+	const double widenMs{ MeasureBestMs(
+		5, [&]() { widened.emplace( pixel::Convert( *narrowed, TextureData::Format::rgba8 ) ); } ) };
+	bool isRoundTripExact{ widened->GetPixels().size() == source.size() };
+	for ( size_t offset{}; isRoundTripExact && offset < source.size(); ++offset )
+	{
+		const uint32_t channelIdx{ static_cast<uint32_t>( offset % TextureData::BytesPerPixel ) };
+		const std::byte constant{ channelIdx == 3 ? std::byte{ 255 } : std::byte{ 0 } };
+		isRoundTripExact = widened->GetPixels()[offset] == ( channelIdx < channelCount ? source[offset] : constant );
+	}
+
+	const double sourceMb{ static_cast<double>( source.size() ) / ( 1024.0 * 1024.0 ) };
+	std::cout << "  byte loop: " << scalarMs << " ms (" << sourceMb / ( scalarMs / 1000.0 ) << " MB/s), SSE2: "
+			  << narrowMs << " ms (" << sourceMb / ( narrowMs / 1000.0 ) << " MB/s, " << scalarMs / narrowMs << "x)"
+			  << ( isExact ? "" : " OUTPUT DIFFERS" ) << ", back to RGBA8 in " << widenMs << " ms"
+			  << ( isRoundTripExact ? "" : " ROUND TRIP DIFFERS" ) << "\n";
+
+	const TextureData::Format blockFormat{ channelCount == 1 ? TextureData::Format::bc4 : TextureData::Format::bc5 };
+	const double texels{ static_cast<double>( texelCount ) };
+	std::cout << "  video memory per texel: " << TextureData::BytesPerPixel << " bytes as RGBA8, "
+			  << narrowed->GetPixels().size() / texels << " as " << GetFormatName( format ) << ", "
+			  << TextureData::GetByteSize(
+					 texture.GetWidth(), texture.GetHeight(), texture.GetLevelCount(), blockFormat ) /
+					 texels
+			  << " as " << GetFormatName( blockFormat ) << "\n";
+
+	return isExact && isRoundTripExact;
+}
+
+bool PackMaterial( const std::string& colorPath, const std::string& alphaPath )
+{
+	const TextureData color{ cooked::texture::Decode( colorPath ) };
+	const TextureData alpha{ cooked::texture::Decode( alphaPath ) };
+	std::cout << colorPath << " + " << alphaPath << " (" << color.GetWidth() << "x" << color.GetHeight()
+			  << ") to a material map\n";
+
+	// Byte by byte, what the kernel replaces; both pack in place
+	const std::span<const std::byte> alphaSource{ alpha.GetPixels() };
+	const size_t texelCount{ alphaSource.size() / TextureData::BytesPerPixel };
+	std::vector<std::byte> expected{ color.CopyPixels() };
+	const double scalarMs{ MeasureBestMs( 5, [&]() {
+		for ( size_t texelIdx{}; texelIdx < texelCount; ++texelIdx )
+		{
+			expected[texelIdx * TextureData::BytesPerPixel + 3] = alphaSource[texelIdx * TextureData::BytesPerPixel];
+		}
+	} ) };
+
+	std::vector<std::byte> actual{ color.CopyPixels() };
+	const double packMs{ MeasureBestMs(
+		5, [&]() { pixel::PackAlpha( alphaSource.data(), actual.data(), texelCount ); } ) };
+	const TextureData packed{ pixel::PackAlpha( color, alpha ) };
+	const bool isExact{ actual == expected && std::ranges::equal( packed.GetPixels(), expected ) };
+
+	const double sourceMb{ static_cast<double>( expected.size() ) / ( 1024.0 * 1024.0 ) };
+	std::cout << "  byte loop: " << scalarMs << " ms (" << sourceMb / ( scalarMs / 1000.0 ) << " MB/s), SSE2: "
+			  << packMs << " ms (" << sourceMb / ( packMs / 1000.0 ) << " MB/s, " << scalarMs / packMs << "x)"
+			  << ( isExact ? "" : " OUTPUT DIFFERS" ) << "\n";
+
+	// The chain is built on the packed map, every level has to hold exactly what the chains of both sources do
+	const mip::Options options{ mip::Content::data };
+	const TextureData packedChain{ mip::Generate( packed, options ) };
+	const TextureData colorChain{ mip::Generate( color, options ) };
+	const TextureData alphaChain{ mip::Generate( alpha, options ) };
+	const std::span<const std::byte> packedPixels{ packedChain.GetPixels() };
+	size_t differingCount{};
+	for ( size_t offset{}; offset < packedPixels.size(); ++offset )
+	{
+		const bool isAlpha{ offset % TextureData::BytesPerPixel == 3 };
+		const std::byte unpacked{ isAlpha ? alphaChain.GetPixels()[offset - 3] : colorChain.GetPixels()[offset] };
+		differingCount += packedPixels[offset] != unpacked;
+	}
+	std::cout << "  " << packedChain.GetLevelCount() << " levels against the unpacked chains: "
+			  << ( differingCount == 0 ? "bit-exact" : "DIFFERS" ) << " (" << differingCount << " bytes)\n";
+
+	// What the renderer gets: one BC3 map against a BC1 specular and a BC4 gloss map
+	ThreadPool pool{};
+	const TextureData material{ bc::Compress( packedChain, TextureData::Format::bc3, bc::Quality::normal, &pool ) };
+	const TextureData specular{ bc::Compress( colorChain, TextureData::Format::bc1, bc::Quality::normal, &pool ) };
+	const TextureData gloss{ bc::Compress( alphaChain, TextureData::Format::bc4, bc::Quality::normal, &pool ) };
+	const TextureData decodedMaterial{ bc::Decompress( material ) };
+	const double specularPsnr{ GetPsnr( colorChain, bc::Decompress( specular ), 3 ) };
+	const double glossPsnr{ GetPsnr( alphaChain, bc::Decompress( gloss ), 1 ) };
+	const double packedSpecularPsnr{ GetPsnr( packedChain, decodedMaterial, 3 ) };
+	const double packedGlossPsnr{ GetPsnr( packedChain, decodedMaterial, 1, 3 ) };
+	std::cout << "  PSNR specular " << specularPsnr << " dB as BC1, " << packedSpecularPsnr << " dB packed; gloss "
+			  << glossPsnr << " dB as BC4, " << packedGlossPsnr << " dB packed\n";
+
+	// Loading packs the same way
+	const TextureData loaded{ cooked::texture::LoadPacked(
+		colorPath, alphaPath, { options, TextureData::Format::bc3, bc::Quality::normal } ) };
+	const bool isLoadEqual{ std::ranges::equal( loaded.GetPixels(), material.GetPixels() ) };
+
+	std::cout << "  samples per pixel: 4 maps before, 3 with the material map; video memory: "
+			  << ( specular.GetPixels().size() + gloss.GetPixels().size() ) / 1024.0 << " KB as BC1 + BC4, "
+			  << material.GetPixels().size() / 1024.0 << " KB packed" << ( isLoadEqual ? "" : ", LOADED MAP DIFFERS" )
+			  << "\n";
+
+	// A tenth of a dB for rounding, BC3's halves are the BC1 and BC4 encoders
+	const bool isLossless{ packedSpecularPsnr >= specularPsnr - 0.1 && packedGlossPsnr >= glossPsnr - 0.1 };
+	return isExact && differingCount == 0 && isLossless && isLoadEqual;
+}
+
+bool StreamTextures( size_t textureCount, size_t budgetBytes )
+{
+	// A row of meshes with a 1024x1024 BC7 map each, the camera flies past them at one side up to halfway down the row
+	// and stays there; stream-ins land a few frames after they start, like they do through the asset loader
+	constexpr uint32_t mapSize{ 1024 };
+	constexpr float spacing{ 4.f };
+	constexpr float sideDistance{ 3.f };
+	constexpr float radius{ 1.f };
+	constexpr float viewDistance{ 64.f }; // further ahead is off screen, as is anything behind the camera
+	constexpr float screenHeight{ 1080.f };
+	constexpr uint64_t latencyFrameCount{ 3 };
+	constexpr uint64_t flightFrameCount{ 2000 };
+	constexpr uint64_t settleFrameCount{ 200 };
+	constexpr size_t maxPendingCount{ 4 }; // the texture streamer's
+	const float fov{ std::tan( 22.5f * std::numbers::pi_v<float> / 180.f ) };
+
+	std::vector<streaming::TextureState> textures( textureCount );
+	size_t allLevelsBytes{};
+	for ( streaming::TextureState& texture : textures )
+	{
+		texture.width = mapSize;
+		texture.height = mapSize;
+		texture.levelCount = TextureData::GetFullLevelCount( mapSize, mapSize );
+		texture.format = TextureData::Format::bc7;
+		texture.tailLevel = streaming::GetTailLevel( mapSize, mapSize, texture.levelCount, texture.format );
+		texture.residentLevel = texture.tailLevel;
+		texture.wantedLevel = texture.tailLevel;
+		texture.pendingLevel = texture.tailLevel;
+		allLevelsBytes += streaming::GetByteSize( texture, 0 );
+	}
+	const size_t tailBytes{ streaming::GetCommittedBytes( textures ) };
+	const size_t limitBytes{ std::max( budgetBytes, tailBytes ) };
+
+	struct Landing
+	{
+		size_t textureIdx{};
+		uint64_t frameIdx{};
+	};
+	std::vector<Landing> inFlight{};
+
+	bool isValid{ true };
+	size_t peakBytes{};
+	size_t streamInCount{};
+	size_t evictionCount{};
+	size_t missingLevelCount{};
+	size_t requestCount{};
+	double planMs{};
+	std::vector<bool> isInView( textureCount );
+	const float stopX{ static_cast<float>( textureCount ) * spacing * 0.5f };
+	for ( uint64_t frameIdx{ 1 }; frameIdx <= flightFrameCount + settleFrameCount; ++frameIdx )
+	{
+		// Landed stream-ins are handed over before the streamer plans, as in the renderer's update
+		std::erase_if( inFlight, [&]( const Landing& landing ) {
+			if ( landing.frameIdx > frameIdx )
+			{
+				return false;
+			}
+			streaming::TextureState& texture{ textures[landing.textureIdx] };
+			texture.residentLevel = texture.pendingLevel;
+			return true;
+		} );
+
+		// The level Texture::PickLevel gives for Mesh::RequestTextureLevels' screen size
+		const float cameraX{ std::min( static_cast<float>( frameIdx ) / flightFrameCount, 1.f ) * stopX };
+		for ( size_t textureIdx{}; textureIdx < textureCount; ++textureIdx )
+		{
+			streaming::TextureState& texture{ textures[textureIdx] };
+			const float aheadDistance{ static_cast<float>( textureIdx ) * spacing - cameraX };
+			isInView[textureIdx] = aheadDistance >= 0.f && aheadDistance <= viewDistance;
+			if ( !isInView[textureIdx] )
+			{
+				texture.wantedLevel = texture.tailLevel;
+				continue;
+			}
+
+			const float distance{ std::hypot( aheadDistance, sideDistance ) - radius };
+			const float screenSize{ radius * screenHeight / ( distance * fov ) };
+			const float levelIdx{ std::floor( std::log2( static_cast<float>( mapSize ) / screenSize ) ) };
+			const uint32_t wantedLevel{ static_cast<uint32_t>(
+				std::clamp( levelIdx, 0.f, static_cast<float>( texture.levelCount - 1 ) ) ) };
+			texture.wantedLevel = std::min( wantedLevel, texture.tailLevel );
+			texture.lastRequestedFrame = frameIdx;
+			missingLevelCount += texture.residentLevel - std::min( texture.residentLevel, texture.wantedLevel );
+			++requestCount;
+		}
+
+		std::optional<streaming::Plan> plan{};
+		const size_t maxStreamInCount{ maxPendingCount - inFlight.size() };
+		planMs += MeasureBestMs(
+			1, [&]() { plan.emplace( streaming::MakePlan( textures, budgetBytes, maxStreamInCount ) ); } );
+
+		// Only levels nobody asked for may go, and never the tail
+		for ( const streaming::Change& eviction : plan->evictions )
+		{
+			streaming::TextureState& texture{ textures[eviction.textureIdx] };
+			isValid &= eviction.residentLevel > texture.residentLevel && eviction.residentLevel <= texture.wantedLevel &&
+					   eviction.residentLevel <= texture.tailLevel;
+			evictionCount += eviction.residentLevel - texture.residentLevel;
+			texture.residentLevel = eviction.residentLevel;
+			texture.pendingLevel = eviction.residentLevel;
+		}
+		for ( const streaming::Change& streamIn : plan->streamIns )
+		{
+			textures[streamIn.textureIdx].pendingLevel = streamIn.residentLevel;
+			inFlight.push_back( { streamIn.textureIdx, frameIdx + latencyFrameCount } );
+			++streamInCount;
+		}
+
+		const size_t committedBytes{ streaming::GetCommittedBytes( textures ) };
+		peakBytes = std::max( peakBytes, committedBytes );
+	}
+	const bool isWithinBudget{ peakBytes <= limitBytes };
+	isValid &= isWithinBudget;
+
+	// After standing still, every map in view has what it asked for whenever that fits
+	size_t wantedBytes{};
+	size_t inViewCount{};
+	size_t settledCount{};
+	for ( size_t textureIdx{}; textureIdx < textureCount; ++textureIdx )
+	{
+		const streaming::TextureState& texture{ textures[textureIdx] };
+		wantedBytes += streaming::GetByteSize( texture, texture.wantedLevel );
+		inViewCount += isInView[textureIdx];
+		settledCount += isInView[textureIdx] && texture.residentLevel <= texture.wantedLevel;
+	}
+	const bool isSettled{ wantedBytes > budgetBytes || settledCount == inViewCount };
+	isValid &= isSettled;
+
+	constexpr double bytesPerMb{ 1024.0 * 1024.0 };
+	const double frameCount{ static_cast<double>( flightFrameCount + settleFrameCount ) };
+	std::cout << textureCount << " streamed " << mapSize << "x" << mapSize << " BC7 maps under a "
+			  << budgetBytes / bytesPerMb << " MB budget\n";
+	std::cout << "  video memory: " << allLevelsBytes / bytesPerMb << " MB with every level, " << tailBytes / bytesPerMb
+			  << " MB in tails, peak " << peakBytes / bytesPerMb << " MB" << ( isWithinBudget ? "" : " OVER BUDGET" )
+			  << "\n";
+	std::cout << "  " << streamInCount << " levels streamed in, " << evictionCount << " evicted, "
+			  << static_cast<double>( missingLevelCount ) / std::max( requestCount, size_t{ 1 } )
+			  << " levels missing per map in view, planned in " << 1000.0 * planMs / frameCount << " us per frame\n";
+	std::cout << "  standing still: " << settledCount << "/" << inViewCount << " maps in view at their level, "
+			  << wantedBytes / bytesPerMb << " MB wanted" << ( isSettled ? "" : " FAIL" ) << "\n";
+
+	return isValid;
+}
+
+bool BuildTextureArrays( const std::vector<std::string>& texturePaths )
+{
+	// Each map compressed like a diffuse map, then half, quarter and eighth size copies standing in for the maps of
+	// smaller props, and the first map once more left uncompressed, which can't share the array
+	ThreadPool pool{};
+	const mip::Options options{ mip::Content::color };
+	std::vector<TextureData> textures{};
+	textures.reserve( texturePaths.size() * 4 + 1 );
+	for ( const std::string& path : texturePaths )
+	{
+		const TextureData chain{ mip::Generate( cooked::texture::Decode( path ), options, &pool ) };
+		textures.push_back( bc::Compress( chain, TextureData::Format::bc7, bc::Quality::fast, &pool ) );
+	}
+	const size_t mapCount{ textures.size() };
+	for ( size_t mapIdx{}; mapIdx < mapCount; ++mapIdx )
+	{
+		for ( uint32_t firstLevel{ 1 }; firstLevel <= 3; ++firstLevel )
+		{
+			textures.push_back( DropLevels( textures[mapIdx], firstLevel ) );
+		}
+	}
+	textures.push_back( mip::Generate( cooked::texture::Decode( texturePaths.front() ), options, &pool ) );
+
+	std::vector<const TextureData*> pTextures{};
+	for ( const TextureData& texture : textures )
+	{
+		pTextures.push_back( &texture );
+	}
+
+	atlas::Layout layout{};
+	std::vector<TextureData> slices{};
+	const double planMs{ MeasureBestMs( 5, [&]() { layout = atlas::Plan( pTextures ); } ) };
+	const double buildMs{ MeasureBestMs( 5, [&]() { slices = atlas::Build( layout, pTextures ); } ) };
+
+	// Everything but the uncompressed map has a place, inside its slice and clear of the others on it
+	bool isPlaced{ !layout.placements.back() };
+	size_t placedCount{};
+	size_t atlasedTexels{};
+	for ( size_t textureIdx{}; textureIdx + 1 < textures.size(); ++textureIdx )
+	{
+		const std::optional<atlas::Placement>& placement{ layout.placements[textureIdx] };
+		if ( !placement )
+		{
+			isPlaced = false;
+			continue;
+		}
+		++placedCount;
+
+		const TextureData& texture{ textures[textureIdx] };
+		isPlaced &= placement->sliceIdx < layout.sliceCount && placement->x + texture.GetWidth() <= layout.width &&
+					placement->y + texture.GetHeight() <= layout.height;
+		if ( placement->sliceIdx >= layout.sliceCount - layout.pageCount )
+		{
+			atlasedTexels += size_t{ texture.GetWidth() } * texture.GetHeight();
+		}
+
+		for ( size_t otherIdx{}; otherIdx < textureIdx; ++otherIdx )
+		{
+			const std::optional<atlas::Placement>& other{ layout.placements[otherIdx] };
+			isPlaced &= !other || other->sliceIdx != placement->sliceIdx ||
+						other->x + textures[otherIdx].GetWidth() <= placement->x ||
+						placement->x + texture.GetWidth() <= other->x ||
+						other->y + textures[otherIdx].GetHeight() <= placement->y ||
+						placement->y + texture.GetHeight() <= other->y;
+		}
+	}
+
+	// Every level the array keeps has to hold the texture's blocks unchanged, wherever it sits
+	size_t differingRowCount{};
+	const uint32_t blockBytes{ TextureData::GetBlockBytes( layout.format ) };
+	for ( size_t textureIdx{}; textureIdx < textures.size(); ++textureIdx )
+	{
+		const std::optional<atlas::Placement>& placement{ layout.placements[textureIdx] };
+		for ( uint32_t levelIdx{}; placement && levelIdx < layout.levelCount; ++levelIdx )
+		{
+			const TextureData::Level level{ textures[textureIdx].GetLevel( levelIdx ) };
+			const TextureData::Level sliceLevel{ slices[placement->sliceIdx].GetLevel( levelIdx ) };
+			const size_t x{ size_t{ ( placement->x >> levelIdx ) / TextureData::BlockSize } * blockBytes };
+			const size_t y{ ( placement->y >> levelIdx ) / TextureData::BlockSize };
+			for ( size_t rowIdx{}; rowIdx * TextureData::BlockSize < level.height; ++rowIdx )
+			{
+				differingRowCount +=
+					!std::ranges::equal( level.pixels.subspan( rowIdx * level.rowPitch, level.rowPitch ),
+										 sliceLevel.pixels.subspan( ( y + rowIdx ) * sliceLevel.rowPitch + x,
+																	level.rowPitch ) );
+			}
+		}
+	}
+
+	size_t separateBytes{};
+	for ( size_t textureIdx{}; textureIdx < textures.size(); ++textureIdx )
+	{
+		if ( layout.placements[textureIdx] )
+		{
+			separateBytes += textures[textureIdx].GetPixels().size();
+		}
+	}
+
+	constexpr double bytesPerMb{ 1024.0 * 1024.0 };
+	const double pageTexels{ static_cast<double>( layout.pageCount ) * layout.width * layout.height };
+	std::cout << textures.size() << " maps into a " << layout.width << "x" << layout.height << " "
+			  << GetFormatName( layout.format ) << " texture array\n";
+	std::cout << "  " << placedCount << " placed" << ( isPlaced ? "" : " WRONG" ) << " in "
+			  << layout.sliceCount - layout.pageCount << " whole slices and " << layout.pageCount << " atlas pages ("
+			  << ( pageTexels > 0.0 ? 100.0 * atlasedTexels / pageTexels : 0.0 ) << "% covered), "
+			  << textures.size() - placedCount << " left out; " << layout.levelCount << "/"
+			  << TextureData::GetFullLevelCount( layout.width, layout.height ) << " levels kept\n";
+	std::cout << "  planned in " << 1000.0 * planMs << " us, built in " << buildMs << " ms, every level "
+			  << ( differingRowCount == 0 ? "bit-exact" : "DIFFERS" ) << " (" << differingRowCount << " block rows)\n";
+	std::cout << "  video memory: " << separateBytes / bytesPerMb << " MB as separate maps, "
+			  << atlas::GetByteSize( layout ) / bytesPerMb << " MB as the array; " << placedCount
+			  << " shader resource views bound between draws before, 1 for all of them\n";
+
+	return isPlaced && differingRowCount == 0;
+}
+
+std::string WriteSyntheticOBJ( size_t faceCount )
+{
+	const std::string path{ "./synthetic_" + std::to_string( faceCount ) + ".obj" };
+	if ( std::filesystem::exists( path ) )
+	{
+		return path;
+	}
+
+	std::cout << "Writing " << path << "...\n";
+
+	// Square grid with just enough quads to hold every face
+	const size_t quadsPerSide{ static_cast<size_t>( std::ceil( std::sqrt( ( faceCount + 1 ) / 2.0 ) ) ) };
+	const size_t verticesPerSide{ quadsPerSide + 1 };
+
+	// Written next to the final path and only renamed once complete, an interrupted write is never reused
+	const std::string tempPath{ path + ".tmp" };
+	std::ofstream file( tempPath );
+	if ( !file )
+	{
+		throw error::file::CouldNotOpenFile();
+	}
+
+	file << "# Synthetic benchmark grid, " << faceCount << " faces\n";
+	for ( size_t y{}; y < verticesPerSide; ++y )
+	{
+		for ( size_t x{}; x < verticesPerSide; ++x )
+		{
+			file << "v " << x * 0.01f << ' ' << std::sin( x * 0.05f ) * std::cos( y * 0.05f ) << ' ' << y * 0.01f
+				 << '\n';
+		}
+	}
+	for ( size_t y{}; y < verticesPerSide; ++y )
+	{
+		for ( size_t x{}; x < verticesPerSide; ++x )
+		{
+			file << "vt " << static_cast<float>( x ) / quadsPerSide << ' ' << static_cast<float>( y ) / quadsPerSide
+				 << '\n';
+		}
+	}
+	file << "vn 0 1 0\n";
+
+	size_t written{};
+	for ( size_t y{}; y < quadsPerSide && written < faceCount; ++y )
+	{
+		for ( size_t x{}; x < quadsPerSide && written < faceCount; ++x )
+		{
+			const size_t i0{ y * verticesPerSide + x + 1 };
+			const size_t i1{ i0 + 1 };
+			const size_t i2{ i0 + verticesPerSide };
+			const size_t i3{ i2 + 1 };
+
+			file << "f " << i0 << '/' << i0 << "/1 " << i2 << '/' << i2 << "/1 " << i1 << '/' << i1 << "/1\n";
+			if ( ++written < faceCount )
+			{
+				file << "f " << i1 << '/' << i1 << "/1 " << i2 << '/' << i2 << "/1 " << i3 << '/' << i3 << "/1\n";
+				++written;
+			}
+		}
+	}
+
+	file.close();
+	if ( !file )
+	{
+		std::filesystem::remove( tempPath );
+		throw error::file::CouldNotWriteFile();
+	}
+	std::filesystem::rename( tempPath, path );
+	return path;
+}
+} // namespace benchmark
+} // namespace dae
+
+int main( int argc, char* argv[] )
+{
+	const bool isLargeIncluded{ argc > 1 && std::string_view{ argv[1] } == "--large" };
+	return dae::benchmark::Run( isLargeIncluded ) ? 0 : 1;
+}
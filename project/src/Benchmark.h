@@ -0,0 +1,131 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Headless load-time benchmarks and checks, built as their own benchmark executable next to the renderer
+// Usage: benchmark [--large], from the directory the resources are copied to; --large adds the ones that write files
+// larger than memory
+#include <string>
+#include <vector>
+#include "BlockCompressor.h"
+#include "MipGenerator.h"
+
+namespace dae
+{
+namespace benchmark
+{
+// isLargeIncluded adds the stream test on a ~17 GB file, run with --large
+// Returns false when a check failed or a benchmark threw
+bool Run( bool isLargeIncluded );
+
+// Compares the memory-mapped parser against the original ifstream parser
+void ParseOBJ( const std::string& objPath );
+void ParseSyntheticOBJ( size_t faceCount );
+
+// Checks the chunked parser against the serial one, then times it at 1/2/4/8/16 threads
+// Returns false when the outputs differ
+bool ParseOBJParallel( const std::string& objPath );
+
+// Reports vertex counts with and without welding and the welder's throughput
+void WeldOBJ( const std::string& objPath );
+
+// Times a cold load (parse and write the cooked file) against opening the cooked file
+// Returns false when the cooked data differs from the parsed data
+bool LoadCookedOBJ( const std::string& objPath );
+
+// Reports ACMR/ATVR before and after vertex cache optimization, for the file order and a shuffled order
+// Returns false when the optimizer changed the set of triangles or their winding
+bool OptimizeVertexCache( const std::string& objPath );
+
+// Measures overdraw from viewCount directions for the file order, the vertex cache order and the overdraw order
+// Returns false when the optimizer changed the set of triangles or their winding
+bool OptimizeOverdraw( const std::string& objPath, uint32_t viewCount );
+
+// Reports cache lines per triangle and overfetch before and after renumbering vertices in first-use order
+// Returns false when a remapped index no longer refers to the same vertex
+bool OptimizeVertexFetch( const std::string& objPath );
+
+// Round-trips the vertices through both packed layouts, checks the worst errors against their bounds and compares
+// vertex buffer sizes and bytes fetched per triangle with the full Vertex struct
+bool PackVertices( const std::string& objPath );
+
+// Runs the cook passes on 32- and 16-bit copies of the same indices, they have to agree
+bool ShortIndices( const std::string& objPath );
+
+// Culls the meshlets from views around the mesh, checks the SSE pass against the scalar tests and that no visible
+// triangle gets culled, and reports how much is culled and what it costs
+bool CullMeshlets( const std::string& objPath );
+
+// Builds the LOD chain, checks its levels and that no triangle collapsed to a line, and compares triangles drawn for a
+// row of copies with and without picking LODs by distance
+bool SimplifyLods( const std::string& objPath );
+
+// Regenerates the parsed mesh's tangents, checks them against a scalar loop and that every triangle sees its own
+// handedness, and times them serially and at 2/4/8/16 threads
+// Returns false when a tangent is broken or the threaded output differs from the serial one
+bool GenerateTangents( const std::string& objPath );
+
+// Streams the file in chunks under memoryBudget, checks the resident memory against the budget and, for files small
+// enough to also parse whole, that every streamed triangle matches the parsed one
+bool StreamOBJ( const std::string& objPath, size_t memoryBudget );
+
+// Loads a mesh and its textures one after the other, the way the first frame used to wait for them, then through the
+// asset loader while a stand-in frame loop polls it; reports time to the first frame, to fully loaded and the longest
+// frame in between, then the loader's timeline of which worker decoded what and how much of it overlapped
+// Returns false when the loader's results differ from the blocking load
+bool LoadAssetsAsync( const std::string& objPath, const std::vector<std::string>& texturePaths );
+
+// Decodes the images one after the other, then all of them on a batched asset loader's workers until one Update hands
+// every image over, and reports the wall-clock time of both and the loader's timeline of the last run
+// Returns false when the pixels differ or the results weren't handed over in a single batch
+bool DecodeImagesAsync( const std::vector<std::string>& texturePaths );
+
+// Decodes every PNG with png::Decode and with SDL_image, checks that the pixels match and reports the throughput of
+// both in MB/s of file and of decoded pixels
+// Returns false when a decoder's pixels differ
+bool DecodePngs( const std::vector<std::string>& texturePaths );
+
+// Builds the texture's mip chain with both filters, checks the chain, that normals stay unit length and that a
+// checkerboard averages to the right gray, times it serially and at 2/4/8 threads, and estimates the bytes fetched per
+// frame with and without mips as the texture shrinks on screen
+// Returns false when a check fails or the threaded output differs from the serial one
+bool GenerateMips( const std::string& texturePath, mip::Content content );
+
+// Compresses the texture's mip chain at every quality, times it serially and at 2/4/8 threads, and reports the PSNR of
+// the channels the format stores against the uncompressed first level and the video memory saved
+// Returns false when the PSNR is implausibly low, drops with a higher quality or the threaded output differs
+bool CompressBlocks( const std::string& texturePath, mip::Content content, TextureData::Format format );
+
+// Writes the texture's compressed mip chain as DDS and KTX2, then times mapping them against decoding the source and
+// checks that the levels come back unchanged without a copy, that loading an image picks up a container next to it and
+// that truncated files are turned down
+// Returns false when a check fails
+bool LoadContainers( const std::string& texturePath, TextureData::Format format );
+
+// Drops the texture's mip chain to the channels format stores and widens it back, checks both against a byte loop,
+// times them and compares the video memory per texel with 8-bit RGBA and the matching BC format
+// Returns false when a kernel's output differs
+bool NarrowTexels( const std::string& texturePath, mip::Content content, TextureData::Format format );
+
+// Packs the alpha source's first channel into the color source's alpha like the material map, checks the kernel
+// against a byte loop and every level of the packed chain against the chains of both sources, and compares the packed
+// BC3 map's PSNR and video memory with BC1 and BC4 maps of its own
+// Returns false when the packed map isn't bit-exact before compression or either channel lost quality to packing
+bool PackMaterial( const std::string& colorPath, const std::string& alphaPath );
+
+// Flies a camera past a row of meshes with streamed maps and runs the streaming planner every frame, checks that the
+// committed video memory stays within the budget (or the tails, when those alone exceed it), that only levels nobody
+// asked for are evicted and that the maps in view get their levels once the camera stops, if they fit
+// Returns false when a check fails
+bool StreamTextures( size_t textureCount, size_t budgetBytes );
+
+// Plans one texture array for the maps, full-size ones as slices and smaller ones in atlas pages, checks that every
+// map that can share it has a place of its own and that the built slices hold its blocks unchanged at every level, and
+// reports the pages' coverage, the levels kept and the video memory against separate maps
+// Returns false when a check fails
+bool BuildTextureArrays( const std::vector<std::string>& texturePaths );
+
+// Writes a grid of quads split in two triangles, reuses the file if an earlier run finished writing it
+std::string WriteSyntheticOBJ( size_t faceCount );
+} // namespace benchmark
+} // namespace dae
+#endif
@@ -0,0 +1,1044 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include "BlockCompressor.h"
+#include "Error.h"
+#include "PixelConverter.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+namespace bc
+{
+namespace
+{
+constexpr uint32_t TexelCount{ TextureData::BlockSize * TextureData::BlockSize };
+
+// Block rows per pool task
+constexpr uint32_t TaskRowCount{ 4 };
+
+// Passes of the high preset's endpoint search, it usually settles after two or three
+constexpr uint32_t MaxSearchPassCount{ 8 };
+
+// Weights of BC7's 4-bit indices, out of 64
+constexpr std::array<int, 16> Bc7Weights{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Channels in [0, 255]
+using Texel = std::array<float, 4>;
+using Texels = std::array<Texel, TexelCount>;
+
+// Where each texel sits on the line between two endpoints, 0 at the first
+using LineWeights = std::array<float, TexelCount>;
+
+struct ColorBlock
+{
+	uint16_t color0{};
+	uint16_t color1{};
+	uint32_t indices{};
+	float error{ std::numeric_limits<float>::max() };
+};
+
+struct AlphaBlock
+{
+	uint8_t alpha0{};
+	uint8_t alpha1{};
+	uint64_t indices{};
+	float error{ std::numeric_limits<float>::max() };
+};
+
+struct Bc7Block
+{
+	std::array<uint8_t, 4> endpoint0{}; // 7 bits per channel, the p-bit below them
+	std::array<uint8_t, 4> endpoint1{};
+	uint8_t pBit0{};
+	uint8_t pBit1{};
+	std::array<uint8_t, TexelCount> indices{};
+	float error{ std::numeric_limits<float>::max() };
+};
+
+// Blocks are little-endian bit streams, the first field starts at the lowest bit of the first byte
+class BitWriter final
+{
+public:
+	void Write( uint32_t value, uint32_t bitCount )
+	{
+		for ( uint32_t bitIdx{}; bitIdx < bitCount; ++bitIdx, ++m_Position )
+		{
+			if ( ( value >> bitIdx ) & 1 )
+			{
+				m_Bytes[m_Position / 8] |= std::byte{ static_cast<uint8_t>( 1 << ( m_Position % 8 ) ) };
+			}
+		}
+	}
+
+	const std::array<std::byte, 16>& GetBytes() const
+	{
+		return m_Bytes;
+	}
+
+private:
+	std::array<std::byte, 16> m_Bytes{};
+	uint32_t m_Position{};
+};
+
+class BitReader final
+{
+public:
+	explicit BitReader( const std::byte* pBytes )
+		: m_pBytes( pBytes )
+	{
+	}
+
+	uint32_t Read( uint32_t bitCount )
+	{
+		uint32_t value{};
+		for ( uint32_t bitIdx{}; bitIdx < bitCount; ++bitIdx, ++m_Position )
+		{
+			value |= ( ( std::to_integer<uint32_t>( m_pBytes[m_Position / 8] ) >> ( m_Position % 8 ) ) & 1 ) << bitIdx;
+		}
+		return value;
+	}
+
+private:
+	const std::byte* m_pBytes{};
+	uint32_t m_Position{};
+};
+
+float Clamp( float value )
+{
+	return std::clamp( value, 0.f, 255.f );
+}
+
+float GetError( const Texel& lhs, const Texel& rhs, uint32_t channelCount )
+{
+	float error{};
+	for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+	{
+		const float difference{ lhs[channelIdx] - rhs[channelIdx] };
+		error += difference * difference;
+	}
+	return error;
+}
+
+Texels LoadBlock( const TextureData::Level& level, uint32_t blockX, uint32_t blockY )
+{
+	Texels texels{};
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		const uint32_t x{ blockX * TextureData::BlockSize + texelIdx % TextureData::BlockSize };
+		const uint32_t y{ blockY * TextureData::BlockSize + texelIdx / TextureData::BlockSize };
+		const std::byte* pTexel{ level.pixels.data() + size_t{ std::min( y, level.height - 1 ) } * level.rowPitch +
+								 size_t{ std::min( x, level.width - 1 ) } * TextureData::BytesPerPixel };
+		for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+		{
+			texels[texelIdx][channelIdx] = std::to_integer<uint8_t>( pTexel[channelIdx] );
+		}
+	}
+	return texels;
+}
+
+// The line through the texels' mean along their principal axis, from the first texel on it to the last
+std::pair<Texel, Texel> FitLine( const Texels& texels, uint32_t channelCount )
+{
+	Texel mean{};
+	for ( const Texel& texel : texels )
+	{
+		for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+		{
+			mean[channelIdx] += texel[channelIdx] / TexelCount;
+		}
+	}
+
+	std::array<Texel, 4> covariance{};
+	for ( const Texel& texel : texels )
+	{
+		for ( uint32_t row{}; row < channelCount; ++row )
+		{
+			for ( uint32_t column{}; column < channelCount; ++column )
+			{
+				covariance[row][column] += ( texel[row] - mean[row] ) * ( texel[column] - mean[column] );
+			}
+		}
+	}
+
+	// Power iteration, started from the channel that varies the most
+	uint32_t widestIdx{};
+	for ( uint32_t channelIdx{ 1 }; channelIdx < channelCount; ++channelIdx )
+	{
+		widestIdx = covariance[channelIdx][channelIdx] > covariance[widestIdx][widestIdx] ? channelIdx : widestIdx;
+	}
+	Texel axis{ covariance[widestIdx] };
+	for ( uint32_t iteration{}; iteration < 8; ++iteration )
+	{
+		Texel next{};
+		float largest{};
+		for ( uint32_t row{}; row < channelCount; ++row )
+		{
+			for ( uint32_t column{}; column < channelCount; ++column )
+			{
+				next[row] += covariance[row][column] * axis[column];
+			}
+			largest = std::max( largest, std::abs( next[row] ) );
+		}
+		if ( largest == 0.f )
+		{
+			return { mean, mean }; // every texel is the same
+		}
+		for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+		{
+			axis[channelIdx] = next[channelIdx] / largest;
+		}
+	}
+
+	const float lengthSq{ GetError( axis, Texel{}, channelCount ) };
+	float minDistance{ std::numeric_limits<float>::max() };
+	float maxDistance{ std::numeric_limits<float>::lowest() };
+	for ( const Texel& texel : texels )
+	{
+		float distance{};
+		for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+		{
+			distance += ( texel[channelIdx] - mean[channelIdx] ) * axis[channelIdx];
+		}
+		minDistance = std::min( minDistance, distance / lengthSq );
+		maxDistance = std::max( maxDistance, distance / lengthSq );
+	}
+
+	std::pair<Texel, Texel> endpoints{};
+	for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+	{
+		endpoints.first[channelIdx] = Clamp( mean[channelIdx] + axis[channelIdx] * minDistance );
+		endpoints.second[channelIdx] = Clamp( mean[channelIdx] + axis[channelIdx] * maxDistance );
+	}
+	return endpoints;
+}
+
+// Least-squares endpoints for texels that keep their place on the line, false when they all sit at the same place
+bool RefineLine( const Texels& texels,
+				 const LineWeights& weights,
+				 uint32_t channelCount,
+				 std::pair<Texel, Texel>& endpoints )
+{
+	float aa{};
+	float ab{};
+	float bb{};
+	Texel ax{};
+	Texel bx{};
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		const float a{ 1.f - weights[texelIdx] };
+		const float b{ weights[texelIdx] };
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+		{
+			ax[channelIdx] += a * texels[texelIdx][channelIdx];
+			bx[channelIdx] += b * texels[texelIdx][channelIdx];
+		}
+	}
+
+	const float determinant{ aa * bb - ab * ab };
+	if ( std::abs( determinant ) < 1e-6f )
+	{
+		return false;
+	}
+
+	for ( uint32_t channelIdx{}; channelIdx < channelCount; ++channelIdx )
+	{
+		endpoints.first[channelIdx] = Clamp( ( ax[channelIdx] * bb - bx[channelIdx] * ab ) / determinant );
+		endpoints.second[channelIdx] = Clamp( ( bx[channelIdx] * aa - ax[channelIdx] * ab ) / determinant );
+	}
+	return true;
+}
+
+// BC1 COLOR
+uint16_t ToRgb565( const Texel& color )
+{
+	const uint32_t r{ static_cast<uint32_t>( std::lround( color[0] * 31.f / 255.f ) ) };
+	const uint32_t g{ static_cast<uint32_t>( std::lround( color[1] * 63.f / 255.f ) ) };
+	const uint32_t b{ static_cast<uint32_t>( std::lround( color[2] * 31.f / 255.f ) ) };
+	return static_cast<uint16_t>( r << 11 | g << 5 | b );
+}
+
+Texel FromRgb565( uint16_t color )
+{
+	const uint32_t r{ static_cast<uint32_t>( color >> 11 ) };
+	const uint32_t g{ static_cast<uint32_t>( color >> 5 ) & 63u };
+	const uint32_t b{ static_cast<uint32_t>( color & 31 ) };
+	return { static_cast<float>( r << 3 | r >> 2 ),
+			 static_cast<float>( g << 2 | g >> 4 ),
+			 static_cast<float>( b << 3 | b >> 2 ),
+			 255.f };
+}
+
+// Four-color mode; with fourColors off and color0 <= color1 it is the three-color mode, where the last entry is
+// transparent black
+std::array<Texel, 4> GetColorPalette( uint16_t color0, uint16_t color1, bool fourColors )
+{
+	std::array<Texel, 4> palette{ FromRgb565( color0 ), FromRgb565( color1 ) };
+	const bool isFourColor{ fourColors || color0 > color1 };
+	for ( uint32_t channelIdx{}; channelIdx < 3; ++channelIdx )
+	{
+		const float c0{ palette[0][channelIdx] };
+		const float c1{ palette[1][channelIdx] };
+		palette[2][channelIdx] = isFourColor ? ( 2.f * c0 + c1 ) / 3.f : ( c0 + c1 ) / 2.f;
+		palette[3][channelIdx] = isFourColor ? ( c0 + 2.f * c1 ) / 3.f : 0.f;
+	}
+	palette[2][3] = 255.f;
+	palette[3][3] = isFourColor ? 255.f : 0.f;
+	return palette;
+}
+
+// Always in four-color mode, so BC3's color half, which ignores the endpoint order, decodes the same
+ColorBlock EncodeColorEndpoints( const Texels& texels, uint16_t color0, uint16_t color1 )
+{
+	ColorBlock block{};
+	block.color0 = std::max( color0, color1 );
+	block.color1 = std::min( color0, color1 );
+	block.error = 0.f;
+
+	// Equal endpoints would switch BC1 to three-color mode, index 0 means color0 in both
+	const std::array<Texel, 4> palette{ GetColorPalette( block.color0, block.color1, true ) };
+	const uint32_t paletteSize{ block.color0 == block.color1 ? 1u : 4u };
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		uint32_t bestIdx{};
+		float bestError{ std::numeric_limits<float>::max() };
+		for ( uint32_t paletteIdx{}; paletteIdx < paletteSize; ++paletteIdx )
+		{
+			const float error{ GetError( texels[texelIdx], palette[paletteIdx], 3 ) };
+			if ( error < bestError )
+			{
+				bestError = error;
+				bestIdx = paletteIdx;
+			}
+		}
+		block.indices |= bestIdx << ( 2 * texelIdx );
+		block.error += bestError;
+	}
+	return block;
+}
+
+ColorBlock EncodeColor( const Texels& texels, Quality quality )
+{
+	std::pair<Texel, Texel> endpoints{ FitLine( texels, 3 ) };
+	ColorBlock best{ EncodeColorEndpoints( texels, ToRgb565( endpoints.first ), ToRgb565( endpoints.second ) ) };
+	if ( quality == Quality::fast )
+	{
+		return best;
+	}
+
+	constexpr std::array<float, 4> indexWeights{ 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+	const uint32_t refineCount{ quality == Quality::high ? 4u : 2u };
+	for ( uint32_t iteration{}; iteration < refineCount; ++iteration )
+	{
+		LineWeights weights{};
+		for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+		{
+			weights[texelIdx] = indexWeights[( best.indices >> ( 2 * texelIdx ) ) & 3];
+		}
+		if ( !RefineLine( texels, weights, 3, endpoints ) )
+		{
+			break;
+		}
+
+		const ColorBlock refined{
+			EncodeColorEndpoints( texels, ToRgb565( endpoints.first ), ToRgb565( endpoints.second ) ) };
+		if ( refined.error >= best.error )
+		{
+			break;
+		}
+		best = refined;
+	}
+
+	if ( quality == Quality::high )
+	{
+		// One 565 step on one channel of one endpoint at a time, kept when it helps
+		constexpr std::array<uint16_t, 3> channelSteps{ 1 << 11, 1 << 5, 1 };
+		constexpr std::array<uint16_t, 3> channelMasks{ 31 << 11, 63 << 5, 31 };
+		for ( uint32_t pass{}; pass < MaxSearchPassCount; ++pass )
+		{
+			bool isImproved{};
+			for ( uint32_t endpointIdx{}; endpointIdx < 2; ++endpointIdx )
+			{
+				for ( uint32_t channelIdx{}; channelIdx < 3; ++channelIdx )
+				{
+					for ( const int direction : { -1, 1 } )
+					{
+						uint16_t colors[2]{ best.color0, best.color1 };
+						const int channel{ colors[endpointIdx] & channelMasks[channelIdx] };
+						const int moved{ channel + direction * channelSteps[channelIdx] };
+						if ( moved < 0 || moved > channelMasks[channelIdx] )
+						{
+							continue;
+						}
+						colors[endpointIdx] =
+							static_cast<uint16_t>( ( colors[endpointIdx] & ~channelMasks[channelIdx] ) | moved );
+
+						const ColorBlock candidate{ EncodeColorEndpoints( texels, colors[0], colors[1] ) };
+						if ( candidate.error < best.error )
+						{
+							best = candidate;
+							isImproved = true;
+						}
+					}
+				}
+			}
+			if ( !isImproved )
+			{
+				break;
+			}
+		}
+	}
+	return best;
+}
+
+void WriteColorBlock( const ColorBlock& block, std::byte* pBlock )
+{
+	std::memcpy( pBlock, &block.color0, sizeof( uint16_t ) );
+	std::memcpy( pBlock + 2, &block.color1, sizeof( uint16_t ) );
+	std::memcpy( pBlock + 4, &block.indices, sizeof( uint32_t ) );
+}
+
+void DecodeColorBlock( const std::byte* pBlock, bool fourColors, Texels& texels )
+{
+	uint16_t color0{};
+	uint16_t color1{};
+	uint32_t indices{};
+	std::memcpy( &color0, pBlock, sizeof( uint16_t ) );
+	std::memcpy( &color1, pBlock + 2, sizeof( uint16_t ) );
+	std::memcpy( &indices, pBlock + 4, sizeof( uint32_t ) );
+
+	const std::array<Texel, 4> palette{ GetColorPalette( color0, color1, fourColors ) };
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		const Texel& color{ palette[( indices >> ( 2 * texelIdx ) ) & 3] };
+		std::copy_n( color.begin(), 3, texels[texelIdx].begin() );
+		texels[texelIdx][3] = fourColors ? texels[texelIdx][3] : color[3];
+	}
+}
+//
+
+// BC4 CHANNEL
+// Eight steps when alpha0 > alpha1, otherwise six plus 0 and 255
+std::array<float, 8> GetAlphaPalette( uint8_t alpha0, uint8_t alpha1 )
+{
+	std::array<float, 8> palette{ static_cast<float>( alpha0 ), static_cast<float>( alpha1 ) };
+	if ( alpha0 > alpha1 )
+	{
+		for ( uint32_t paletteIdx{ 2 }; paletteIdx < 8; ++paletteIdx )
+		{
+			palette[paletteIdx] = ( ( 8.f - paletteIdx ) * alpha0 + ( paletteIdx - 1.f ) * alpha1 ) / 7.f;
+		}
+	}
+	else
+	{
+		for ( uint32_t paletteIdx{ 2 }; paletteIdx < 6; ++paletteIdx )
+		{
+			palette[paletteIdx] = ( ( 6.f - paletteIdx ) * alpha0 + ( paletteIdx - 1.f ) * alpha1 ) / 5.f;
+		}
+		palette[6] = 0.f;
+		palette[7] = 255.f;
+	}
+	return palette;
+}
+
+AlphaBlock EncodeAlphaEndpoints( const std::array<float, TexelCount>& values, uint8_t alpha0, uint8_t alpha1 )
+{
+	AlphaBlock block{};
+	block.alpha0 = alpha0;
+	block.alpha1 = alpha1;
+	block.error = 0.f;
+
+	const std::array<float, 8> palette{ GetAlphaPalette( alpha0, alpha1 ) };
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		uint64_t bestIdx{};
+		float bestError{ std::numeric_limits<float>::max() };
+		for ( uint32_t paletteIdx{}; paletteIdx < 8; ++paletteIdx )
+		{
+			const float difference{ values[texelIdx] - palette[paletteIdx] };
+			const float error{ difference * difference };
+			if ( error < bestError )
+			{
+				bestError = error;
+				bestIdx = paletteIdx;
+			}
+		}
+		block.indices |= bestIdx << ( 3 * texelIdx );
+		block.error += bestError;
+	}
+	return block;
+}
+
+uint8_t ToByte( float value )
+{
+	return static_cast<uint8_t>( std::lround( Clamp( value ) ) );
+}
+
+AlphaBlock EncodeAlpha( const Texels& texels, uint32_t channelIdx, Quality quality )
+{
+	std::array<float, TexelCount> values{};
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		values[texelIdx] = texels[texelIdx][channelIdx];
+	}
+
+	const auto [minIt, maxIt]{ std::minmax_element( values.begin(), values.end() ) };
+	const uint8_t minValue{ ToByte( *minIt ) };
+	const uint8_t maxValue{ ToByte( *maxIt ) };
+
+	// Eight-step mode, the larger endpoint first
+	const auto encode{ [&]( uint8_t first, uint8_t second ) {
+		return EncodeAlphaEndpoints( values, std::max( first, second ), std::min( first, second ) );
+	} };
+	AlphaBlock best{ encode( maxValue, minValue ) };
+	if ( quality == Quality::fast )
+	{
+		return best;
+	}
+
+	const uint32_t refineCount{ quality == Quality::high ? 4u : 2u };
+	for ( uint32_t iteration{}; iteration < refineCount && best.alpha0 > best.alpha1; ++iteration )
+	{
+		LineWeights weights{};
+		for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+		{
+			const uint32_t paletteIdx{ static_cast<uint32_t>( ( best.indices >> ( 3 * texelIdx ) ) & 7 ) };
+			weights[texelIdx] = paletteIdx == 0 ? 0.f : paletteIdx == 1 ? 1.f : ( paletteIdx - 1.f ) / 7.f;
+		}
+
+		Texels line{};
+		for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+		{
+			line[texelIdx][0] = values[texelIdx];
+		}
+		std::pair<Texel, Texel> endpoints{};
+		if ( !RefineLine( line, weights, 1, endpoints ) )
+		{
+			break;
+		}
+
+		const AlphaBlock refined{ encode( ToByte( endpoints.first[0] ), ToByte( endpoints.second[0] ) ) };
+		if ( refined.error >= best.error )
+		{
+			break;
+		}
+		best = refined;
+	}
+
+	if ( quality == Quality::high )
+	{
+		// Six-step mode spends its steps between the values that aren't 0 or 255
+		uint8_t innerMin{ 255 };
+		uint8_t innerMax{ 0 };
+		for ( const float value : values )
+		{
+			const uint8_t byte{ ToByte( value ) };
+			if ( byte != 0 && byte != 255 )
+			{
+				innerMin = std::min( innerMin, byte );
+				innerMax = std::max( innerMax, byte );
+			}
+		}
+		if ( innerMin <= innerMax )
+		{
+			const AlphaBlock sixStep{ EncodeAlphaEndpoints( values, innerMin, innerMax ) };
+			best = sixStep.error < best.error ? sixStep : best;
+		}
+
+		for ( uint32_t pass{}; pass < MaxSearchPassCount; ++pass )
+		{
+			bool isImproved{};
+			for ( uint32_t endpointIdx{}; endpointIdx < 2; ++endpointIdx )
+			{
+				for ( const int direction : { -1, 1 } )
+				{
+					int endpoints[2]{ best.alpha0, best.alpha1 };
+					endpoints[endpointIdx] += direction;
+					if ( endpoints[endpointIdx] < 0 || endpoints[endpointIdx] > 255 )
+					{
+						continue;
+					}
+
+					// Moving an endpoint must not flip the mode
+					const bool isEightStep{ best.alpha0 > best.alpha1 };
+					if ( ( endpoints[0] > endpoints[1] ) != isEightStep )
+					{
+						continue;
+					}
+
+					const AlphaBlock candidate{ EncodeAlphaEndpoints(
+						values, static_cast<uint8_t>( endpoints[0] ), static_cast<uint8_t>( endpoints[1] ) ) };
+					if ( candidate.error < best.error )
+					{
+						best = candidate;
+						isImproved = true;
+					}
+				}
+			}
+			if ( !isImproved )
+			{
+				break;
+			}
+		}
+	}
+	return best;
+}
+
+void WriteAlphaBlock( const AlphaBlock& block, std::byte* pBlock )
+{
+	pBlock[0] = std::byte{ block.alpha0 };
+	pBlock[1] = std::byte{ block.alpha1 };
+	for ( uint32_t byteIdx{}; byteIdx < 6; ++byteIdx )
+	{
+		pBlock[2 + byteIdx] = std::byte{ static_cast<uint8_t>( block.indices >> ( 8 * byteIdx ) ) };
+	}
+}
+
+void DecodeAlphaBlock( const std::byte* pBlock, uint32_t channelIdx, Texels& texels )
+{
+	uint64_t indices{};
+	for ( uint32_t byteIdx{}; byteIdx < 6; ++byteIdx )
+	{
+		indices |= std::to_integer<uint64_t>( pBlock[2 + byteIdx] ) << ( 8 * byteIdx );
+	}
+
+	const std::array<float, 8> palette{ GetAlphaPalette( std::to_integer<uint8_t>( pBlock[0] ),
+														 std::to_integer<uint8_t>( pBlock[1] ) ) };
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		texels[texelIdx][channelIdx] = palette[( indices >> ( 3 * texelIdx ) ) & 7];
+	}
+}
+//
+
+// BC7 MODE 6
+Texel ExpandBc7Endpoint( const std::array<uint8_t, 4>& endpoint, uint8_t pBit )
+{
+	Texel expanded{};
+	for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+	{
+		expanded[channelIdx] = static_cast<float>( endpoint[channelIdx] << 1 | pBit );
+	}
+	return expanded;
+}
+
+// Exactly what the GPU interpolates, in integers
+std::array<Texel, 16> GetBc7Palette( const Texel& endpoint0, const Texel& endpoint1 )
+{
+	std::array<Texel, 16> palette{};
+	for ( uint32_t paletteIdx{}; paletteIdx < 16; ++paletteIdx )
+	{
+		const int weight{ Bc7Weights[paletteIdx] };
+		for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+		{
+			const int value{ ( ( 64 - weight ) * static_cast<int>( endpoint0[channelIdx] ) +
+							   weight * static_cast<int>( endpoint1[channelIdx] ) + 32 ) >>
+							 6 };
+			palette[paletteIdx][channelIdx] = static_cast<float>( value );
+		}
+	}
+	return palette;
+}
+
+std::array<uint8_t, 4> QuantizeBc7Endpoint( const Texel& endpoint, uint8_t pBit )
+{
+	std::array<uint8_t, 4> quantized{};
+	for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+	{
+		quantized[channelIdx] =
+			static_cast<uint8_t>( std::clamp( std::lround( ( endpoint[channelIdx] - pBit ) / 2.f ), 0l, 127l ) );
+	}
+	return quantized;
+}
+
+Bc7Block EncodeBc7Quantized( const Texels& texels,
+							 const std::array<uint8_t, 4>& endpoint0,
+							 const std::array<uint8_t, 4>& endpoint1,
+							 uint8_t pBit0,
+							 uint8_t pBit1 )
+{
+	Bc7Block block{};
+	block.endpoint0 = endpoint0;
+	block.endpoint1 = endpoint1;
+	block.pBit0 = pBit0;
+	block.pBit1 = pBit1;
+	block.error = 0.f;
+
+	const std::array<Texel, 16> palette{ GetBc7Palette( ExpandBc7Endpoint( endpoint0, pBit0 ),
+														ExpandBc7Endpoint( endpoint1, pBit1 ) ) };
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		float bestError{ std::numeric_limits<float>::max() };
+		for ( uint32_t paletteIdx{}; paletteIdx < 16; ++paletteIdx )
+		{
+			const float error{ GetError( texels[texelIdx], palette[paletteIdx], 4 ) };
+			if ( error < bestError )
+			{
+				bestError = error;
+				block.indices[texelIdx] = static_cast<uint8_t>( paletteIdx );
+			}
+		}
+		block.error += bestError;
+	}
+	return block;
+}
+
+// The fast preset picks each p-bit on its own endpoint's rounding, the others try all four pairs
+Bc7Block EncodeBc7Endpoints( const Texels& texels, const std::pair<Texel, Texel>& endpoints, Quality quality )
+{
+	const auto pickPBit{ [&]( const Texel& endpoint ) {
+		float errors[2]{};
+		for ( const uint8_t pBit : { 0, 1 } )
+		{
+			errors[pBit] = GetError( endpoint, ExpandBc7Endpoint( QuantizeBc7Endpoint( endpoint, pBit ), pBit ), 4 );
+		}
+		return static_cast<uint8_t>( errors[1] < errors[0] ? 1 : 0 );
+	} };
+
+	if ( quality == Quality::fast )
+	{
+		const uint8_t pBit0{ pickPBit( endpoints.first ) };
+		const uint8_t pBit1{ pickPBit( endpoints.second ) };
+		return EncodeBc7Quantized( texels,
+								   QuantizeBc7Endpoint( endpoints.first, pBit0 ),
+								   QuantizeBc7Endpoint( endpoints.second, pBit1 ),
+								   pBit0,
+								   pBit1 );
+	}
+
+	Bc7Block best{};
+	for ( uint8_t pBits{}; pBits < 4; ++pBits )
+	{
+		const uint8_t pBit0{ static_cast<uint8_t>( pBits & 1 ) };
+		const uint8_t pBit1{ static_cast<uint8_t>( pBits >> 1 ) };
+		const Bc7Block candidate{ EncodeBc7Quantized( texels,
+													  QuantizeBc7Endpoint( endpoints.first, pBit0 ),
+													  QuantizeBc7Endpoint( endpoints.second, pBit1 ),
+													  pBit0,
+													  pBit1 ) };
+		best = candidate.error < best.error ? candidate : best;
+	}
+	return best;
+}
+
+Bc7Block EncodeBc7( const Texels& texels, Quality quality )
+{
+	std::pair<Texel, Texel> endpoints{ FitLine( texels, 4 ) };
+	Bc7Block best{ EncodeBc7Endpoints( texels, endpoints, quality ) };
+	if ( quality == Quality::fast )
+	{
+		return best;
+	}
+
+	const uint32_t refineCount{ quality == Quality::high ? 4u : 2u };
+	for ( uint32_t iteration{}; iteration < refineCount; ++iteration )
+	{
+		LineWeights weights{};
+		for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+		{
+			weights[texelIdx] = Bc7Weights[best.indices[texelIdx]] / 64.f;
+		}
+		if ( !RefineLine( texels, weights, 4, endpoints ) )
+		{
+			break;
+		}
+
+		const Bc7Block refined{ EncodeBc7Endpoints( texels, endpoints, quality ) };
+		if ( refined.error >= best.error )
+		{
+			break;
+		}
+		best = refined;
+	}
+
+	if ( quality == Quality::high )
+	{
+		for ( uint32_t pass{}; pass < MaxSearchPassCount; ++pass )
+		{
+			bool isImproved{};
+			for ( uint32_t endpointIdx{}; endpointIdx < 2; ++endpointIdx )
+			{
+				for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+				{
+					for ( const int direction : { -1, 1 } )
+					{
+						std::array<uint8_t, 4> quantized[2]{ best.endpoint0, best.endpoint1 };
+						const int moved{ quantized[endpointIdx][channelIdx] + direction };
+						if ( moved < 0 || moved > 127 )
+						{
+							continue;
+						}
+						quantized[endpointIdx][channelIdx] = static_cast<uint8_t>( moved );
+
+						const Bc7Block candidate{
+							EncodeBc7Quantized( texels, quantized[0], quantized[1], best.pBit0, best.pBit1 ) };
+						if ( candidate.error < best.error )
+						{
+							best = candidate;
+							isImproved = true;
+						}
+					}
+				}
+			}
+			if ( !isImproved )
+			{
+				break;
+			}
+		}
+	}
+	return best;
+}
+
+void WriteBc7Block( Bc7Block block, std::byte* pBlock )
+{
+	// The first texel's index drops its top bit, so it has to be in the lower half; swapping the endpoints mirrors
+	// every index
+	if ( block.indices[0] >= 8 )
+	{
+		std::swap( block.endpoint0, block.endpoint1 );
+		std::swap( block.pBit0, block.pBit1 );
+		for ( uint8_t& index : block.indices )
+		{
+			index = static_cast<uint8_t>( 15 - index );
+		}
+	}
+
+	BitWriter writer{};
+	writer.Write( 1 << 6, 7 ); // mode 6
+	for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+	{
+		writer.Write( block.endpoint0[channelIdx], 7 );
+		writer.Write( block.endpoint1[channelIdx], 7 );
+	}
+	writer.Write( block.pBit0, 1 );
+	writer.Write( block.pBit1, 1 );
+	writer.Write( block.indices[0], 3 );
+	for ( uint32_t texelIdx{ 1 }; texelIdx < TexelCount; ++texelIdx )
+	{
+		writer.Write( block.indices[texelIdx], 4 );
+	}
+	std::memcpy( pBlock, writer.GetBytes().data(), writer.GetBytes().size() );
+}
+
+void DecodeBc7Block( const std::byte* pBlock, Texels& texels )
+{
+	BitReader reader{ pBlock };
+	if ( reader.Read( 7 ) != 1 << 6 )
+	{
+		texels = {};
+		return;
+	}
+
+	std::array<uint8_t, 4> endpoint0{};
+	std::array<uint8_t, 4> endpoint1{};
+	for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+	{
+		endpoint0[channelIdx] = static_cast<uint8_t>( reader.Read( 7 ) );
+		endpoint1[channelIdx] = static_cast<uint8_t>( reader.Read( 7 ) );
+	}
+	const uint8_t pBit0{ static_cast<uint8_t>( reader.Read( 1 ) ) };
+	const uint8_t pBit1{ static_cast<uint8_t>( reader.Read( 1 ) ) };
+
+	const std::array<Texel, 16> palette{ GetBc7Palette( ExpandBc7Endpoint( endpoint0, pBit0 ),
+														ExpandBc7Endpoint( endpoint1, pBit1 ) ) };
+	for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+	{
+		texels[texelIdx] = palette[reader.Read( texelIdx == 0 ? 3 : 4 )];
+	}
+}
+//
+
+void EncodeBlock( const Texels& texels, TextureData::Format format, Quality quality, std::byte* pBlock )
+{
+	switch ( format )
+	{
+	case TextureData::Format::bc1:
+		WriteColorBlock( EncodeColor( texels, quality ), pBlock );
+		break;
+
+	case TextureData::Format::bc3:
+		WriteAlphaBlock( EncodeAlpha( texels, 3, quality ), pBlock );
+		WriteColorBlock( EncodeColor( texels, quality ), pBlock + 8 );
+		break;
+
+	case TextureData::Format::bc4:
+		WriteAlphaBlock( EncodeAlpha( texels, 0, quality ), pBlock );
+		break;
+
+	case TextureData::Format::bc5:
+		WriteAlphaBlock( EncodeAlpha( texels, 0, quality ), pBlock );
+		WriteAlphaBlock( EncodeAlpha( texels, 1, quality ), pBlock + 8 );
+		break;
+
+	case TextureData::Format::bc7:
+		WriteBc7Block( EncodeBc7( texels, quality ), pBlock );
+		break;
+
+	default:
+		break;
+	}
+}
+
+Texels DecodeBlock( const std::byte* pBlock, TextureData::Format format )
+{
+	Texels texels{};
+	for ( Texel& texel : texels )
+	{
+		texel[3] = 255.f;
+	}
+
+	switch ( format )
+	{
+	case TextureData::Format::bc1:
+		DecodeColorBlock( pBlock, false, texels );
+		break;
+
+	case TextureData::Format::bc3:
+		DecodeAlphaBlock( pBlock, 3, texels );
+		DecodeColorBlock( pBlock + 8, true, texels );
+		break;
+
+	case TextureData::Format::bc4:
+		DecodeAlphaBlock( pBlock, 0, texels );
+		break;
+
+	case TextureData::Format::bc5:
+		DecodeAlphaBlock( pBlock, 0, texels );
+		DecodeAlphaBlock( pBlock + 8, 1, texels );
+		break;
+
+	case TextureData::Format::bc7:
+		DecodeBc7Block( pBlock, texels );
+		break;
+
+	default:
+		break;
+	}
+	return texels;
+}
+
+void ForEachRowRange( uint32_t rowCount,
+					  size_t blockCount,
+					  ThreadPool* pThreadPool,
+					  const std::function<void( uint32_t, uint32_t )>& function )
+{
+	if ( !pThreadPool || blockCount < MinParallelBlockCount )
+	{
+		function( 0, rowCount );
+		return;
+	}
+
+	pThreadPool->ParallelFor( ( rowCount + TaskRowCount - 1 ) / TaskRowCount, [&]( size_t taskIdx ) {
+		const uint32_t rowBegin{ static_cast<uint32_t>( taskIdx ) * TaskRowCount };
+		function( rowBegin, std::min( rowCount, rowBegin + TaskRowCount ) );
+	} );
+}
+} // namespace
+
+TextureData Compress( const TextureData& texture, TextureData::Format format, Quality quality, ThreadPool* pThreadPool )
+{
+	const uint32_t width{ texture.GetWidth() };
+	const uint32_t height{ texture.GetHeight() };
+	const uint32_t levelCount{ texture.GetLevelCount() };
+	if ( !TextureData::IsCompressed( format ) )
+	{
+		return pixel::Convert( texture, format );
+	}
+
+	if ( width % TextureData::BlockSize != 0 || height % TextureData::BlockSize != 0 )
+	{
+		throw error::texture::CompressFail();
+	}
+
+	const uint32_t blockBytes{ TextureData::GetBlockBytes( format ) };
+	std::vector<std::byte> blocks( TextureData::GetByteSize( width, height, levelCount, format ) );
+	size_t levelOffset{};
+	for ( uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx )
+	{
+		const TextureData::Level level{ texture.GetLevel( levelIdx ) };
+		const uint32_t blockColumnCount{ ( level.width + TextureData::BlockSize - 1 ) / TextureData::BlockSize };
+		const uint32_t blockRowCount{ ( level.height + TextureData::BlockSize - 1 ) / TextureData::BlockSize };
+		std::byte* pLevelBlocks{ blocks.data() + levelOffset };
+
+		ForEachRowRange( blockRowCount,
+						 size_t{ blockColumnCount } * blockRowCount,
+						 pThreadPool,
+						 [&]( uint32_t rowBegin, uint32_t rowEnd ) {
+							 for ( uint32_t blockY{ rowBegin }; blockY < rowEnd; ++blockY )
+							 {
+								 for ( uint32_t blockX{}; blockX < blockColumnCount; ++blockX )
+								 {
+									 const size_t blockIdx{ size_t{ blockY } * blockColumnCount + blockX };
+									 EncodeBlock( LoadBlock( level, blockX, blockY ),
+												  format,
+												  quality,
+												  pLevelBlocks + blockIdx * blockBytes );
+								 }
+							 }
+						 } );
+		levelOffset += size_t{ blockColumnCount } * blockRowCount * blockBytes;
+	}
+
+	return TextureData{ width, height, levelCount, std::move( blocks ), format };
+}
+
+TextureData Decompress( const TextureData& texture )
+{
+	const uint32_t width{ texture.GetWidth() };
+	const uint32_t height{ texture.GetHeight() };
+	const uint32_t levelCount{ texture.GetLevelCount() };
+	const TextureData::Format format{ texture.GetFormat() };
+	if ( !TextureData::IsCompressed( format ) )
+	{
+		return pixel::Convert( texture, TextureData::Format::rgba8 );
+	}
+
+	const uint32_t blockBytes{ TextureData::GetBlockBytes( format ) };
+	std::vector<std::byte> pixels( TextureData::GetByteSize( width, height, levelCount ) );
+	size_t levelOffset{};
+	for ( uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx )
+	{
+		const TextureData::Level level{ texture.GetLevel( levelIdx ) };
+		const uint32_t blockColumnCount{ ( level.width + TextureData::BlockSize - 1 ) / TextureData::BlockSize };
+		const uint32_t blockRowCount{ ( level.height + TextureData::BlockSize - 1 ) / TextureData::BlockSize };
+		const uint32_t rowPitch{ level.width * TextureData::BytesPerPixel };
+
+		for ( uint32_t blockY{}; blockY < blockRowCount; ++blockY )
+		{
+			for ( uint32_t blockX{}; blockX < blockColumnCount; ++blockX )
+			{
+				const size_t blockIdx{ size_t{ blockY } * blockColumnCount + blockX };
+				const Texels texels{ DecodeBlock( level.pixels.data() + blockIdx * blockBytes, format ) };
+
+				// Texels past the level's edge only exist in the block
+				for ( uint32_t texelIdx{}; texelIdx < TexelCount; ++texelIdx )
+				{
+					const uint32_t x{ blockX * TextureData::BlockSize + texelIdx % TextureData::BlockSize };
+					const uint32_t y{ blockY * TextureData::BlockSize + texelIdx / TextureData::BlockSize };
+					if ( x >= level.width || y >= level.height )
+					{
+						continue;
+					}
+
+					std::byte* pTexel{ pixels.data() + levelOffset + size_t{ y } * rowPitch +
+									   size_t{ x } * TextureData::BytesPerPixel };
+					for ( uint32_t channelIdx{}; channelIdx < 4; ++channelIdx )
+					{
+						pTexel[channelIdx] = std::byte{ ToByte( texels[texelIdx][channelIdx] ) };
+					}
+				}
+			}
+		}
+		levelOffset += size_t{ rowPitch } * level.height;
+	}
+
+	return TextureData{ width, height, levelCount, std::move( pixels ) };
+}
+} // namespace bc
+} // namespace dae
@@ -0,0 +1,41 @@
+#ifndef BLOCKCOMPRESSOR_H
+#define BLOCKCOMPRESSOR_H
+
+// CPU encoder for the block-compressed formats TextureData knows, run by the asset cooker or at load time
+// Every 4x4 block gets its endpoints from the principal axis of its texels, the quality presets decide how hard they
+// are refined from there; BC7 blocks are all written in mode 6, a single RGBA line with 16 steps
+#include <cstdint>
+#include "TextureData.h"
+
+namespace dae
+{
+class ThreadPool;
+
+namespace bc
+{
+enum class Quality
+{
+	fast,	// endpoints straight from the principal axis
+	normal, // refined by least squares against the indices they got
+	high,	// refined, then nudged one step at a time while that lowers the error
+};
+
+// Below this the pool costs more than it saves
+constexpr uint32_t MinParallelBlockCount{ uint32_t{ 1 } << 10 };
+
+// Compresses every level of an 8-bit RGBA texture, returns a copy when format is rgba8 and only keeps the channels r8
+// and rg8 store
+// Blocks hanging over the edge of a level smaller than a block repeat its last row and column
+// Throws error::texture::CompressFail when the first level isn't a whole number of blocks, D3D11 can't create those
+TextureData Compress( const TextureData& texture,
+					  TextureData::Format format,
+					  Quality quality,
+					  ThreadPool* pThreadPool = nullptr );
+
+// Decodes every level back to 8-bit RGBA the way the GPU samples it, r8 and rg8 included; channels the format doesn't
+// store come back as 0 and alpha as 255
+// Only meant for what Compress wrote, BC7 blocks in any other mode decode to 0
+TextureData Decompress( const TextureData& texture );
+} // namespace bc
+} // namespace dae
+#endif
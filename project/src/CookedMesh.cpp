@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "CookedMesh.h"
+#include "Error.h"
+#include "Hash.h"
+#include "MeshOptimizer.h"
+#include "VertexPacking.h"
+
+namespace dae
+{
+namespace cooked
+{
+namespace
+{
+uint64_t AlignUp( uint64_t value )
+{
+	return ( value + Alignment - 1 ) & ~( Alignment - 1 );
+}
+
+void WritePadding( std::ofstream& file, uint64_t from, uint64_t to )
+{
+	constexpr char zeroes[Alignment]{};
+	file.write( zeroes, static_cast<std::streamsize>( to - from ) );
+}
+
+bool IsValidHeader( const Header& header, uint64_t fileSize, uint64_t optionsHash )
+{
+	if ( header.magic != Magic || header.version != Version || header.headerSize != sizeof( Header ) )
+	{
+		return false;
+	}
+
+	if ( ( header.indexSize != sizeof( uint16_t ) && header.indexSize != sizeof( uint32_t ) ) || header.layout.stride == 0 ||
+		 header.layout.attributeCount > VertexLayout::MaxAttributes || header.lodCount > simplify::MaxLodCount )
+	{
+		return false;
+	}
+
+	if ( header.optionsHash != optionsHash || header.fileSize != fileSize )
+	{
+		return false;
+	}
+
+	if ( header.vertexOffset % Alignment != 0 || header.indexOffset % Alignment != 0 ||
+		 header.meshletOffset % Alignment != 0 )
+	{
+		return false;
+	}
+
+	// Counts are checked against the file size before multiplying, so corrupt values cannot overflow
+	const uint64_t stride{ header.layout.stride };
+	if ( header.vertexCount > fileSize / stride || header.indexCount > fileSize / header.indexSize ||
+		 header.meshletCount > fileSize / sizeof( meshlet::Meshlet ) )
+	{
+		return false;
+	}
+
+	const uint64_t vertexEnd{ header.vertexOffset + header.vertexCount * stride };
+	const uint64_t indexEnd{ header.indexOffset + header.indexCount * header.indexSize };
+	const uint64_t meshletEnd{ header.meshletOffset + header.meshletCount * sizeof( meshlet::Meshlet ) };
+	return header.vertexOffset >= sizeof( Header ) && vertexEnd <= header.indexOffset &&
+		   indexEnd <= header.meshletOffset && meshletEnd <= fileSize;
+}
+
+// Meshlets and LOD levels are drawn as index ranges, so a corrupt one must not point past the index buffer
+bool IsValidMeshlets( std::span<const meshlet::Meshlet> meshlets, uint64_t indexCount )
+{
+	return std::all_of( meshlets.begin(), meshlets.end(), [&]( const meshlet::Meshlet& meshlet ) {
+		return meshlet.firstIndex + uint64_t{ meshlet.triangleCount } * 3 <= indexCount;
+	} );
+}
+
+bool IsValidLods( std::span<const LodLevel> lods, uint64_t indexCount )
+{
+	return std::all_of( lods.begin(), lods.end(), [&]( const LodLevel& lod ) {
+		return lod.firstIndex + uint64_t{ lod.indexCount } <= indexCount;
+	} );
+}
+
+std::vector<uint16_t> NarrowIndices( std::span<const uint32_t> indices )
+{
+	std::vector<uint16_t> result( indices.size() );
+	std::transform(
+		indices.begin(), indices.end(), result.begin(), []( uint32_t index ) { return static_cast<uint16_t>( index ); } );
+	return result;
+}
+
+// Runs the stages that only need the index width, so both widths share them
+template <IndexType Index>
+MeshData Cook( std::vector<Vertex>&& vertices, std::vector<Index>&& indices, const CookOptions& options )
+{
+	OptimizeResult optimized{ Optimize( vertices, indices, options ) };
+
+	MeshData mesh{};
+	if ( options.packVertices )
+	{
+		const BoundingBox bounds{ BoundingBox::Create( vertices ) };
+		const VertexLayout layout{ packing::ChoosePackedLayout( vertices, options.halfPositions ) };
+		mesh = MeshData{ packing::Pack( vertices, layout ), layout, std::move( indices ), bounds };
+	}
+	else
+	{
+		mesh = MeshData{ std::move( vertices ), std::move( indices ) };
+	}
+	mesh.SetMeshlets( std::move( optimized.meshlets ) );
+	mesh.SetLods( std::move( optimized.lods ) );
+	return mesh;
+}
+
+// Maps a cooked file and fills in its header, returns nothing when it is missing, malformed or cooked with other options
+std::optional<MeshData> Map( const std::string& cachePath, uint64_t optionsHash, Header& header )
+{
+	MappedFile file{};
+	try
+	{
+		file = MappedFile( cachePath );
+	}
+	catch ( const error::file::FileError& )
+	{
+		return std::nullopt;
+	}
+
+	if ( file.GetSize() < sizeof( Header ) )
+	{
+		return std::nullopt;
+	}
+
+	std::memcpy( &header, file.GetData(), sizeof( Header ) );
+	if ( !IsValidHeader( header, file.GetSize(), optionsHash ) )
+	{
+		return std::nullopt;
+	}
+
+	// The mapping is page-aligned and the sections are 16-byte aligned, so the blobs can be used in place
+	const std::byte* pVertices{ reinterpret_cast<const std::byte*>( file.GetData() + header.vertexOffset ) };
+	const std::byte* pIndices{ reinterpret_cast<const std::byte*>( file.GetData() + header.indexOffset ) };
+	const std::span<const meshlet::Meshlet> meshlets{
+		reinterpret_cast<const meshlet::Meshlet*>( file.GetData() + header.meshletOffset ),
+		static_cast<size_t>( header.meshletCount ) };
+	const std::span<const LodLevel> lods{ header.lods, header.lodCount };
+	if ( !IsValidMeshlets( meshlets, header.indexCount ) || !IsValidLods( lods, header.indexCount ) )
+	{
+		return std::nullopt;
+	}
+
+	BoundingBox bounds{};
+	bounds.min = { header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+	bounds.max = { header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+
+	MeshData mesh{ std::move( file ),
+				   { pVertices, static_cast<size_t>( header.vertexCount * header.layout.stride ) },
+				   header.layout,
+				   { pIndices, static_cast<size_t>( header.indexCount * header.indexSize ) },
+				   header.indexSize,
+				   meshlets,
+				   bounds };
+	mesh.SetLods( { lods.begin(), lods.end() } );
+	return mesh;
+}
+} // namespace
+
+std::string GetCachePath( const std::string& sourcePath )
+{
+	return std::filesystem::path{ sourcePath }.replace_extension( ".mesh" ).string();
+}
+
+uint64_t HashOptions( const obj::ParseOptions& parseOptions, const CookOptions& cookOptions )
+{
+	uint64_t result{ hash::Combine( hash::DefaultSeed, Version ) };
+	result = hash::Combine( result, PipelineVersion );
+	result = hash::Combine( result, parseOptions.flipAxisAndWinding );
+	result = hash::Combine( result, parseOptions.weldVertices );
+	result = hash::Combine( result, cookOptions.optimizeVertexCache );
+	result = hash::Combine( result, cookOptions.optimizeOverdraw );
+	result = hash::Combine( result, cookOptions.optimizeVertexFetch );
+	result = hash::Combine( result, cookOptions.packVertices );
+	result = hash::Combine( result, cookOptions.halfPositions );
+	result = hash::Combine( result, cookOptions.buildMeshlets );
+	result = hash::Combine( result, cookOptions.buildLods );
+	return result;
+}
+
+SourceInfo ReadSourceInfo( const std::string& sourcePath )
+{
+	std::error_code errorCode{};
+	const uint64_t size{ std::filesystem::file_size( sourcePath, errorCode ) };
+	if ( errorCode )
+	{
+		throw error::file::CouldNotOpenFile();
+	}
+
+	const std::filesystem::file_time_type writeTime{ std::filesystem::last_write_time( sourcePath, errorCode ) };
+	if ( errorCode )
+	{
+		throw error::file::CouldNotOpenFile();
+	}
+
+	SourceInfo source{};
+	source.size = size;
+	source.timestamp = static_cast<int64_t>( writeTime.time_since_epoch().count() );
+	return source;
+}
+
+void Write( const std::string& cachePath, const MeshData& mesh, const SourceInfo& source, uint64_t optionsHash )
+{
+	const std::span<const std::byte> vertices{ mesh.GetVertexData() };
+	const std::span<const std::byte> indices{ mesh.GetIndexData() };
+	const std::span<const meshlet::Meshlet> meshlets{ mesh.GetMeshlets() };
+	const std::span<const LodLevel> lods{ mesh.GetLods() };
+	const BoundingBox& bounds{ mesh.GetBounds() };
+
+	Header header{};
+	header.magic = Magic;
+	header.version = Version;
+	header.headerSize = sizeof( Header );
+	header.indexSize = mesh.GetIndexSize();
+
+	header.sourceSize = source.size;
+	header.sourceTimestamp = source.timestamp;
+	header.sourceHash = source.hash;
+	header.optionsHash = optionsHash;
+
+	header.boundsMin[0] = bounds.min.x;
+	header.boundsMin[1] = bounds.min.y;
+	header.boundsMin[2] = bounds.min.z;
+	header.boundsMax[0] = bounds.max.x;
+	header.boundsMax[1] = bounds.max.y;
+	header.boundsMax[2] = bounds.max.z;
+
+	header.layout = mesh.GetLayout();
+
+	header.vertexCount = mesh.GetVertexCount();
+	header.vertexOffset = AlignUp( sizeof( Header ) );
+	header.indexCount = mesh.GetIndexCount();
+	header.indexOffset = AlignUp( header.vertexOffset + vertices.size_bytes() );
+	header.meshletCount = meshlets.size();
+	header.meshletOffset = AlignUp( header.indexOffset + indices.size_bytes() );
+	header.fileSize = AlignUp( header.meshletOffset + meshlets.size_bytes() );
+
+	if ( lods.size() > simplify::MaxLodCount )
+	{
+		throw error::file::CouldNotWriteFile();
+	}
+	header.lodCount = static_cast<uint32_t>( lods.size() );
+	std::copy( lods.begin(), lods.end(), header.lods );
+
+	const std::string tempPath{ cachePath + ".tmp" };
+	{
+		std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+		if ( !file )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+
+		file.write( reinterpret_cast<const char*>( &header ), sizeof( Header ) );
+		WritePadding( file, sizeof( Header ), header.vertexOffset );
+
+		file.write( reinterpret_cast<const char*>( vertices.data() ),
+					static_cast<std::streamsize>( vertices.size_bytes() ) );
+		WritePadding( file, header.vertexOffset + vertices.size_bytes(), header.indexOffset );
+
+		file.write( reinterpret_cast<const char*>( indices.data() ),
+					static_cast<std::streamsize>( indices.size_bytes() ) );
+		WritePadding( file, header.indexOffset + indices.size_bytes(), header.meshletOffset );
+
+		file.write( reinterpret_cast<const char*>( meshlets.data() ),
+					static_cast<std::streamsize>( meshlets.size_bytes() ) );
+		WritePadding( file, header.meshletOffset + meshlets.size_bytes(), header.fileSize );
+
+		if ( !file )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+	}
+
+	std::error_code errorCode{};
+	std::filesystem::rename( tempPath, cachePath, errorCode );
+	if ( errorCode )
+	{
+		std::filesystem::remove( tempPath, errorCode );
+		throw error::file::CouldNotWriteFile();
+	}
+}
+
+std::optional<MeshData> Open( const std::string& cachePath,
+							  const std::string& sourcePath,
+							  const SourceInfo& source,
+							  uint64_t optionsHash )
+{
+	Header header{};
+	std::optional<MeshData> mesh{ Map( cachePath, optionsHash, header ) };
+	if ( !mesh || header.sourceSize != source.size )
+	{
+		return std::nullopt;
+	}
+
+	// Timestamps change on checkout or copy without the content changing, fall back to comparing hashes
+	if ( header.sourceTimestamp != source.timestamp )
+	{
+		const MappedFile sourceFile{ sourcePath };
+		if ( hash::HashBytes( sourceFile.GetView() ) != header.sourceHash )
+		{
+			return std::nullopt;
+		}
+	}
+
+	return mesh;
+}
+
+std::optional<MeshData> Open( const std::string& cachePath, uint64_t optionsHash )
+{
+	Header header{};
+	return Map( cachePath, optionsHash, header );
+}
+
+template <IndexType Index>
+OptimizeResult Optimize( std::vector<Vertex>& vertices, std::vector<Index>& indices, const CookOptions& options )
+{
+	OptimizeResult result{};
+	if ( options.optimizeVertexCache || options.optimizeOverdraw || options.buildMeshlets )
+	{
+		const optimize::VertexCacheStatistics before{ optimize::AnalyzeVertexCache( indices, vertices.size() ) };
+		if ( options.optimizeVertexCache )
+		{
+			optimize::OptimizeVertexCache( indices, vertices.size() );
+		}
+
+		// Split before the overdraw pass, which would otherwise scatter neighbouring triangles over the whole buffer
+		if ( options.buildMeshlets )
+		{
+			result.meshlets = meshlet::Build( indices, vertices );
+			if ( options.optimizeOverdraw )
+			{
+				meshlet::SortForOverdraw( indices, vertices, result.meshlets );
+			}
+		}
+		else if ( options.optimizeOverdraw )
+		{
+			optimize::OptimizeOverdraw( indices, vertices );
+		}
+		const optimize::VertexCacheStatistics after{ optimize::AnalyzeVertexCache( indices, vertices.size() ) };
+
+		std::cout << "Vertex cache: ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> "
+				  << after.atvr << "\n";
+	}
+
+	// The full-detail level stays first, so the meshlets keep pointing at the right indices
+	if ( options.buildLods )
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+		result.lods = simplify::BuildLodChain( indices, vertices );
+		const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+
+		std::cout << "LODs:";
+		for ( const LodLevel& lod : result.lods )
+		{
+			std::cout << " " << lod.indexCount / 3;
+		}
+		std::cout << " triangles, built in " << elapsed.count() << " ms\n";
+	}
+
+	// Last, every earlier pass changes the order vertices are first used in
+	if ( options.optimizeVertexFetch )
+	{
+		const optimize::VertexFetchStatistics before{
+			optimize::AnalyzeVertexFetch( indices, vertices.size(), sizeof( Vertex ) ) };
+		optimize::OptimizeVertexFetch( indices, vertices );
+		const optimize::VertexFetchStatistics after{
+			optimize::AnalyzeVertexFetch( indices, vertices.size(), sizeof( Vertex ) ) };
+
+		std::cout << "Vertex fetch: " << before.linesPerTriangle << " -> " << after.linesPerTriangle
+				  << " cache lines per triangle, overfetch " << before.overfetch << " -> " << after.overfetch << "\n";
+	}
+
+	return result;
+}
+
+template OptimizeResult Optimize( std::vector<Vertex>&, std::vector<uint16_t>&, const CookOptions& );
+template OptimizeResult Optimize( std::vector<Vertex>&, std::vector<uint32_t>&, const CookOptions& );
+
+MeshData CookOBJ( std::string_view source, const obj::ParseOptions& parseOptions, const CookOptions& cookOptions )
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	if ( !obj::Parse( source, vertices, indices, parseOptions ) )
+	{
+		throw error::file::ParseFail();
+	}
+
+	// Every pass keeps the vertex count or lowers it, so the width can be picked up front
+	if ( vertices.size() <= MaxShortIndexVertexCount )
+	{
+		return Cook( std::move( vertices ), NarrowIndices( indices ), cookOptions );
+	}
+	return Cook( std::move( vertices ), std::move( indices ), cookOptions );
+}
+
+MeshData LoadOBJ( const std::string& sourcePath, const obj::ParseOptions& parseOptions, const CookOptions& cookOptions )
+{
+	const auto start{ std::chrono::steady_clock::now() };
+
+	const std::string cachePath{ GetCachePath( sourcePath ) };
+	const uint64_t optionsHash{ HashOptions( parseOptions, cookOptions ) };
+	SourceInfo source{ ReadSourceInfo( sourcePath ) };
+
+	std::optional<MeshData> mesh{ Open( cachePath, sourcePath, source, optionsHash ) };
+	if ( !mesh )
+	{
+		const MappedFile sourceFile{ sourcePath };
+		mesh.emplace( CookOBJ( sourceFile.GetView(), parseOptions, cookOptions ) );
+		source.hash = hash::HashBytes( sourceFile.GetView() );
+
+		// A missing cache only costs load time on the next run, so a failed write is reported but not fatal
+		error::utils::HandleThrowingFunction( [&]() { Write( cachePath, *mesh, source, optionsHash ); } );
+	}
+
+	const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+	std::cout << "Loaded " << sourcePath << ( mesh->IsMapped() ? " from cache" : "" ) << " in " << elapsed.count()
+			  << " ms (" << mesh->GetVertexCount() << " vertices of " << mesh->GetLayout().stride << " bytes, "
+			  << mesh->GetIndexCount() << " indices of " << mesh->GetIndexSize() << " bytes, "
+			  << mesh->GetMeshlets().size() << " meshlets, " << mesh->GetLods().size() << " LODs)\n";
+
+	return std::move( *mesh );
+}
+} // namespace cooked
+} // namespace dae
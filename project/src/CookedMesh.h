@@ -0,0 +1,136 @@
+#ifndef COOKEDMESH_H
+#define COOKEDMESH_H
+
+// Binary cache of parsed meshes, written next to the source on first load and mapped on later runs
+// File layout, every section starts on a 16-byte boundary:
+//	[Header][vertex blob][index blob][meshlets]
+// LOD levels are ranges of the index blob and small enough to live in the header
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MeshData.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "VertexLayout.h"
+
+namespace dae
+{
+namespace cooked
+{
+constexpr uint32_t Magic{ 0x4D454144 }; // "DAEM"
+constexpr uint32_t Version{ 4 };
+constexpr uint64_t Alignment{ 16 };
+
+// Bumped whenever a processing stage changes what gets cooked from the same source and options
+constexpr uint32_t PipelineVersion{ 9 };
+
+// Meshes with at most this many vertices are cooked with 16-bit indices
+constexpr size_t MaxShortIndexVertexCount{ 65536 };
+
+// Processing stages run after parsing
+struct CookOptions
+{
+	// Both reorder triangles, keep them off for blended meshes where the draw order is visible
+	bool optimizeVertexCache{ true };
+	bool optimizeOverdraw{ true };
+
+	// Only renumbers vertices, safe for every mesh
+	bool optimizeVertexFetch{ true };
+
+	// Stores VertexLayout::CreatePacked vertices instead of the Vertex struct
+	bool packVertices{ false };
+	bool halfPositions{ false };
+
+	// Splits the final index buffer into meshlet::Meshlet runs for CPU culling
+	bool buildMeshlets{ true };
+
+	// Appends simplified copies of the index buffer that share its vertices, meshlets only cover the first level
+	bool buildLods{ true };
+};
+
+// What the optimization stages produce besides the reordered buffers
+struct OptimizeResult
+{
+	std::vector<meshlet::Meshlet> meshlets{};
+	std::vector<LodLevel> lods{};
+};
+
+// Identifies the source asset a cooked file was built from
+struct SourceInfo
+{
+	uint64_t size{};
+	int64_t timestamp{};
+	uint64_t hash{}; // only computed when the size or timestamp no longer match
+};
+
+struct alignas( 16 ) Header
+{
+	uint32_t magic{};
+	uint32_t version{};
+	uint32_t headerSize{};
+	uint32_t indexSize{};
+
+	uint64_t sourceSize{};
+	int64_t sourceTimestamp{};
+	uint64_t sourceHash{};
+	uint64_t optionsHash{};
+
+	float boundsMin[4]{};
+	float boundsMax[4]{};
+
+	VertexLayout layout{};
+
+	uint64_t vertexCount{};
+	uint64_t vertexOffset{};
+	uint64_t indexCount{};
+	uint64_t indexOffset{};
+	uint64_t meshletCount{};
+	uint64_t meshletOffset{};
+	uint64_t fileSize{};
+
+	uint32_t lodCount{};
+	uint32_t padding[3]{};
+	LodLevel lods[simplify::MaxLodCount]{};
+};
+static_assert( sizeof( Header ) % Alignment == 0 );
+
+// Cooked file path for a source asset
+std::string GetCachePath( const std::string& sourcePath );
+
+// Hash of everything besides the source that changes the cooked output
+uint64_t HashOptions( const obj::ParseOptions& parseOptions, const CookOptions& cookOptions );
+
+// Throws error::file::CouldNotOpenFile when the source does not exist
+SourceInfo ReadSourceInfo( const std::string& sourcePath );
+
+// Writes to a temporary file first, so an interrupted write never leaves a truncated cache behind
+void Write( const std::string& cachePath, const MeshData& mesh, const SourceInfo& source, uint64_t optionsHash );
+
+// Maps a cooked file, returns nothing when it is missing, malformed or stale
+std::optional<MeshData> Open( const std::string& cachePath,
+							  const std::string& sourcePath,
+							  const SourceInfo& source,
+							  uint64_t optionsHash );
+
+// Same without looking at the source, for files the asset cooker vouches for
+std::optional<MeshData> Open( const std::string& cachePath, uint64_t optionsHash );
+
+// Runs the optimization stages over freshly parsed geometry and reports their effect
+// Returns the meshlets when CookOptions::buildMeshlets is set, the overdraw pass then sorts whole meshlets
+// Returns the LOD levels when CookOptions::buildLods is set, indices then holds every level one after the other
+template <IndexType Index>
+OptimizeResult Optimize( std::vector<Vertex>& vertices, std::vector<Index>& indices, const CookOptions& options );
+
+// Parses and optimizes an OBJ held in memory
+// Throws error::file::ParseFail when it references attributes that don't exist
+MeshData CookOBJ( std::string_view source, const obj::ParseOptions& parseOptions, const CookOptions& cookOptions );
+
+// Loads from the cache when it is up to date, otherwise parses and optimizes the OBJ and (re)writes the cache
+MeshData LoadOBJ( const std::string& sourcePath,
+				  const obj::ParseOptions& parseOptions,
+				  const CookOptions& cookOptions = {} );
+} // namespace cooked
+} // namespace dae
+#endif
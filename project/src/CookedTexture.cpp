@@ -0,0 +1,284 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <SDL_image.h>
+#include <SDL_surface.h>
+#include "CookedTexture.h"
+#include "Error.h"
+#include "Hash.h"
+#include "PixelConverter.h"
+#include "PngDecoder.h"
+#include "TextureContainer.h"
+
+namespace dae
+{
+namespace cooked
+{
+namespace texture
+{
+namespace
+{
+uint64_t AlignUp( uint64_t value )
+{
+	return ( value + Alignment - 1 ) & ~( Alignment - 1 );
+}
+
+// Without an options hash, any options are accepted
+bool IsValidHeader( const Header& header, uint64_t fileSize, std::optional<uint64_t> optionsHash )
+{
+	if ( header.magic != Magic || header.version != Version || header.headerSize != sizeof( Header ) )
+	{
+		return false;
+	}
+
+	if ( ( optionsHash && header.optionsHash != *optionsHash ) || header.fileSize != fileSize ||
+		 header.pixelOffset % Alignment != 0 )
+	{
+		return false;
+	}
+
+	if ( header.format >= static_cast<uint32_t>( TextureData::Format::count ) )
+	{
+		return false;
+	}
+
+	// Checked against the file size before multiplying, so corrupt values cannot overflow
+	const TextureData::Format format{ static_cast<TextureData::Format>( header.format ) };
+	const bool isCompressed{ TextureData::IsCompressed( format ) };
+	const uint64_t rowPitch{ isCompressed ? ( uint64_t{ header.width } + TextureData::BlockSize - 1 ) /
+												TextureData::BlockSize * TextureData::GetBlockBytes( format )
+										  : uint64_t{ header.width } * TextureData::GetTexelBytes( format ) };
+	const uint64_t rowCount{ isCompressed
+								 ? ( uint64_t{ header.height } + TextureData::BlockSize - 1 ) / TextureData::BlockSize
+								 : header.height };
+	if ( header.width == 0 || header.height == 0 || rowCount > fileSize / rowPitch )
+	{
+		return false;
+	}
+
+	if ( header.levelCount == 0 || header.levelCount > TextureData::GetFullLevelCount( header.width, header.height ) )
+	{
+		return false;
+	}
+
+	return header.pixelSize == TextureData::GetByteSize( header.width, header.height, header.levelCount, format ) &&
+		   header.pixelOffset >= sizeof( Header ) && header.pixelOffset + header.pixelSize <= fileSize;
+}
+
+std::optional<TextureData> Map( const std::string& cachePath, std::optional<uint64_t> optionsHash )
+{
+	MappedFile file{};
+	try
+	{
+		file = MappedFile( cachePath );
+	}
+	catch ( const error::file::FileError& )
+	{
+		return std::nullopt;
+	}
+
+	if ( file.GetSize() < sizeof( Header ) )
+	{
+		return std::nullopt;
+	}
+
+	Header header{};
+	std::memcpy( &header, file.GetData(), sizeof( Header ) );
+	if ( !IsValidHeader( header, file.GetSize(), optionsHash ) )
+	{
+		return std::nullopt;
+	}
+
+	const std::span<const std::byte> pixels{ reinterpret_cast<const std::byte*>( file.GetData() + header.pixelOffset ),
+											 static_cast<size_t>( header.pixelSize ) };
+	return TextureData{ std::move( file ),
+						header.width,
+						header.height,
+						header.levelCount,
+						pixels,
+						static_cast<TextureData::Format>( header.format ) };
+}
+} // namespace
+
+std::string GetCachePath( const std::string& sourcePath )
+{
+	return std::filesystem::path{ sourcePath }.replace_extension( ".tex" ).string();
+}
+
+std::string GetPackedSourcePath( const std::string& colorPath, const std::string& alphaPath )
+{
+	return colorPath + '+' + alphaPath;
+}
+
+uint64_t HashOptions( const Options& options )
+{
+	uint64_t result{ hash::Combine( hash::DefaultSeed, Version ) };
+	result = hash::Combine( result, PipelineVersion );
+	result = hash::Combine( result, static_cast<uint64_t>( options.mip.content ) );
+	result = hash::Combine( result, static_cast<uint64_t>( options.mip.filter ) );
+	result = hash::Combine( result, static_cast<uint64_t>( options.format ) );
+	result = hash::Combine( result, static_cast<uint64_t>( options.quality ) );
+	return result;
+}
+
+TextureData Decode( std::string_view bytes )
+{
+	// PNGs skip SDL_image and its surfaces, the pixels are decoded where the texture keeps them
+	if ( const std::optional<png::Info> info{ png::ReadInfo( bytes ) } )
+	{
+		const size_t rowPitch{ size_t{ info->width } * TextureData::BytesPerPixel };
+		std::vector<std::byte> pixels( rowPitch * info->height );
+		png::Decode( bytes, pixels, rowPitch );
+		return TextureData{ info->width, info->height, 1, std::move( pixels ) };
+	}
+	return DecodeWithSdl( bytes );
+}
+
+TextureData DecodeWithSdl( std::string_view bytes )
+{
+	SDL_RWops* pStream{ SDL_RWFromConstMem( bytes.data(), static_cast<int>( bytes.size() ) ) };
+	SDL_Surface* pSurface{ pStream ? IMG_Load_RW( pStream, 1 ) : nullptr };
+	if ( !pSurface )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	// PNGs without alpha or with a palette come back in other formats
+	SDL_Surface* pConverted{ SDL_ConvertSurfaceFormat( pSurface, SDL_PIXELFORMAT_RGBA32, 0 ) };
+	SDL_FreeSurface( pSurface );
+	if ( !pConverted )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	const uint32_t width{ static_cast<uint32_t>( pConverted->w ) };
+	const uint32_t height{ static_cast<uint32_t>( pConverted->h ) };
+	const size_t rowPitch{ size_t{ width } * TextureData::BytesPerPixel };
+
+	// Surface rows can be padded, cooked rows are not
+	std::vector<std::byte> pixels( rowPitch * height );
+	const std::byte* pSource{ static_cast<const std::byte*>( pConverted->pixels ) };
+	for ( uint32_t y{}; y < height; ++y )
+	{
+		std::memcpy( pixels.data() + y * rowPitch, pSource + size_t{ y } * pConverted->pitch, rowPitch );
+	}
+	SDL_FreeSurface( pConverted );
+
+	return TextureData{ width, height, 1, std::move( pixels ) };
+}
+
+TextureData Decode( const std::string& sourcePath )
+{
+	const MappedFile file{ sourcePath };
+	return Decode( file.GetView() );
+}
+
+TextureData DecodePacked( std::string_view colorBytes, std::string_view alphaBytes )
+{
+	const TextureData color{ Decode( colorBytes ) };
+	const TextureData alpha{ Decode( alphaBytes ) };
+	if ( color.GetWidth() != alpha.GetWidth() || color.GetHeight() != alpha.GetHeight() )
+	{
+		throw error::texture::DecodeFail();
+	}
+	return pixel::PackAlpha( color, alpha );
+}
+
+void Write( const std::string& cachePath, const TextureData& texture, const SourceInfo& source, uint64_t optionsHash )
+{
+	Header header{};
+	header.magic = Magic;
+	header.version = Version;
+	header.headerSize = sizeof( Header );
+	header.levelCount = texture.GetLevelCount();
+
+	header.sourceSize = source.size;
+	header.sourceTimestamp = source.timestamp;
+	header.sourceHash = source.hash;
+	header.optionsHash = optionsHash;
+
+	header.width = texture.GetWidth();
+	header.height = texture.GetHeight();
+	header.format = static_cast<uint32_t>( texture.GetFormat() );
+	header.pixelOffset = AlignUp( sizeof( Header ) );
+	header.pixelSize = TextureData::GetByteSize( header.width, header.height, header.levelCount, texture.GetFormat() );
+	header.fileSize = AlignUp( header.pixelOffset + header.pixelSize );
+
+	const std::string tempPath{ cachePath + ".tmp" };
+	{
+		std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+		if ( !file )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+
+		constexpr char zeroes[Alignment]{};
+		file.write( reinterpret_cast<const char*>( &header ), sizeof( Header ) );
+		file.write( zeroes, static_cast<std::streamsize>( header.pixelOffset - sizeof( Header ) ) );
+		for ( uint32_t levelIdx{}; levelIdx < header.levelCount; ++levelIdx )
+		{
+			const std::span<const std::byte> pixels{ texture.GetLevel( levelIdx ).pixels };
+			file.write( reinterpret_cast<const char*>( pixels.data() ),
+						static_cast<std::streamsize>( pixels.size_bytes() ) );
+		}
+		file.write( zeroes, static_cast<std::streamsize>( header.fileSize - header.pixelOffset - header.pixelSize ) );
+
+		if ( !file )
+		{
+			throw error::file::CouldNotWriteFile();
+		}
+	}
+
+	std::error_code errorCode{};
+	std::filesystem::rename( tempPath, cachePath, errorCode );
+	if ( errorCode )
+	{
+		std::filesystem::remove( tempPath, errorCode );
+		throw error::file::CouldNotWriteFile();
+	}
+}
+
+std::optional<TextureData> Open( const std::string& cachePath, uint64_t optionsHash )
+{
+	return Map( cachePath, optionsHash );
+}
+
+TextureData Load( const std::string& path, const Options& options )
+{
+	std::optional<TextureData> texture{};
+	if ( std::filesystem::path{ path }.extension() == ".tex" )
+	{
+		texture = Map( path, std::nullopt );
+	}
+	else if ( container::IsContainer( path ) )
+	{
+		texture = container::Open( path );
+	}
+	else
+	{
+		// One that can't be used is skipped, the source is still there
+		const std::optional<std::string> containerPath{ container::FindNextTo( path ) };
+		texture = containerPath ? container::Open( *containerPath ) : std::nullopt;
+		if ( !texture )
+		{
+			return bc::Compress( mip::Generate( Decode( path ), options.mip ), options.format, options.quality );
+		}
+	}
+
+	if ( !texture )
+	{
+		throw error::texture::DecodeFail();
+	}
+	return std::move( *texture );
+}
+
+TextureData LoadPacked( const std::string& colorPath, const std::string& alphaPath, const Options& options )
+{
+	const MappedFile colorFile{ colorPath };
+	const MappedFile alphaFile{ alphaPath };
+	const TextureData texture{ DecodePacked( colorFile.GetView(), alphaFile.GetView() ) };
+	return bc::Compress( mip::Generate( texture, options.mip ), options.format, options.quality );
+}
+} // namespace texture
+} // namespace cooked
+} // namespace dae
@@ -0,0 +1,96 @@
+#ifndef COOKEDTEXTURE_H
+#define COOKEDTEXTURE_H
+
+// Cooked textures, decoded offline so loading is a mapping and an upload
+// File layout, the pixels start on a 16-byte boundary and hold every mip level, largest first, in the header's format:
+//	[Header][pixels]
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "BlockCompressor.h"
+#include "CookedMesh.h"
+#include "MipGenerator.h"
+#include "TextureData.h"
+
+namespace dae
+{
+namespace cooked
+{
+namespace texture
+{
+constexpr uint32_t Magic{ 0x54454144 }; // "DAET"
+constexpr uint32_t Version{ 3 };
+
+// Bumped whenever decoding or processing changes what gets cooked from the same source
+constexpr uint32_t PipelineVersion{ 3 };
+
+struct alignas( 16 ) Header
+{
+	uint32_t magic{};
+	uint32_t version{};
+	uint32_t headerSize{};
+	uint32_t levelCount{};
+
+	uint64_t sourceSize{};
+	int64_t sourceTimestamp{};
+	uint64_t sourceHash{};
+	uint64_t optionsHash{};
+
+	uint32_t width{};
+	uint32_t height{};
+	uint32_t format{}; // TextureData::Format
+	uint32_t padding{};
+	uint64_t pixelOffset{};
+	uint64_t pixelSize{};
+	uint64_t fileSize{};
+};
+static_assert( sizeof( Header ) % Alignment == 0 );
+
+// How a source image is turned into what gets uploaded
+struct Options
+{
+	mip::Options mip{};
+	TextureData::Format format{ TextureData::Format::rgba8 };
+	bc::Quality quality{ bc::Quality::normal }; // only used by the block-compressed formats
+};
+
+// Cooked file path for a source image
+std::string GetCachePath( const std::string& sourcePath );
+
+// Name of a map packed from two sources in resources/cook.txt, the manifest and the cache, both paths joined by a '+'
+std::string GetPackedSourcePath( const std::string& colorPath, const std::string& alphaPath );
+
+uint64_t HashOptions( const Options& options );
+
+// Decodes any format SDL_image reads into 8-bit RGBA, PNGs through png::Decode unless they need SDL_image
+// Throws error::texture::DecodeFail when the bytes aren't an image it understands
+TextureData Decode( std::string_view bytes );
+TextureData Decode( const std::string& sourcePath );
+
+// Always through SDL_image, what png::Decode is checked against
+TextureData DecodeWithSdl( std::string_view bytes );
+
+// The color image's rgb with the first channel of the alpha image as alpha, like specular with gloss
+// Throws error::texture::DecodeFail when either isn't an image or their sizes differ
+TextureData DecodePacked( std::string_view colorBytes, std::string_view alphaBytes );
+
+// Writes to a temporary file first, so an interrupted write never leaves a truncated file behind
+void Write( const std::string& cachePath, const TextureData& texture, const SourceInfo& source, uint64_t optionsHash );
+
+// Maps a cooked file, returns nothing when it is missing or malformed or was cooked with other options
+std::optional<TextureData> Open( const std::string& cachePath, uint64_t optionsHash );
+
+// Maps .tex files the asset cooker wrote, they keep the options resources/cook.txt gave them, and DDS or KTX2 files,
+// which keep whatever they hold; a container next to any other image is mapped in its place
+// Other images are decoded, get their mip chain built and are compressed with options
+// Throws error::texture::DecodeFail on failure
+TextureData Load( const std::string& path, const Options& options = {} );
+
+// Packs both sources before building the mip chain, for data content that is the same as packing both their chains
+// Throws error::texture::DecodeFail on failure
+TextureData LoadPacked( const std::string& colorPath, const std::string& alphaPath, const Options& options = {} );
+} // namespace texture
+} // namespace cooked
+} // namespace dae
+#endif
@@ -1,14 +1,93 @@
 #include <sstream>
-#include <array>
+#include <vector>
+#include <d3dcompiler.h>
 #include <d3dx11effect.h>
 #include "Effect.h"
 #include "Error.h"
 
 using namespace dae;
 
-Effect::Effect( ID3D11Device* pDevice, const std::wstring& assetFile )
+namespace
 {
-	m_pEffect = Effect::LoadEffect( pDevice, assetFile );
+// Packed vertices need the technique whose vertex shader decodes them
+const char* GetTechniqueName( const VertexLayout& layout )
+{
+	return layout.IsPacked() ? "PackedTechnique" : "DefaultTechnique";
+}
+
+// The same vertex shaders with the pixel shader that reads a material map
+const char* GetMaterialMapTechniqueName( const VertexLayout& layout )
+{
+	return layout.IsPacked() ? "PackedMaterialMapTechnique" : "MaterialMapTechnique";
+}
+
+std::vector<D3D11_INPUT_ELEMENT_DESC> CreateInputElements( const VertexLayout& layout )
+{
+	std::vector<D3D11_INPUT_ELEMENT_DESC> elements( layout.attributeCount );
+	for ( uint32_t attributeIdx{}; attributeIdx < layout.attributeCount; ++attributeIdx )
+	{
+		const VertexAttribute& attribute{ layout.attributes[attributeIdx] };
+		D3D11_INPUT_ELEMENT_DESC& element{ elements[attributeIdx] };
+
+		switch ( attribute.semantic )
+		{
+		case VertexSemantic::position:
+			element.SemanticName = "POSITION";
+			break;
+		case VertexSemantic::color:
+			element.SemanticName = "COLOR";
+			break;
+		case VertexSemantic::texcoord:
+			element.SemanticName = "TEXCOORD";
+			break;
+		case VertexSemantic::normal:
+		case VertexSemantic::normalTangent:
+			element.SemanticName = "NORMAL";
+			break;
+		case VertexSemantic::tangent:
+			element.SemanticName = "TANGENT";
+			break;
+		}
+
+		switch ( attribute.format )
+		{
+		case VertexAttributeFormat::float2:
+			element.Format = DXGI_FORMAT_R32G32_FLOAT;
+			break;
+		case VertexAttributeFormat::float3:
+			element.Format = DXGI_FORMAT_R32G32B32_FLOAT;
+			break;
+		case VertexAttributeFormat::float4:
+			element.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+			break;
+		case VertexAttributeFormat::half2:
+			element.Format = DXGI_FORMAT_R16G16_FLOAT;
+			break;
+		case VertexAttributeFormat::half4:
+			element.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			break;
+		case VertexAttributeFormat::unorm16x2:
+			element.Format = DXGI_FORMAT_R16G16_UNORM;
+			break;
+		case VertexAttributeFormat::snorm8x4:
+			element.Format = DXGI_FORMAT_R8G8B8A8_SNORM;
+			break;
+		}
+
+		element.AlignedByteOffset = attribute.offset;
+		element.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	}
+	return elements;
+}
+} // namespace
+
+Effect::Effect( ID3D11Device* pDevice,
+				std::span<const std::byte> bytecode,
+				const VertexLayout& layout,
+				const SamplerSet& samplers )
+	: m_Samplers( samplers )
+{
+	m_pEffect = Effect::CreateEffect( pDevice, bytecode );
 
 	if ( !m_pEffect )
 	{
@@ -20,49 +99,30 @@ Effect::Effect( ID3D11Device* pDevice, const std::wstring& assetFile )
 		throw error::effect::InvalidEffect();
 	}
 
-	m_pTechnique = m_pEffect->GetTechniqueByName( "DefaultTechnique" );
+	m_pTechnique = m_pEffect->GetTechniqueByName( GetTechniqueName( layout ) );
 
 	if ( !m_pTechnique->IsValid() )
 	{
 		throw error::effect::InvalidTechnique();
 	}
 
+	m_pMaterialMapTechnique = m_pEffect->GetTechniqueByName( GetMaterialMapTechniqueName( layout ) );
+
+	if ( !m_pMaterialMapTechnique->IsValid() )
+	{
+		throw error::effect::InvalidTechnique();
+	}
+
 	// Create Vertex Layout
-	constexpr int elementCount{ 5 };
-	std::array<D3D11_INPUT_ELEMENT_DESC, elementCount> vertexDesc{};
-
-	vertexDesc[0].SemanticName = "POSITION";
-	vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[0].AlignedByteOffset = 0;
-	vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[1].SemanticName = "COLOR";
-	vertexDesc[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[1].AlignedByteOffset = 12;
-	vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[2].SemanticName = "TEXCOORD";
-	vertexDesc[2].Format = DXGI_FORMAT_R32G32_FLOAT;
-	vertexDesc[2].AlignedByteOffset = 24;
-	vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[3].SemanticName = "NORMAL";
-	vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[3].AlignedByteOffset = 32;
-	vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[4].SemanticName = "TANGENT";
-	vertexDesc[4].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[4].AlignedByteOffset = 44;
-	vertexDesc[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	const std::vector<D3D11_INPUT_ELEMENT_DESC> vertexDesc{ CreateInputElements( layout ) };
 	//
 
-	// Create Input Layout
+	// Create Input Layout, both techniques share the vertex shader and so the input signature
 	D3DX11_PASS_DESC passDesc{};
 	m_pTechnique->GetPassByIndex( 0 )->GetDesc( &passDesc );
 
 	HRESULT result{ pDevice->CreateInputLayout( vertexDesc.data(),
-												vertexDesc.size(),
+												static_cast<UINT>( vertexDesc.size() ),
 												passDesc.pIAInputSignature,
 												passDesc.IAInputSignatureSize,
 												&m_pInputLayout ) };
@@ -114,10 +174,18 @@ Effect::Effect( ID3D11Device* pDevice, const std::wstring& assetFile )
 	{
 		throw error::effect::InvalidMap();
 	}
-	//
 
-	// Create the sampler state
-	m_Sampler = Sampler( pDevice, m_pEffect );
+	m_pMaterialMap = m_pEffect->GetVariableByName( "gMaterialMap" )->AsShaderResource();
+	if ( !m_pMaterialMap->IsValid() )
+	{
+		throw error::effect::InvalidMap();
+	}
+
+	m_pSampler = m_pEffect->GetVariableByName( "gSampler" )->AsSampler();
+	if ( !m_pSampler->IsValid() )
+	{
+		throw error::effect::InvalidSampler();
+	}
 	//
 }
 
@@ -134,14 +202,19 @@ Effect::Effect( Effect&& rhs )
 
 	m_pInputLayout = rhs.m_pInputLayout;
 	rhs.m_pInputLayout = nullptr;
+	//
 
-	m_Sampler = std::move( rhs.m_Sampler );
+	// SHARED
+	m_Samplers = std::move( rhs.m_Samplers );
 	//
 
 	// NON-OWNING
 	m_pTechnique = rhs.m_pTechnique;
 	rhs.m_pTechnique = nullptr;
 
+	m_pMaterialMapTechnique = rhs.m_pMaterialMapTechnique;
+	rhs.m_pMaterialMapTechnique = nullptr;
+
 	m_pWorldViewProjection = rhs.m_pWorldViewProjection;
 	rhs.m_pWorldViewProjection = nullptr;
 
@@ -162,6 +235,12 @@ Effect::Effect( Effect&& rhs )
 
 	m_pGlossMap = rhs.m_pGlossMap;
 	rhs.m_pSpecularMap = nullptr;
+
+	m_pMaterialMap = rhs.m_pMaterialMap;
+	rhs.m_pMaterialMap = nullptr;
+
+	m_pSampler = rhs.m_pSampler;
+	rhs.m_pSampler = nullptr;
 	//
 }
 
@@ -178,14 +257,19 @@ Effect& Effect::operator=( Effect&& rhs )
 
 	m_pInputLayout = rhs.m_pInputLayout;
 	rhs.m_pInputLayout = nullptr;
+	//
 
-	m_Sampler = std::move( rhs.m_Sampler );
+	// SHARED
+	m_Samplers = std::move( rhs.m_Samplers );
 	//
 
 	// NON-OWNING
 	m_pTechnique = rhs.m_pTechnique;
 	rhs.m_pTechnique = nullptr;
 
+	m_pMaterialMapTechnique = rhs.m_pMaterialMapTechnique;
+	rhs.m_pMaterialMapTechnique = nullptr;
+
 	m_pWorldViewProjection = rhs.m_pWorldViewProjection;
 	rhs.m_pWorldViewProjection = nullptr;
 
@@ -206,6 +290,12 @@ Effect& Effect::operator=( Effect&& rhs )
 
 	m_pGlossMap = rhs.m_pGlossMap;
 	rhs.m_pSpecularMap = nullptr;
+
+	m_pMaterialMap = rhs.m_pMaterialMap;
+	rhs.m_pMaterialMap = nullptr;
+
+	m_pSampler = rhs.m_pSampler;
+	rhs.m_pSampler = nullptr;
 	//
 
 	return *this;
@@ -229,11 +319,6 @@ ID3DX11Effect* Effect::operator->()
 	return m_pEffect;
 }
 
-void Effect::CycleFilteringMode()
-{
-	m_Sampler.Cycle();
-}
-
 void Effect::SetWorldViewProjection( const Matrix& wvp )
 {
 	m_pWorldViewProjection->SetMatrix( reinterpret_cast<const float*>( &wvp ) );
@@ -270,9 +355,19 @@ void Effect::SetGlossMap( const Texture& glossMap )
 	m_pGlossMap->SetResource( glossMap.GetSRV() );
 }
 
-ID3DX11EffectTechnique* Effect::GetTechniquePtr() const
+void Effect::SetMaterialMap( const Texture& materialMap )
 {
-	return m_pTechnique;
+	m_pMaterialMap->SetResource( materialMap.GetSRV() );
+}
+
+void Effect::SetFilterMode( Sampler::FilterMode filterMode )
+{
+	m_pSampler->SetSampler( 0, m_Samplers[static_cast<size_t>( filterMode )]->GetState() );
+}
+
+ID3DX11EffectTechnique* Effect::GetTechniquePtr( MaterialLayout materialLayout ) const
+{
+	return materialLayout == MaterialLayout::packed ? m_pMaterialMapTechnique : m_pTechnique;
 }
 
 ID3D11InputLayout* Effect::GetInputLayoutPtr() const
@@ -280,9 +375,13 @@ ID3D11InputLayout* Effect::GetInputLayoutPtr() const
 	return m_pInputLayout;
 }
 
-TransparentEffect::TransparentEffect( ID3D11Device* pDevice, const std::wstring& assetFile )
+TransparentEffect::TransparentEffect( ID3D11Device* pDevice,
+									  std::span<const std::byte> bytecode,
+									  const VertexLayout& layout,
+									  const SamplerSet& samplers )
+	: m_Samplers( samplers )
 {
-	m_pEffect = Effect::LoadEffect( pDevice, assetFile );
+	m_pEffect = Effect::CreateEffect( pDevice, bytecode );
 
 	if ( !m_pEffect )
 	{
@@ -294,7 +393,7 @@ TransparentEffect::TransparentEffect( ID3D11Device* pDevice, const std::wstring&
 		throw error::effect::InvalidEffect();
 	}
 
-	m_pTechnique = m_pEffect->GetTechniqueByName( "DefaultTechnique" );
+	m_pTechnique = m_pEffect->GetTechniqueByName( GetTechniqueName( layout ) );
 
 	if ( !m_pTechnique->IsValid() )
 	{
@@ -302,33 +401,7 @@ TransparentEffect::TransparentEffect( ID3D11Device* pDevice, const std::wstring&
 	}
 
 	// Create Vertex Layout
-	constexpr int elementCount{ 5 };
-	std::array<D3D11_INPUT_ELEMENT_DESC, elementCount> vertexDesc{};
-
-	vertexDesc[0].SemanticName = "POSITION";
-	vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[0].AlignedByteOffset = 0;
-	vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[1].SemanticName = "COLOR";
-	vertexDesc[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[1].AlignedByteOffset = 12;
-	vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[2].SemanticName = "TEXCOORD";
-	vertexDesc[2].Format = DXGI_FORMAT_R32G32_FLOAT;
-	vertexDesc[2].AlignedByteOffset = 24;
-	vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[3].SemanticName = "NORMAL";
-	vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[3].AlignedByteOffset = 32;
-	vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-	vertexDesc[4].SemanticName = "TANGENT";
-	vertexDesc[4].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[4].AlignedByteOffset = 44;
-	vertexDesc[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	const std::vector<D3D11_INPUT_ELEMENT_DESC> vertexDesc{ CreateInputElements( layout ) };
 	//
 
 	// Create Input Layout
@@ -336,7 +409,7 @@ TransparentEffect::TransparentEffect( ID3D11Device* pDevice, const std::wstring&
 	m_pTechnique->GetPassByIndex( 0 )->GetDesc( &passDesc );
 
 	HRESULT result{ pDevice->CreateInputLayout( vertexDesc.data(),
-												vertexDesc.size(),
+												static_cast<UINT>( vertexDesc.size() ),
 												passDesc.pIAInputSignature,
 												passDesc.IAInputSignatureSize,
 												&m_pInputLayout ) };
@@ -358,10 +431,12 @@ TransparentEffect::TransparentEffect( ID3D11Device* pDevice, const std::wstring&
 	{
 		throw error::effect::InvalidMap();
 	}
-	//
 
-	// Create the sampler state
-	m_Sampler = Sampler( pDevice, m_pEffect );
+	m_pSampler = m_pEffect->GetVariableByName( "gSampler" )->AsSampler();
+	if ( !m_pSampler->IsValid() )
+	{
+		throw error::effect::InvalidSampler();
+	}
 	//
 }
 
@@ -378,8 +453,10 @@ TransparentEffect::TransparentEffect( TransparentEffect&& rhs )
 
 	m_pInputLayout = rhs.m_pInputLayout;
 	rhs.m_pInputLayout = nullptr;
+	//
 
-	m_Sampler = std::move( rhs.m_Sampler );
+	// SHARED
+	m_Samplers = std::move( rhs.m_Samplers );
 	//
 
 	// NON-OWNING
@@ -391,6 +468,9 @@ TransparentEffect::TransparentEffect( TransparentEffect&& rhs )
 
 	m_pDiffuseMap = rhs.m_pDiffuseMap;
 	rhs.m_pDiffuseMap = nullptr;
+
+	m_pSampler = rhs.m_pSampler;
+	rhs.m_pSampler = nullptr;
 	//
 }
 
@@ -407,8 +487,10 @@ TransparentEffect& TransparentEffect::operator=( TransparentEffect&& rhs )
 
 	m_pInputLayout = rhs.m_pInputLayout;
 	rhs.m_pInputLayout = nullptr;
+	//
 
-	m_Sampler = std::move( rhs.m_Sampler );
+	// SHARED
+	m_Samplers = std::move( rhs.m_Samplers );
 	//
 
 	// NON-OWNING
@@ -420,6 +502,9 @@ TransparentEffect& TransparentEffect::operator=( TransparentEffect&& rhs )
 
 	m_pDiffuseMap = rhs.m_pDiffuseMap;
 	rhs.m_pDiffuseMap = nullptr;
+
+	m_pSampler = rhs.m_pSampler;
+	rhs.m_pSampler = nullptr;
 	//
 
 	return *this;
@@ -443,11 +528,6 @@ ID3DX11Effect* TransparentEffect::operator->()
 	return m_pEffect;
 }
 
-void TransparentEffect::CycleFilteringMode()
-{
-	m_Sampler.Cycle();
-}
-
 void TransparentEffect::SetWorldViewProjection( const Matrix& wvp )
 {
 	m_pWorldViewProjection->SetMatrix( reinterpret_cast<const float*>( &wvp ) );
@@ -458,6 +538,11 @@ void TransparentEffect::SetDiffuseMap( const Texture& diffuseMap )
 	m_pDiffuseMap->SetResource( diffuseMap.GetSRV() );
 }
 
+void TransparentEffect::SetFilterMode( Sampler::FilterMode filterMode )
+{
+	m_pSampler->SetSampler( 0, m_Samplers[static_cast<size_t>( filterMode )]->GetState() );
+}
+
 ID3DX11EffectTechnique* TransparentEffect::GetTechniquePtr() const
 {
 	return m_pTechnique;
@@ -468,19 +553,20 @@ ID3D11InputLayout* TransparentEffect::GetInputLayoutPtr() const
 	return m_pInputLayout;
 }
 
-ID3DX11Effect* Effect::LoadEffect( ID3D11Device* pDevice, const std::wstring& assetFile )
+std::vector<std::byte> Effect::CompileEffect( const std::wstring& assetFile )
 {
 	HRESULT result{};
+	ID3D10Blob* pBytecodeBlob{};
 	ID3D10Blob* pErrorBlob{};
-	ID3DX11Effect* pEffect{};
 
 	DWORD shaderFlags{};
 #if defined( DEBUG ) || defined( _DEBUG )
 	shaderFlags |= D3DCOMPILE_DEBUG;
 	shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
-	result = D3DX11CompileEffectFromFile(
-		assetFile.c_str(), nullptr, nullptr, shaderFlags, 0, pDevice, &pEffect, &pErrorBlob );
+	// What D3DX11CompileEffectFromFile does before it creates the effect, fx_5_0 is the only profile effects read
+	result = D3DCompileFromFile(
+		assetFile.c_str(), nullptr, nullptr, nullptr, "fx_5_0", shaderFlags, 0, &pBytecodeBlob, &pErrorBlob );
 
 	if ( FAILED( result ) )
 	{
@@ -500,14 +586,42 @@ ID3DX11Effect* Effect::LoadEffect( ID3D11Device* pDevice, const std::wstring& as
 
 			std::wcout << stringStream.str() << "\n";
 
-			return nullptr;
+			return {};
 		}
 		else
 		{
-			std::wcout << L"EffectLoader: Failed to CreateEffectFromFile!\nPath: " << assetFile << "\n";
-			return nullptr;
+			std::wcout << L"EffectLoader: Failed to CompileEffectFromFile!\nPath: " << assetFile << "\n";
+			return {};
 		}
 	}
 
+	// Warnings only
+	if ( pErrorBlob )
+	{
+		pErrorBlob->Release();
+	}
+
+	const std::byte* pBytecode{ static_cast<const std::byte*>( pBytecodeBlob->GetBufferPointer() ) };
+	std::vector<std::byte> bytecode( pBytecode, pBytecode + pBytecodeBlob->GetBufferSize() );
+	pBytecodeBlob->Release();
+
+	return bytecode;
+}
+
+ID3DX11Effect* Effect::CreateEffect( ID3D11Device* pDevice, std::span<const std::byte> bytecode )
+{
+	if ( bytecode.empty() )
+	{
+		return nullptr;
+	}
+
+	ID3DX11Effect* pEffect{};
+	const HRESULT result{ D3DX11CreateEffectFromMemory( bytecode.data(), bytecode.size(), 0, pDevice, &pEffect ) };
+	if ( FAILED( result ) )
+	{
+		std::wcout << L"EffectLoader: Failed to CreateEffectFromMemory!\n";
+		return nullptr;
+	}
+
 	return pEffect;
 }
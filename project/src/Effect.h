@@ -2,19 +2,41 @@
 #define EFFECT_H
 
 // This is an RAII wrapper around DirectX effects
+// Standard includes
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
 // Project includes
 #include "Matrix.h"
 #include "Sampler.h"
 #include "Texture.h"
+#include "VertexLayout.h"
 
 namespace dae
 {
+// One sampler per filter mode, from the resource cache
+using SamplerSet = std::array<std::shared_ptr<const Sampler>, Sampler::FilterModeCount>;
 
+// Shared by every mesh drawn with it, meshes set their own variables right before they draw
 class Effect final
 {
 public:
+	// Where specular and gloss come from, each has its own pixel shader
+	enum class MaterialLayout
+	{
+		separate, // a specular and a gloss map
+		packed,	  // one material map, specular in rgb and gloss in alpha
+	};
+
 	Effect() = default;
-	Effect( ID3D11Device* pDevice, const std::wstring& assetFile );
+	// From what CompileEffect returned, so the slow part can run on another thread
+	Effect( ID3D11Device* pDevice,
+			std::span<const std::byte> bytecode,
+			const VertexLayout& layout,
+			const SamplerSet& samplers );
 	Effect( const Effect& ) = delete;
 	Effect( Effect&& rhs );
 	Effect& operator=( const Effect& ) = delete;
@@ -24,9 +46,6 @@ public:
 
 	ID3DX11Effect* operator->(); // Access effect
 
-	// Methods
-	void CycleFilteringMode();
-
 	// Setters
 	void SetWorldViewProjection( const Matrix& wvp );
 	void SetWorld( const Matrix& w );
@@ -35,22 +54,31 @@ public:
 	void SetNormalMap( const Texture& normalMap );
 	void SetSpecularMap( const Texture& specularMap );
 	void SetGlossMap( const Texture& glossMap );
+	void SetMaterialMap( const Texture& materialMap );
+	void SetFilterMode( Sampler::FilterMode filterMode );
 
 	// Getters
-	ID3DX11EffectTechnique* GetTechniquePtr() const;
+	ID3DX11EffectTechnique* GetTechniquePtr( MaterialLayout materialLayout = MaterialLayout::separate ) const;
 	ID3D11InputLayout* GetInputLayoutPtr() const;
 
-	static ID3DX11Effect* LoadEffect( ID3D11Device* pDevice, const std::wstring& assetFile );
+	// Needs no device, safe from any thread; empty when the file doesn't compile, the errors are printed
+	static std::vector<std::byte> CompileEffect( const std::wstring& assetFile );
+	// Null when the bytecode is empty or the device rejects it
+	static ID3DX11Effect* CreateEffect( ID3D11Device* pDevice, std::span<const std::byte> bytecode );
 
 private:
 	// HARDWARE RESOURCES: OWNING
 	ID3DX11Effect* m_pEffect{};
 	ID3D11InputLayout* m_pInputLayout{};
-	Sampler m_Sampler{};
+	//
+
+	// HARDWARE RESOURCES: SHARED
+	SamplerSet m_Samplers{};
 	//
 
 	// HARDWARE RESOURCES: NON-OWNING
 	ID3DX11EffectTechnique* m_pTechnique{};
+	ID3DX11EffectTechnique* m_pMaterialMapTechnique{};
 	ID3DX11EffectMatrixVariable* m_pWorldViewProjection{};
 	ID3DX11EffectMatrixVariable* m_pWorld{};
 	ID3DX11EffectVectorVariable* m_pCameraOrigin{};
@@ -58,6 +86,8 @@ private:
 	ID3DX11EffectShaderResourceVariable* m_pNormalMap{};
 	ID3DX11EffectShaderResourceVariable* m_pSpecularMap{};
 	ID3DX11EffectShaderResourceVariable* m_pGlossMap{};
+	ID3DX11EffectShaderResourceVariable* m_pMaterialMap{};
+	ID3DX11EffectSamplerVariable* m_pSampler{};
 	//
 };
 
@@ -65,7 +95,10 @@ class TransparentEffect final // see transparent mesh
 {
 public:
 	TransparentEffect() = default;
-	TransparentEffect( ID3D11Device* pDevice, const std::wstring& assetFile );
+	TransparentEffect( ID3D11Device* pDevice,
+					   std::span<const std::byte> bytecode,
+					   const VertexLayout& layout,
+					   const SamplerSet& samplers );
 	TransparentEffect( const Effect& ) = delete;
 	TransparentEffect( TransparentEffect&& rhs );
 	TransparentEffect& operator=( const TransparentEffect& ) = delete;
@@ -75,12 +108,10 @@ public:
 
 	ID3DX11Effect* operator->(); // Access effect
 
-	// Methods
-	void CycleFilteringMode();
-
 	// Setters
 	void SetWorldViewProjection( const Matrix& wvp );
 	void SetDiffuseMap( const Texture& diffuseMap );
+	void SetFilterMode( Sampler::FilterMode filterMode );
 
 	// Getters
 	ID3DX11EffectTechnique* GetTechniquePtr() const;
@@ -90,13 +121,17 @@ private:
 	// HARDWARE RESOURCES: OWNING
 	ID3DX11Effect* m_pEffect{};
 	ID3D11InputLayout* m_pInputLayout{};
-	Sampler m_Sampler{};
+	//
+
+	// HARDWARE RESOURCES: SHARED
+	SamplerSet m_Samplers{};
 	//
 
 	// HARDWARE RESOURCES: NON-OWNING
 	ID3DX11EffectTechnique* m_pTechnique{};
 	ID3DX11EffectMatrixVariable* m_pWorldViewProjection{};
 	ID3DX11EffectShaderResourceVariable* m_pDiffuseMap{};
+	ID3DX11EffectSamplerVariable* m_pSampler{};
 	//
 };
 } // namespace dae
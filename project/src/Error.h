@@ -7,10 +7,12 @@
 #include <iostream>
 #include <string>
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#undef min
-#undef max
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	undef min
+#	undef max
+#endif
 
 namespace error
 {
@@ -46,6 +48,24 @@ public:
 		return "CouldNotOpenFile";
 	}
 };
+
+class CouldNotWriteFile : public FileError
+{
+public:
+	virtual std::string what() const override
+	{
+		return "CouldNotWriteFile";
+	}
+};
+
+class ParseFail : public FileError
+{
+public:
+	virtual std::string what() const override
+	{
+		return "ParseFail";
+	}
+};
 } // namespace file
 
 namespace effect
@@ -169,6 +189,24 @@ public:
 		return "ResourceViewCreateFail";
 	}
 };
+
+class DecodeFail : public TextureError
+{
+public:
+	virtual std::string what() const override
+	{
+		return "DecodeFail";
+	}
+};
+
+class CompressFail : public TextureError
+{
+public:
+	virtual std::string what() const override
+	{
+		return "CompressFail";
+	}
+};
 } // namespace texture
 
 namespace mesh
@@ -329,6 +367,17 @@ public:
 
 namespace utils
 {
+// 12 is red, 7 the default; the headless tools built off Windows print without color
+inline void SetConsoleColor( int color )
+{
+#ifdef _WIN32
+	HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
+	SetConsoleTextAttribute( consoleHandle, color );
+#else
+	static_cast<void>( color );
+#endif
+}
+
 template <typename Function>
 bool HandleThrowingFunction( Function f ) noexcept // All exceptions are contained within this function -> doesn't throw
 {
@@ -338,62 +387,56 @@ bool HandleThrowingFunction( Function f ) noexcept // All exceptions are contain
 	}
 	catch ( const Error& e )
 	{
-		HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
-		SetConsoleTextAttribute( consoleHandle, 12 );
+		SetConsoleColor( 12 );
 
 		std::cout << "[" << e.category() << "]: " << e.what() << "\n";
 
-		SetConsoleTextAttribute( consoleHandle, 7 );
+		SetConsoleColor( 7 );
 		return true;
 	}
 	catch ( const std::exception& e )
 	{
-		HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
-		SetConsoleTextAttribute( consoleHandle, 12 );
+		SetConsoleColor( 12 );
 
 		std::cout << "Caught exception: " << e.what() << "\n";
 
-		SetConsoleTextAttribute( consoleHandle, 7 );
+		SetConsoleColor( 7 );
 		return true;
 	}
 	catch ( const std::string& eString )
 	{
-		HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
-		SetConsoleTextAttribute( consoleHandle, 12 );
+		SetConsoleColor( 12 );
 
 		std::cout << "Caught exception: " << eString << "\n";
 
-		SetConsoleTextAttribute( consoleHandle, 7 );
+		SetConsoleColor( 7 );
 		return true;
 	}
 	catch ( int eCode )
 	{
-		HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
-		SetConsoleTextAttribute( consoleHandle, 12 );
+		SetConsoleColor( 12 );
 
 		std::cout << "Caught exception: CODE=[0x" << std::hex << eCode << "]\n";
 
-		SetConsoleTextAttribute( consoleHandle, 7 );
+		SetConsoleColor( 7 );
 		return true;
 	}
 	catch ( uint32_t eCode )
 	{
-		HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
-		SetConsoleTextAttribute( consoleHandle, 12 );
+		SetConsoleColor( 12 );
 
 		std::cout << "Caught exception: CODE=[0x" << std::hex << eCode << "]\n";
 
-		SetConsoleTextAttribute( consoleHandle, 7 );
+		SetConsoleColor( 7 );
 		return true;
 	}
 	catch ( ... )
 	{
-		HANDLE consoleHandle{ GetStdHandle( STD_OUTPUT_HANDLE ) };
-		SetConsoleTextAttribute( consoleHandle, 12 );
+		SetConsoleColor( 12 );
 
 		std::cout << "Caught unhandled exception\n";
 
-		SetConsoleTextAttribute( consoleHandle, 7 );
+		SetConsoleColor( 7 );
 		return true;
 	}
 
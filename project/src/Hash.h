@@ -0,0 +1,59 @@
+#ifndef HASH_H
+#define HASH_H
+
+// Non-cryptographic 64-bit content hash, used to tell whether a source asset changed
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace dae
+{
+namespace hash
+{
+constexpr uint64_t DefaultSeed{ 0xCBF29CE484222325ull };
+
+inline uint64_t Mix( uint64_t hash )
+{
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+// Eight bytes per step, the tail is folded in byte by byte
+inline uint64_t HashBytes( const void* pData, size_t size, uint64_t seed = DefaultSeed )
+{
+	constexpr uint64_t prime{ 0x100000001B3ull };
+
+	const unsigned char* pBytes{ static_cast<const unsigned char*>( pData ) };
+	uint64_t hash{ seed ^ ( size * prime ) };
+
+	size_t offset{};
+	for ( ; offset + sizeof( uint64_t ) <= size; offset += sizeof( uint64_t ) )
+	{
+		uint64_t word{};
+		std::memcpy( &word, pBytes + offset, sizeof( word ) );
+		hash = ( hash ^ Mix( word ) ) * prime;
+	}
+	for ( ; offset < size; ++offset )
+	{
+		hash = ( hash ^ pBytes[offset] ) * prime;
+	}
+
+	return Mix( hash );
+}
+
+inline uint64_t HashBytes( std::string_view bytes, uint64_t seed = DefaultSeed )
+{
+	return HashBytes( bytes.data(), bytes.size(), seed );
+}
+
+inline uint64_t Combine( uint64_t hash, uint64_t value )
+{
+	return Mix( hash ^ ( value + 0x9E3779B97F4A7C15ull + ( hash << 6 ) + ( hash >> 2 ) ) );
+}
+} // namespace hash
+} // namespace dae
+#endif
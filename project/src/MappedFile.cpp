@@ -0,0 +1,219 @@
+#include <algorithm>
+#include "MappedFile.h"
+#include "Error.h"
+
+#ifndef _WIN32
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace dae
+{
+MappedFile::MappedFile( const std::string& path )
+{
+#ifdef _WIN32
+	HANDLE fileHandle{ CreateFileA( path.c_str(),
+									GENERIC_READ,
+									FILE_SHARE_READ,
+									nullptr,
+									OPEN_EXISTING,
+									FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+									nullptr ) };
+	if ( fileHandle == INVALID_HANDLE_VALUE )
+	{
+		throw error::file::CouldNotOpenFile();
+	}
+	m_FileHandle = fileHandle;
+
+	LARGE_INTEGER fileSize{};
+	if ( !GetFileSizeEx( fileHandle, &fileSize ) )
+	{
+		Close();
+		throw error::file::CouldNotOpenFile();
+	}
+	m_Size = static_cast<size_t>( fileSize.QuadPart );
+
+	// Zero-sized files can't be mapped, an empty view is all they need
+	if ( m_Size == 0 )
+	{
+		return;
+	}
+
+	m_MappingHandle = CreateFileMappingA( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if ( !m_MappingHandle )
+	{
+		Close();
+		throw error::file::CouldNotOpenFile();
+	}
+
+	m_pData = static_cast<const char*>( MapViewOfFile( m_MappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	if ( !m_pData )
+	{
+		Close();
+		throw error::file::CouldNotOpenFile();
+	}
+#else
+	const int fileDescriptor{ open( path.c_str(), O_RDONLY ) };
+	if ( fileDescriptor < 0 )
+	{
+		throw error::file::CouldNotOpenFile();
+	}
+
+	struct stat fileStat{};
+	if ( fstat( fileDescriptor, &fileStat ) != 0 )
+	{
+		close( fileDescriptor );
+		throw error::file::CouldNotOpenFile();
+	}
+	m_Size = static_cast<size_t>( fileStat.st_size );
+
+	if ( m_Size != 0 )
+	{
+		void* pMapping{ mmap( nullptr, m_Size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 ) };
+		if ( pMapping == MAP_FAILED )
+		{
+			close( fileDescriptor );
+			throw error::file::CouldNotOpenFile();
+		}
+		madvise( pMapping, m_Size, MADV_SEQUENTIAL );
+		m_pData = static_cast<const char*>( pMapping );
+	}
+
+	// The mapping keeps its own reference to the file
+	close( fileDescriptor );
+#endif
+}
+
+MappedFile::MappedFile( MappedFile&& rhs )
+{
+	if ( this == &rhs )
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	m_FileHandle = rhs.m_FileHandle;
+	rhs.m_FileHandle = nullptr;
+
+	m_MappingHandle = rhs.m_MappingHandle;
+	rhs.m_MappingHandle = nullptr;
+#endif
+
+	m_pData = rhs.m_pData;
+	rhs.m_pData = nullptr;
+
+	m_Size = rhs.m_Size;
+	rhs.m_Size = 0;
+}
+
+MappedFile& MappedFile::operator=( MappedFile&& rhs )
+{
+	if ( this == &rhs )
+	{
+		return *this;
+	}
+
+	Close();
+
+#ifdef _WIN32
+	m_FileHandle = rhs.m_FileHandle;
+	rhs.m_FileHandle = nullptr;
+
+	m_MappingHandle = rhs.m_MappingHandle;
+	rhs.m_MappingHandle = nullptr;
+#endif
+
+	m_pData = rhs.m_pData;
+	rhs.m_pData = nullptr;
+
+	m_Size = rhs.m_Size;
+	rhs.m_Size = 0;
+
+	return *this;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+	Close();
+}
+
+const char* MappedFile::GetData() const
+{
+	return m_pData;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return m_Size;
+}
+
+std::string_view MappedFile::GetView() const
+{
+	return { m_pData, m_pData ? m_Size : 0 };
+}
+
+void MappedFile::Evict( size_t offset, size_t size ) const
+{
+	if ( !m_pData || offset >= m_Size )
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	SYSTEM_INFO systemInfo{};
+	GetSystemInfo( &systemInfo );
+	const size_t pageSize{ systemInfo.dwPageSize };
+#else
+	const size_t pageSize{ static_cast<size_t>( sysconf( _SC_PAGESIZE ) ) };
+#endif
+
+	// The mapping is read-only, pages shared with a neighbouring range can't lose anything
+	const size_t begin{ offset / pageSize * pageSize };
+	const size_t end{ std::min( ( std::min( offset + size, m_Size ) + pageSize - 1 ) / pageSize * pageSize,
+							   ( m_Size + pageSize - 1 ) / pageSize * pageSize ) };
+	if ( end <= begin )
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	// Unlocking pages that were never locked removes them from the working set, the file keeps them on standby
+	VirtualUnlock( const_cast<char*>( m_pData + begin ), end - begin );
+#else
+	madvise( const_cast<char*>( m_pData + begin ), end - begin, MADV_DONTNEED );
+#endif
+}
+
+void MappedFile::Close() noexcept
+{
+#ifdef _WIN32
+	if ( m_pData )
+	{
+		UnmapViewOfFile( m_pData );
+	}
+
+	if ( m_MappingHandle )
+	{
+		CloseHandle( m_MappingHandle );
+	}
+
+	if ( m_FileHandle )
+	{
+		CloseHandle( m_FileHandle );
+	}
+
+	m_FileHandle = nullptr;
+	m_MappingHandle = nullptr;
+#else
+	if ( m_pData )
+	{
+		munmap( const_cast<char*>( m_pData ), m_Size );
+	}
+#endif
+
+	m_pData = nullptr;
+	m_Size = 0;
+}
+} // namespace dae
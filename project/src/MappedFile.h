@@ -0,0 +1,45 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+// This is an RAII wrapper around a read-only memory mapping of a whole file
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace dae
+{
+class MappedFile final
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile( const std::string& path );
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile( MappedFile&& rhs );
+	MappedFile& operator=( const MappedFile& ) = delete;
+	MappedFile& operator=( MappedFile&& rhs );
+
+	~MappedFile() noexcept;
+
+	// Getters
+	const char* GetData() const;
+	size_t GetSize() const;
+	std::string_view GetView() const;
+
+	// Drops every page overlapping [offset, offset + size) from the working set, touching them again reads them back
+	// from the file; keeps a pass over a file larger than memory from filling memory with it
+	void Evict( size_t offset, size_t size ) const;
+
+private:
+	void Close() noexcept;
+
+	// OS RESOURCES: OWNING
+#ifdef _WIN32
+	void* m_FileHandle{};
+	void* m_MappingHandle{};
+#endif
+	const char* m_pData{};
+	size_t m_Size{};
+	//
+};
+} // namespace dae
+#endif
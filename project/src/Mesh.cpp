@@ -1,40 +1,92 @@
+#include <algorithm>
+#include <iostream>
+#include <limits>
 #include "Mesh.h"
 #include "Error.h"
+#include "MeshSimplifier.h"
 
 namespace dae
 {
+namespace
+{
+// Errors and sizes are in object space, the largest axis scale keeps estimates conservative
+float GetMaxScale( const Matrix& world )
+{
+	return std::max(
+		{ world.GetAxisX().Magnitude(), world.GetAxisY().Magnitude(), world.GetAxisZ().Magnitude() } );
+}
+} // namespace
+
 Mesh::Mesh( ID3D11Device* pDevice,
-			const std::vector<Vertex>& vertices,
-			const std::vector<UINT>& indices,
+			const MeshData& meshData,
 			D3D11_PRIMITIVE_TOPOLOGY topology,
+			ResourceCache& cache,
 			const std::wstring& effectPath,
 			const std::string& diffuseMapPath,
 			const std::string& normalMapPath,
 			const std::string& specularMapPath,
 			const std::string& glossMapPath )
+	: Mesh( pDevice,
+			meshData,
+			topology,
+			cache.GetEffect( effectPath, meshData.GetLayout() ),
+			cache.GetTexture( diffuseMapPath, DiffuseMapOptions ),
+			cache.GetTexture( normalMapPath, NormalMapOptions ),
+			cache.GetTexture( specularMapPath, SpecularMapOptions ),
+			cache.GetTexture( glossMapPath, GlossMapOptions ) )
+{
+}
+
+Mesh::Mesh( ID3D11Device* pDevice,
+			const MeshData& meshData,
+			D3D11_PRIMITIVE_TOPOLOGY topology,
+			std::shared_ptr<Effect> pEffect,
+			std::shared_ptr<const Texture> pDiffuseMap,
+			std::shared_ptr<const Texture> pNormalMap,
+			std::shared_ptr<const Texture> pSpecularMap,
+			std::shared_ptr<const Texture> pGlossMap )
 	: m_Topology( topology )
-	, m_Effect( pDevice, effectPath )
-	, m_DiffuseMap( pDevice, diffuseMapPath )
-	, m_NormalMap( pDevice, normalMapPath )
-	, m_SpecularMap( pDevice, specularMapPath )
-	, m_GlossMap( pDevice, glossMapPath )
+	, m_MeshletCuller( meshData.GetMeshlets() )
+	, m_Lods( meshData.GetLods().begin(), meshData.GetLods().end() )
+	, m_pEffect( std::move( pEffect ) )
+	, m_pDiffuseMap( std::move( pDiffuseMap ) )
+	, m_pNormalMap( std::move( pNormalMap ) )
+	, m_pSpecularMap( std::move( pSpecularMap ) )
+	, m_pGlossMap( std::move( pGlossMap ) )
 {
-	if ( vertices.size() == 0 )
+	const std::span<const std::byte> vertices{ meshData.GetVertexData() };
+	const std::span<const std::byte> indices{ meshData.GetIndexData() };
+
+	if ( vertices.empty() )
 	{
 		throw error::mesh::BufferIsEmpty();
 	}
 
-	if ( indices.size() == 0 )
+	if ( indices.empty() )
 	{
 		throw error::mesh::BufferIsEmpty();
 	}
-	m_VertexCount = vertices.size();
-	m_IndexCount = indices.size();
+	m_VertexCount = static_cast<uint32_t>( meshData.GetVertexCount() );
+	m_VertexStride = meshData.GetLayout().stride;
+	m_IndexCount = static_cast<uint32_t>( meshData.GetIndexCount() );
+	m_IndexFormat = meshData.GetIndexSize() == sizeof( uint16_t ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	if ( m_Lods.empty() )
+	{
+		m_Lods.push_back( { 0, m_IndexCount } );
+	}
+
+	const BoundingBox& bounds{ meshData.GetBounds() };
+	m_BoundsCenter = ( bounds.min + bounds.max ) * 0.5f;
+	m_BoundsRadius = ( bounds.max - bounds.min ).Magnitude() * 0.5f;
+
+	// Drawn whole until the first view culls the meshlets
+	m_DrawRanges.push_back( { m_Lods.front().firstIndex, m_Lods.front().indexCount } );
 
 	// Create Vertex Buffer
 	D3D11_BUFFER_DESC vertexBufferDesc{};
 	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-	vertexBufferDesc.ByteWidth = sizeof( Vertex ) * m_VertexCount;
+	vertexBufferDesc.ByteWidth = static_cast<UINT>( vertices.size() );
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 
 	D3D11_SUBRESOURCE_DATA vertexData{};
@@ -50,7 +102,7 @@ Mesh::Mesh( ID3D11Device* pDevice,
 	// Create Index Buffer
 	D3D11_BUFFER_DESC indexBufferDesc{};
 	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-	indexBufferDesc.ByteWidth = sizeof( UINT ) * m_IndexCount;
+	indexBufferDesc.ByteWidth = static_cast<UINT>( indices.size() );
 	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
 	D3D11_SUBRESOURCE_DATA indexData{};
@@ -62,13 +114,25 @@ Mesh::Mesh( ID3D11Device* pDevice,
 		throw static_cast<int>( result );
 	}
 	//
+}
 
-	// Pass texture view to effect
-	m_Effect.SetDiffuseMap( m_DiffuseMap );
-	m_Effect.SetNormalMap( m_NormalMap );
-	m_Effect.SetSpecularMap( m_SpecularMap );
-	m_Effect.SetGlossMap( m_GlossMap );
-	//
+Mesh::Mesh( ID3D11Device* pDevice,
+			const MeshData& meshData,
+			D3D11_PRIMITIVE_TOPOLOGY topology,
+			std::shared_ptr<Effect> pEffect,
+			std::shared_ptr<const Texture> pDiffuseMap,
+			std::shared_ptr<const Texture> pNormalMap,
+			std::shared_ptr<const Texture> pMaterialMap )
+	: Mesh( pDevice,
+			meshData,
+			topology,
+			std::move( pEffect ),
+			std::move( pDiffuseMap ),
+			std::move( pNormalMap ),
+			nullptr,
+			nullptr )
+{
+	m_pMaterialMap = std::move( pMaterialMap );
 }
 
 Mesh::Mesh( Mesh&& rhs )
@@ -79,8 +143,21 @@ Mesh::Mesh( Mesh&& rhs )
 	}
 
 	m_VertexCount = rhs.m_VertexCount;
+	m_VertexStride = rhs.m_VertexStride;
 	m_IndexCount = rhs.m_IndexCount;
+	m_IndexFormat = rhs.m_IndexFormat;
 	m_Topology = rhs.m_Topology;
+	m_MeshletCuller = std::move( rhs.m_MeshletCuller );
+	m_DrawRanges = std::move( rhs.m_DrawRanges );
+	m_CullStatistics = rhs.m_CullStatistics;
+	m_Lods = std::move( rhs.m_Lods );
+	m_LodIdx = rhs.m_LodIdx;
+	m_BoundsCenter = rhs.m_BoundsCenter;
+	m_BoundsRadius = rhs.m_BoundsRadius;
+	m_WorldViewProjection = rhs.m_WorldViewProjection;
+	m_WorldMatrix = rhs.m_WorldMatrix;
+	m_CameraOrigin = rhs.m_CameraOrigin;
+	m_FilterMode = rhs.m_FilterMode;
 
 	m_pVertexBuffer = rhs.m_pVertexBuffer;
 	rhs.m_pVertexBuffer = nullptr;
@@ -88,11 +165,12 @@ Mesh::Mesh( Mesh&& rhs )
 	m_pIndexBuffer = rhs.m_pIndexBuffer;
 	rhs.m_pIndexBuffer = nullptr;
 
-	m_Effect = std::move( rhs.m_Effect );
-	m_DiffuseMap = std::move( rhs.m_DiffuseMap );
-	m_NormalMap = std::move( rhs.m_NormalMap );
-	m_SpecularMap = std::move( rhs.m_SpecularMap );
-	m_GlossMap = std::move( rhs.m_GlossMap );
+	m_pEffect = std::move( rhs.m_pEffect );
+	m_pDiffuseMap = std::move( rhs.m_pDiffuseMap );
+	m_pNormalMap = std::move( rhs.m_pNormalMap );
+	m_pSpecularMap = std::move( rhs.m_pSpecularMap );
+	m_pGlossMap = std::move( rhs.m_pGlossMap );
+	m_pMaterialMap = std::move( rhs.m_pMaterialMap );
 }
 
 Mesh& Mesh::operator=( Mesh&& rhs )
@@ -103,8 +181,21 @@ Mesh& Mesh::operator=( Mesh&& rhs )
 	}
 
 	m_VertexCount = rhs.m_VertexCount;
+	m_VertexStride = rhs.m_VertexStride;
 	m_IndexCount = rhs.m_IndexCount;
+	m_IndexFormat = rhs.m_IndexFormat;
 	m_Topology = rhs.m_Topology;
+	m_MeshletCuller = std::move( rhs.m_MeshletCuller );
+	m_DrawRanges = std::move( rhs.m_DrawRanges );
+	m_CullStatistics = rhs.m_CullStatistics;
+	m_Lods = std::move( rhs.m_Lods );
+	m_LodIdx = rhs.m_LodIdx;
+	m_BoundsCenter = rhs.m_BoundsCenter;
+	m_BoundsRadius = rhs.m_BoundsRadius;
+	m_WorldViewProjection = rhs.m_WorldViewProjection;
+	m_WorldMatrix = rhs.m_WorldMatrix;
+	m_CameraOrigin = rhs.m_CameraOrigin;
+	m_FilterMode = rhs.m_FilterMode;
 
 	m_pVertexBuffer = rhs.m_pVertexBuffer;
 	rhs.m_pVertexBuffer = nullptr;
@@ -112,11 +203,12 @@ Mesh& Mesh::operator=( Mesh&& rhs )
 	m_pIndexBuffer = rhs.m_pIndexBuffer;
 	rhs.m_pIndexBuffer = nullptr;
 
-	m_Effect = std::move( rhs.m_Effect );
-	m_DiffuseMap = std::move( rhs.m_DiffuseMap );
-	m_NormalMap = std::move( rhs.m_NormalMap );
-	m_SpecularMap = std::move( rhs.m_SpecularMap );
-	m_GlossMap = std::move( rhs.m_GlossMap );
+	m_pEffect = std::move( rhs.m_pEffect );
+	m_pDiffuseMap = std::move( rhs.m_pDiffuseMap );
+	m_pNormalMap = std::move( rhs.m_pNormalMap );
+	m_pSpecularMap = std::move( rhs.m_pSpecularMap );
+	m_pGlossMap = std::move( rhs.m_pGlossMap );
+	m_pMaterialMap = std::move( rhs.m_pMaterialMap );
 
 	return *this;
 }
@@ -140,29 +232,51 @@ void Mesh::Draw( ID3D11DeviceContext* pDeviceContext ) const
 	pDeviceContext->IASetPrimitiveTopology( m_Topology );
 
 	// 2. Set input layout
-	pDeviceContext->IASetInputLayout( m_Effect.GetInputLayoutPtr() );
+	pDeviceContext->IASetInputLayout( m_pEffect->GetInputLayoutPtr() );
 
 	// 3. Set vertex buffer
-	constexpr UINT stride{ sizeof( Vertex ) };
 	constexpr UINT offset{};
-	pDeviceContext->IASetVertexBuffers( 0, 1, &m_pVertexBuffer, &stride, &offset );
+	pDeviceContext->IASetVertexBuffers( 0, 1, &m_pVertexBuffer, &m_VertexStride, &offset );
 
 	// 4. Set index buffer
-	pDeviceContext->IASetIndexBuffer( m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0 );
+	pDeviceContext->IASetIndexBuffer( m_pIndexBuffer, m_IndexFormat, 0 );
+
+	// 5. Set variables, the effect is shared with every other mesh drawn with it
+	m_pEffect->SetWorldViewProjection( m_WorldViewProjection );
+	m_pEffect->SetWorld( m_WorldMatrix );
+	m_pEffect->SetCameraOrigin( m_CameraOrigin );
+	m_pEffect->SetDiffuseMap( *m_pDiffuseMap );
+	m_pEffect->SetNormalMap( *m_pNormalMap );
+	if ( m_pMaterialMap )
+	{
+		m_pEffect->SetMaterialMap( *m_pMaterialMap );
+	}
+	else
+	{
+		m_pEffect->SetSpecularMap( *m_pSpecularMap );
+		m_pEffect->SetGlossMap( *m_pGlossMap );
+	}
+	m_pEffect->SetFilterMode( m_FilterMode );
 
-	// 5. Draw
+	// 6. Draw
+	ID3DX11EffectTechnique* pTechnique{ m_pEffect->GetTechniquePtr(
+		m_pMaterialMap ? Effect::MaterialLayout::packed : Effect::MaterialLayout::separate ) };
 	D3DX11_TECHNIQUE_DESC techDesc{};
-	m_Effect.GetTechniquePtr()->GetDesc( &techDesc );
+	pTechnique->GetDesc( &techDesc );
 	for ( UINT passIdx{}; passIdx < techDesc.Passes; ++passIdx )
 	{
-		m_Effect.GetTechniquePtr()->GetPassByIndex( passIdx )->Apply( 0, pDeviceContext );
-		pDeviceContext->DrawIndexed( m_IndexCount, 0, 0 );
+		pTechnique->GetPassByIndex( passIdx )->Apply( 0, pDeviceContext );
+		for ( const meshlet::DrawRange& range : m_DrawRanges )
+		{
+			pDeviceContext->DrawIndexed( range.indexCount, range.firstIndex, 0 );
+		}
 	}
 }
 
 void Mesh::CycleFilteringMode()
 {
-	m_Effect.CycleFilteringMode();
+	m_FilterMode = Sampler::GetNextFilterMode( m_FilterMode );
+	std::cout << "Set filter mode to " << Sampler::GetFilterModeName( m_FilterMode ) << "\n";
 }
 
 void Mesh::ApplyMatrix( const Matrix& action )
@@ -172,15 +286,61 @@ void Mesh::ApplyMatrix( const Matrix& action )
 
 void Mesh::SetWorldViewProjection( const Vector3& o, const Matrix& v, const Matrix& p )
 {
-	m_Effect.SetWorldViewProjection( m_WorldMatrix * ( v * p ) );
-	m_Effect.SetWorld( m_WorldMatrix );
-	m_Effect.SetCameraOrigin( o );
+	const Matrix viewProjection{ v * p };
+	m_WorldViewProjection = m_WorldMatrix * viewProjection;
+	m_CameraOrigin = o;
+
+	if ( m_LodIdx == 0 && m_MeshletCuller.GetMeshletCount() > 0 )
+	{
+		const meshlet::CullView view{ meshlet::CullView::Create( m_WorldMatrix, viewProjection, o ) };
+		m_CullStatistics = m_MeshletCuller.Cull( view, m_DrawRanges );
+	}
+	else
+	{
+		const LodLevel& lod{ m_Lods[m_LodIdx] };
+		m_DrawRanges.assign( 1, { lod.firstIndex, lod.indexCount } );
+		m_CullStatistics = {};
+	}
 }
 
 void Mesh::SetWorld( const Matrix& w )
 {
 	m_WorldMatrix = w;
-	m_Effect.SetWorld( m_WorldMatrix );
+}
+
+void Mesh::SetLod( uint32_t lodIdx )
+{
+	m_LodIdx = std::min( lodIdx, GetLodCount() - 1 );
+}
+
+uint32_t Mesh::PickLod( const Vector3& o, float fov ) const
+{
+	const float scale{ GetMaxScale( m_WorldMatrix ) };
+	const Vector3 center{ m_WorldMatrix.TransformPoint( m_BoundsCenter ) };
+
+	// Distance to the bounding sphere, so the nearest part of the mesh decides
+	const float distance{ ( center - o ).Magnitude() - m_BoundsRadius * scale };
+	return simplify::SelectLod( m_Lods, distance / scale, fov );
+}
+
+void Mesh::RequestTextureLevels( const Vector3& o, float fov, uint32_t screenHeight ) const
+{
+	const float radius{ m_BoundsRadius * GetMaxScale( m_WorldMatrix ) };
+	const Vector3 center{ m_WorldMatrix.TransformPoint( m_BoundsCenter ) };
+
+	// Pixels the bounding sphere's diameter covers at its nearest point, the maps are taken to be spread over it once,
+	// which an atlas like the vehicle's is
+	const float distance{ ( center - o ).Magnitude() - radius };
+	const float screenSize{ distance > 0.f ? radius * static_cast<float>( screenHeight ) / ( distance * fov )
+										   : std::numeric_limits<float>::infinity() };
+	for ( const Texture* pMap :
+		  { m_pDiffuseMap.get(), m_pNormalMap.get(), m_pSpecularMap.get(), m_pGlossMap.get(), m_pMaterialMap.get() } )
+	{
+		if ( pMap )
+		{
+			pMap->Request( pMap->PickLevel( screenSize ) );
+		}
+	}
 }
 
 ID3D11Buffer* Mesh::GetVertexBufferPtr() const
@@ -195,7 +355,7 @@ ID3D11Buffer* Mesh::GetIndexBufferPtr() const
 
 Effect* Mesh::GetEffectPtr()
 {
-	return &m_Effect;
+	return m_pEffect.get();
 }
 
 uint32_t Mesh::GetVertexCount() const
@@ -207,32 +367,81 @@ uint32_t Mesh::GetIndexCount() const
 {
 	return m_IndexCount;
 }
+
+const meshlet::CullStatistics& Mesh::GetCullStatistics() const
+{
+	return m_CullStatistics;
+}
+
+uint32_t Mesh::GetLodCount() const
+{
+	return static_cast<uint32_t>( m_Lods.size() );
+}
+
+uint32_t Mesh::GetLodIdx() const
+{
+	return m_LodIdx;
+}
+
+size_t Mesh::GetDrawnTriangleCount() const
+{
+	size_t indexCount{};
+	for ( const meshlet::DrawRange& range : m_DrawRanges )
+	{
+		indexCount += range.indexCount;
+	}
+	return indexCount / 3;
+}
 TransparentMesh::TransparentMesh( ID3D11Device* pDevice,
-								  const std::vector<Vertex>& vertices,
-								  const std::vector<UINT>& indices,
+								  const MeshData& meshData,
 								  D3D11_PRIMITIVE_TOPOLOGY topology,
+								  ResourceCache& cache,
 								  const std::wstring& effectPath,
 								  const std::string& diffuseMapPath )
+	: TransparentMesh( pDevice,
+					   meshData,
+					   topology,
+					   cache.GetTransparentEffect( effectPath, meshData.GetLayout() ),
+					   cache.GetTexture( diffuseMapPath, DiffuseMapOptions ) )
+{
+}
+
+TransparentMesh::TransparentMesh( ID3D11Device* pDevice,
+								  const MeshData& meshData,
+								  D3D11_PRIMITIVE_TOPOLOGY topology,
+								  std::shared_ptr<TransparentEffect> pEffect,
+								  std::shared_ptr<const Texture> pDiffuseMap )
 	: m_Topology( topology )
-	, m_Effect( pDevice, effectPath )
-	, m_DiffuseMap( pDevice, diffuseMapPath )
+	, m_pEffect( std::move( pEffect ) )
+	, m_pDiffuseMap( std::move( pDiffuseMap ) )
 {
-	if ( vertices.size() == 0 )
+	const std::span<const std::byte> vertices{ meshData.GetVertexData() };
+	const std::span<const std::byte> indices{ meshData.GetIndexData() };
+
+	if ( vertices.empty() )
 	{
 		throw error::mesh::BufferIsEmpty();
 	}
 
-	if ( indices.size() == 0 )
+	if ( indices.empty() )
 	{
 		throw error::mesh::BufferIsEmpty();
 	}
-	m_VertexCount = vertices.size();
-	m_IndexCount = indices.size();
+	m_VertexCount = static_cast<uint32_t>( meshData.GetVertexCount() );
+	m_VertexStride = meshData.GetLayout().stride;
+	m_IndexCount = static_cast<uint32_t>( meshData.GetIndexCount() );
+	m_IndexFormat = meshData.GetIndexSize() == sizeof( uint16_t ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	// Always drawn at full detail, simplified levels would follow it in the buffer
+	if ( !meshData.GetLods().empty() )
+	{
+		m_IndexCount = meshData.GetLods().front().indexCount;
+	}
 
 	// Create Vertex Buffer
 	D3D11_BUFFER_DESC vertexBufferDesc{};
 	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-	vertexBufferDesc.ByteWidth = sizeof( Vertex ) * m_VertexCount;
+	vertexBufferDesc.ByteWidth = static_cast<UINT>( vertices.size() );
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 
 	D3D11_SUBRESOURCE_DATA vertexData{};
@@ -248,7 +457,7 @@ TransparentMesh::TransparentMesh( ID3D11Device* pDevice,
 	// Create Index Buffer
 	D3D11_BUFFER_DESC indexBufferDesc{};
 	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-	indexBufferDesc.ByteWidth = sizeof( UINT ) * m_IndexCount;
+	indexBufferDesc.ByteWidth = static_cast<UINT>( indices.size() );
 	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
 	D3D11_SUBRESOURCE_DATA indexData{};
@@ -260,10 +469,6 @@ TransparentMesh::TransparentMesh( ID3D11Device* pDevice,
 		throw static_cast<int>( result );
 	}
 	//
-
-	// Pass texture view to effect
-	m_Effect.SetDiffuseMap( m_DiffuseMap );
-	//
 }
 
 TransparentMesh::TransparentMesh( TransparentMesh&& rhs )
@@ -274,8 +479,13 @@ TransparentMesh::TransparentMesh( TransparentMesh&& rhs )
 	}
 
 	m_VertexCount = rhs.m_VertexCount;
+	m_VertexStride = rhs.m_VertexStride;
 	m_IndexCount = rhs.m_IndexCount;
+	m_IndexFormat = rhs.m_IndexFormat;
 	m_Topology = rhs.m_Topology;
+	m_WorldViewProjection = rhs.m_WorldViewProjection;
+	m_WorldMatrix = rhs.m_WorldMatrix;
+	m_FilterMode = rhs.m_FilterMode;
 
 	m_pVertexBuffer = rhs.m_pVertexBuffer;
 	rhs.m_pVertexBuffer = nullptr;
@@ -283,8 +493,8 @@ TransparentMesh::TransparentMesh( TransparentMesh&& rhs )
 	m_pIndexBuffer = rhs.m_pIndexBuffer;
 	rhs.m_pIndexBuffer = nullptr;
 
-	m_Effect = std::move( rhs.m_Effect );
-	m_DiffuseMap = std::move( rhs.m_DiffuseMap );
+	m_pEffect = std::move( rhs.m_pEffect );
+	m_pDiffuseMap = std::move( rhs.m_pDiffuseMap );
 }
 
 TransparentMesh& TransparentMesh::operator=( TransparentMesh&& rhs )
@@ -295,8 +505,13 @@ TransparentMesh& TransparentMesh::operator=( TransparentMesh&& rhs )
 	}
 
 	m_VertexCount = rhs.m_VertexCount;
+	m_VertexStride = rhs.m_VertexStride;
 	m_IndexCount = rhs.m_IndexCount;
+	m_IndexFormat = rhs.m_IndexFormat;
 	m_Topology = rhs.m_Topology;
+	m_WorldViewProjection = rhs.m_WorldViewProjection;
+	m_WorldMatrix = rhs.m_WorldMatrix;
+	m_FilterMode = rhs.m_FilterMode;
 
 	m_pVertexBuffer = rhs.m_pVertexBuffer;
 	rhs.m_pVertexBuffer = nullptr;
@@ -304,8 +519,8 @@ TransparentMesh& TransparentMesh::operator=( TransparentMesh&& rhs )
 	m_pIndexBuffer = rhs.m_pIndexBuffer;
 	rhs.m_pIndexBuffer = nullptr;
 
-	m_Effect = std::move( rhs.m_Effect );
-	m_DiffuseMap = std::move( rhs.m_DiffuseMap );
+	m_pEffect = std::move( rhs.m_pEffect );
+	m_pDiffuseMap = std::move( rhs.m_pDiffuseMap );
 
 	return *this;
 }
@@ -329,29 +544,34 @@ void TransparentMesh::Draw( ID3D11DeviceContext* pDeviceContext ) const
 	pDeviceContext->IASetPrimitiveTopology( m_Topology );
 
 	// 2. Set input layout
-	pDeviceContext->IASetInputLayout( m_Effect.GetInputLayoutPtr() );
+	pDeviceContext->IASetInputLayout( m_pEffect->GetInputLayoutPtr() );
 
 	// 3. Set vertex buffer
-	constexpr UINT stride{ sizeof( Vertex ) };
 	constexpr UINT offset{};
-	pDeviceContext->IASetVertexBuffers( 0, 1, &m_pVertexBuffer, &stride, &offset );
+	pDeviceContext->IASetVertexBuffers( 0, 1, &m_pVertexBuffer, &m_VertexStride, &offset );
 
 	// 4. Set index buffer
-	pDeviceContext->IASetIndexBuffer( m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0 );
+	pDeviceContext->IASetIndexBuffer( m_pIndexBuffer, m_IndexFormat, 0 );
 
-	// 5. Draw
+	// 5. Set variables, the effect is shared with every other mesh drawn with it
+	m_pEffect->SetWorldViewProjection( m_WorldViewProjection );
+	m_pEffect->SetDiffuseMap( *m_pDiffuseMap );
+	m_pEffect->SetFilterMode( m_FilterMode );
+
+	// 6. Draw
 	D3DX11_TECHNIQUE_DESC techDesc{};
-	m_Effect.GetTechniquePtr()->GetDesc( &techDesc );
+	m_pEffect->GetTechniquePtr()->GetDesc( &techDesc );
 	for ( UINT passIdx{}; passIdx < techDesc.Passes; ++passIdx )
 	{
-		m_Effect.GetTechniquePtr()->GetPassByIndex( passIdx )->Apply( 0, pDeviceContext );
+		m_pEffect->GetTechniquePtr()->GetPassByIndex( passIdx )->Apply( 0, pDeviceContext );
 		pDeviceContext->DrawIndexed( m_IndexCount, 0, 0 );
 	}
 }
 
 void TransparentMesh::CycleFilteringMode()
 {
-	m_Effect.CycleFilteringMode();
+	m_FilterMode = Sampler::GetNextFilterMode( m_FilterMode );
+	std::cout << "Set filter mode to " << Sampler::GetFilterModeName( m_FilterMode ) << "\n";
 }
 
 void TransparentMesh::ApplyMatrix( const Matrix& action )
@@ -359,9 +579,14 @@ void TransparentMesh::ApplyMatrix( const Matrix& action )
 	m_WorldMatrix = action * m_WorldMatrix;
 }
 
+void TransparentMesh::RequestTextureLevels() const
+{
+	m_pDiffuseMap->Request( 0 );
+}
+
 void TransparentMesh::SetWorldViewProjection( const Matrix& v, const Matrix& p )
 {
-	m_Effect.SetWorldViewProjection( m_WorldMatrix * ( v * p ) );
+	m_WorldViewProjection = m_WorldMatrix * ( v * p );
 }
 
 void TransparentMesh::SetWorld( const Matrix& w )
@@ -381,7 +606,7 @@ ID3D11Buffer* TransparentMesh::GetIndexBufferPtr() const
 
 TransparentEffect* TransparentMesh::GetEffectPtr()
 {
-	return &m_Effect;
+	return m_pEffect.get();
 }
 
 uint32_t TransparentMesh::GetVertexCount() const
@@ -1,23 +1,53 @@
 #ifndef MESH_H
 #define MESH_H
+#include <memory>
 #include <vector>
 #include "Effect.h"
+#include "MeshData.h"
+#include "ResourceCache.h"
 
 namespace dae
 {
 class Mesh final
 {
 public:
+	// How each map's mip chain is built and compressed, resources/cook.txt gives the cooked maps the same
+	// The normal map only keeps x and y, the shader rebuilds z
+	static constexpr cooked::texture::Options DiffuseMapOptions{ { mip::Content::color }, TextureData::Format::bc7 };
+	static constexpr cooked::texture::Options NormalMapOptions{ { mip::Content::normal }, TextureData::Format::bc5 };
+	static constexpr cooked::texture::Options SpecularMapOptions{ { mip::Content::data }, TextureData::Format::bc1 };
+	static constexpr cooked::texture::Options GlossMapOptions{ { mip::Content::data }, TextureData::Format::bc4 };
+	// Specular in rgb and gloss in alpha, in one BC3 map that takes as much memory as the two; BC3 stores rgb like BC1
+	// and alpha like BC4, so neither loses anything, where BC7's RGBA modes would give gloss too few bits
+	static constexpr cooked::texture::Options MaterialMapOptions{ { mip::Content::data }, TextureData::Format::bc3 };
+
 	Mesh() = default;
+	// Whatever the cache doesn't have yet is loaded on the spot
 	Mesh( ID3D11Device* pDevice,
-		  const std::vector<Vertex>& vertices,
-		  const std::vector<UINT>& indices,
+		  const MeshData& meshData,
 		  D3D11_PRIMITIVE_TOPOLOGY topology,
+		  ResourceCache& cache,
 		  const std::wstring& effectPath,
 		  const std::string& diffuseMapPath,
 		  const std::string& normalMapPath,
 		  const std::string& specularMapPath,
 		  const std::string& glossMapPath );
+	Mesh( ID3D11Device* pDevice,
+		  const MeshData& meshData,
+		  D3D11_PRIMITIVE_TOPOLOGY topology,
+		  std::shared_ptr<Effect> pEffect,
+		  std::shared_ptr<const Texture> pDiffuseMap,
+		  std::shared_ptr<const Texture> pNormalMap,
+		  std::shared_ptr<const Texture> pSpecularMap,
+		  std::shared_ptr<const Texture> pGlossMap );
+	// Drawn with the effect's material map technique, one sample less per pixel
+	Mesh( ID3D11Device* pDevice,
+		  const MeshData& meshData,
+		  D3D11_PRIMITIVE_TOPOLOGY topology,
+		  std::shared_ptr<Effect> pEffect,
+		  std::shared_ptr<const Texture> pDiffuseMap,
+		  std::shared_ptr<const Texture> pNormalMap,
+		  std::shared_ptr<const Texture> pMaterialMap );
 	Mesh( const Mesh& ) = delete;
 	Mesh( Mesh&& rhs );
 
@@ -31,9 +61,17 @@ public:
 	void CycleFilteringMode();
 	void ApplyMatrix( const Matrix& action );
 
+	// Level whose error stays below a pixel or so from o, given the camera's tangent of half its vertical fov
+	uint32_t PickLod( const Vector3& o, float fov ) const;
+	// Asks the texture streamer for the map levels the mesh's size on screen needs, seen from o
+	void RequestTextureLevels( const Vector3& o, float fov, uint32_t screenHeight ) const;
+
 	// Setters
+	// Also culls the meshlets against the new view, only the full-detail level has meshlets
 	void SetWorldViewProjection( const Vector3& o, const Matrix& v, const Matrix& p );
 	void SetWorld( const Matrix& w );
+	// Takes effect on the next SetWorldViewProjection
+	void SetLod( uint32_t lodIdx );
 
 	// Getters
 	ID3D11Buffer* GetVertexBufferPtr() const;
@@ -41,35 +79,63 @@ public:
 	Effect* GetEffectPtr();
 	uint32_t GetVertexCount() const;
 	uint32_t GetIndexCount() const;
+	const meshlet::CullStatistics& GetCullStatistics() const;
+	uint32_t GetLodCount() const;
+	uint32_t GetLodIdx() const;
+	// Triangles the next Draw submits
+	size_t GetDrawnTriangleCount() const;
 
 private:
 	// SOFTWARE RESOURCES
 	uint32_t m_VertexCount{};
+	uint32_t m_VertexStride{};
 	uint32_t m_IndexCount{};
+	DXGI_FORMAT m_IndexFormat{ DXGI_FORMAT_R32_UINT };
 	D3D11_PRIMITIVE_TOPOLOGY m_Topology{};
 	Matrix m_WorldMatrix{ Matrix::CreateIdentity() };
+	meshlet::Culler m_MeshletCuller{};
+	std::vector<meshlet::DrawRange> m_DrawRanges{};
+	meshlet::CullStatistics m_CullStatistics{};
+	std::vector<LodLevel> m_Lods{};
+	uint32_t m_LodIdx{};
+	Vector3 m_BoundsCenter{};
+	float m_BoundsRadius{};
+	Matrix m_WorldViewProjection{};
+	Vector3 m_CameraOrigin{};
+	Sampler::FilterMode m_FilterMode{ Sampler::FilterMode::linear };
 
 	// HARDWARE RESOURCES: OWNING
 	ID3D11Buffer* m_pVertexBuffer{};
 	ID3D11Buffer* m_pIndexBuffer{};
-	Effect m_Effect{};
-	Texture m_DiffuseMap{};
-	Texture m_NormalMap{};
-	Texture m_SpecularMap{};
-	Texture m_GlossMap{};
+	//
+
+	// HARDWARE RESOURCES: SHARED
+	std::shared_ptr<Effect> m_pEffect{};
+	std::shared_ptr<const Texture> m_pDiffuseMap{};
+	std::shared_ptr<const Texture> m_pNormalMap{};
+	std::shared_ptr<const Texture> m_pSpecularMap{};
+	std::shared_ptr<const Texture> m_pGlossMap{};
+	std::shared_ptr<const Texture> m_pMaterialMap{}; // instead of the specular and gloss maps
 	//
 };
 
 class TransparentMesh final // no inheritance because transparent meshes have to be handled differently
 {
 public:
+	static constexpr cooked::texture::Options DiffuseMapOptions{ { mip::Content::color }, TextureData::Format::bc7 };
+
 	TransparentMesh() = default;
 	TransparentMesh( ID3D11Device* pDevice,
-					 const std::vector<Vertex>& vertices,
-					 const std::vector<UINT>& indices,
+					 const MeshData& meshData,
 					 D3D11_PRIMITIVE_TOPOLOGY topology,
+					 ResourceCache& cache,
 					 const std::wstring& effectPath,
 					 const std::string& diffuseMapPath );
+	TransparentMesh( ID3D11Device* pDevice,
+					 const MeshData& meshData,
+					 D3D11_PRIMITIVE_TOPOLOGY topology,
+					 std::shared_ptr<TransparentEffect> pEffect,
+					 std::shared_ptr<const Texture> pDiffuseMap );
 
 	TransparentMesh( const TransparentMesh& ) = delete;
 	TransparentMesh( TransparentMesh&& rhs );
@@ -83,6 +149,8 @@ public:
 	void Draw( ID3D11DeviceContext* pDeviceContext ) const;
 	void CycleFilteringMode();
 	void ApplyMatrix( const Matrix& action );
+	// Without bounds to size it by, the whole chain is asked for
+	void RequestTextureLevels() const;
 
 	// Setters
 	void SetWorldViewProjection( const Matrix& v, const Matrix& p );
@@ -98,15 +166,22 @@ public:
 private:
 	// SOFTWARE RESOURCES
 	uint32_t m_VertexCount{};
+	uint32_t m_VertexStride{};
 	uint32_t m_IndexCount{};
+	DXGI_FORMAT m_IndexFormat{ DXGI_FORMAT_R32_UINT };
 	D3D11_PRIMITIVE_TOPOLOGY m_Topology{};
 	Matrix m_WorldMatrix{ Matrix::CreateIdentity() };
+	Matrix m_WorldViewProjection{};
+	Sampler::FilterMode m_FilterMode{ Sampler::FilterMode::linear };
 
 	// HARDWARE RESOURCES: OWNING
 	ID3D11Buffer* m_pVertexBuffer{};
 	ID3D11Buffer* m_pIndexBuffer{};
-	TransparentEffect m_Effect{};
-	Texture m_DiffuseMap{};
+	//
+
+	// HARDWARE RESOURCES: SHARED
+	std::shared_ptr<TransparentEffect> m_pEffect{};
+	std::shared_ptr<const Texture> m_pDiffuseMap{};
 	//
 };
 }; // namespace dae
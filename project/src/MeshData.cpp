@@ -0,0 +1,144 @@
+#include <algorithm>
+#include "MeshData.h"
+
+namespace dae
+{
+BoundingBox BoundingBox::Create( std::span<const Vertex> vertices )
+{
+	if ( vertices.empty() )
+	{
+		return {};
+	}
+
+	BoundingBox bounds{ vertices.front().position, vertices.front().position };
+	for ( const Vertex& vertex : vertices )
+	{
+		bounds.min.x = std::min( bounds.min.x, vertex.position.x );
+		bounds.min.y = std::min( bounds.min.y, vertex.position.y );
+		bounds.min.z = std::min( bounds.min.z, vertex.position.z );
+		bounds.max.x = std::max( bounds.max.x, vertex.position.x );
+		bounds.max.y = std::max( bounds.max.y, vertex.position.y );
+		bounds.max.z = std::max( bounds.max.z, vertex.position.z );
+	}
+	return bounds;
+}
+
+template <IndexType Index>
+MeshData::MeshData( std::vector<Vertex>&& vertices, std::vector<Index>&& indices )
+	: m_Vertices( std::move( vertices ) )
+	, m_Indices( std::move( indices ) )
+	, m_VertexView( std::as_bytes( std::span<const Vertex>{ m_Vertices } ) )
+	, m_IndexView( std::as_bytes( std::span<const Index>{ std::get<std::vector<Index>>( m_Indices ) } ) )
+	, m_IndexSize( sizeof( Index ) )
+	, m_Layout( VertexLayout::CreateDefault() )
+	, m_Bounds( BoundingBox::Create( m_Vertices ) )
+{
+}
+
+template <IndexType Index>
+MeshData::MeshData( std::vector<std::byte>&& vertexData,
+					const VertexLayout& layout,
+					std::vector<Index>&& indices,
+					const BoundingBox& bounds )
+	: m_VertexBytes( std::move( vertexData ) )
+	, m_Indices( std::move( indices ) )
+	, m_VertexView( m_VertexBytes )
+	, m_IndexView( std::as_bytes( std::span<const Index>{ std::get<std::vector<Index>>( m_Indices ) } ) )
+	, m_IndexSize( sizeof( Index ) )
+	, m_Layout( layout )
+	, m_Bounds( bounds )
+{
+}
+
+template MeshData::MeshData( std::vector<Vertex>&&, std::vector<uint16_t>&& );
+template MeshData::MeshData( std::vector<Vertex>&&, std::vector<uint32_t>&& );
+template MeshData::MeshData( std::vector<std::byte>&&, const VertexLayout&, std::vector<uint16_t>&&, const BoundingBox& );
+template MeshData::MeshData( std::vector<std::byte>&&, const VertexLayout&, std::vector<uint32_t>&&, const BoundingBox& );
+
+MeshData::MeshData( MappedFile&& file,
+					std::span<const std::byte> vertexData,
+					const VertexLayout& layout,
+					std::span<const std::byte> indexData,
+					uint32_t indexSize,
+					std::span<const meshlet::Meshlet> meshlets,
+					const BoundingBox& bounds )
+	: m_File( std::move( file ) )
+	, m_VertexView( vertexData )
+	, m_IndexView( indexData )
+	, m_MeshletView( meshlets )
+	, m_IndexSize( indexSize )
+	, m_Layout( layout )
+	, m_Bounds( bounds )
+{
+}
+
+std::span<const std::byte> MeshData::GetVertexData() const
+{
+	return m_VertexView;
+}
+
+const VertexLayout& MeshData::GetLayout() const
+{
+	return m_Layout;
+}
+
+size_t MeshData::GetVertexCount() const
+{
+	return m_Layout.stride == 0 ? 0 : m_VertexView.size() / m_Layout.stride;
+}
+
+std::span<const std::byte> MeshData::GetIndexData() const
+{
+	return m_IndexView;
+}
+
+uint32_t MeshData::GetIndexSize() const
+{
+	return m_IndexSize;
+}
+
+size_t MeshData::GetIndexCount() const
+{
+	return m_IndexView.size() / m_IndexSize;
+}
+
+std::span<const meshlet::Meshlet> MeshData::GetMeshlets() const
+{
+	return m_MeshletView;
+}
+
+std::span<const LodLevel> MeshData::GetLods() const
+{
+	return m_Lods;
+}
+
+const BoundingBox& MeshData::GetBounds() const
+{
+	return m_Bounds;
+}
+
+bool MeshData::IsMapped() const
+{
+	return m_File.GetData() != nullptr;
+}
+
+void MeshData::SetMeshlets( std::vector<meshlet::Meshlet>&& meshlets )
+{
+	m_Meshlets = std::move( meshlets );
+	m_MeshletView = m_Meshlets;
+}
+
+void MeshData::SetLods( std::vector<LodLevel>&& lods )
+{
+	m_Lods = std::move( lods );
+}
+
+std::span<const Vertex> MeshData::GetVertices() const
+{
+	if ( m_Layout != VertexLayout::CreateDefault() )
+	{
+		return {};
+	}
+	return { reinterpret_cast<const Vertex*>( m_VertexView.data() ), GetVertexCount() };
+}
+} // namespace dae
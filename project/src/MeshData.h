@@ -0,0 +1,131 @@
+#ifndef MESHDATA_H
+#define MESHDATA_H
+
+// CPU-side geometry of a mesh, either owned or viewed straight out of a mapped cooked file
+// Buffers can be created from the spans without an intermediate copy
+// Vertices are raw bytes in whatever format the layout describes, indices are 16-bit when every index fits
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+#include "MappedFile.h"
+#include "Meshlet.h"
+#include "Structs.h"
+#include "VertexLayout.h"
+
+namespace dae
+{
+template <typename Index>
+concept IndexType = std::same_as<Index, uint16_t> || std::same_as<Index, uint32_t>;
+
+struct BoundingBox
+{
+	Vector3 min{};
+	Vector3 max{};
+
+	static BoundingBox Create( std::span<const Vertex> vertices );
+};
+
+// One level of detail, a range of the shared index buffer that draws the whole mesh
+// Stored as-is in cooked files
+struct LodLevel
+{
+	uint32_t firstIndex{};
+	uint32_t indexCount{};
+	float error{}; // furthest the level strays from the full-detail surface, in object space
+	uint32_t padding{};
+};
+
+class MeshData final
+{
+public:
+	MeshData() = default;
+	template <IndexType Index>
+	MeshData( std::vector<Vertex>&& vertices, std::vector<Index>&& indices );
+	template <IndexType Index>
+	MeshData( std::vector<std::byte>&& vertexData,
+			  const VertexLayout& layout,
+			  std::vector<Index>&& indices,
+			  const BoundingBox& bounds );
+	MeshData( MappedFile&& file,
+			  std::span<const std::byte> vertexData,
+			  const VertexLayout& layout,
+			  std::span<const std::byte> indexData,
+			  uint32_t indexSize,
+			  std::span<const meshlet::Meshlet> meshlets,
+			  const BoundingBox& bounds );
+	MeshData( const MeshData& ) = delete;
+	MeshData( MeshData&& ) = default; // vectors and the mapping keep their addresses when moved
+	MeshData& operator=( const MeshData& ) = delete;
+	MeshData& operator=( MeshData&& ) = default;
+
+	~MeshData() noexcept = default;
+
+	// Getters
+	std::span<const std::byte> GetVertexData() const;
+	const VertexLayout& GetLayout() const;
+	size_t GetVertexCount() const;
+	std::span<const std::byte> GetIndexData() const;
+	uint32_t GetIndexSize() const;
+	size_t GetIndexCount() const;
+	std::span<const meshlet::Meshlet> GetMeshlets() const;
+	std::span<const LodLevel> GetLods() const;
+	const BoundingBox& GetBounds() const;
+	bool IsMapped() const;
+
+	// Setters
+	void SetMeshlets( std::vector<meshlet::Meshlet>&& meshlets );
+	// Empty means the whole index buffer is the only level
+	void SetLods( std::vector<LodLevel>&& lods );
+
+	// Empty unless the vertices use the default layout
+	std::span<const Vertex> GetVertices() const;
+
+	// Empty unless Index matches the stored index size
+	template <IndexType Index>
+	std::span<const Index> GetIndices() const;
+
+	// Calls function with the indices as a span of their stored type
+	template <typename Function>
+	decltype( auto ) VisitIndices( Function&& function ) const;
+
+private:
+	// SOFTWARE RESOURCES
+	std::vector<Vertex> m_Vertices{};
+	std::vector<std::byte> m_VertexBytes{};
+	std::variant<std::vector<uint16_t>, std::vector<uint32_t>> m_Indices{};
+	std::vector<meshlet::Meshlet> m_Meshlets{};
+	std::vector<LodLevel> m_Lods{};
+	MappedFile m_File{};
+	std::span<const std::byte> m_VertexView{};
+	std::span<const std::byte> m_IndexView{};
+	std::span<const meshlet::Meshlet> m_MeshletView{};
+	uint32_t m_IndexSize{ sizeof( uint32_t ) };
+	VertexLayout m_Layout{};
+	BoundingBox m_Bounds{};
+	//
+};
+
+template <IndexType Index>
+std::span<const Index> MeshData::GetIndices() const
+{
+	if ( m_IndexSize != sizeof( Index ) )
+	{
+		return {};
+	}
+	return { reinterpret_cast<const Index*>( m_IndexView.data() ), GetIndexCount() };
+}
+
+template <typename Function>
+decltype( auto ) MeshData::VisitIndices( Function&& function ) const
+{
+	if ( m_IndexSize == sizeof( uint16_t ) )
+	{
+		return function( GetIndices<uint16_t>() );
+	}
+	return function( GetIndices<uint32_t>() );
+}
+} // namespace dae
+#endif
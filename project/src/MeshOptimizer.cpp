@@ -0,0 +1,691 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numbers>
+#include <vector>
+#include "MeshOptimizer.h"
+
+namespace dae
+{
+namespace optimize
+{
+namespace
+{
+template <typename Index>
+Adjacency BuildAdjacencyImpl( std::span<const Index> indices, size_t vertexCount )
+{
+	Adjacency adjacency{};
+	adjacency.offsets.assign( vertexCount + 1, 0 );
+	adjacency.triangles.resize( indices.size() );
+
+	for ( const uint32_t index : indices )
+	{
+		++adjacency.offsets[index + 1];
+	}
+	for ( size_t vertexIdx{}; vertexIdx < vertexCount; ++vertexIdx )
+	{
+		adjacency.offsets[vertexIdx + 1] += adjacency.offsets[vertexIdx];
+	}
+
+	std::vector<uint32_t> cursors( adjacency.offsets.begin(), adjacency.offsets.end() - 1 );
+	for ( size_t cornerIdx{}; cornerIdx < indices.size(); ++cornerIdx )
+	{
+		adjacency.triangles[cursors[indices[cornerIdx]]++] = static_cast<uint32_t>( cornerIdx / 3 );
+	}
+
+	return adjacency;
+}
+// FIFO cache simulated with timestamps, a vertex is cached while fewer than cacheSize misses happened since its own miss
+class CacheSimulator final
+{
+public:
+	CacheSimulator( size_t vertexCount, uint32_t cacheSize )
+		: m_MissTime( vertexCount, 0 )
+		, m_CacheSize( cacheSize )
+		, m_Time( cacheSize + 1 )
+	{
+	}
+
+	// Returns the number of misses
+	template <typename Index>
+	uint32_t Access( const Index* pTriangle )
+	{
+		uint32_t misses{};
+		for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+		{
+			const uint32_t vertex{ pTriangle[cornerIdx] };
+			if ( m_Time - m_MissTime[vertex] > m_CacheSize )
+			{
+				m_MissTime[vertex] = m_Time++;
+				++misses;
+			}
+		}
+		return misses;
+	}
+
+	void Flush()
+	{
+		m_Time += m_CacheSize + 1;
+	}
+
+private:
+	std::vector<uint32_t> m_MissTime{};
+	uint32_t m_CacheSize{};
+	uint32_t m_Time{};
+};
+
+// Area-weighted centroid and normal of a run of triangles
+struct ClusterShape
+{
+	Vector3 weightedCentroid{};
+	Vector3 normal{};
+	float area{};
+};
+
+template <typename Index>
+ClusterShape MeasureCluster( std::span<const Index> indices, std::span<const Vertex> vertices )
+{
+	ClusterShape shape{};
+	for ( size_t cornerIdx{}; cornerIdx + 2 < indices.size(); cornerIdx += 3 )
+	{
+		const Vector3& p0{ vertices[indices[cornerIdx]].position };
+		const Vector3& p1{ vertices[indices[cornerIdx + 1]].position };
+		const Vector3& p2{ vertices[indices[cornerIdx + 2]].position };
+
+		// Points outwards for the winding the parser emits
+		const Vector3 normal{ Vector3::Cross( p1 - p0, p2 - p0 ) };
+		const float area{ normal.Magnitude() };
+
+		shape.weightedCentroid += ( p0 + p1 + p2 ) * ( area / 3.f );
+		shape.normal += normal;
+		shape.area += area;
+	}
+	return shape;
+}
+
+// Top-left style fill rule, of two triangles sharing an edge exactly one owns the pixels on it
+bool OwnsEdge( float dx, float dy )
+{
+	return dy > 0.f || ( dy == 0.f && dx < 0.f );
+}
+
+void RasterizeTriangle( const Vector3& p0,
+						const Vector3& p1,
+						const Vector3& p2,
+						uint32_t resolution,
+						std::vector<float>& depths,
+						OverdrawStatistics& statistics )
+{
+	const float area{ ( p1.x - p0.x ) * ( p2.y - p0.y ) - ( p1.y - p0.y ) * ( p2.x - p0.x ) };
+	if ( area == 0.f )
+	{
+		return;
+	}
+
+	// Make the edge functions positive on the inside
+	const Vector3& a{ p0 };
+	const Vector3& b{ area > 0.f ? p1 : p2 };
+	const Vector3& c{ area > 0.f ? p2 : p1 };
+	const float inverseArea{ 1.f / std::abs( area ) };
+
+	const int minX{ std::max( static_cast<int>( std::floor( std::min( { a.x, b.x, c.x } ) ) ), 0 ) };
+	const int minY{ std::max( static_cast<int>( std::floor( std::min( { a.y, b.y, c.y } ) ) ), 0 ) };
+	const int maxX{ std::min( static_cast<int>( std::ceil( std::max( { a.x, b.x, c.x } ) ) ),
+							  static_cast<int>( resolution ) - 1 ) };
+	const int maxY{ std::min( static_cast<int>( std::ceil( std::max( { a.y, b.y, c.y } ) ) ),
+							  static_cast<int>( resolution ) - 1 ) };
+
+	const bool ownsEdgeA{ OwnsEdge( c.x - b.x, c.y - b.y ) };
+	const bool ownsEdgeB{ OwnsEdge( a.x - c.x, a.y - c.y ) };
+	const bool ownsEdgeC{ OwnsEdge( b.x - a.x, b.y - a.y ) };
+
+	for ( int y{ minY }; y <= maxY; ++y )
+	{
+		for ( int x{ minX }; x <= maxX; ++x )
+		{
+			const float px{ x + 0.5f };
+			const float py{ y + 0.5f };
+
+			const float wA{ ( c.x - b.x ) * ( py - b.y ) - ( c.y - b.y ) * ( px - b.x ) };
+			const float wB{ ( a.x - c.x ) * ( py - c.y ) - ( a.y - c.y ) * ( px - c.x ) };
+			const float wC{ ( b.x - a.x ) * ( py - a.y ) - ( b.y - a.y ) * ( px - a.x ) };
+
+			const bool isInside{ ( wA > 0.f || ( wA == 0.f && ownsEdgeA ) ) && ( wB > 0.f || ( wB == 0.f && ownsEdgeB ) ) &&
+								 ( wC > 0.f || ( wC == 0.f && ownsEdgeC ) ) };
+			if ( !isInside )
+			{
+				continue;
+			}
+
+			const float depth{ ( wA * a.z + wB * b.z + wC * c.z ) * inverseArea };
+			float& storedDepth{ depths[static_cast<size_t>( y ) * resolution + x] };
+			if ( depth < storedDepth )
+			{
+				storedDepth = depth;
+				++statistics.shadedPixels;
+			}
+		}
+	}
+}
+
+// The passes are written once for both index widths, the overloads below forward to them
+template <typename Index>
+VertexCacheStatistics AnalyzeVertexCacheImpl( std::span<const Index> indices, size_t vertexCount, uint32_t cacheSize )
+{
+	VertexCacheStatistics statistics{};
+	if ( indices.size() < 3 || vertexCount == 0 )
+	{
+		return statistics;
+	}
+
+	CacheSimulator cache{ vertexCount, cacheSize };
+	size_t misses{};
+	for ( size_t cornerIdx{}; cornerIdx + 2 < indices.size(); cornerIdx += 3 )
+	{
+		misses += cache.Access( &indices[cornerIdx] );
+	}
+
+	std::vector<bool> isReferenced( vertexCount, false );
+	size_t referencedCount{};
+	for ( const uint32_t index : indices )
+	{
+		if ( !isReferenced[index] )
+		{
+			isReferenced[index] = true;
+			++referencedCount;
+		}
+	}
+
+	statistics.acmr = static_cast<double>( misses ) / static_cast<double>( indices.size() / 3 );
+	statistics.atvr = static_cast<double>( misses ) / static_cast<double>( referencedCount );
+	return statistics;
+}
+
+template <typename Index>
+void OptimizeVertexCacheImpl( std::span<Index> indices, size_t vertexCount, uint32_t cacheSize )
+{
+	const size_t triangleCount{ indices.size() / 3 };
+	if ( triangleCount == 0 || vertexCount == 0 )
+	{
+		return;
+	}
+
+	const Adjacency adjacency{ BuildAdjacency( std::span<const Index>{ indices }, vertexCount ) };
+
+	// Triangles each vertex still has to be emitted in
+	std::vector<uint32_t> liveTriangles( vertexCount );
+	for ( size_t vertexIdx{}; vertexIdx < vertexCount; ++vertexIdx )
+	{
+		liveTriangles[vertexIdx] = adjacency.offsets[vertexIdx + 1] - adjacency.offsets[vertexIdx];
+	}
+
+	std::vector<uint32_t> cacheTime( vertexCount, 0 );
+	std::vector<bool> isEmitted( triangleCount, false );
+	std::vector<uint32_t> deadEnds{};
+	std::vector<uint32_t> candidates{};
+	std::vector<Index> output{};
+	output.reserve( indices.size() );
+
+	uint32_t time{ cacheSize + 1 };
+	size_t scanCursor{};
+	int64_t fanVertex{ indices[0] };
+
+	while ( fanVertex >= 0 )
+	{
+		candidates.clear();
+
+		// Emit every remaining triangle around the fanning vertex
+		for ( uint32_t adjacencyIdx{ adjacency.offsets[fanVertex] }; adjacencyIdx < adjacency.offsets[fanVertex + 1];
+			  ++adjacencyIdx )
+		{
+			const uint32_t triangleIdx{ adjacency.triangles[adjacencyIdx] };
+			if ( isEmitted[triangleIdx] )
+			{
+				continue;
+			}
+			isEmitted[triangleIdx] = true;
+
+			for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+			{
+				const uint32_t vertex{ indices[triangleIdx * 3 + cornerIdx] };
+				output.push_back( static_cast<Index>( vertex ) );
+				deadEnds.push_back( vertex );
+				candidates.push_back( vertex );
+				--liveTriangles[vertex];
+
+				if ( time - cacheTime[vertex] > cacheSize )
+				{
+					cacheTime[vertex] = time++;
+				}
+			}
+		}
+
+		// Prefer the candidate that stays in the cache longest while its remaining triangles are emitted
+		fanVertex = -1;
+		int64_t bestPriority{ -1 };
+		for ( const uint32_t vertex : candidates )
+		{
+			if ( liveTriangles[vertex] == 0 )
+			{
+				continue;
+			}
+
+			int64_t priority{};
+			const int64_t age{ static_cast<int64_t>( time - cacheTime[vertex] ) };
+			if ( age + 2 * static_cast<int64_t>( liveTriangles[vertex] ) <= cacheSize )
+			{
+				priority = age;
+			}
+
+			if ( priority > bestPriority )
+			{
+				bestPriority = priority;
+				fanVertex = vertex;
+			}
+		}
+
+		if ( fanVertex >= 0 )
+		{
+			continue;
+		}
+
+		// Dead end, fall back to recently used vertices, then to the input order
+		while ( !deadEnds.empty() && fanVertex < 0 )
+		{
+			const uint32_t vertex{ deadEnds.back() };
+			deadEnds.pop_back();
+			if ( liveTriangles[vertex] > 0 )
+			{
+				fanVertex = vertex;
+			}
+		}
+
+		while ( fanVertex < 0 && scanCursor < indices.size() )
+		{
+			const uint32_t vertex{ indices[scanCursor++] };
+			if ( liveTriangles[vertex] > 0 )
+			{
+				fanVertex = vertex;
+			}
+		}
+	}
+
+	std::copy( output.begin(), output.end(), indices.begin() );
+}
+
+template <typename Index>
+OverdrawStatistics AnalyzeOverdrawImpl( std::span<const Index> indices,
+										std::span<const Vertex> vertices,
+										uint32_t viewCount,
+										uint32_t resolution )
+{
+	OverdrawStatistics statistics{};
+	if ( indices.size() < 3 || vertices.empty() || viewCount == 0 || resolution == 0 )
+	{
+		return statistics;
+	}
+
+	// Every view uses the same scale, fitted to the bounding sphere around the box center
+	Vector3 boundsMin{ vertices[0].position };
+	Vector3 boundsMax{ vertices[0].position };
+	for ( const Vertex& vertex : vertices )
+	{
+		boundsMin = { std::min( boundsMin.x, vertex.position.x ),
+					  std::min( boundsMin.y, vertex.position.y ),
+					  std::min( boundsMin.z, vertex.position.z ) };
+		boundsMax = { std::max( boundsMax.x, vertex.position.x ),
+					  std::max( boundsMax.y, vertex.position.y ),
+					  std::max( boundsMax.z, vertex.position.z ) };
+	}
+	const Vector3 center{ ( boundsMin + boundsMax ) * 0.5f };
+	const float radius{ std::max( ( boundsMax - boundsMin ).Magnitude() * 0.5f, std::numeric_limits<float>::min() ) };
+	const float scale{ resolution / ( 2.f * radius ) };
+
+	std::vector<Vector3> projected( vertices.size() );
+	std::vector<float> depths( static_cast<size_t>( resolution ) * resolution );
+
+	for ( uint32_t viewIdx{}; viewIdx < viewCount; ++viewIdx )
+	{
+		// Fibonacci sphere
+		const float y{ 1.f - 2.f * ( viewIdx + 0.5f ) / viewCount };
+		const float ringRadius{ std::sqrt( 1.f - y * y ) };
+		const float angle{ viewIdx * std::numbers::pi_v<float> * ( 3.f - std::sqrt( 5.f ) ) };
+		const Vector3 forward{ ringRadius * std::cos( angle ), y, ringRadius * std::sin( angle ) };
+
+		const Vector3 helper{ std::abs( forward.y ) < 0.99f ? Vector3{ 0.f, 1.f, 0.f } : Vector3{ 1.f, 0.f, 0.f } };
+		const Vector3 right{ Vector3::Cross( helper, forward ).Normalized() };
+		const Vector3 up{ Vector3::Cross( forward, right ) };
+
+		for ( size_t vertexIdx{}; vertexIdx < vertices.size(); ++vertexIdx )
+		{
+			const Vector3 offset{ vertices[vertexIdx].position - center };
+			projected[vertexIdx] = { ( Vector3::Dot( offset, right ) + radius ) * scale,
+									 ( Vector3::Dot( offset, up ) + radius ) * scale,
+									 Vector3::Dot( offset, forward ) };
+		}
+
+		std::fill( depths.begin(), depths.end(), std::numeric_limits<float>::infinity() );
+		for ( size_t cornerIdx{}; cornerIdx + 2 < indices.size(); cornerIdx += 3 )
+		{
+			const Vector3& p0{ vertices[indices[cornerIdx]].position };
+			const Vector3& p1{ vertices[indices[cornerIdx + 1]].position };
+			const Vector3& p2{ vertices[indices[cornerIdx + 2]].position };
+			if ( Vector3::Dot( Vector3::Cross( p1 - p0, p2 - p0 ), forward ) >= 0.f )
+			{
+				continue;
+			}
+
+			RasterizeTriangle( projected[indices[cornerIdx]],
+							   projected[indices[cornerIdx + 1]],
+							   projected[indices[cornerIdx + 2]],
+							   resolution,
+							   depths,
+							   statistics );
+		}
+
+		statistics.coveredPixels += std::count_if(
+			depths.begin(), depths.end(), []( float depth ) { return depth != std::numeric_limits<float>::infinity(); } );
+	}
+
+	statistics.overdraw = statistics.coveredPixels == 0 ? 0.0
+														: static_cast<double>( statistics.shadedPixels ) /
+															  static_cast<double>( statistics.coveredPixels );
+	return statistics;
+}
+
+template <typename Index>
+std::vector<uint32_t> SortClustersImpl( std::span<Index> indices,
+										std::span<const Vertex> vertices,
+										std::span<const size_t> boundaries )
+{
+	if ( boundaries.size() < 2 )
+	{
+		return {};
+	}
+
+	// Sort key, how far a cluster sits out along its own normal from the mesh centroid
+	std::vector<ClusterShape> shapes( boundaries.size() - 1 );
+	Vector3 meshCentroid{};
+	float meshArea{};
+	for ( size_t clusterIdx{}; clusterIdx < shapes.size(); ++clusterIdx )
+	{
+		const size_t begin{ boundaries[clusterIdx] * 3 };
+		const size_t end{ boundaries[clusterIdx + 1] * 3 };
+		shapes[clusterIdx] = MeasureCluster( std::span<const Index>{ indices.subspan( begin, end - begin ) }, vertices );
+
+		meshCentroid += shapes[clusterIdx].weightedCentroid;
+		meshArea += shapes[clusterIdx].area;
+	}
+	if ( meshArea > 0.f )
+	{
+		meshCentroid /= meshArea;
+	}
+
+	std::vector<float> sortKeys( shapes.size() );
+	std::vector<uint32_t> clusterOrder( shapes.size() );
+	for ( size_t clusterIdx{}; clusterIdx < shapes.size(); ++clusterIdx )
+	{
+		const ClusterShape& shape{ shapes[clusterIdx] };
+		const float normalLength{ shape.normal.Magnitude() };
+		if ( shape.area > 0.f && normalLength > 0.f )
+		{
+			const Vector3 centroid{ shape.weightedCentroid / shape.area };
+			sortKeys[clusterIdx] = Vector3::Dot( centroid - meshCentroid, shape.normal / normalLength );
+		}
+		clusterOrder[clusterIdx] = static_cast<uint32_t>( clusterIdx );
+	}
+
+	std::stable_sort( clusterOrder.begin(), clusterOrder.end(), [&]( uint32_t lhs, uint32_t rhs ) {
+		return sortKeys[lhs] > sortKeys[rhs];
+	} );
+
+	std::vector<Index> output{};
+	output.reserve( indices.size() );
+	for ( const uint32_t clusterIdx : clusterOrder )
+	{
+		output.insert( output.end(),
+					   indices.begin() + boundaries[clusterIdx] * 3,
+					   indices.begin() + boundaries[clusterIdx + 1] * 3 );
+	}
+	std::copy( output.begin(), output.end(), indices.begin() );
+	return clusterOrder;
+}
+
+template <typename Index>
+void OptimizeOverdrawImpl( std::span<Index> indices, std::span<const Vertex> vertices, float threshold, uint32_t cacheSize )
+{
+	const size_t triangleCount{ indices.size() / 3 };
+	if ( triangleCount == 0 || vertices.empty() )
+	{
+		return;
+	}
+
+	// Hard boundaries, a triangle that misses on all three vertices starts a new fan after a dead end
+	std::vector<size_t> hardBoundaries{ 0 };
+	{
+		CacheSimulator cache{ vertices.size(), cacheSize };
+		for ( size_t triangleIdx{}; triangleIdx < triangleCount; ++triangleIdx )
+		{
+			if ( cache.Access( &indices[triangleIdx * 3] ) == 3 && triangleIdx > 0 )
+			{
+				hardBoundaries.push_back( triangleIdx );
+			}
+		}
+	}
+	hardBoundaries.push_back( triangleCount );
+
+	// Soft boundaries, split every hard cluster as soon as the running ACMR is within threshold of the cluster's own
+	std::vector<size_t> boundaries{};
+	CacheSimulator cache{ vertices.size(), cacheSize };
+	for ( size_t clusterIdx{}; clusterIdx + 1 < hardBoundaries.size(); ++clusterIdx )
+	{
+		const size_t begin{ hardBoundaries[clusterIdx] };
+		const size_t end{ hardBoundaries[clusterIdx + 1] };
+
+		cache.Flush();
+		size_t clusterMisses{};
+		for ( size_t triangleIdx{ begin }; triangleIdx < end; ++triangleIdx )
+		{
+			clusterMisses += cache.Access( &indices[triangleIdx * 3] );
+		}
+		const float limit{ threshold * static_cast<float>( clusterMisses ) / static_cast<float>( end - begin ) };
+
+		const size_t firstBoundary{ boundaries.size() };
+		boundaries.push_back( begin );
+
+		cache.Flush();
+		size_t runningMisses{};
+		size_t runningTriangles{};
+		for ( size_t triangleIdx{ begin }; triangleIdx < end; ++triangleIdx )
+		{
+			runningMisses += cache.Access( &indices[triangleIdx * 3] );
+			++runningTriangles;
+
+			if ( static_cast<float>( runningMisses ) <= limit * static_cast<float>( runningTriangles ) )
+			{
+				boundaries.push_back( triangleIdx + 1 );
+				cache.Flush();
+				runningMisses = 0;
+				runningTriangles = 0;
+			}
+		}
+
+		// The split at the very end would start an empty cluster, a short tail that never got under the limit is
+		// merged into the cluster before it
+		if ( boundaries.back() == end || ( runningTriangles > 0 && boundaries.size() - firstBoundary > 1 ) )
+		{
+			boundaries.pop_back();
+		}
+	}
+	boundaries.push_back( triangleCount );
+
+	SortClustersImpl( indices, vertices, std::span<const size_t>{ boundaries } );
+}
+
+template <typename Index>
+VertexFetchStatistics AnalyzeVertexFetchImpl( std::span<const Index> indices, size_t vertexCount, size_t vertexStride )
+{
+	constexpr size_t cacheLineSize{ 64 };
+	constexpr size_t cacheLineCount{ 16 * 1024 / cacheLineSize };
+
+	VertexFetchStatistics statistics{};
+	if ( indices.size() < 3 || vertexCount == 0 || vertexStride == 0 )
+	{
+		return statistics;
+	}
+
+	std::vector<size_t> cacheTags( cacheLineCount, SIZE_MAX );
+	size_t distinctLines{};
+	size_t fetchedLines{};
+
+	for ( size_t cornerIdx{}; cornerIdx + 2 < indices.size(); cornerIdx += 3 )
+	{
+		// A vertex spans at most a handful of lines, so the distinct ones are collected in a tiny array
+		size_t triangleLines[16]{};
+		size_t triangleLineCount{};
+
+		for ( size_t vertexIdx{}; vertexIdx < 3; ++vertexIdx )
+		{
+			const size_t begin{ indices[cornerIdx + vertexIdx] * vertexStride };
+			for ( size_t line{ begin / cacheLineSize }; line <= ( begin + vertexStride - 1 ) / cacheLineSize; ++line )
+			{
+				size_t& tag{ cacheTags[line % cacheLineCount] };
+				if ( tag != line )
+				{
+					tag = line;
+					++fetchedLines;
+				}
+
+				size_t* pEnd{ triangleLines + triangleLineCount };
+				if ( std::find( triangleLines, pEnd, line ) == pEnd && triangleLineCount < std::size( triangleLines ) )
+				{
+					triangleLines[triangleLineCount++] = line;
+				}
+			}
+		}
+
+		distinctLines += triangleLineCount;
+	}
+
+	statistics.linesPerTriangle = static_cast<double>( distinctLines ) / static_cast<double>( indices.size() / 3 );
+	statistics.overfetch =
+		static_cast<double>( fetchedLines * cacheLineSize ) / static_cast<double>( vertexCount * vertexStride );
+	return statistics;
+}
+
+template <typename Index>
+size_t OptimizeVertexFetchImpl( std::span<Index> indices, std::vector<Vertex>& vertices )
+{
+	constexpr uint32_t Unassigned{ UINT32_MAX };
+
+	std::vector<uint32_t> remap( vertices.size(), Unassigned );
+	std::vector<Vertex> reordered{};
+	reordered.reserve( vertices.size() );
+
+	for ( Index& index : indices )
+	{
+		if ( remap[index] == Unassigned )
+		{
+			remap[index] = static_cast<uint32_t>( reordered.size() );
+			reordered.push_back( vertices[index] );
+		}
+		index = static_cast<Index>( remap[index] );
+	}
+
+	vertices = std::move( reordered );
+	return vertices.size();
+}
+} // namespace
+
+VertexCacheStatistics AnalyzeVertexCache( std::span<const uint16_t> indices, size_t vertexCount, uint32_t cacheSize )
+{
+	return AnalyzeVertexCacheImpl( indices, vertexCount, cacheSize );
+}
+
+VertexCacheStatistics AnalyzeVertexCache( std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize )
+{
+	return AnalyzeVertexCacheImpl( indices, vertexCount, cacheSize );
+}
+
+void OptimizeVertexCache( std::span<uint16_t> indices, size_t vertexCount, uint32_t cacheSize )
+{
+	OptimizeVertexCacheImpl( indices, vertexCount, cacheSize );
+}
+
+void OptimizeVertexCache( std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize )
+{
+	OptimizeVertexCacheImpl( indices, vertexCount, cacheSize );
+}
+
+OverdrawStatistics AnalyzeOverdraw( std::span<const uint16_t> indices,
+									std::span<const Vertex> vertices,
+									uint32_t viewCount,
+									uint32_t resolution )
+{
+	return AnalyzeOverdrawImpl( indices, vertices, viewCount, resolution );
+}
+
+OverdrawStatistics AnalyzeOverdraw( std::span<const uint32_t> indices,
+									std::span<const Vertex> vertices,
+									uint32_t viewCount,
+									uint32_t resolution )
+{
+	return AnalyzeOverdrawImpl( indices, vertices, viewCount, resolution );
+}
+
+void OptimizeOverdraw( std::span<uint16_t> indices, std::span<const Vertex> vertices, float threshold, uint32_t cacheSize )
+{
+	OptimizeOverdrawImpl( indices, vertices, threshold, cacheSize );
+}
+
+void OptimizeOverdraw( std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold, uint32_t cacheSize )
+{
+	OptimizeOverdrawImpl( indices, vertices, threshold, cacheSize );
+}
+
+std::vector<uint32_t> SortClusters( std::span<uint16_t> indices,
+								   std::span<const Vertex> vertices,
+								   std::span<const size_t> boundaries )
+{
+	return SortClustersImpl( indices, vertices, boundaries );
+}
+
+std::vector<uint32_t> SortClusters( std::span<uint32_t> indices,
+								   std::span<const Vertex> vertices,
+								   std::span<const size_t> boundaries )
+{
+	return SortClustersImpl( indices, vertices, boundaries );
+}
+
+VertexFetchStatistics AnalyzeVertexFetch( std::span<const uint16_t> indices, size_t vertexCount, size_t vertexStride )
+{
+	return AnalyzeVertexFetchImpl( indices, vertexCount, vertexStride );
+}
+
+VertexFetchStatistics AnalyzeVertexFetch( std::span<const uint32_t> indices, size_t vertexCount, size_t vertexStride )
+{
+	return AnalyzeVertexFetchImpl( indices, vertexCount, vertexStride );
+}
+
+size_t OptimizeVertexFetch( std::span<uint16_t> indices, std::vector<Vertex>& vertices )
+{
+	return OptimizeVertexFetchImpl( indices, vertices );
+}
+
+size_t OptimizeVertexFetch( std::span<uint32_t> indices, std::vector<Vertex>& vertices )
+{
+	return OptimizeVertexFetchImpl( indices, vertices );
+}
+
+Adjacency BuildAdjacency( std::span<const uint16_t> indices, size_t vertexCount )
+{
+	return BuildAdjacencyImpl( indices, vertexCount );
+}
+
+Adjacency BuildAdjacency( std::span<const uint32_t> indices, size_t vertexCount )
+{
+	return BuildAdjacencyImpl( indices, vertexCount );
+}
+} // namespace optimize
+} // namespace dae
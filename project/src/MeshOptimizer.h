@@ -0,0 +1,105 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+// Index buffer reordering passes, run once when a mesh is cooked
+// Every pass has an overload for 16- and 32-bit indices, both share one implementation
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Structs.h"
+
+namespace dae
+{
+namespace optimize
+{
+// Post-transform cache size the passes optimize for and the statistics are measured with
+constexpr uint32_t DefaultCacheSize{ 16 };
+
+struct VertexCacheStatistics
+{
+	double acmr{}; // transformed vertices per triangle, 0.5 is ideal for large regular meshes
+	double atvr{}; // transformed vertices per referenced vertex, 1.0 is ideal
+};
+
+struct VertexFetchStatistics
+{
+	double linesPerTriangle{}; // distinct cache lines the three vertices of a triangle span
+	double overfetch{};		   // bytes fetched through a small cache / vertex buffer size, 1.0 is ideal
+};
+
+struct OverdrawStatistics
+{
+	size_t coveredPixels{};
+	size_t shadedPixels{};
+	double overdraw{}; // shaded / covered, 1.0 means every covered pixel is shaded once
+};
+
+// Vertex -> triangle adjacency in compressed rows, the triangles around vertex v are
+// triangles[offsets[v]..offsets[v + 1]) in ascending order
+struct Adjacency
+{
+	std::vector<uint32_t> offsets{};
+	std::vector<uint32_t> triangles{};
+};
+
+// Simulates a FIFO post-transform cache
+VertexCacheStatistics AnalyzeVertexCache( std::span<const uint16_t> indices,
+										  size_t vertexCount,
+										  uint32_t cacheSize = DefaultCacheSize );
+VertexCacheStatistics AnalyzeVertexCache( std::span<const uint32_t> indices,
+										  size_t vertexCount,
+										  uint32_t cacheSize = DefaultCacheSize );
+
+// Tipsify (Sander et al. 2007), runs in time linear in the triangle count for any cache size
+// Reorders whole triangles, so the winding of every triangle is preserved
+void OptimizeVertexCache( std::span<uint16_t> indices, size_t vertexCount, uint32_t cacheSize = DefaultCacheSize );
+void OptimizeVertexCache( std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize = DefaultCacheSize );
+
+// Rasterizes the mesh orthographically from viewCount directions spread over a sphere
+// Back faces are culled and depth is tested per pixel in submission order, like the opaque pass with early-z
+OverdrawStatistics AnalyzeOverdraw( std::span<const uint16_t> indices,
+									std::span<const Vertex> vertices,
+									uint32_t viewCount = 16,
+									uint32_t resolution = 256 );
+OverdrawStatistics AnalyzeOverdraw( std::span<const uint32_t> indices,
+									std::span<const Vertex> vertices,
+									uint32_t viewCount = 16,
+									uint32_t resolution = 256 );
+
+// Expects cache-optimized indices, splits them into clusters and draws the clusters that are most likely to occlude
+// the rest first (Sander et al. 2007)
+// Clusters are split until their ACMR is within threshold of the unsplit one, so 1.05 costs at most ~5% ACMR
+void OptimizeOverdraw( std::span<uint16_t> indices,
+					   std::span<const Vertex> vertices,
+					   float threshold = 1.05f,
+					   uint32_t cacheSize = DefaultCacheSize );
+void OptimizeOverdraw( std::span<uint32_t> indices,
+					   std::span<const Vertex> vertices,
+					   float threshold = 1.05f,
+					   uint32_t cacheSize = DefaultCacheSize );
+
+// The sorting half of OptimizeOverdraw for clusters that are already fixed, boundaries are triangle offsets that start
+// with 0 and end with the triangle count
+// Returns the new cluster order, entry i is the old index of the cluster now in position i
+std::vector<uint32_t> SortClusters( std::span<uint16_t> indices,
+								   std::span<const Vertex> vertices,
+								   std::span<const size_t> boundaries );
+std::vector<uint32_t> SortClusters( std::span<uint32_t> indices,
+								   std::span<const Vertex> vertices,
+								   std::span<const size_t> boundaries );
+
+// Both statistics count 64-byte lines, the fetch cache is a 16 KB direct-mapped one
+VertexFetchStatistics AnalyzeVertexFetch( std::span<const uint16_t> indices, size_t vertexCount, size_t vertexStride );
+VertexFetchStatistics AnalyzeVertexFetch( std::span<const uint32_t> indices, size_t vertexCount, size_t vertexStride );
+
+// Renumbers vertices in the order the index buffer first uses them, run after every pass that reorders triangles
+// Unreferenced vertices are dropped, returns the new vertex count
+size_t OptimizeVertexFetch( std::span<uint16_t> indices, std::vector<Vertex>& vertices );
+size_t OptimizeVertexFetch( std::span<uint32_t> indices, std::vector<Vertex>& vertices );
+
+// Shared by the passes here, the simplifier and the tangent generator
+Adjacency BuildAdjacency( std::span<const uint16_t> indices, size_t vertexCount );
+Adjacency BuildAdjacency( std::span<const uint32_t> indices, size_t vertexCount );
+} // namespace optimize
+} // namespace dae
+#endif
@@ -0,0 +1,639 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+namespace dae
+{
+namespace simplify
+{
+namespace
+{
+constexpr uint32_t InvalidVertex{ std::numeric_limits<uint32_t>::max() };
+
+// Open edges get planes perpendicular to their triangle so borders and seams keep their shape
+// Weighted above the triangle planes, which are weighted by area, because a collapse along them is far more visible
+constexpr double EdgeWeight{ 10.0 };
+
+enum class VertexKind : uint8_t
+{
+	Manifold, // only vertex at its position, surrounded by triangles
+	Border,	  // only vertex at its position, on one open edge loop
+	Seam,	  // one of two vertices at its position, both on the same seam
+	Locked	  // corners, non-manifold vertices and seams where more than two vertices meet
+};
+
+// Symmetric plane quadric, evaluates to the weighted sum of squared distances to the planes it was built from
+struct Quadric
+{
+	double a00{};
+	double a11{};
+	double a22{};
+	double a10{};
+	double a20{};
+	double a21{};
+	double b0{};
+	double b1{};
+	double b2{};
+	double c{};
+	double weight{};
+
+	Quadric& operator+=( const Quadric& rhs )
+	{
+		a00 += rhs.a00;
+		a11 += rhs.a11;
+		a22 += rhs.a22;
+		a10 += rhs.a10;
+		a20 += rhs.a20;
+		a21 += rhs.a21;
+		b0 += rhs.b0;
+		b1 += rhs.b1;
+		b2 += rhs.b2;
+		c += rhs.c;
+		weight += rhs.weight;
+		return *this;
+	}
+};
+
+// normal has to be normalized
+Quadric CreatePlaneQuadric( const Vector3& normal, const Vector3& point, double weight )
+{
+	const double a{ normal.x };
+	const double b{ normal.y };
+	const double c{ normal.z };
+	const double d{ -( a * point.x + b * point.y + c * point.z ) };
+
+	Quadric quadric{};
+	quadric.a00 = a * a * weight;
+	quadric.a11 = b * b * weight;
+	quadric.a22 = c * c * weight;
+	quadric.a10 = a * b * weight;
+	quadric.a20 = a * c * weight;
+	quadric.a21 = b * c * weight;
+	quadric.b0 = a * d * weight;
+	quadric.b1 = b * d * weight;
+	quadric.b2 = c * d * weight;
+	quadric.c = d * d * weight;
+	quadric.weight = weight;
+	return quadric;
+}
+
+// Weighted mean squared distance of point to the planes
+double Evaluate( const Quadric& quadric, const Vector3& point )
+{
+	const double x{ point.x };
+	const double y{ point.y };
+	const double z{ point.z };
+
+	double rx{ quadric.b0 + quadric.a10 * y };
+	double ry{ quadric.b1 + quadric.a21 * z };
+	double rz{ quadric.b2 + quadric.a20 * x };
+	rx = rx * 2 + quadric.a00 * x;
+	ry = ry * 2 + quadric.a11 * y;
+	rz = rz * 2 + quadric.a22 * z;
+
+	const double result{ quadric.c + rx * x + ry * y + rz * z };
+	return quadric.weight > 0 ? std::abs( result ) / quadric.weight : 0;
+}
+
+// How the input vertices are connected, computed once per Simplify call
+struct Topology
+{
+	std::vector<uint32_t> groups{};	  // lowest vertex index at the same position
+	std::vector<uint32_t> wedges{};	  // next vertex at the same position, circular
+	std::vector<uint32_t> openNext{}; // target of the vertex's open outgoing edge, if it has exactly one
+	std::vector<uint32_t> openPrev{}; // source of the vertex's open incoming edge, if it has exactly one
+	std::vector<VertexKind> kinds{};
+};
+
+// Exact, welding already merged every position that is meant to be shared
+bool IsSamePosition( const Vector3& a, const Vector3& b )
+{
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+void BuildPositionGroups( std::span<const Vertex> vertices, Topology& topology )
+{
+	std::vector<uint32_t> order( vertices.size() );
+	std::iota( order.begin(), order.end(), 0 );
+	std::sort( order.begin(), order.end(), [&]( uint32_t lhs, uint32_t rhs ) {
+		const Vector3& a{ vertices[lhs].position };
+		const Vector3& b{ vertices[rhs].position };
+		if ( a.x != b.x )
+		{
+			return a.x < b.x;
+		}
+		if ( a.y != b.y )
+		{
+			return a.y < b.y;
+		}
+		if ( a.z != b.z )
+		{
+			return a.z < b.z;
+		}
+		return lhs < rhs;
+	} );
+
+	topology.groups.resize( vertices.size() );
+	topology.wedges.resize( vertices.size() );
+	for ( size_t runStart{}; runStart < order.size(); )
+	{
+		const Vector3& position{ vertices[order[runStart]].position };
+		size_t runEnd{ runStart + 1 };
+		while ( runEnd < order.size() && IsSamePosition( vertices[order[runEnd]].position, position ) )
+		{
+			++runEnd;
+		}
+
+		for ( size_t orderIdx{ runStart }; orderIdx < runEnd; ++orderIdx )
+		{
+			topology.groups[order[orderIdx]] = order[runStart];
+			topology.wedges[order[orderIdx]] = order[orderIdx + 1 < runEnd ? orderIdx + 1 : runStart];
+		}
+		runStart = runEnd;
+	}
+}
+
+// An edge is open when no triangle uses it in the opposite direction with the same two vertices, which is the case on
+// borders and, because the vertices differ on either side, on seams
+void ClassifyVertices( std::span<const uint32_t> indices, size_t vertexCount, Topology& topology )
+{
+	std::vector<uint32_t> offsets( vertexCount + 1, 0 );
+	for ( const uint32_t index : indices )
+	{
+		++offsets[index + 1];
+	}
+	std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+
+	std::vector<uint32_t> targets( indices.size() );
+	std::vector<uint32_t> cursors( offsets.begin(), offsets.end() - 1 );
+	for ( size_t cornerIdx{}; cornerIdx < indices.size(); ++cornerIdx )
+	{
+		const size_t nextIdx{ cornerIdx % 3 == 2 ? cornerIdx - 2 : cornerIdx + 1 };
+		targets[cursors[indices[cornerIdx]]++] = indices[nextIdx];
+	}
+
+	const auto hasEdge{ [&]( uint32_t from, uint32_t to ) {
+		return std::find( targets.begin() + offsets[from], targets.begin() + offsets[from + 1], to ) !=
+			   targets.begin() + offsets[from + 1];
+	} };
+
+	std::vector<uint8_t> openOut( vertexCount, 0 );
+	std::vector<uint8_t> openIn( vertexCount, 0 );
+	topology.openNext.assign( vertexCount, InvalidVertex );
+	topology.openPrev.assign( vertexCount, InvalidVertex );
+	for ( uint32_t from{}; from < vertexCount; ++from )
+	{
+		for ( uint32_t edgeIdx{ offsets[from] }; edgeIdx < offsets[from + 1]; ++edgeIdx )
+		{
+			const uint32_t to{ targets[edgeIdx] };
+			if ( !hasEdge( to, from ) )
+			{
+				openOut[from] = static_cast<uint8_t>( std::min( openOut[from] + 1, 2 ) );
+				openIn[to] = static_cast<uint8_t>( std::min( openIn[to] + 1, 2 ) );
+				topology.openNext[from] = to;
+				topology.openPrev[to] = from;
+			}
+		}
+	}
+
+	const auto isOnSingleLoop{ [&]( uint32_t vertex ) { return openOut[vertex] == 1 && openIn[vertex] == 1; } };
+
+	topology.kinds.assign( vertexCount, VertexKind::Locked );
+	for ( uint32_t vertex{}; vertex < vertexCount; ++vertex )
+	{
+		const uint32_t twin{ topology.wedges[vertex] };
+		if ( twin == vertex )
+		{
+			if ( openOut[vertex] == 0 && openIn[vertex] == 0 )
+			{
+				topology.kinds[vertex] = VertexKind::Manifold;
+			}
+			else if ( isOnSingleLoop( vertex ) )
+			{
+				topology.kinds[vertex] = VertexKind::Border;
+			}
+		}
+		else if ( topology.wedges[twin] == vertex && isOnSingleLoop( vertex ) && isOnSingleLoop( twin ) )
+		{
+			// Both sides have to run along the same positions, otherwise the pair is on a border as well
+			const std::vector<uint32_t>& groups{ topology.groups };
+			if ( groups[topology.openNext[vertex]] == groups[topology.openPrev[twin]] &&
+				 groups[topology.openPrev[vertex]] == groups[topology.openNext[twin]] )
+			{
+				topology.kinds[vertex] = VertexKind::Seam;
+			}
+		}
+	}
+}
+
+std::vector<Quadric> BuildQuadrics( std::span<const uint32_t> indices,
+									std::span<const Vertex> vertices,
+									const Topology& topology )
+{
+	std::vector<Quadric> quadrics( vertices.size() );
+	for ( size_t triangleIdx{}; triangleIdx < indices.size() / 3; ++triangleIdx )
+	{
+		const uint32_t* pTriangle{ &indices[triangleIdx * 3] };
+		const Vector3& p0{ vertices[pTriangle[0]].position };
+		const Vector3& p1{ vertices[pTriangle[1]].position };
+		const Vector3& p2{ vertices[pTriangle[2]].position };
+
+		Vector3 normal{ Vector3::Cross( p1 - p0, p2 - p0 ) };
+		const float doubleArea{ normal.Normalize() };
+		if ( doubleArea <= 0.f )
+		{
+			continue;
+		}
+
+		const Quadric plane{ CreatePlaneQuadric( normal, p0, doubleArea * 0.5 ) };
+		for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+		{
+			quadrics[topology.groups[pTriangle[cornerIdx]]] += plane;
+		}
+
+		for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+		{
+			const uint32_t from{ pTriangle[cornerIdx] };
+			const uint32_t to{ pTriangle[( cornerIdx + 1 ) % 3] };
+			if ( topology.openNext[from] != to )
+			{
+				continue;
+			}
+
+			// Perpendicular to both the edge and the triangle, through the edge
+			const Vector3& a{ vertices[from].position };
+			const Vector3& b{ vertices[to].position };
+			Vector3 edge{ b - a };
+			const float length{ edge.Normalize() };
+			Vector3 edgeNormal{ Vector3::Cross( edge, normal ) };
+			if ( length <= 0.f || edgeNormal.Normalize() <= 0.f )
+			{
+				continue;
+			}
+
+			const Quadric edgePlane{ CreatePlaneQuadric( edgeNormal, a, length * EdgeWeight ) };
+			quadrics[topology.groups[from]] += edgePlane;
+			quadrics[topology.groups[to]] += edgePlane;
+		}
+	}
+	return quadrics;
+}
+
+// Border and seam vertices only slide along their own open edges, which keeps the open loop closed
+bool CanCollapse( const Topology& topology, uint32_t from, uint32_t to )
+{
+	switch ( topology.kinds[from] )
+	{
+	case VertexKind::Manifold:
+		return true;
+	case VertexKind::Border:
+	case VertexKind::Seam:
+		return to == topology.openNext[from] || to == topology.openPrev[from];
+	default:
+		return false;
+	}
+}
+
+struct Collapse
+{
+	uint32_t from{};
+	uint32_t to{};
+	double error{};
+};
+
+// Moves every vertex at from's position to to's position and checks that no surviving triangle turns over
+// Returns the number of triangles the collapse removes, or nothing when it has to be rejected
+std::optional<uint32_t> TryCollapse( std::span<const uint32_t> indices,
+									 std::span<const Vertex> vertices,
+									 const Topology& topology,
+									 const optimize::Adjacency& adjacency,
+									 uint32_t from,
+									 uint32_t to )
+{
+	const uint32_t fromGroup{ topology.groups[from] };
+	const uint32_t toGroup{ topology.groups[to] };
+	const Vector3& target{ vertices[to].position };
+
+	uint32_t removedCount{};
+	uint32_t wedge{ from };
+	do
+	{
+		for ( uint32_t adjacentIdx{ adjacency.offsets[wedge] }; adjacentIdx < adjacency.offsets[wedge + 1];
+			  ++adjacentIdx )
+		{
+			const uint32_t* pTriangle{ &indices[adjacency.triangles[adjacentIdx] * 3] };
+
+			Vector3 before[3]{};
+			Vector3 after[3]{};
+			bool isRemoved{};
+			for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+			{
+				const uint32_t group{ topology.groups[pTriangle[cornerIdx]] };
+				before[cornerIdx] = vertices[pTriangle[cornerIdx]].position;
+				after[cornerIdx] = group == fromGroup ? target : before[cornerIdx];
+				isRemoved = isRemoved || group == toGroup;
+			}
+
+			if ( isRemoved )
+			{
+				++removedCount;
+				continue;
+			}
+
+			const Vector3 normalBefore{ Vector3::Cross( before[1] - before[0], before[2] - before[0] ) };
+			const Vector3 normalAfter{ Vector3::Cross( after[1] - after[0], after[2] - after[0] ) };
+			const float dot{ Vector3::Dot( normalBefore, normalAfter ) };
+			if ( dot <= 1e-2f * normalBefore.Magnitude() * normalAfter.Magnitude() )
+			{
+				return std::nullopt;
+			}
+		}
+		wedge = topology.wedges[wedge];
+	}
+	while ( wedge != from );
+
+	return removedCount;
+}
+
+void LockNeighbourhood( std::span<const uint32_t> indices,
+						const Topology& topology,
+						const optimize::Adjacency& adjacency,
+						uint32_t vertex,
+						std::vector<bool>& isLocked )
+{
+	uint32_t wedge{ vertex };
+	do
+	{
+		for ( uint32_t adjacentIdx{ adjacency.offsets[wedge] }; adjacentIdx < adjacency.offsets[wedge + 1];
+			  ++adjacentIdx )
+		{
+			const uint32_t* pTriangle{ &indices[adjacency.triangles[adjacentIdx] * 3] };
+			for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+			{
+				isLocked[topology.groups[pTriangle[cornerIdx]]] = true;
+			}
+		}
+		wedge = topology.wedges[wedge];
+	}
+	while ( wedge != vertex );
+}
+
+// Works on 32-bit indices internally, the narrow overload only converts at the ends
+float SimplifyIndices( std::vector<uint32_t>& indices,
+					   std::span<const Vertex> vertices,
+					   size_t targetIndexCount,
+					   float maxError )
+{
+	Topology topology{};
+	BuildPositionGroups( vertices, topology );
+	ClassifyVertices( indices, vertices.size(), topology );
+	std::vector<Quadric> quadrics{ BuildQuadrics( indices, vertices, topology ) };
+
+	const double maxSquaredError{ double{ maxError } * maxError };
+	double resultError{};
+
+	std::vector<Collapse> collapses{};
+	std::vector<uint32_t> remap( vertices.size() );
+	std::vector<bool> isLocked( vertices.size() );
+	bool isPassBounded{ true };
+	while ( indices.size() > targetIndexCount )
+	{
+		const optimize::Adjacency adjacency{ optimize::BuildAdjacency( indices, vertices.size() ) };
+
+		// Each edge is costed in both directions, the cheaper one is the candidate
+		// Interior edges show up in both their triangles, only the one where a < b is kept
+		collapses.clear();
+		for ( size_t cornerIdx{}; cornerIdx < indices.size(); ++cornerIdx )
+		{
+			const uint32_t a{ indices[cornerIdx] };
+			const uint32_t b{ indices[cornerIdx % 3 == 2 ? cornerIdx - 2 : cornerIdx + 1] };
+			if ( a > b && topology.openNext[a] != b )
+			{
+				continue;
+			}
+			const double errorAB{ CanCollapse( topology, a, b )
+									  ? Evaluate( quadrics[topology.groups[a]], vertices[b].position )
+									  : std::numeric_limits<double>::infinity() };
+			const double errorBA{ CanCollapse( topology, b, a )
+									  ? Evaluate( quadrics[topology.groups[b]], vertices[a].position )
+									  : std::numeric_limits<double>::infinity() };
+			if ( std::min( errorAB, errorBA ) <= maxSquaredError )
+			{
+				collapses.push_back( errorAB <= errorBA ? Collapse{ a, b, errorAB } : Collapse{ b, a, errorBA } );
+			}
+		}
+		if ( collapses.empty() )
+		{
+			break;
+		}
+
+		// Locking skips many of the cheapest collapses, a pass stops well before the expensive end of the list because
+		// the next pass offers cheaper ones again, so only the part below the bound is sorted
+		const auto isCheaper{ []( const Collapse& lhs, const Collapse& rhs ) { return lhs.error < rhs.error; } };
+		const size_t goalTriangles{ ( indices.size() - targetIndexCount ) / 3 };
+		double passMaxError{ maxSquaredError };
+		if ( isPassBounded )
+		{
+			const auto bound{ collapses.begin() + std::min( goalTriangles / 2, collapses.size() - 1 ) };
+			std::nth_element( collapses.begin(), bound, collapses.end(), isCheaper );
+			passMaxError = bound->error * 1.5;
+		}
+		const auto passEnd{ std::partition( collapses.begin(), collapses.end(), [&]( const Collapse& collapse ) {
+			return collapse.error <= passMaxError;
+		} ) };
+		std::sort( collapses.begin(), passEnd, isCheaper );
+
+		// Only the triangles around from change, locking its neighbours keeps those of other collapses in the same pass
+		// apart, so their flip tests stay valid
+		std::iota( remap.begin(), remap.end(), 0 );
+		std::fill( isLocked.begin(), isLocked.end(), false );
+		size_t removedTriangles{};
+		size_t collapseCount{};
+		for ( const Collapse& collapse : std::span<const Collapse>{ collapses.begin(), passEnd } )
+		{
+			if ( removedTriangles >= goalTriangles )
+			{
+				break;
+			}
+			if ( isLocked[topology.groups[collapse.from]] || isLocked[topology.groups[collapse.to]] )
+			{
+				continue;
+			}
+
+			// The other side of a seam moves along its own copy of the edge
+			uint32_t twinFrom{ InvalidVertex };
+			uint32_t twinTo{ InvalidVertex };
+			if ( topology.kinds[collapse.from] == VertexKind::Seam )
+			{
+				twinFrom = topology.wedges[collapse.from];
+				twinTo = collapse.to == topology.openNext[collapse.from] ? topology.openPrev[twinFrom]
+																		 : topology.openNext[twinFrom];
+				if ( topology.groups[twinTo] != topology.groups[collapse.to] )
+				{
+					continue;
+				}
+			}
+
+			const std::optional<uint32_t> removedCount{
+				TryCollapse( indices, vertices, topology, adjacency, collapse.from, collapse.to ) };
+			if ( !removedCount )
+			{
+				continue;
+			}
+
+			LockNeighbourhood( indices, topology, adjacency, collapse.from, isLocked );
+			isLocked[topology.groups[collapse.to]] = true;
+
+			remap[collapse.from] = collapse.to;
+			if ( twinFrom != InvalidVertex )
+			{
+				remap[twinFrom] = twinTo;
+			}
+			quadrics[topology.groups[collapse.to]] += quadrics[topology.groups[collapse.from]];
+
+			removedTriangles += *removedCount;
+			resultError = std::max( resultError, collapse.error );
+			++collapseCount;
+		}
+
+		// Every cheap collapse can be rejected by the flip test, the rest of the list gets one more chance
+		if ( collapseCount == 0 )
+		{
+			if ( !isPassBounded )
+			{
+				break;
+			}
+			isPassBounded = false;
+			continue;
+		}
+		isPassBounded = true;
+
+		// Triangles with two corners at the same position have no area left
+		size_t writeIdx{};
+		for ( size_t readIdx{}; readIdx < indices.size(); readIdx += 3 )
+		{
+			const uint32_t i0{ remap[indices[readIdx]] };
+			const uint32_t i1{ remap[indices[readIdx + 1]] };
+			const uint32_t i2{ remap[indices[readIdx + 2]] };
+			const uint32_t g0{ topology.groups[i0] };
+			const uint32_t g1{ topology.groups[i1] };
+			const uint32_t g2{ topology.groups[i2] };
+			if ( g0 == g1 || g1 == g2 || g2 == g0 )
+			{
+				continue;
+			}
+			indices[writeIdx++] = i0;
+			indices[writeIdx++] = i1;
+			indices[writeIdx++] = i2;
+		}
+		indices.resize( writeIdx );
+	}
+
+	return static_cast<float>( std::sqrt( resultError ) );
+}
+
+template <typename Index>
+float SimplifyImpl( std::span<const Index> indices,
+					std::span<const Vertex> vertices,
+					size_t targetIndexCount,
+					float maxError,
+					std::vector<Index>& result )
+{
+	std::vector<uint32_t> work( indices.begin(), indices.end() );
+	const float error{ SimplifyIndices( work, vertices, targetIndexCount, maxError ) };
+	result.assign( work.begin(), work.end() );
+	return error;
+}
+
+template <typename Index>
+std::vector<LodLevel> BuildLodChainImpl( std::vector<Index>& indices,
+										 std::span<const Vertex> vertices,
+										 uint32_t lodCount,
+										 float maxRelativeError )
+{
+	std::vector<LodLevel> lods{ LodLevel{ 0, static_cast<uint32_t>( indices.size() ), 0.f } };
+
+	const BoundingBox bounds{ BoundingBox::Create( vertices ) };
+	const Vector3 extent{ bounds.max - bounds.min };
+	const float maxError{ std::max( { extent.x, extent.y, extent.z } ) * maxRelativeError };
+
+	// Each level starts from the previous one, so its error bound is the sum of the errors so far
+	std::vector<Index> previous( indices.begin(), indices.end() );
+	float error{};
+	while ( lods.size() < std::min( lodCount, MaxLodCount ) )
+	{
+		std::vector<Index> level{};
+		const float levelError{
+			SimplifyImpl<Index>( previous, vertices, previous.size() / 6 * 3, maxError - error, level ) };
+		if ( level.empty() || level.size() * 5 > previous.size() * 4 )
+		{
+			break;
+		}
+
+		optimize::OptimizeVertexCache( std::span<Index>{ level }, vertices.size() );
+		error += levelError;
+		lods.push_back(
+			LodLevel{ static_cast<uint32_t>( indices.size() ), static_cast<uint32_t>( level.size() ), error } );
+		indices.insert( indices.end(), level.begin(), level.end() );
+		previous = std::move( level );
+	}
+	return lods;
+}
+} // namespace
+
+float Simplify( std::span<const uint16_t> indices,
+				std::span<const Vertex> vertices,
+				size_t targetIndexCount,
+				float maxError,
+				std::vector<uint16_t>& result )
+{
+	return SimplifyImpl( indices, vertices, targetIndexCount, maxError, result );
+}
+
+float Simplify( std::span<const uint32_t> indices,
+				std::span<const Vertex> vertices,
+				size_t targetIndexCount,
+				float maxError,
+				std::vector<uint32_t>& result )
+{
+	return SimplifyImpl( indices, vertices, targetIndexCount, maxError, result );
+}
+
+std::vector<LodLevel> BuildLodChain( std::vector<uint16_t>& indices,
+									 std::span<const Vertex> vertices,
+									 uint32_t lodCount,
+									 float maxRelativeError )
+{
+	return BuildLodChainImpl( indices, vertices, lodCount, maxRelativeError );
+}
+
+std::vector<LodLevel> BuildLodChain( std::vector<uint32_t>& indices,
+									 std::span<const Vertex> vertices,
+									 uint32_t lodCount,
+									 float maxRelativeError )
+{
+	return BuildLodChainImpl( indices, vertices, lodCount, maxRelativeError );
+}
+
+uint32_t SelectLod( std::span<const LodLevel> lods, float distance, float fov, float threshold )
+{
+	if ( distance <= 0.f )
+	{
+		return 0;
+	}
+
+	// The error covers error / ( distance * fov ) of half the viewport height
+	const float maxError{ threshold * distance * fov };
+	uint32_t result{};
+	for ( uint32_t lodIdx{ 1 }; lodIdx < lods.size() && lods[lodIdx].error <= maxError; ++lodIdx )
+	{
+		result = lodIdx;
+	}
+	return result;
+}
+} // namespace simplify
+} // namespace dae
@@ -0,0 +1,59 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+// Quadric error simplification (Garland and Heckbert 1997), run once when a mesh is cooked
+// Collapses move a vertex onto a neighbour, so every level reuses the original vertex buffer
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "MeshData.h"
+#include "Structs.h"
+
+namespace dae
+{
+namespace simplify
+{
+// Levels stored per mesh, including the full-detail one
+constexpr uint32_t MaxLodCount{ 5 };
+
+// Collapses are rejected once they move the surface further than this fraction of the largest bounds extent
+constexpr float DefaultMaxError{ 0.05f };
+
+// Projected error, as a fraction of half the viewport height, a level may have before a finer one is drawn instead
+// 1/540 is about a pixel at 1080p
+constexpr float DefaultLodThreshold{ 1.f / 540.f };
+
+// Collapses edges in order of increasing quadric error until at most targetIndexCount indices are left or the next
+// collapse would exceed maxError, an absolute distance in the mesh's object space
+// Vertices that share a position but not attributes are seams, they only move along the seam and together, so UV and
+// normal discontinuities stay closed; open borders only move along the border and corners never move
+// Returns the largest error of any collapse done
+float Simplify( std::span<const uint16_t> indices,
+				std::span<const Vertex> vertices,
+				size_t targetIndexCount,
+				float maxError,
+				std::vector<uint16_t>& result );
+float Simplify( std::span<const uint32_t> indices,
+				std::span<const Vertex> vertices,
+				size_t targetIndexCount,
+				float maxError,
+				std::vector<uint32_t>& result );
+
+// Halves the triangle count per level, each level is simplified from the previous one, cache-optimized and appended to
+// indices; the first returned level is the input range
+// Stops early once a level cannot get below 80% of the previous one within maxRelativeError
+std::vector<LodLevel> BuildLodChain( std::vector<uint16_t>& indices,
+									 std::span<const Vertex> vertices,
+									 uint32_t lodCount = MaxLodCount,
+									 float maxRelativeError = DefaultMaxError );
+std::vector<LodLevel> BuildLodChain( std::vector<uint32_t>& indices,
+									 std::span<const Vertex> vertices,
+									 uint32_t lodCount = MaxLodCount,
+									 float maxRelativeError = DefaultMaxError );
+
+// Coarsest level whose error, seen from distance through a camera with the given tangent of half the vertical fov,
+// covers at most threshold of half the viewport height; the first level is picked when distance is not positive
+uint32_t SelectLod( std::span<const LodLevel> lods, float distance, float fov, float threshold = DefaultLodThreshold );
+} // namespace simplify
+} // namespace dae
+#endif
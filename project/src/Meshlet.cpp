@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <xmmintrin.h>
+#include "MeshOptimizer.h"
+#include "Meshlet.h"
+
+namespace dae
+{
+namespace meshlet
+{
+namespace
+{
+template <typename Index>
+Meshlet CreateMeshlet( std::span<const Index> indices,
+					   std::span<const Vertex> vertices,
+					   size_t firstTriangle,
+					   size_t endTriangle,
+					   uint32_t vertexCount )
+{
+	Meshlet meshlet{};
+	meshlet.firstIndex = static_cast<uint32_t>( firstTriangle * 3 );
+	meshlet.triangleCount = static_cast<uint32_t>( endTriangle - firstTriangle );
+	meshlet.vertexCount = vertexCount;
+
+	const std::span<const Index> corners{ indices.subspan( firstTriangle * 3, ( endTriangle - firstTriangle ) * 3 ) };
+
+	// Sphere around the box center, looser than a minimal one but only a few percent on typical clusters
+	Vector3 boundsMin{ vertices[corners[0]].position };
+	Vector3 boundsMax{ boundsMin };
+	for ( const Index index : corners )
+	{
+		const Vector3& position{ vertices[index].position };
+		boundsMin = { std::min( boundsMin.x, position.x ),
+					  std::min( boundsMin.y, position.y ),
+					  std::min( boundsMin.z, position.z ) };
+		boundsMax = { std::max( boundsMax.x, position.x ),
+					  std::max( boundsMax.y, position.y ),
+					  std::max( boundsMax.z, position.z ) };
+	}
+
+	const Vector3 center{ ( boundsMin + boundsMax ) * 0.5f };
+	float radius{};
+	for ( const Index index : corners )
+	{
+		radius = std::max( radius, ( vertices[index].position - center ).Magnitude() );
+	}
+
+	// Normal cone, the axis averages the unit triangle normals and the cutoff comes from the widest one
+	std::vector<Vector3> normals{};
+	normals.reserve( meshlet.triangleCount );
+	Vector3 axis{};
+	for ( size_t cornerIdx{}; cornerIdx + 2 < corners.size(); cornerIdx += 3 )
+	{
+		const Vector3& p0{ vertices[corners[cornerIdx]].position };
+		const Vector3& p1{ vertices[corners[cornerIdx + 1]].position };
+		const Vector3& p2{ vertices[corners[cornerIdx + 2]].position };
+
+		// Points outwards for the winding the parser emits
+		const Vector3 normal{ Vector3::Cross( p1 - p0, p2 - p0 ) };
+		const float length{ normal.Magnitude() };
+		if ( length > 0.f )
+		{
+			normals.push_back( normal / length );
+			axis += normals.back();
+		}
+	}
+
+	float minDot{ -1.f };
+	const float axisLength{ axis.Magnitude() };
+	if ( axisLength > 0.f )
+	{
+		axis /= axisLength;
+		minDot = 1.f;
+		for ( const Vector3& normal : normals )
+		{
+			minDot = std::min( minDot, Vector3::Dot( axis, normal ) );
+		}
+	}
+
+	meshlet.center[0] = center.x;
+	meshlet.center[1] = center.y;
+	meshlet.center[2] = center.z;
+	meshlet.radius = radius;
+	meshlet.coneAxis[0] = axis.x;
+	meshlet.coneAxis[1] = axis.y;
+	meshlet.coneAxis[2] = axis.z;
+
+	// Cones close to a hemisphere almost never pass the test, they are not worth the precision trouble
+	meshlet.coneCutoff = minDot <= 0.1f ? 1.f : std::sqrt( 1.f - minDot * minDot );
+	return meshlet;
+}
+
+template <typename Index>
+std::vector<Meshlet> BuildImpl( std::span<const Index> indices,
+								std::span<const Vertex> vertices,
+								uint32_t maxVertices,
+								uint32_t maxTriangles )
+{
+	std::vector<Meshlet> meshlets{};
+	const size_t triangleCount{ indices.size() / 3 };
+	if ( triangleCount == 0 || vertices.empty() || maxVertices < 3 || maxTriangles == 0 )
+	{
+		return meshlets;
+	}
+
+	// Meshlet each vertex was last counted in, so nothing has to be cleared between meshlets
+	std::vector<uint32_t> lastMeshlet( vertices.size(), UINT32_MAX );
+	uint32_t meshletIdx{};
+	uint32_t vertexCount{};
+	size_t firstTriangle{};
+
+	for ( size_t triangleIdx{}; triangleIdx < triangleCount; ++triangleIdx )
+	{
+		const Index* pTriangle{ &indices[triangleIdx * 3] };
+
+		uint32_t newVertexCount{};
+		for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+		{
+			newVertexCount += lastMeshlet[pTriangle[cornerIdx]] != meshletIdx;
+		}
+
+		if ( vertexCount + newVertexCount > maxVertices || triangleIdx - firstTriangle == maxTriangles )
+		{
+			meshlets.push_back( CreateMeshlet( indices, vertices, firstTriangle, triangleIdx, vertexCount ) );
+			firstTriangle = triangleIdx;
+			vertexCount = 0;
+			++meshletIdx;
+		}
+
+		for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+		{
+			uint32_t& last{ lastMeshlet[pTriangle[cornerIdx]] };
+			if ( last != meshletIdx )
+			{
+				last = meshletIdx;
+				++vertexCount;
+			}
+		}
+	}
+	meshlets.push_back( CreateMeshlet( indices, vertices, firstTriangle, triangleCount, vertexCount ) );
+
+	return meshlets;
+}
+
+template <typename Index>
+void SortForOverdrawImpl( std::span<Index> indices, std::span<const Vertex> vertices, std::vector<Meshlet>& meshlets )
+{
+	if ( meshlets.empty() )
+	{
+		return;
+	}
+
+	std::vector<size_t> boundaries{};
+	boundaries.reserve( meshlets.size() + 1 );
+	for ( const Meshlet& meshlet : meshlets )
+	{
+		boundaries.push_back( meshlet.firstIndex / 3 );
+	}
+	boundaries.push_back( meshlets.back().firstIndex / 3 + meshlets.back().triangleCount );
+
+	const std::vector<uint32_t> order{ optimize::SortClusters( indices, vertices, boundaries ) };
+
+	std::vector<Meshlet> sorted{};
+	sorted.reserve( meshlets.size() );
+	uint32_t firstIndex{};
+	for ( const uint32_t meshletIdx : order )
+	{
+		sorted.push_back( meshlets[meshletIdx] );
+		sorted.back().firstIndex = firstIndex;
+		firstIndex += sorted.back().triangleCount * 3;
+	}
+	meshlets = std::move( sorted );
+}
+} // namespace
+
+CullView CullView::Create( const Matrix& world, const Matrix& viewProjection, const Vector3& cameraOrigin )
+{
+	// Row vectors, so clip = object * worldViewProjection and every plane is a sum of two columns
+	const Matrix worldViewProjection{ world * viewProjection };
+	const auto column{ [&]( int columnIdx ) {
+		return Vector4{ worldViewProjection[0][columnIdx],
+						worldViewProjection[1][columnIdx],
+						worldViewProjection[2][columnIdx],
+						worldViewProjection[3][columnIdx] };
+	} };
+
+	const Vector4 x{ column( 0 ) };
+	const Vector4 y{ column( 1 ) };
+	const Vector4 z{ column( 2 ) };
+	const Vector4 w{ column( 3 ) };
+
+	// Left, right, bottom, top, near ( z >= 0 ), far
+	const Vector4 planes[6]{ w + x, w - x, w + y, w - y, z, w - z };
+
+	CullView view{};
+	for ( size_t planeIdx{}; planeIdx < 6; ++planeIdx )
+	{
+		const Vector4& plane{ planes[planeIdx] };
+		const float length{ plane.GetXYZ().Magnitude() };
+		const float inverseLength{ length > 0.f ? 1.f / length : 0.f };
+
+		view.planes[planeIdx][0] = plane.x * inverseLength;
+		view.planes[planeIdx][1] = plane.y * inverseLength;
+		view.planes[planeIdx][2] = plane.z * inverseLength;
+		view.planes[planeIdx][3] = plane.w * inverseLength;
+	}
+
+	view.cameraPosition = Matrix::Inverse( world ).TransformPoint( cameraOrigin );
+	return view;
+}
+
+CullStatistics& CullStatistics::operator+=( const CullStatistics& rhs )
+{
+	meshletCount += rhs.meshletCount;
+	visibleMeshletCount += rhs.visibleMeshletCount;
+	triangleCount += rhs.triangleCount;
+	backfaceCulledTriangles += rhs.backfaceCulledTriangles;
+	frustumCulledTriangles += rhs.frustumCulledTriangles;
+	rangeCount += rhs.rangeCount;
+	cullMs += rhs.cullMs;
+	return *this;
+}
+
+std::vector<Meshlet> Build( std::span<const uint16_t> indices,
+							std::span<const Vertex> vertices,
+							uint32_t maxVertices,
+							uint32_t maxTriangles )
+{
+	return BuildImpl( indices, vertices, maxVertices, maxTriangles );
+}
+
+std::vector<Meshlet> Build( std::span<const uint32_t> indices,
+							std::span<const Vertex> vertices,
+							uint32_t maxVertices,
+							uint32_t maxTriangles )
+{
+	return BuildImpl( indices, vertices, maxVertices, maxTriangles );
+}
+
+void SortForOverdraw( std::span<uint16_t> indices, std::span<const Vertex> vertices, std::vector<Meshlet>& meshlets )
+{
+	SortForOverdrawImpl( indices, vertices, meshlets );
+}
+
+void SortForOverdraw( std::span<uint32_t> indices, std::span<const Vertex> vertices, std::vector<Meshlet>& meshlets )
+{
+	SortForOverdrawImpl( indices, vertices, meshlets );
+}
+
+bool IsBackFacing( const Meshlet& meshlet, const Vector3& cameraPosition )
+{
+	// Every triangle faces away when the whole sphere lies inside the cone mirrored through its apex
+	const Vector3 offset{ Vector3{ meshlet.center[0], meshlet.center[1], meshlet.center[2] } - cameraPosition };
+	const Vector3 axis{ meshlet.coneAxis[0], meshlet.coneAxis[1], meshlet.coneAxis[2] };
+	return Vector3::Dot( offset, axis ) >= meshlet.coneCutoff * offset.Magnitude() + meshlet.radius;
+}
+
+bool IsOutsideFrustum( const Meshlet& meshlet, const CullView& view )
+{
+	for ( const float( &plane )[4] : view.planes )
+	{
+		const float distance{ plane[0] * meshlet.center[0] + plane[1] * meshlet.center[1] +
+							  plane[2] * meshlet.center[2] + plane[3] };
+		if ( distance < -meshlet.radius )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+Culler::Culler( std::span<const Meshlet> meshlets )
+	: m_MeshletCount( meshlets.size() )
+{
+	const size_t paddedCount{ ( meshlets.size() + 3 ) & ~size_t{ 3 } };
+	for ( std::vector<float>* pLane :
+		  { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_AxisX, &m_AxisY, &m_AxisZ, &m_Cutoff } )
+	{
+		pLane->assign( paddedCount, 0.f );
+	}
+	m_FirstIndex.assign( paddedCount, 0 );
+	m_TriangleCount.assign( paddedCount, 0 );
+
+	for ( size_t meshletIdx{}; meshletIdx < meshlets.size(); ++meshletIdx )
+	{
+		const Meshlet& meshlet{ meshlets[meshletIdx] };
+		m_CenterX[meshletIdx] = meshlet.center[0];
+		m_CenterY[meshletIdx] = meshlet.center[1];
+		m_CenterZ[meshletIdx] = meshlet.center[2];
+		m_Radius[meshletIdx] = meshlet.radius;
+		m_AxisX[meshletIdx] = meshlet.coneAxis[0];
+		m_AxisY[meshletIdx] = meshlet.coneAxis[1];
+		m_AxisZ[meshletIdx] = meshlet.coneAxis[2];
+		m_Cutoff[meshletIdx] = meshlet.coneCutoff;
+		m_FirstIndex[meshletIdx] = meshlet.firstIndex;
+		m_TriangleCount[meshletIdx] = meshlet.triangleCount;
+	}
+}
+
+CullStatistics Culler::Cull( const CullView& view, std::vector<DrawRange>& ranges ) const
+{
+	const auto start{ std::chrono::steady_clock::now() };
+
+	CullStatistics statistics{};
+	statistics.meshletCount = m_MeshletCount;
+	ranges.clear();
+
+	const __m128 cameraX{ _mm_set1_ps( view.cameraPosition.x ) };
+	const __m128 cameraY{ _mm_set1_ps( view.cameraPosition.y ) };
+	const __m128 cameraZ{ _mm_set1_ps( view.cameraPosition.z ) };
+
+	for ( size_t baseIdx{}; baseIdx < m_MeshletCount; baseIdx += 4 )
+	{
+		const __m128 centerX{ _mm_loadu_ps( &m_CenterX[baseIdx] ) };
+		const __m128 centerY{ _mm_loadu_ps( &m_CenterY[baseIdx] ) };
+		const __m128 centerZ{ _mm_loadu_ps( &m_CenterZ[baseIdx] ) };
+		const __m128 radius{ _mm_loadu_ps( &m_Radius[baseIdx] ) };
+		const __m128 negativeRadius{ _mm_sub_ps( _mm_setzero_ps(), radius ) };
+
+		__m128 isOutside{ _mm_setzero_ps() };
+		for ( const float( &plane )[4] : view.planes )
+		{
+			// Same operation order as IsOutsideFrustum, so both agree to the bit
+			const __m128 distance{ _mm_add_ps(
+				_mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( plane[0] ), centerX ),
+										_mm_mul_ps( _mm_set1_ps( plane[1] ), centerY ) ),
+							_mm_mul_ps( _mm_set1_ps( plane[2] ), centerZ ) ),
+				_mm_set1_ps( plane[3] ) ) };
+			isOutside = _mm_or_ps( isOutside, _mm_cmplt_ps( distance, negativeRadius ) );
+		}
+
+		const __m128 offsetX{ _mm_sub_ps( centerX, cameraX ) };
+		const __m128 offsetY{ _mm_sub_ps( centerY, cameraY ) };
+		const __m128 offsetZ{ _mm_sub_ps( centerZ, cameraZ ) };
+		const __m128 distance{ _mm_sqrt_ps( _mm_add_ps(
+			_mm_add_ps( _mm_mul_ps( offsetX, offsetX ), _mm_mul_ps( offsetY, offsetY ) ), _mm_mul_ps( offsetZ, offsetZ ) ) ) };
+		const __m128 alongAxis{
+			_mm_add_ps( _mm_add_ps( _mm_mul_ps( offsetX, _mm_loadu_ps( &m_AxisX[baseIdx] ) ),
+									_mm_mul_ps( offsetY, _mm_loadu_ps( &m_AxisY[baseIdx] ) ) ),
+						_mm_mul_ps( offsetZ, _mm_loadu_ps( &m_AxisZ[baseIdx] ) ) ) };
+		const __m128 isBackFacing{ _mm_cmpge_ps(
+			alongAxis, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &m_Cutoff[baseIdx] ), distance ), radius ) ) };
+
+		const int outsideMask{ _mm_movemask_ps( isOutside ) };
+		const int backFacingMask{ _mm_movemask_ps( _mm_andnot_ps( isOutside, isBackFacing ) ) };
+
+		const size_t laneCount{ std::min<size_t>( 4, m_MeshletCount - baseIdx ) };
+		for ( size_t laneIdx{}; laneIdx < laneCount; ++laneIdx )
+		{
+			const size_t meshletIdx{ baseIdx + laneIdx };
+			const uint32_t triangleCount{ m_TriangleCount[meshletIdx] };
+			statistics.triangleCount += triangleCount;
+
+			if ( outsideMask & ( 1 << laneIdx ) )
+			{
+				statistics.frustumCulledTriangles += triangleCount;
+				continue;
+			}
+			if ( backFacingMask & ( 1 << laneIdx ) )
+			{
+				statistics.backfaceCulledTriangles += triangleCount;
+				continue;
+			}
+
+			++statistics.visibleMeshletCount;
+			const uint32_t firstIndex{ m_FirstIndex[meshletIdx] };
+			if ( !ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == firstIndex )
+			{
+				ranges.back().indexCount += triangleCount * 3;
+			}
+			else
+			{
+				ranges.push_back( { firstIndex, triangleCount * 3 } );
+			}
+		}
+	}
+
+	statistics.rangeCount = ranges.size();
+
+	const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+	statistics.cullMs = elapsed.count();
+	return statistics;
+}
+
+size_t Culler::GetMeshletCount() const
+{
+	return m_MeshletCount;
+}
+} // namespace meshlet
+} // namespace dae
@@ -0,0 +1,112 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+// Clusters of triangles that are culled on the CPU before the mesh is drawn
+// A meshlet is a contiguous run of the cooked index buffer, so the survivors are drawn as index ranges
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Matrix.h"
+#include "Structs.h"
+
+namespace dae
+{
+namespace meshlet
+{
+constexpr uint32_t MaxVertices{ 64 };
+constexpr uint32_t MaxTriangles{ 124 };
+
+// Stored as-is in cooked files
+struct Meshlet
+{
+	float center[3]{};
+	float radius{};
+	float coneAxis[3]{};
+	float coneCutoff{}; // 1 when the triangles face too many directions for the meshlet to ever be back-facing
+	uint32_t firstIndex{};
+	uint32_t triangleCount{};
+	uint32_t vertexCount{};
+	uint32_t padding{};
+};
+static_assert( sizeof( Meshlet ) == 48 );
+
+struct DrawRange
+{
+	uint32_t firstIndex{};
+	uint32_t indexCount{};
+};
+
+// Frustum planes and camera position in the mesh's object space
+struct CullView
+{
+	float planes[6][4]{}; // normalized, a point is inside when dot( plane.xyz, point ) + plane.w >= 0
+
+	Vector3 cameraPosition{};
+
+	static CullView Create( const Matrix& world, const Matrix& viewProjection, const Vector3& cameraOrigin );
+};
+
+struct CullStatistics
+{
+	size_t meshletCount{};
+	size_t visibleMeshletCount{};
+	size_t triangleCount{};
+	size_t backfaceCulledTriangles{};
+	size_t frustumCulledTriangles{};
+	size_t rangeCount{};
+	double cullMs{};
+
+	CullStatistics& operator+=( const CullStatistics& rhs );
+};
+
+// Splits the index buffer, in its current order, into runs of at most maxVertices unique vertices and maxTriangles
+// triangles, so the order earlier passes chose is kept
+std::vector<Meshlet> Build( std::span<const uint16_t> indices,
+							std::span<const Vertex> vertices,
+							uint32_t maxVertices = MaxVertices,
+							uint32_t maxTriangles = MaxTriangles );
+std::vector<Meshlet> Build( std::span<const uint32_t> indices,
+							std::span<const Vertex> vertices,
+							uint32_t maxVertices = MaxVertices,
+							uint32_t maxTriangles = MaxTriangles );
+
+// Overdraw pass at meshlet granularity, moves whole meshlets with optimize::SortClusters so each stays contiguous
+void SortForOverdraw( std::span<uint16_t> indices, std::span<const Vertex> vertices, std::vector<Meshlet>& meshlets );
+void SortForOverdraw( std::span<uint32_t> indices, std::span<const Vertex> vertices, std::vector<Meshlet>& meshlets );
+
+// Both tests are conservative, a meshlet is only rejected when none of its triangles can be visible
+bool IsBackFacing( const Meshlet& meshlet, const Vector3& cameraPosition );
+bool IsOutsideFrustum( const Meshlet& meshlet, const CullView& view );
+
+// Tests four meshlets at a time with SSE against bounds kept as a structure of arrays
+class Culler final
+{
+public:
+	Culler() = default;
+	explicit Culler( std::span<const Meshlet> meshlets );
+
+	// Replaces ranges with those of the surviving meshlets, neighbouring survivors are merged into one range
+	CullStatistics Cull( const CullView& view, std::vector<DrawRange>& ranges ) const;
+
+	size_t GetMeshletCount() const;
+
+private:
+	// SOFTWARE RESOURCES
+	// Padded to a multiple of four, the padding lanes are never reported
+	std::vector<float> m_CenterX{};
+	std::vector<float> m_CenterY{};
+	std::vector<float> m_CenterZ{};
+	std::vector<float> m_Radius{};
+	std::vector<float> m_AxisX{};
+	std::vector<float> m_AxisY{};
+	std::vector<float> m_AxisZ{};
+	std::vector<float> m_Cutoff{};
+	std::vector<uint32_t> m_FirstIndex{};
+	std::vector<uint32_t> m_TriangleCount{};
+	size_t m_MeshletCount{};
+	//
+};
+} // namespace meshlet
+} // namespace dae
+#endif
@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numbers>
+#include <span>
+#include <vector>
+#include <emmintrin.h>
+#include "MipGenerator.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+namespace mip
+{
+namespace
+{
+constexpr uint32_t MaxTapCount{ 6 };
+
+// Rows per pool task
+constexpr uint32_t TaskRowCount{ 32 };
+
+// Linear light to sRGB bytes, fine enough that a lookup is never more than a tenth of a step off
+constexpr uint32_t EncodeTableSize{ uint32_t{ 1 } << 14 };
+
+// A register that can be a container's element, __m128 itself loses its alignment attribute as a template argument
+struct Float4
+{
+	__m128 value{};
+};
+
+// One RGBA texel per register
+using Image = std::vector<Float4>;
+
+// Taps along one axis for a 2:1 reduction, target texel x covers source texels 2x and 2x + 1
+struct Kernel
+{
+	std::array<Float4, MaxTapCount> weights{};
+	int firstOffset{}; // relative to 2x
+	uint32_t tapCount{};
+};
+
+// Zeroth-order modified Bessel function of the first kind, the series converges fast over the window's range
+double BesselI0( double x )
+{
+	double sum{ 1.0 };
+	double term{ 1.0 };
+	for ( int k{ 1 }; k < 32; ++k )
+	{
+		const double factor{ x / ( 2.0 * k ) };
+		term *= factor * factor;
+		sum += term;
+	}
+	return sum;
+}
+
+Kernel CreateKernel( Filter filter )
+{
+	Kernel kernel{};
+	if ( filter == Filter::box )
+	{
+		kernel.weights[0].value = _mm_set1_ps( 0.5f );
+		kernel.weights[1].value = _mm_set1_ps( 0.5f );
+		kernel.tapCount = 2;
+		return kernel;
+	}
+
+	// Sinc cut off at the target's Nyquist rate, windowed over three source texels to either side of the center
+	constexpr double radius{ 3.0 };
+	constexpr double alpha{ 4.0 };
+	kernel.firstOffset = -2;
+	kernel.tapCount = MaxTapCount;
+
+	std::array<double, MaxTapCount> weights{};
+	double weightSum{};
+	for ( uint32_t tapIdx{}; tapIdx < MaxTapCount; ++tapIdx )
+	{
+		// Never 0, the center lies halfway between two texels
+		const double distance{ kernel.firstOffset + static_cast<double>( tapIdx ) - 0.5 };
+		const double x{ std::numbers::pi * distance / 2.0 };
+		const double window{ BesselI0( alpha * std::sqrt( 1.0 - ( distance / radius ) * ( distance / radius ) ) ) /
+							 BesselI0( alpha ) };
+		weights[tapIdx] = std::sin( x ) / x * window;
+		weightSum += weights[tapIdx];
+	}
+	for ( uint32_t tapIdx{}; tapIdx < MaxTapCount; ++tapIdx )
+	{
+		kernel.weights[tapIdx].value = _mm_set1_ps( static_cast<float>( weights[tapIdx] / weightSum ) );
+	}
+	return kernel;
+}
+
+// Source index of every tap of every target texel along one axis, wrapped around the edges
+std::vector<uint32_t> GetTapIndices( uint32_t sourceSize, uint32_t targetSize, const Kernel& kernel )
+{
+	std::vector<uint32_t> indices( size_t{ targetSize } * kernel.tapCount );
+	for ( uint32_t targetIdx{}; targetIdx < targetSize; ++targetIdx )
+	{
+		for ( uint32_t tapIdx{}; tapIdx < kernel.tapCount; ++tapIdx )
+		{
+			const int64_t sourceIdx{ int64_t{ 2 } * targetIdx + kernel.firstOffset + tapIdx };
+			indices[size_t{ targetIdx } * kernel.tapCount + tapIdx] =
+				static_cast<uint32_t>( ( sourceIdx % sourceSize + sourceSize ) % sourceSize );
+		}
+	}
+	return indices;
+}
+
+float DecodeSrgb( float value )
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow( ( value + 0.055f ) / 1.055f, 2.4f );
+}
+
+float EncodeSrgb( float value )
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow( value, 1.f / 2.4f ) - 0.055f;
+}
+
+const std::array<float, 256>& GetDecodeTable()
+{
+	static const std::array<float, 256> table{ []() {
+		std::array<float, 256> result{};
+		for ( uint32_t value{}; value < 256; ++value )
+		{
+			result[value] = DecodeSrgb( value / 255.f );
+		}
+		return result;
+	}() };
+	return table;
+}
+
+const std::vector<uint8_t>& GetEncodeTable()
+{
+	static const std::vector<uint8_t> table{ []() {
+		std::vector<uint8_t> result( EncodeTableSize );
+		for ( uint32_t idx{}; idx < EncodeTableSize; ++idx )
+		{
+			const float value{ EncodeSrgb( static_cast<float>( idx ) / ( EncodeTableSize - 1 ) ) };
+			result[idx] = static_cast<uint8_t>( std::lround( value * 255.f ) );
+		}
+		return result;
+	}() };
+	return table;
+}
+
+// Bytes to floats in [0, 255]
+__m128 LoadTexel( const std::byte* pTexel )
+{
+	int32_t bits{};
+	std::memcpy( &bits, pTexel, sizeof( bits ) );
+
+	const __m128i zero{ _mm_setzero_si128() };
+	const __m128i bytes{ _mm_cvtsi32_si128( bits ) };
+	return _mm_cvtepi32_ps( _mm_unpacklo_epi16( _mm_unpacklo_epi8( bytes, zero ), zero ) );
+}
+
+// Floats in [0, 255] to bytes, rounded to nearest; the packs saturate, so the filter's negative lobes clamp for free
+void StoreTexel( __m128 texel, std::byte* pTexel )
+{
+	const __m128i integers{ _mm_cvtps_epi32( texel ) };
+	const __m128i words{ _mm_packs_epi32( integers, integers ) };
+	const int32_t bits{ _mm_cvtsi128_si32( _mm_packus_epi16( words, words ) ) };
+	std::memcpy( pTexel, &bits, sizeof( bits ) );
+}
+
+// Leaves w alone, vectors that averaged out to nothing point straight out of the surface
+__m128 NormalizeXyz( __m128 texel )
+{
+	const __m128 squared{ _mm_mul_ps( texel, texel ) };
+	const __m128 lengthSq{ _mm_add_ps( _mm_add_ps( _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 0, 0, 0, 0 ) ),
+												   _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ),
+									   _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) };
+	const __m128 xyzMask{ _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) ) };
+	const __m128 isUsable{ _mm_and_ps( xyzMask, _mm_cmpgt_ps( lengthSq, _mm_set1_ps( 1e-12f ) ) ) };
+
+	const __m128 scale{ _mm_or_ps( _mm_and_ps( isUsable, _mm_div_ps( _mm_set1_ps( 1.f ), _mm_sqrt_ps( lengthSq ) ) ),
+								   _mm_andnot_ps( isUsable, _mm_set1_ps( 1.f ) ) ) };
+	const __m128 normalized{ _mm_mul_ps( texel, scale ) };
+
+	// The fallback only replaces xyz, lanes where the mask is off are w or usable ones
+	const __m128 isFallback{ _mm_andnot_ps( isUsable, xyzMask ) };
+	const __m128 up{ _mm_set_ps( 0.f, 1.f, 0.f, 0.f ) };
+	return _mm_or_ps( _mm_andnot_ps( isFallback, normalized ), _mm_and_ps( isFallback, up ) );
+}
+
+void ForEachRowRange( uint32_t rowCount,
+					  size_t texelCount,
+					  ThreadPool* pThreadPool,
+					  const std::function<void( uint32_t, uint32_t )>& function )
+{
+	if ( !pThreadPool || texelCount < MinParallelTexelCount )
+	{
+		function( 0, rowCount );
+		return;
+	}
+
+	pThreadPool->ParallelFor( ( rowCount + TaskRowCount - 1 ) / TaskRowCount, [&]( size_t taskIdx ) {
+		const uint32_t rowBegin{ static_cast<uint32_t>( taskIdx ) * TaskRowCount };
+		function( rowBegin, std::min( rowCount, rowBegin + TaskRowCount ) );
+	} );
+}
+
+// Into the space the content is averaged in, rgb in [-1, 1] for normals and [0, 1] otherwise, alpha in [0, 1]
+void DecodeRows( const TextureData::Level& level, Content content, Image& image, uint32_t rowBegin, uint32_t rowEnd )
+{
+	const std::array<float, 256>& decodeTable{ GetDecodeTable() };
+	const __m128 normalScale{ _mm_set_ps( 1.f / 255.f, 2.f / 255.f, 2.f / 255.f, 2.f / 255.f ) };
+	const __m128 normalBias{ _mm_set_ps( 0.f, 1.f, 1.f, 1.f ) };
+
+	for ( size_t texelIdx{ size_t{ rowBegin } * level.width }; texelIdx < size_t{ rowEnd } * level.width; ++texelIdx )
+	{
+		const std::byte* pTexel{ level.pixels.data() + texelIdx * TextureData::BytesPerPixel };
+		switch ( content )
+		{
+		case Content::color:
+			image[texelIdx].value = _mm_set_ps( std::to_integer<uint8_t>( pTexel[3] ) / 255.f,
+												decodeTable[std::to_integer<uint8_t>( pTexel[2] )],
+												decodeTable[std::to_integer<uint8_t>( pTexel[1] )],
+												decodeTable[std::to_integer<uint8_t>( pTexel[0] )] );
+			break;
+
+		case Content::data:
+			image[texelIdx].value = _mm_mul_ps( LoadTexel( pTexel ), _mm_set1_ps( 1.f / 255.f ) );
+			break;
+
+		case Content::normal:
+			image[texelIdx].value =
+				NormalizeXyz( _mm_sub_ps( _mm_mul_ps( LoadTexel( pTexel ), normalScale ), normalBias ) );
+			break;
+		}
+	}
+}
+
+void EncodeRows( const Image& image,
+				 uint32_t width,
+				 Content content,
+				 std::byte* pPixels,
+				 uint32_t rowBegin,
+				 uint32_t rowEnd )
+{
+	const std::vector<uint8_t>& encodeTable{ GetEncodeTable() };
+	const __m128 normalScale{ _mm_set_ps( 255.f, 127.5f, 127.5f, 127.5f ) };
+	const __m128 normalBias{ _mm_set_ps( 0.f, 127.5f, 127.5f, 127.5f ) };
+
+	for ( size_t texelIdx{ size_t{ rowBegin } * width }; texelIdx < size_t{ rowEnd } * width; ++texelIdx )
+	{
+		std::byte* pTexel{ pPixels + texelIdx * TextureData::BytesPerPixel };
+		switch ( content )
+		{
+		case Content::color:
+		{
+			// Clamped first, the filter's negative lobes overshoot at hard edges
+			const __m128 clamped{ _mm_min_ps( _mm_max_ps( image[texelIdx].value, _mm_setzero_ps() ),
+											  _mm_set1_ps( 1.f ) ) };
+			alignas( 16 ) float channels[4]{};
+			_mm_store_ps( channels, clamped );
+			for ( uint32_t channelIdx{}; channelIdx < 3; ++channelIdx )
+			{
+				const size_t tableIdx{ static_cast<size_t>( channels[channelIdx] * ( EncodeTableSize - 1 ) + 0.5f ) };
+				pTexel[channelIdx] = std::byte{ encodeTable[tableIdx] };
+			}
+			pTexel[3] = std::byte{ static_cast<uint8_t>( std::lround( channels[3] * 255.f ) ) };
+			break;
+		}
+
+		case Content::data:
+			StoreTexel( _mm_mul_ps( image[texelIdx].value, _mm_set1_ps( 255.f ) ), pTexel );
+			break;
+
+		case Content::normal:
+			StoreTexel( _mm_add_ps( _mm_mul_ps( image[texelIdx].value, normalScale ), normalBias ), pTexel );
+			break;
+		}
+	}
+}
+
+// Halves the width, every source row is filtered on its own
+void ReduceRows( const Image& source,
+				 uint32_t sourceWidth,
+				 Image& target,
+				 uint32_t targetWidth,
+				 const Kernel& kernel,
+				 const std::vector<uint32_t>& tapIndices,
+				 uint32_t rowBegin,
+				 uint32_t rowEnd )
+{
+	for ( uint32_t y{ rowBegin }; y < rowEnd; ++y )
+	{
+		const Float4* pSourceRow{ source.data() + size_t{ y } * sourceWidth };
+		Float4* pTargetRow{ target.data() + size_t{ y } * targetWidth };
+		for ( uint32_t x{}; x < targetWidth; ++x )
+		{
+			const uint32_t* pTaps{ tapIndices.data() + size_t{ x } * kernel.tapCount };
+			__m128 sum{ _mm_setzero_ps() };
+			for ( uint32_t tapIdx{}; tapIdx < kernel.tapCount; ++tapIdx )
+			{
+				sum = _mm_add_ps( sum, _mm_mul_ps( pSourceRow[pTaps[tapIdx]].value, kernel.weights[tapIdx].value ) );
+			}
+			pTargetRow[x].value = sum;
+		}
+	}
+}
+
+// Halves the height, whole rows are accumulated at a time so every pass over the source streams through memory
+void ReduceColumns( const Image& source,
+					Image& target,
+					uint32_t width,
+					const Kernel& kernel,
+					const std::vector<uint32_t>& tapIndices,
+					bool isNormal,
+					uint32_t rowBegin,
+					uint32_t rowEnd )
+{
+	for ( uint32_t y{ rowBegin }; y < rowEnd; ++y )
+	{
+		Float4* pTargetRow{ target.data() + size_t{ y } * width };
+		std::fill( pTargetRow, pTargetRow + width, Float4{} );
+		for ( uint32_t tapIdx{}; tapIdx < kernel.tapCount; ++tapIdx )
+		{
+			const uint32_t sourceY{ tapIndices[size_t{ y } * kernel.tapCount + tapIdx] };
+			const Float4* pSourceRow{ source.data() + size_t{ sourceY } * width };
+			const __m128 weight{ kernel.weights[tapIdx].value };
+			for ( uint32_t x{}; x < width; ++x )
+			{
+				pTargetRow[x].value = _mm_add_ps( pTargetRow[x].value, _mm_mul_ps( pSourceRow[x].value, weight ) );
+			}
+		}
+
+		if ( isNormal )
+		{
+			std::transform( pTargetRow, pTargetRow + width, pTargetRow, []( Float4 texel ) {
+				return Float4{ NormalizeXyz( texel.value ) };
+			} );
+		}
+	}
+}
+} // namespace
+
+TextureData Generate( const TextureData& texture, const Options& options, ThreadPool* pThreadPool )
+{
+	const TextureData::Level first{ texture.GetLevel( 0 ) };
+	const uint32_t levelCount{ TextureData::GetFullLevelCount( first.width, first.height ) };
+
+	std::vector<std::byte> pixels( TextureData::GetByteSize( first.width, first.height, levelCount ) );
+	std::copy( first.pixels.begin(), first.pixels.end(), pixels.begin() );
+
+	const Kernel kernel{ CreateKernel( options.filter ) };
+	const bool isNormal{ options.content == Content::normal };
+
+	Image source( size_t{ first.width } * first.height );
+	ForEachRowRange( first.height, source.size(), pThreadPool, [&]( uint32_t rowBegin, uint32_t rowEnd ) {
+		DecodeRows( first, options.content, source, rowBegin, rowEnd );
+	} );
+
+	Image reduced{};
+	Image target{};
+	uint32_t sourceWidth{ first.width };
+	uint32_t sourceHeight{ first.height };
+	size_t levelOffset{ first.pixels.size() };
+	for ( uint32_t levelIdx{ 1 }; levelIdx < levelCount; ++levelIdx )
+	{
+		const uint32_t targetWidth{ std::max( sourceWidth / 2, 1u ) };
+		const uint32_t targetHeight{ std::max( sourceHeight / 2, 1u ) };
+		const std::vector<uint32_t> columnTaps{ GetTapIndices( sourceWidth, targetWidth, kernel ) };
+		const std::vector<uint32_t> rowTaps{ GetTapIndices( sourceHeight, targetHeight, kernel ) };
+
+		reduced.resize( size_t{ targetWidth } * sourceHeight );
+		ForEachRowRange( sourceHeight, reduced.size(), pThreadPool, [&]( uint32_t rowBegin, uint32_t rowEnd ) {
+			ReduceRows( source, sourceWidth, reduced, targetWidth, kernel, columnTaps, rowBegin, rowEnd );
+		} );
+
+		target.resize( size_t{ targetWidth } * targetHeight );
+		std::byte* pLevelPixels{ pixels.data() + levelOffset };
+		ForEachRowRange( targetHeight, target.size(), pThreadPool, [&]( uint32_t rowBegin, uint32_t rowEnd ) {
+			ReduceColumns( reduced, target, targetWidth, kernel, rowTaps, isNormal, rowBegin, rowEnd );
+			EncodeRows( target, targetWidth, options.content, pLevelPixels, rowBegin, rowEnd );
+		} );
+
+		// The next level is filtered from these floats, rounding to bytes doesn't add up over the chain
+		std::swap( source, target );
+		sourceWidth = targetWidth;
+		sourceHeight = targetHeight;
+		levelOffset += size_t{ targetWidth } * targetHeight * TextureData::BytesPerPixel;
+	}
+
+	return TextureData{ first.width, first.height, levelCount, std::move( pixels ) };
+}
+} // namespace mip
+} // namespace dae
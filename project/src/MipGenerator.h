@@ -0,0 +1,45 @@
+#ifndef MIPGENERATOR_H
+#define MIPGENERATOR_H
+
+// Full mip chains for 8-bit RGBA textures, built on the CPU at load time or by the asset cooker
+// Every level is filtered from the float result of the level above it, not from its rounded bytes, with SSE doing
+// one RGBA texel per register; edges wrap, like the samplers that read them
+#include <cstdint>
+#include "TextureData.h"
+
+namespace dae
+{
+class ThreadPool;
+
+namespace mip
+{
+enum class Filter
+{
+	box,   // averages the 2x2 texels below, cheap but lets through detail that aliases
+	kaiser // Kaiser-windowed sinc over 6x6 texels, sharper and with less aliasing
+};
+
+// What the channels hold, picks the space texels are averaged in
+enum class Content
+{
+	color,	// sRGB colors, averaged as linear light so the levels don't darken
+	data,	// stored as is, like specular and gloss masks
+	normal, // tangent-space normals in rgb, renormalized on every level
+};
+
+// Two enums without padding, safe to hash as bytes
+struct Options
+{
+	Content content{ Content::color };
+	Filter filter{ Filter::kaiser };
+};
+
+// Below this the pool costs more than it saves
+constexpr uint32_t MinParallelTexelCount{ uint32_t{ 1 } << 16 };
+
+// Returns the texture with every level down to 1x1 after its first one, which is copied as is
+// Odd sizes round down like D3D's, the box filter then skips the last row or column of the level above
+TextureData Generate( const TextureData& texture, const Options& options, ThreadPool* pThreadPool = nullptr );
+} // namespace mip
+} // namespace dae
+#endif
@@ -0,0 +1,89 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+// Unbounded lock-free queue for many producer threads and a single consumer thread
+// Producers swap their node in as the new head and then link it, the consumer follows the links from a stub node
+// A producer preempted between those two steps hides everything behind it until it resumes, but nothing is lost
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace dae
+{
+template <typename T>
+class MpscQueue final
+{
+public:
+	MpscQueue();
+	MpscQueue( const MpscQueue& ) = delete;
+	MpscQueue( MpscQueue&& ) = delete;
+	MpscQueue& operator=( const MpscQueue& ) = delete;
+	MpscQueue& operator=( MpscQueue&& ) = delete;
+
+	~MpscQueue() noexcept;
+
+	// Methods
+	// Safe from any thread
+	void Push( T&& value );
+	// Only from the consumer thread, empty when nothing has been linked yet
+	std::optional<T> TryPop();
+
+private:
+	struct Node
+	{
+		std::atomic<Node*> pNext{};
+		std::optional<T> value{};
+	};
+
+	// SOFTWARE RESOURCES
+	std::atomic<Node*> m_pHead{};
+	Node* m_pTail{}; // the last node popped, or the stub, its value is already gone
+	//
+};
+
+template <typename T>
+MpscQueue<T>::MpscQueue()
+	: m_pHead( new Node{} )
+	, m_pTail( m_pHead.load( std::memory_order_relaxed ) )
+{
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue() noexcept
+{
+	while ( m_pTail )
+	{
+		Node* pNext{ m_pTail->pNext.load( std::memory_order_acquire ) };
+		delete m_pTail;
+		m_pTail = pNext;
+	}
+}
+
+template <typename T>
+void MpscQueue<T>::Push( T&& value )
+{
+	Node* pNode{ new Node{} };
+	pNode->value.emplace( std::move( value ) );
+
+	Node* pPrevious{ m_pHead.exchange( pNode, std::memory_order_acq_rel ) };
+	pPrevious->pNext.store( pNode, std::memory_order_release );
+}
+
+template <typename T>
+std::optional<T> MpscQueue<T>::TryPop()
+{
+	Node* pNext{ m_pTail->pNext.load( std::memory_order_acquire ) };
+	if ( !pNext )
+	{
+		return std::nullopt;
+	}
+
+	// The next node becomes the new stub once its value is moved out
+	std::optional<T> value{ std::move( pNext->value ) };
+	pNext->value.reset();
+	delete m_pTail;
+	m_pTail = pNext;
+	return value;
+}
+} // namespace dae
+#endif
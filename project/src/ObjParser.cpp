@@ -0,0 +1,1105 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include "TangentGenerator.h"
+#include "ThreadPool.h"
+#include "VertexWelder.h"
+
+namespace dae
+{
+namespace obj
+{
+namespace
+{
+constexpr uint32_t NoIndex{ UINT32_MAX };
+
+struct Corner
+{
+	uint32_t position{ NoIndex };
+	uint32_t UV{ NoIndex };
+	uint32_t normal{ NoIndex };
+};
+
+enum class Record
+{
+	none,
+	position,
+	UV,
+	normal,
+	face,
+};
+
+bool IsBlank( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipBlanks( const char* pCursor, const char* pLineEnd )
+{
+	while ( pCursor < pLineEnd && IsBlank( *pCursor ) )
+	{
+		++pCursor;
+	}
+	return pCursor;
+}
+
+const char* FindLineEnd( const char* pCursor, const char* pEnd )
+{
+	const void* pNewLine{ std::memchr( pCursor, '\n', static_cast<size_t>( pEnd - pCursor ) ) };
+	return pNewLine ? static_cast<const char*>( pNewLine ) : pEnd;
+}
+
+// Identifies the record and moves the cursor past its keyword
+Record ReadKeyword( const char*& pCursor, const char* pLineEnd )
+{
+	pCursor = SkipBlanks( pCursor, pLineEnd );
+	const size_t length{ static_cast<size_t>( pLineEnd - pCursor ) };
+
+	if ( length >= 2 && pCursor[0] == 'v' && IsBlank( pCursor[1] ) )
+	{
+		pCursor += 2;
+		return Record::position;
+	}
+	if ( length >= 3 && pCursor[0] == 'v' && pCursor[1] == 't' && IsBlank( pCursor[2] ) )
+	{
+		pCursor += 3;
+		return Record::UV;
+	}
+	if ( length >= 3 && pCursor[0] == 'v' && pCursor[1] == 'n' && IsBlank( pCursor[2] ) )
+	{
+		pCursor += 3;
+		return Record::normal;
+	}
+	if ( length >= 2 && pCursor[0] == 'f' && IsBlank( pCursor[1] ) )
+	{
+		pCursor += 2;
+		return Record::face;
+	}
+	return Record::none;
+}
+
+// Missing components are left at zero, same as a default constructed vector
+float ReadFloat( const char*& pCursor, const char* pLineEnd )
+{
+	pCursor = SkipBlanks( pCursor, pLineEnd );
+
+	float value{};
+	const auto [pNext, errorCode]{ std::from_chars( pCursor, pLineEnd, value ) };
+	if ( errorCode == std::errc{} )
+	{
+		pCursor = pNext;
+	}
+	return value;
+}
+
+void ReadVector3( const char*& pCursor, const char* pLineEnd, Vector3& vector )
+{
+	vector.x = ReadFloat( pCursor, pLineEnd );
+	vector.y = ReadFloat( pCursor, pLineEnd );
+	vector.z = ReadFloat( pCursor, pLineEnd );
+}
+
+// OBJ puts v = 0 at the bottom of the image, D3D at the top
+void ReadUV( const char*& pCursor, const char* pLineEnd, Vector2& UV )
+{
+	UV.x = ReadFloat( pCursor, pLineEnd );
+	UV.y = 1 - ReadFloat( pCursor, pLineEnd );
+}
+
+// Resolves a 1-based (or negative, relative) OBJ index against the amount of records read so far
+bool ReadIndex( const char*& pCursor, const char* pLineEnd, size_t count, uint32_t& index )
+{
+	int64_t value{};
+	const auto [pNext, errorCode]{ std::from_chars( pCursor, pLineEnd, value ) };
+	if ( errorCode != std::errc{} )
+	{
+		return false;
+	}
+	pCursor = pNext;
+
+	const int64_t resolved{ value > 0 ? value - 1 : static_cast<int64_t>( count ) + value };
+	if ( value == 0 || resolved < 0 || resolved >= static_cast<int64_t>( count ) )
+	{
+		return false;
+	}
+
+	index = static_cast<uint32_t>( resolved );
+	return true;
+}
+
+// Reads "p", "p/t", "p//n" or "p/t/n"
+bool ReadCorner( const char*& pCursor, const char* pLineEnd, const RecordCounts& counts, Corner& corner )
+{
+	if ( !ReadIndex( pCursor, pLineEnd, counts.positions, corner.position ) )
+	{
+		return false;
+	}
+
+	if ( pCursor == pLineEnd || *pCursor != '/' )
+	{
+		return true;
+	}
+	++pCursor;
+
+	if ( pCursor != pLineEnd && *pCursor != '/' )
+	{
+		// Optional texture coordinate
+		if ( !ReadIndex( pCursor, pLineEnd, counts.UVs, corner.UV ) )
+		{
+			return false;
+		}
+	}
+
+	if ( pCursor != pLineEnd && *pCursor == '/' )
+	{
+		++pCursor;
+
+		// Optional vertex normal
+		if ( !ReadIndex( pCursor, pLineEnd, counts.normals, corner.normal ) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t CountCorners( const char* pCursor, const char* pLineEnd )
+{
+	size_t corners{};
+	while ( true )
+	{
+		pCursor = SkipBlanks( pCursor, pLineEnd );
+		if ( pCursor == pLineEnd || *pCursor == '#' )
+		{
+			return corners;
+		}
+
+		++corners;
+		while ( pCursor < pLineEnd && !IsBlank( *pCursor ) )
+		{
+			++pCursor;
+		}
+	}
+}
+
+// Fans a face out from its first corner, writes cornerCount - 2 triangles
+void WriteFan( uint32_t firstVertex, size_t cornerCount, bool flipAxisAndWinding, uint32_t* pIndices )
+{
+	for ( uint32_t corner{ 1 }; corner + 1 < cornerCount; ++corner )
+	{
+		uint32_t* const pTriangle{ pIndices + ( corner - 1 ) * 3 };
+		pTriangle[0] = firstVertex;
+		if ( flipAxisAndWinding )
+		{
+			pTriangle[1] = firstVertex + corner + 1;
+			pTriangle[2] = firstVertex + corner;
+		}
+		else
+		{
+			pTriangle[1] = firstVertex + corner;
+			pTriangle[2] = firstVertex + corner + 1;
+		}
+	}
+}
+
+// A run of whole lines, parsed independently from its neighbours
+struct Chunk
+{
+	std::string_view source{};
+	RecordCounts counts{};	// Records inside this chunk
+	RecordCounts offsets{}; // Records in all chunks before this one
+};
+
+// Attribute pools and resolved face corners for the whole file
+struct Records
+{
+	std::vector<Vector3> positions{};
+	std::vector<Vector2> UVs{};
+	std::vector<Vector3> normals{};
+	std::vector<Corner> corners{};
+};
+
+std::vector<Chunk> SplitIntoChunks( std::string_view source, size_t chunkCount )
+{
+	std::vector<Chunk> chunks{};
+	chunks.reserve( chunkCount );
+
+	const char* const pEnd{ source.data() + source.size() };
+	const char* pBegin{ source.data() };
+	for ( size_t chunkIdx{ 1 }; chunkIdx <= chunkCount && pBegin < pEnd; ++chunkIdx )
+	{
+		// Every split point is moved forward to the start of the next line
+		const char* pSplit{ source.data() + source.size() * chunkIdx / chunkCount };
+		if ( pSplit < pBegin )
+		{
+			pSplit = pBegin;
+		}
+		if ( pSplit < pEnd )
+		{
+			const char* const pLineEnd{ FindLineEnd( pSplit, pEnd ) };
+			pSplit = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+		}
+
+		if ( pSplit > pBegin )
+		{
+			Chunk chunk{};
+			chunk.source = std::string_view{ pBegin, static_cast<size_t>( pSplit - pBegin ) };
+			chunks.push_back( chunk );
+		}
+		pBegin = pSplit;
+	}
+
+	return chunks;
+}
+
+RecordCounts AssignOffsets( std::vector<Chunk>& chunks )
+{
+	RecordCounts totals{};
+	for ( auto& chunk : chunks )
+	{
+		chunk.offsets = totals;
+
+		totals.positions += chunk.counts.positions;
+		totals.UVs += chunk.counts.UVs;
+		totals.normals += chunk.counts.normals;
+		totals.corners += chunk.counts.corners;
+		totals.triangles += chunk.counts.triangles;
+	}
+	return totals;
+}
+
+void Allocate( const RecordCounts& totals, Records& records, std::vector<uint32_t>& indices )
+{
+	records.positions.resize( totals.positions );
+	records.UVs.resize( totals.UVs );
+	records.normals.resize( totals.normals );
+	records.corners.resize( totals.corners );
+
+	indices.clear();
+	indices.resize( totals.triangles * 3 );
+}
+
+// Writes the chunk's attributes, corners and triangles at its offsets
+// Only references records of earlier lines, so it doesn't depend on other chunks being parsed
+bool ParseChunk( const Chunk& chunk, Records& records, std::vector<uint32_t>& indices, bool flipAxisAndWinding )
+{
+	RecordCounts counts{ chunk.offsets };
+	const size_t cornerEnd{ chunk.offsets.corners + chunk.counts.corners };
+
+	const char* pCursor{ chunk.source.data() };
+	const char* const pEnd{ pCursor + chunk.source.size() };
+	while ( pCursor < pEnd )
+	{
+		const char* const pLineEnd{ FindLineEnd( pCursor, pEnd ) };
+
+		switch ( ReadKeyword( pCursor, pLineEnd ) )
+		{
+		case Record::position:
+			ReadVector3( pCursor, pLineEnd, records.positions[counts.positions++] );
+			break;
+
+		case Record::UV:
+			ReadUV( pCursor, pLineEnd, records.UVs[counts.UVs++] );
+			break;
+
+		case Record::normal:
+			ReadVector3( pCursor, pLineEnd, records.normals[counts.normals++] );
+			break;
+
+		case Record::face:
+		{
+			// Every corner becomes its own vertex, the face is then fanned out from the first one
+			const size_t firstCorner{ counts.corners };
+			size_t cornerCount{};
+			while ( true )
+			{
+				pCursor = SkipBlanks( pCursor, pLineEnd );
+				if ( pCursor == pLineEnd || *pCursor == '#' )
+				{
+					break;
+				}
+
+				Corner corner{};
+				if ( !ReadCorner( pCursor, pLineEnd, counts, corner ) )
+				{
+					return false;
+				}
+
+				// Points and lines weren't counted, they may not fit
+				if ( firstCorner + cornerCount < cornerEnd )
+				{
+					records.corners[firstCorner + cornerCount] = corner;
+				}
+				++cornerCount;
+			}
+
+			if ( cornerCount < 3 )
+			{
+				break;
+			}
+			if ( firstCorner + cornerCount > cornerEnd )
+			{
+				return false;
+			}
+			counts.corners += cornerCount;
+
+			WriteFan(
+				static_cast<uint32_t>( firstCorner ), cornerCount, flipAxisAndWinding, &indices[counts.triangles * 3] );
+			counts.triangles += cornerCount - 2;
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		pCursor = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+	}
+
+	return true;
+}
+
+// The z flip mirrors the mesh, the winding was already flipped when the faces were read
+void FillVertices( const Records& records,
+				   const Corner* pCorners,
+				   size_t count,
+				   Vertex* pVertices,
+				   bool flipAxisAndWinding )
+{
+	for ( size_t cornerIdx{}; cornerIdx < count; ++cornerIdx )
+	{
+		const Corner& corner{ pCorners[cornerIdx] };
+		Vertex& vertex{ pVertices[cornerIdx] };
+
+		vertex.position = records.positions[corner.position];
+		if ( corner.UV != NoIndex )
+		{
+			vertex.UV = records.UVs[corner.UV];
+		}
+		if ( corner.normal != NoIndex )
+		{
+			vertex.normal = records.normals[corner.normal];
+		}
+
+		if ( flipAxisAndWinding )
+		{
+			vertex.position.z *= -1.f;
+			vertex.normal.z *= -1.f;
+		}
+	}
+}
+
+// Dereferences the chunk's corners, chunks never touch each other's vertices
+void BuildChunk( const Chunk& chunk, const Records& records, std::vector<Vertex>& vertices, bool flipAxisAndWinding )
+{
+	const size_t cornerBegin{ chunk.offsets.corners };
+	FillVertices( records,
+				  &records.corners[cornerBegin],
+				  chunk.counts.corners,
+				  vertices.data() + cornerBegin,
+				  flipAxisAndWinding );
+}
+
+// Tangents need the final vertices and triangles, so they are generated once over the whole mesh
+void GenerateTangents( std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const ParseOptions& options )
+{
+	tangent::GenerateStatistics statistics{};
+	tangent::Generate( vertices, indices, options.pThreadPool, &statistics );
+	if ( options.pStatistics )
+	{
+		options.pStatistics->tangents = statistics;
+	}
+}
+
+// Corners sharing all three attribute indices collapse into one vertex, first occurrence decides the order
+// Returns the number of unique corners, they are moved to the front
+size_t CompactCorners( std::vector<Corner>& corners, std::vector<uint32_t>& cornerToVertex )
+{
+	cornerToVertex.resize( corners.size() );
+
+	VertexWelder welder{ corners.size() };
+	size_t uniqueCount{};
+	for ( size_t cornerIdx{}; cornerIdx < corners.size(); ++cornerIdx )
+	{
+		const Corner& corner{ corners[cornerIdx] };
+
+		bool isNew{};
+		cornerToVertex[cornerIdx] = welder.Insert( corner.position, corner.UV, corner.normal, isNew );
+		if ( isNew )
+		{
+			// Unique corners are compacted in place, they're never read again at their old spot
+			corners[uniqueCount++] = corner;
+		}
+	}
+	return uniqueCount;
+}
+
+// The index buffer is rewritten from corner ids to welded vertex ids
+void WeldCorners( Records& records,
+				  std::vector<Vertex>& vertices,
+				  std::vector<uint32_t>& indices,
+				  const ParseOptions& options )
+{
+	const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+
+	std::vector<uint32_t> cornerToVertex{};
+	const size_t uniqueCount{ CompactCorners( records.corners, cornerToVertex ) };
+
+	if ( options.pStatistics )
+	{
+		const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+		options.pStatistics->weldMs = elapsed.count();
+	}
+
+	for ( auto& index : indices )
+	{
+		index = cornerToVertex[index];
+	}
+
+	vertices.resize( uniqueCount );
+	FillVertices( records, records.corners.data(), uniqueCount, vertices.data(), options.flipAxisAndWinding );
+
+	// Tangents are now shared between faces, every triangle touching a welded vertex contributes
+	GenerateTangents( vertices, indices, options );
+}
+
+bool ParseSerial( std::string_view source,
+				  std::vector<Vertex>& vertices,
+				  std::vector<uint32_t>& indices,
+				  const ParseOptions& options )
+{
+	Chunk chunk{};
+	chunk.source = source;
+	chunk.counts = CountRecords( source );
+
+	Records records{};
+	Allocate( chunk.counts, records, indices );
+	vertices.clear();
+
+	if ( !ParseChunk( chunk, records, indices, options.flipAxisAndWinding ) )
+	{
+		return false;
+	}
+
+	if ( options.pStatistics )
+	{
+		options.pStatistics->records = chunk.counts;
+	}
+
+	if ( options.weldVertices )
+	{
+		WeldCorners( records, vertices, indices, options );
+		return true;
+	}
+
+	vertices.resize( chunk.counts.corners );
+	BuildChunk( chunk, records, vertices, options.flipAxisAndWinding );
+	GenerateTangents( vertices, indices, options );
+	return true;
+}
+
+bool ParseParallel( std::string_view source,
+					std::vector<Vertex>& vertices,
+					std::vector<uint32_t>& indices,
+					const ParseOptions& options,
+					size_t chunkCount )
+{
+	ThreadPool& pool{ *options.pThreadPool };
+	std::vector<Chunk> chunks{ SplitIntoChunks( source, chunkCount ) };
+
+	// 1. Count every chunk, prefix sums give each chunk its place in the output
+	pool.ParallelFor( chunks.size(), [&]( size_t chunkIdx ) {
+		chunks[chunkIdx].counts = CountRecords( chunks[chunkIdx].source );
+	} );
+
+	Records records{};
+	const RecordCounts totals{ AssignOffsets( chunks ) };
+	Allocate( totals, records, indices );
+	vertices.clear();
+
+	// 2. Parse attributes and corners straight into place
+	std::vector<uint8_t> chunkIsValid( chunks.size() );
+	pool.ParallelFor( chunks.size(), [&]( size_t chunkIdx ) {
+		chunkIsValid[chunkIdx] = ParseChunk( chunks[chunkIdx], records, indices, options.flipAxisAndWinding );
+	} );
+
+	if ( std::find( chunkIsValid.begin(), chunkIsValid.end(), uint8_t{} ) != chunkIsValid.end() )
+	{
+		return false;
+	}
+
+	if ( options.pStatistics )
+	{
+		options.pStatistics->records = totals;
+	}
+
+	// Welding has to see the corners in file order to match the serial result
+	if ( options.weldVertices )
+	{
+		WeldCorners( records, vertices, indices, options );
+		return true;
+	}
+
+	// 3. Every attribute is known now, build the vertices
+	vertices.resize( totals.corners );
+	pool.ParallelFor( chunks.size(), [&]( size_t chunkIdx ) {
+		BuildChunk( chunks[chunkIdx], records, vertices, options.flipAxisAndWinding );
+	} );
+	GenerateTangents( vertices, indices, options );
+
+	return true;
+}
+
+// Attribute records per entry of the stream index, and per decoded block
+constexpr size_t StreamBlockSize{ 4096 };
+
+// How much of the file the indexing pass reads before dropping it from memory again
+constexpr size_t MaxIndexEvictInterval{ size_t{ 64 } << 20 };
+
+// Faulting a page in can map the rest of its cached folio too, including pages in front of it that were dropped
+// before, so every eviction reaches back this far
+constexpr size_t EvictReach{ size_t{ 4 } << 20 };
+
+// File offset of every StreamBlockSize'th record of one attribute type
+struct BlockIndex
+{
+	std::vector<uint64_t> offsets{};
+	size_t recordCount{};
+};
+
+// A run of whole lines whose faces are finished and handed out together
+struct Window
+{
+	size_t begin{};
+	size_t end{};
+	RecordCounts offsets{}; // records before the window, relative indices resolve against these
+	RecordCounts counts{};
+};
+
+// Memory a window needs at its peak, its resident source pages included
+size_t GetWindowBytes( size_t sourceSize, size_t cornerCount, size_t triangleCount, bool weldVertices )
+{
+	size_t bytes{ sourceSize + cornerCount * ( sizeof( Corner ) + sizeof( Vertex ) ) +
+				  triangleCount * 3 * sizeof( uint32_t ) + tangent::GetScratchBytes( cornerCount, triangleCount ) };
+	if ( weldVertices )
+	{
+		bytes += cornerCount * sizeof( uint32_t ) + VertexWelder::GetMemoryBytes( cornerCount );
+	}
+	return bytes;
+}
+
+// Pass 1: indexes the attribute records and cuts the faces into windows of at most windowBudget bytes
+// Lines before a window's first face don't belong to any window
+bool PlanWindows( const MappedFile& file,
+				  size_t windowBudget,
+				  bool weldVertices,
+				  std::array<BlockIndex, 3>& blocks,
+				  std::vector<Window>& windows,
+				  RecordCounts& totals )
+{
+	const char* const pBegin{ file.GetData() };
+	const char* const pEnd{ pBegin + file.GetSize() };
+	const size_t evictInterval{ std::min( MaxIndexEvictInterval, windowBudget ) };
+
+	RecordCounts counts{};
+	Window window{};
+	size_t evictedEnd{};
+	for ( const char* pCursor{ pBegin }; pCursor < pEnd; )
+	{
+		const size_t lineBegin{ static_cast<size_t>( pCursor - pBegin ) };
+		const char* const pLineEnd{ FindLineEnd( pCursor, pEnd ) };
+		const size_t lineEnd{ static_cast<size_t>( pLineEnd - pBegin ) + 1 };
+
+		if ( window.counts.corners == 0 )
+		{
+			window.begin = lineBegin;
+			window.offsets = counts;
+		}
+
+		size_t corners{};
+		switch ( const Record record{ ReadKeyword( pCursor, pLineEnd ) } )
+		{
+		case Record::position:
+		case Record::UV:
+		case Record::normal:
+		{
+			BlockIndex& index{ blocks[record == Record::position ? 0 : record == Record::UV ? 1 : 2] };
+			if ( index.recordCount % StreamBlockSize == 0 )
+			{
+				index.offsets.push_back( lineBegin );
+			}
+			++index.recordCount;
+			break;
+		}
+
+		case Record::face:
+			corners = CountCorners( pCursor, pLineEnd );
+			corners = corners >= 3 ? corners : 0;
+			break;
+
+		default:
+			break;
+		}
+
+		if ( window.counts.corners > 0 || corners > 0 )
+		{
+			const size_t cornerCount{ window.counts.corners + corners };
+			const size_t triangleCount{ window.counts.triangles + ( corners > 0 ? corners - 2 : 0 ) };
+			if ( GetWindowBytes( lineEnd - window.begin, cornerCount, triangleCount, weldVertices ) > windowBudget )
+			{
+				if ( window.counts.corners == 0 )
+				{
+					return false;
+				}
+
+				window.end = lineBegin;
+				windows.push_back( window );
+
+				window = {};
+				window.begin = lineBegin;
+				window.offsets = counts;
+				if ( GetWindowBytes( lineEnd - lineBegin, corners, corners > 0 ? corners - 2 : 0, weldVertices ) >
+					 windowBudget )
+				{
+					return false;
+				}
+			}
+
+			window.counts.corners += corners;
+			window.counts.triangles += corners > 0 ? corners - 2 : 0;
+		}
+
+		counts.positions = blocks[0].recordCount;
+		counts.UVs = blocks[1].recordCount;
+		counts.normals = blocks[2].recordCount;
+		counts.corners += corners;
+		counts.triangles += corners > 0 ? corners - 2 : 0;
+
+		if ( lineEnd - evictedEnd >= evictInterval )
+		{
+			const size_t evictBegin{ evictedEnd - std::min( evictedEnd, EvictReach ) };
+			file.Evict( evictBegin, lineEnd - evictBegin );
+			evictedEnd = lineEnd;
+		}
+		pCursor = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+	}
+	const size_t evictBegin{ evictedEnd - std::min( evictedEnd, EvictReach ) };
+	file.Evict( evictBegin, file.GetSize() - evictBegin );
+
+	if ( window.counts.corners > 0 )
+	{
+		window.end = file.GetSize();
+		windows.push_back( window );
+	}
+	totals = counts;
+	return true;
+}
+
+// Decoded attribute blocks, the least recently used one is replaced once the cache is full
+template <typename Attribute>
+class AttributeCache final
+{
+public:
+	AttributeCache( const MappedFile& file, const BlockIndex& index, Record record, size_t capacity )
+		: m_File{ file }
+		, m_Index{ index }
+		, m_Record{ record }
+		, m_Capacity{ std::max( capacity, size_t{ 1 } ) }
+		, m_BlockToSlot( index.offsets.size(), NoIndex )
+	{
+	}
+
+	const Attribute& Get( uint32_t recordIdx )
+	{
+		const size_t blockIdx{ recordIdx / StreamBlockSize };
+		uint32_t slotIdx{ m_BlockToSlot[blockIdx] };
+		if ( slotIdx == NoIndex )
+		{
+			slotIdx = Load( blockIdx );
+		}
+
+		m_LastUse[slotIdx] = ++m_UseCount;
+		return m_Slots[slotIdx][recordIdx % StreamBlockSize];
+	}
+
+	// Getters
+	size_t GetLoadCount() const
+	{
+		return m_LoadCount;
+	}
+
+	static size_t GetBlockBytes()
+	{
+		return StreamBlockSize * sizeof( Attribute ) + sizeof( uint64_t ) + sizeof( uint32_t );
+	}
+
+private:
+	const MappedFile& m_File;
+	const BlockIndex& m_Index;
+	const Record m_Record;
+	const size_t m_Capacity;
+
+	// SOFTWARE RESOURCES
+	std::vector<uint32_t> m_BlockToSlot{};
+	std::vector<std::vector<Attribute>> m_Slots{};
+	std::vector<uint32_t> m_SlotToBlock{};
+	std::vector<uint64_t> m_LastUse{};
+	uint64_t m_UseCount{};
+	size_t m_LoadCount{};
+	//
+
+	uint32_t Load( size_t blockIdx )
+	{
+		uint32_t slotIdx{ static_cast<uint32_t>( m_Slots.size() ) };
+		if ( m_Slots.size() < m_Capacity )
+		{
+			m_Slots.emplace_back( StreamBlockSize );
+			m_SlotToBlock.push_back( NoIndex );
+			m_LastUse.push_back( 0 );
+		}
+		else
+		{
+			const auto leastRecent{ std::min_element( m_LastUse.begin(), m_LastUse.end() ) };
+			slotIdx = static_cast<uint32_t>( leastRecent - m_LastUse.begin() );
+			m_BlockToSlot[m_SlotToBlock[slotIdx]] = NoIndex;
+		}
+
+		const size_t offset{ m_Index.offsets[blockIdx] };
+		const size_t recordCount{ std::min( StreamBlockSize, m_Index.recordCount - blockIdx * StreamBlockSize ) };
+		std::vector<Attribute>& slot{ m_Slots[slotIdx] };
+
+		const char* const pBegin{ m_File.GetData() + offset };
+		const char* const pEnd{ m_File.GetData() + m_File.GetSize() };
+		const char* pCursor{ pBegin };
+		for ( size_t recordIdx{}; recordIdx < recordCount && pCursor < pEnd; )
+		{
+			const char* const pLineEnd{ FindLineEnd( pCursor, pEnd ) };
+			if ( ReadKeyword( pCursor, pLineEnd ) == m_Record )
+			{
+				if constexpr ( std::is_same_v<Attribute, Vector2> )
+				{
+					ReadUV( pCursor, pLineEnd, slot[recordIdx++] );
+				}
+				else
+				{
+					ReadVector3( pCursor, pLineEnd, slot[recordIdx++] );
+				}
+			}
+			pCursor = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+		}
+		const size_t evictBegin{ offset - std::min( offset, EvictReach ) };
+		m_File.Evict( evictBegin, static_cast<size_t>( pCursor - m_File.GetData() ) - evictBegin );
+
+		m_BlockToSlot[blockIdx] = slotIdx;
+		m_SlotToBlock[slotIdx] = static_cast<uint32_t>( blockIdx );
+		++m_LoadCount;
+		return slotIdx;
+	}
+};
+
+struct AttributeCaches
+{
+	AttributeCache<Vector3> positions;
+	AttributeCache<Vector2> UVs;
+	AttributeCache<Vector3> normals;
+};
+
+// Buffers reused from window to window, sized for the largest one up front
+struct WindowBuffers
+{
+	std::vector<Corner> corners{};
+	std::vector<uint32_t> indices{};
+	std::vector<uint32_t> cornerToVertex{};
+	std::vector<Vertex> vertices{};
+};
+
+// Pass 2: reads the window's faces, other records only advance the counts relative indices resolve against
+bool ParseWindowFaces( std::string_view source, const Window& window, bool flipAxisAndWinding, WindowBuffers& buffers )
+{
+	buffers.corners.clear();
+	buffers.indices.resize( window.counts.triangles * 3 );
+
+	RecordCounts counts{ window.offsets };
+	const char* pCursor{ source.data() + window.begin };
+	const char* const pEnd{ source.data() + window.end };
+	while ( pCursor < pEnd )
+	{
+		const char* const pLineEnd{ FindLineEnd( pCursor, pEnd ) };
+
+		switch ( ReadKeyword( pCursor, pLineEnd ) )
+		{
+		case Record::position:
+			++counts.positions;
+			break;
+
+		case Record::UV:
+			++counts.UVs;
+			break;
+
+		case Record::normal:
+			++counts.normals;
+			break;
+
+		case Record::face:
+		{
+			const size_t firstCorner{ buffers.corners.size() };
+			while ( true )
+			{
+				pCursor = SkipBlanks( pCursor, pLineEnd );
+				if ( pCursor == pLineEnd || *pCursor == '#' )
+				{
+					break;
+				}
+
+				Corner& corner{ buffers.corners.emplace_back() };
+				if ( !ReadCorner( pCursor, pLineEnd, counts, corner ) )
+				{
+					return false;
+				}
+			}
+
+			const size_t cornerCount{ buffers.corners.size() - firstCorner };
+			if ( cornerCount < 3 )
+			{
+				buffers.corners.resize( firstCorner );
+				break;
+			}
+
+			const size_t firstTriangle{ counts.triangles - window.offsets.triangles };
+			WriteFan( static_cast<uint32_t>( firstCorner ),
+					  cornerCount,
+					  flipAxisAndWinding,
+					  &buffers.indices[firstTriangle * 3] );
+			counts.triangles += cornerCount - 2;
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		pCursor = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+	}
+
+	return true;
+}
+
+// Dereferences the first count corners through the caches, same as FillVertices
+void ResolveCorners( AttributeCaches& caches, size_t count, bool flipAxisAndWinding, WindowBuffers& buffers )
+{
+	buffers.vertices.resize( count );
+	for ( size_t cornerIdx{}; cornerIdx < count; ++cornerIdx )
+	{
+		const Corner& corner{ buffers.corners[cornerIdx] };
+		Vertex& vertex{ buffers.vertices[cornerIdx] };
+
+		vertex = {};
+		vertex.position = caches.positions.Get( corner.position );
+		if ( corner.UV != NoIndex )
+		{
+			vertex.UV = caches.UVs.Get( corner.UV );
+		}
+		if ( corner.normal != NoIndex )
+		{
+			vertex.normal = caches.normals.Get( corner.normal );
+		}
+
+		if ( flipAxisAndWinding )
+		{
+			vertex.position.z *= -1.f;
+			vertex.normal.z *= -1.f;
+		}
+	}
+}
+} // namespace
+
+RecordCounts CountRecords( std::string_view source )
+{
+	RecordCounts counts{};
+
+	const char* pCursor{ source.data() };
+	const char* const pEnd{ pCursor + source.size() };
+	while ( pCursor < pEnd )
+	{
+		const char* const pLineEnd{ FindLineEnd( pCursor, pEnd ) };
+
+		switch ( ReadKeyword( pCursor, pLineEnd ) )
+		{
+		case Record::position:
+			++counts.positions;
+			break;
+
+		case Record::UV:
+			++counts.UVs;
+			break;
+
+		case Record::normal:
+			++counts.normals;
+			break;
+
+		case Record::face:
+		{
+			const size_t corners{ CountCorners( pCursor, pLineEnd ) };
+			if ( corners >= 3 )
+			{
+				counts.corners += corners;
+				counts.triangles += corners - 2;
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		pCursor = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+	}
+
+	return counts;
+}
+
+bool Parse( std::string_view source,
+			std::vector<Vertex>& vertices,
+			std::vector<uint32_t>& indices,
+			const ParseOptions& options )
+{
+	if ( options.pThreadPool )
+	{
+		// A few chunks per thread evens out chunks that happen to be slower to parse
+		const size_t maxChunkCount{ options.pThreadPool->GetThreadCount() * size_t{ 4 } };
+		const size_t chunkCount{ std::min( source.size() / std::max( options.minChunkSize, size_t{ 1 } ),
+										   maxChunkCount ) };
+		if ( chunkCount > 1 )
+		{
+			return ParseParallel( source, vertices, indices, options, chunkCount );
+		}
+	}
+
+	return ParseSerial( source, vertices, indices, options );
+}
+
+bool Stream( const MappedFile& file, const StreamConsumer& consumer, const StreamOptions& options )
+{
+	const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+
+	// A quarter of the budget caches decoded attributes, split by record size, the index gets a generous guess
+	const size_t cacheBudget{ options.memoryBudget / 4 };
+	const size_t positionBlockCount{ cacheBudget * 12 / 32 / AttributeCache<Vector3>::GetBlockBytes() };
+	const size_t UVBlockCount{ cacheBudget * 8 / 32 / AttributeCache<Vector2>::GetBlockBytes() };
+	const size_t normalBlockCount{ cacheBudget * 12 / 32 / AttributeCache<Vector3>::GetBlockBytes() };
+	const size_t indexBytes{ file.GetSize() / 2048 };
+
+	// Pages the OS maps in ahead of the one being read are resident too, up to a folio past the window
+	const size_t fixedBytes{ cacheBudget + indexBytes + EvictReach };
+	if ( options.memoryBudget <= fixedBytes )
+	{
+		return false;
+	}
+	const size_t windowBudget{ options.memoryBudget - fixedBytes };
+
+	// 1. Index the attributes and plan the windows
+	std::array<BlockIndex, 3> blocks{};
+	std::vector<Window> windows{};
+	RecordCounts totals{};
+	if ( !PlanWindows( file, windowBudget, options.weldVertices, blocks, windows, totals ) )
+	{
+		return false;
+	}
+
+	const std::chrono::steady_clock::time_point indexEnd{ std::chrono::steady_clock::now() };
+
+	size_t maxCornerCount{};
+	size_t maxTriangleCount{};
+	for ( const Window& window : windows )
+	{
+		maxCornerCount = std::max( maxCornerCount, window.counts.corners );
+		maxTriangleCount = std::max( maxTriangleCount, window.counts.triangles );
+	}
+
+	WindowBuffers buffers{};
+	buffers.corners.reserve( maxCornerCount );
+	buffers.indices.reserve( maxTriangleCount * 3 );
+	buffers.vertices.reserve( maxCornerCount );
+	if ( options.weldVertices )
+	{
+		buffers.cornerToVertex.reserve( maxCornerCount );
+	}
+
+	AttributeCaches caches{
+		{ file, blocks[0], Record::position, positionBlockCount },
+		{ file, blocks[1], Record::UV, UVBlockCount },
+		{ file, blocks[2], Record::normal, normalBlockCount },
+	};
+
+	// Each window's source is only touched once, its pages are dropped after it's done
+	size_t peakBytes{};
+	double consumerMs{};
+	for ( size_t windowIdx{}; windowIdx < windows.size(); ++windowIdx )
+	{
+		const Window& window{ windows[windowIdx] };
+
+		// 2. Faces into corners and local indices
+		if ( !ParseWindowFaces( file.GetView(), window, options.flipAxisAndWinding, buffers ) )
+		{
+			return false;
+		}
+
+		size_t vertexCount{ buffers.corners.size() };
+		if ( options.weldVertices )
+		{
+			vertexCount = CompactCorners( buffers.corners, buffers.cornerToVertex );
+			for ( auto& index : buffers.indices )
+			{
+				index = buffers.cornerToVertex[index];
+			}
+		}
+
+		// 3. Attributes through the caches, tangents over the window
+		ResolveCorners( caches, vertexCount, options.flipAxisAndWinding, buffers );
+		tangent::Generate( buffers.vertices, buffers.indices, options.pThreadPool );
+
+		peakBytes = std::max( peakBytes,
+							  GetWindowBytes( window.end - window.begin,
+											  window.counts.corners,
+											  window.counts.triangles,
+											  options.weldVertices ) );
+
+		// 4. Hand it over
+		const std::chrono::steady_clock::time_point consumerStart{ std::chrono::steady_clock::now() };
+		consumer( StreamChunk{ buffers.vertices, buffers.indices, windowIdx } );
+		const std::chrono::duration<double, std::milli> consumerElapsed{ std::chrono::steady_clock::now() -
+																		 consumerStart };
+		consumerMs += consumerElapsed.count();
+
+		const size_t evictBegin{ window.begin - std::min( window.begin, EvictReach ) };
+		file.Evict( evictBegin, window.end - evictBegin );
+	}
+
+	if ( options.pStatistics )
+	{
+		const std::chrono::steady_clock::time_point end{ std::chrono::steady_clock::now() };
+		const std::chrono::duration<double, std::milli> indexElapsed{ indexEnd - start };
+		const std::chrono::duration<double, std::milli> parseElapsed{ end - indexEnd };
+
+		StreamStatistics& statistics{ *options.pStatistics };
+		statistics.records = totals;
+		statistics.chunkCount = windows.size();
+		statistics.blockLoadCount =
+			caches.positions.GetLoadCount() + caches.UVs.GetLoadCount() + caches.normals.GetLoadCount();
+		statistics.peakBytes = peakBytes + fixedBytes;
+		statistics.indexMs = indexElapsed.count();
+		statistics.parseMs = parseElapsed.count() - consumerMs;
+		statistics.consumerMs = consumerMs;
+	}
+
+	return true;
+}
+} // namespace obj
+} // namespace dae
@@ -0,0 +1,109 @@
+#ifndef OBJPARSER_H
+#define OBJPARSER_H
+
+// Allocation-free Wavefront OBJ parser
+// Works on an in-memory view of the file (see MappedFile), a counting pre-pass sizes every array exactly once
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "Structs.h"
+#include "TangentGenerator.h"
+
+namespace dae
+{
+class MappedFile;
+class ThreadPool;
+
+namespace obj
+{
+// Number of records per type, gathered by the pre-pass
+struct RecordCounts
+{
+	size_t positions{};
+	size_t UVs{};
+	size_t normals{};
+	size_t corners{};
+	size_t triangles{};
+};
+
+struct ParseStatistics
+{
+	RecordCounts records{};
+	double weldMs{};
+	tangent::GenerateStatistics tangents{};
+};
+
+struct ParseOptions
+{
+	bool flipAxisAndWinding{ true };
+
+	// Corners with the same (position, UV, normal) indices share one vertex instead of each getting their own
+	bool weldVertices{ false };
+
+	// Files are split at line boundaries and parsed on the pool when they span more than one chunk
+	// The output is identical to the serial parse
+	ThreadPool* pThreadPool{};
+	size_t minChunkSize{ size_t{ 4 } << 20 };
+
+	// Optional, filled in when set
+	ParseStatistics* pStatistics{};
+};
+
+// Finished geometry of one window of the file, the indices refer to this chunk's vertices
+struct StreamChunk
+{
+	std::span<const Vertex> vertices{};
+	std::span<const uint32_t> indices{};
+	size_t chunkIdx{};
+};
+
+struct StreamStatistics
+{
+	RecordCounts records{};
+	size_t chunkCount{};
+	size_t blockLoadCount{}; // attribute blocks decoded, more than there are means faces jumped back and forth
+	size_t peakBytes{};		 // most the parser held at once by its own count, resident pages of the file included
+	double indexMs{};
+	double parseMs{}; // without the time spent in the consumer
+	double consumerMs{};
+};
+
+struct StreamOptions
+{
+	bool flipAxisAndWinding{ true };
+
+	// Welding and tangents only see one chunk, vertices on a chunk border are repeated in both
+	bool weldVertices{ false };
+
+	// Covers the parser's own buffers and the pages of the file it keeps resident, not what the consumer allocates
+	size_t memoryBudget{ size_t{ 512 } << 20 };
+
+	// Only used for tangents, the file itself is read front to back on the calling thread
+	ThreadPool* pThreadPool{};
+
+	// Optional, filled in when set
+	StreamStatistics* pStatistics{};
+};
+
+using StreamConsumer = std::function<void( const StreamChunk& chunk )>;
+
+RecordCounts CountRecords( std::string_view source );
+
+// Parses v/vt/vn/f records, faces with more than three corners are fan-triangulated
+// Returns false when the source references attributes that don't exist
+bool Parse( std::string_view source,
+			std::vector<Vertex>& vertices,
+			std::vector<uint32_t>& indices,
+			const ParseOptions& options = {} );
+
+// Parses files of any size in windows that fit the memory budget, every window's vertices and indices are handed to
+// consumer in file order and are only valid during the call
+// A first pass indexes the attribute records, faces then decode them a block at a time as they are referenced, so
+// faces far from their attributes cost time rather than memory
+// Returns false when the source references attributes that don't exist or a single face doesn't fit the budget
+bool Stream( const MappedFile& file, const StreamConsumer& consumer, const StreamOptions& options = {} );
+} // namespace obj
+} // namespace dae
+#endif
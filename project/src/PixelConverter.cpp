@@ -0,0 +1,200 @@
+#include <vector>
+#include <emmintrin.h>
+#include "PixelConverter.h"
+
+namespace dae
+{
+namespace pixel
+{
+namespace
+{
+constexpr size_t VectorBytes{ sizeof( __m128i ) };
+
+void NarrowR8( const std::byte* pRgba, std::byte* pTarget, size_t texelCount )
+{
+	// Red sits in the low byte of every texel, packing with saturation leaves it alone
+	const __m128i redMask{ _mm_set1_epi32( 0xFF ) };
+	size_t texelIdx{};
+	for ( ; texelIdx + VectorBytes <= texelCount; texelIdx += VectorBytes )
+	{
+		const __m128i* pSource{ reinterpret_cast<const __m128i*>( pRgba + texelIdx * TextureData::BytesPerPixel ) };
+		const __m128i red0{ _mm_and_si128( _mm_loadu_si128( pSource ), redMask ) };
+		const __m128i red1{ _mm_and_si128( _mm_loadu_si128( pSource + 1 ), redMask ) };
+		const __m128i red2{ _mm_and_si128( _mm_loadu_si128( pSource + 2 ), redMask ) };
+		const __m128i red3{ _mm_and_si128( _mm_loadu_si128( pSource + 3 ), redMask ) };
+		const __m128i red{ _mm_packus_epi16( _mm_packs_epi32( red0, red1 ), _mm_packs_epi32( red2, red3 ) ) };
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( pTarget + texelIdx ), red );
+	}
+
+	for ( ; texelIdx < texelCount; ++texelIdx )
+	{
+		pTarget[texelIdx] = pRgba[texelIdx * TextureData::BytesPerPixel];
+	}
+}
+
+void NarrowRg8( const std::byte* pRgba, std::byte* pTarget, size_t texelCount )
+{
+	// The red-green pair is sign-extended first, so the saturating pack keeps its bits as they are
+	constexpr size_t texelsPerVector{ VectorBytes / 2 };
+	size_t texelIdx{};
+	for ( ; texelIdx + texelsPerVector <= texelCount; texelIdx += texelsPerVector )
+	{
+		const __m128i* pSource{ reinterpret_cast<const __m128i*>( pRgba + texelIdx * TextureData::BytesPerPixel ) };
+		const __m128i redGreen0{ _mm_srai_epi32( _mm_slli_epi32( _mm_loadu_si128( pSource ), 16 ), 16 ) };
+		const __m128i redGreen1{ _mm_srai_epi32( _mm_slli_epi32( _mm_loadu_si128( pSource + 1 ), 16 ), 16 ) };
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( pTarget + texelIdx * 2 ),
+						  _mm_packs_epi32( redGreen0, redGreen1 ) );
+	}
+
+	for ( ; texelIdx < texelCount; ++texelIdx )
+	{
+		pTarget[texelIdx * 2] = pRgba[texelIdx * TextureData::BytesPerPixel];
+		pTarget[texelIdx * 2 + 1] = pRgba[texelIdx * TextureData::BytesPerPixel + 1];
+	}
+}
+
+void WidenR8( const std::byte* pSource, std::byte* pRgba, size_t texelCount )
+{
+	const __m128i zero{ _mm_setzero_si128() };
+	const __m128i alpha{ _mm_set1_epi32( static_cast<int>( 0xFF000000 ) ) };
+	size_t texelIdx{};
+	for ( ; texelIdx + VectorBytes <= texelCount; texelIdx += VectorBytes )
+	{
+		const __m128i red{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSource + texelIdx ) ) };
+		const __m128i redLow{ _mm_unpacklo_epi8( red, zero ) };
+		const __m128i redHigh{ _mm_unpackhi_epi8( red, zero ) };
+		__m128i* pTarget{ reinterpret_cast<__m128i*>( pRgba + texelIdx * TextureData::BytesPerPixel ) };
+		_mm_storeu_si128( pTarget, _mm_or_si128( _mm_unpacklo_epi16( redLow, zero ), alpha ) );
+		_mm_storeu_si128( pTarget + 1, _mm_or_si128( _mm_unpackhi_epi16( redLow, zero ), alpha ) );
+		_mm_storeu_si128( pTarget + 2, _mm_or_si128( _mm_unpacklo_epi16( redHigh, zero ), alpha ) );
+		_mm_storeu_si128( pTarget + 3, _mm_or_si128( _mm_unpackhi_epi16( redHigh, zero ), alpha ) );
+	}
+
+	for ( ; texelIdx < texelCount; ++texelIdx )
+	{
+		std::byte* pTexel{ pRgba + texelIdx * TextureData::BytesPerPixel };
+		pTexel[0] = pSource[texelIdx];
+		pTexel[1] = std::byte{ 0 };
+		pTexel[2] = std::byte{ 0 };
+		pTexel[3] = std::byte{ 255 };
+	}
+}
+
+void WidenRg8( const std::byte* pSource, std::byte* pRgba, size_t texelCount )
+{
+	constexpr size_t texelsPerVector{ VectorBytes / 2 };
+	const __m128i zero{ _mm_setzero_si128() };
+	const __m128i alpha{ _mm_set1_epi32( static_cast<int>( 0xFF000000 ) ) };
+	size_t texelIdx{};
+	for ( ; texelIdx + texelsPerVector <= texelCount; texelIdx += texelsPerVector )
+	{
+		const __m128i redGreen{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSource + texelIdx * 2 ) ) };
+		__m128i* pTarget{ reinterpret_cast<__m128i*>( pRgba + texelIdx * TextureData::BytesPerPixel ) };
+		_mm_storeu_si128( pTarget, _mm_or_si128( _mm_unpacklo_epi16( redGreen, zero ), alpha ) );
+		_mm_storeu_si128( pTarget + 1, _mm_or_si128( _mm_unpackhi_epi16( redGreen, zero ), alpha ) );
+	}
+
+	for ( ; texelIdx < texelCount; ++texelIdx )
+	{
+		std::byte* pTexel{ pRgba + texelIdx * TextureData::BytesPerPixel };
+		pTexel[0] = pSource[texelIdx * 2];
+		pTexel[1] = pSource[texelIdx * 2 + 1];
+		pTexel[2] = std::byte{ 0 };
+		pTexel[3] = std::byte{ 255 };
+	}
+}
+} // namespace
+
+void Narrow( const std::byte* pRgba, std::byte* pTarget, size_t texelCount, TextureData::Format format )
+{
+	if ( format == TextureData::Format::r8 )
+	{
+		NarrowR8( pRgba, pTarget, texelCount );
+	}
+	else
+	{
+		NarrowRg8( pRgba, pTarget, texelCount );
+	}
+}
+
+void Widen( const std::byte* pSource, std::byte* pRgba, size_t texelCount, TextureData::Format format )
+{
+	if ( format == TextureData::Format::r8 )
+	{
+		WidenR8( pSource, pRgba, texelCount );
+	}
+	else
+	{
+		WidenRg8( pSource, pRgba, texelCount );
+	}
+}
+
+TextureData Convert( const TextureData& texture, TextureData::Format format )
+{
+	const uint32_t width{ texture.GetWidth() };
+	const uint32_t height{ texture.GetHeight() };
+	const uint32_t levelCount{ texture.GetLevelCount() };
+	const TextureData::Format sourceFormat{ texture.GetFormat() };
+	if ( sourceFormat == format )
+	{
+		return TextureData{ width, height, levelCount, texture.CopyPixels(), format };
+	}
+
+	// Levels are tightly packed in every uncompressed format, so each one converts as a single run
+	std::vector<std::byte> pixels( TextureData::GetByteSize( width, height, levelCount, format ) );
+	size_t levelOffset{};
+	for ( uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx )
+	{
+		const TextureData::Level level{ texture.GetLevel( levelIdx ) };
+		const size_t texelCount{ size_t{ level.width } * level.height };
+		if ( sourceFormat == TextureData::Format::rgba8 )
+		{
+			Narrow( level.pixels.data(), pixels.data() + levelOffset, texelCount, format );
+		}
+		else
+		{
+			Widen( level.pixels.data(), pixels.data() + levelOffset, texelCount, sourceFormat );
+		}
+		levelOffset += texelCount * TextureData::GetTexelBytes( format );
+	}
+
+	return TextureData{ width, height, levelCount, std::move( pixels ), format };
+}
+
+void PackAlpha( const std::byte* pAlphaSource, std::byte* pRgba, size_t texelCount )
+{
+	// Red sits in the low byte of every texel, shifting it up by three bytes lands it on alpha
+	constexpr size_t texelsPerVector{ VectorBytes / TextureData::BytesPerPixel };
+	const __m128i colorMask{ _mm_set1_epi32( 0x00FFFFFF ) };
+	size_t texelIdx{};
+	for ( ; texelIdx + texelsPerVector <= texelCount; texelIdx += texelsPerVector )
+	{
+		const size_t offset{ texelIdx * TextureData::BytesPerPixel };
+		const __m128i alpha{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pAlphaSource + offset ) ) };
+		__m128i* pTarget{ reinterpret_cast<__m128i*>( pRgba + offset ) };
+		const __m128i color{ _mm_and_si128( _mm_loadu_si128( pTarget ), colorMask ) };
+		_mm_storeu_si128( pTarget, _mm_or_si128( color, _mm_slli_epi32( alpha, 24 ) ) );
+	}
+
+	for ( ; texelIdx < texelCount; ++texelIdx )
+	{
+		pRgba[texelIdx * TextureData::BytesPerPixel + 3] = pAlphaSource[texelIdx * TextureData::BytesPerPixel];
+	}
+}
+
+TextureData PackAlpha( const TextureData& color, const TextureData& alphaSource )
+{
+	std::vector<std::byte> pixels{ color.CopyPixels() };
+	size_t levelOffset{};
+	for ( uint32_t levelIdx{}; levelIdx < color.GetLevelCount(); ++levelIdx )
+	{
+		const TextureData::Level level{ alphaSource.GetLevel( levelIdx ) };
+		const size_t texelCount{ size_t{ level.width } * level.height };
+		PackAlpha( level.pixels.data(), pixels.data() + levelOffset, texelCount );
+		levelOffset += texelCount * TextureData::BytesPerPixel;
+	}
+
+	return TextureData{ color.GetWidth(), color.GetHeight(), color.GetLevelCount(), std::move( pixels ) };
+}
+} // namespace pixel
+} // namespace dae
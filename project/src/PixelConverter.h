@@ -0,0 +1,31 @@
+#ifndef PIXELCONVERTER_H
+#define PIXELCONVERTER_H
+
+// Converts between 8-bit RGBA and the uncompressed formats that keep fewer of its channels, and packs a one-channel
+// map into the alpha of another
+// The bulk of every run of texels goes through SSE2, whatever is left over through a scalar loop
+#include <cstddef>
+#include "TextureData.h"
+
+namespace dae
+{
+namespace pixel
+{
+// Keeps the channels format stores, r8 or rg8
+void Narrow( const std::byte* pRgba, std::byte* pTarget, size_t texelCount, TextureData::Format format );
+
+// Back to 8-bit RGBA the way the GPU samples it, color channels the format doesn't store come back as 0 and alpha as
+// 255
+void Widen( const std::byte* pSource, std::byte* pRgba, size_t texelCount, TextureData::Format format );
+
+// Every level, from or to rgba8; converting to the texture's own format copies it
+TextureData Convert( const TextureData& texture, TextureData::Format format );
+
+// The first channel of every texel of pAlphaSource into the alpha of the same texel of pRgba, both 8-bit RGBA
+void PackAlpha( const std::byte* pAlphaSource, std::byte* pRgba, size_t texelCount );
+
+// Every level of color with alphaSource's first channel as alpha, both rgba8 with the same size and level count
+TextureData PackAlpha( const TextureData& color, const TextureData& alphaSource );
+} // namespace pixel
+} // namespace dae
+#endif
@@ -0,0 +1,1075 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <emmintrin.h>
+#include "PngDecoder.h"
+#include "Error.h"
+#include "TextureData.h"
+
+namespace dae
+{
+namespace png
+{
+namespace
+{
+constexpr std::string_view Signature{ "\x89PNG\r\n\x1a\n", 8 };
+
+// D3D11 can't create anything larger, and it keeps every size computation far from overflowing
+constexpr uint32_t MaxDimension{ 16384 };
+
+enum class ColorType : uint8_t
+{
+	gray = 0,
+	rgb = 2,
+	palette = 3,
+	grayAlpha = 4,
+	rgba = 6
+};
+
+struct Header
+{
+	Info info{};
+	uint32_t bitDepth{};
+	ColorType colorType{};
+	uint32_t channelCount{};
+};
+
+// What the decoder needs from the chunks after the header
+struct Chunks
+{
+	std::string_view palette{};
+	std::string_view transparency{};
+	std::vector<std::string_view> data{}; // every IDAT, in order
+};
+
+// Deflate
+constexpr uint32_t FastBits{ 10 };
+constexpr uint32_t MaxCodeLength{ 15 };
+constexpr uint32_t EndOfBlock{ 256 };
+
+constexpr std::array<uint16_t, 29> LengthBases{ 3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23,  27,
+												31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr std::array<uint8_t, 29> LengthExtraBits{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+												   2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr std::array<uint16_t, 30> DistanceBases{ 1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+												  33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+												  1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr std::array<uint8_t, 30> DistanceExtraBits{ 0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+													 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+constexpr std::array<uint8_t, 19> CodeLengthOrder{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// Matches are copied 8 bytes at a time, which can write this far past the last one
+constexpr size_t CopySlack{ 8 };
+
+// Checksums
+// Adler-32's sums stay below 2^32 for this many bytes before they have to be reduced
+constexpr size_t AdlerBlockSize{ 5552 };
+constexpr uint32_t AdlerModulus{ 65521 };
+
+// CRC-32 eight bytes at a time, table i advances a byte's CRC past i more bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> CreateCrcTables()
+{
+	std::array<std::array<uint32_t, 256>, 8> tables{};
+	for ( uint32_t byte{}; byte < 256; ++byte )
+	{
+		uint32_t crc{ byte };
+		for ( uint32_t bitIdx{}; bitIdx < 8; ++bitIdx )
+		{
+			crc = crc & 1 ? 0xEDB88320 ^ crc >> 1 : crc >> 1;
+		}
+		tables[0][byte] = crc;
+	}
+	for ( uint32_t byte{}; byte < 256; ++byte )
+	{
+		for ( size_t tableIdx{ 1 }; tableIdx < tables.size(); ++tableIdx )
+		{
+			const uint32_t previous{ tables[tableIdx - 1][byte] };
+			tables[tableIdx][byte] = tables[0][previous & 255] ^ previous >> 8;
+		}
+	}
+	return tables;
+}
+constexpr std::array<std::array<uint32_t, 256>, 8> CrcTables{ CreateCrcTables() };
+
+// Reads the deflate stream least significant bit first, refilled 8 bytes at a time
+class BitReader final
+{
+public:
+	explicit BitReader( std::span<const uint8_t> bytes )
+		: m_Bytes( bytes )
+	{
+	}
+
+	// At least 56 bits are buffered afterwards; past the end zeros are shifted in, IsOverrun tells when they were used
+	void Refill()
+	{
+		if ( m_Position + sizeof( uint64_t ) <= m_Bytes.size() )
+		{
+			uint64_t word{};
+			std::memcpy( &word, m_Bytes.data() + m_Position, sizeof( uint64_t ) );
+			m_Bits |= word << m_BitCount;
+			m_Position += ( 63 - m_BitCount ) >> 3;
+			m_BitCount |= 56;
+			return;
+		}
+
+		while ( m_BitCount < 56 )
+		{
+			const uint64_t byte{ m_Position < m_Bytes.size() ? m_Bytes[m_Position] : uint8_t{} };
+			m_Bits |= byte << m_BitCount;
+			++m_Position;
+			m_BitCount += 8;
+		}
+	}
+
+	uint32_t Peek() const
+	{
+		return static_cast<uint32_t>( m_Bits );
+	}
+
+	void Consume( uint32_t bitCount )
+	{
+		m_Bits >>= bitCount;
+		m_BitCount -= bitCount;
+	}
+
+	uint32_t Read( uint32_t bitCount )
+	{
+		const uint32_t value{ static_cast<uint32_t>( m_Bits & ( ( uint64_t{ 1 } << bitCount ) - 1 ) ) };
+		Consume( bitCount );
+		return value;
+	}
+
+	// Drops the rest of the current byte and the buffered bytes, reading goes on from the returned position
+	size_t AlignToByte()
+	{
+		Consume( m_BitCount & 7 );
+		const size_t position{ m_Position - m_BitCount / 8 };
+		m_Bits = 0;
+		m_BitCount = 0;
+		m_Position = position;
+		return position;
+	}
+
+	void Skip( size_t byteCount )
+	{
+		m_Position += byteCount;
+	}
+
+	bool IsOverrun() const
+	{
+		return m_Position - m_BitCount / 8 > m_Bytes.size();
+	}
+
+private:
+	std::span<const uint8_t> m_Bytes{};
+	size_t m_Position{};
+	uint64_t m_Bits{};
+	uint32_t m_BitCount{};
+};
+
+// A canonical Huffman code, looked up FastBits at a time
+struct Huffman
+{
+	// ( symbol << 4 ) | length of every code no longer than FastBits, indexed by the next FastBits of the stream; 0
+	// where a longer code starts
+	std::array<uint16_t, 1 << FastBits> fast{};
+	// Longer codes are found by comparing the next 16 bits, reversed, with the end of every length's codes
+	std::array<uint32_t, MaxCodeLength + 2> limits{};
+	std::array<uint16_t, MaxCodeLength + 1> firstCodes{};
+	std::array<uint16_t, MaxCodeLength + 1> firstIndices{};
+	std::array<uint16_t, 288> symbols{}; // in code order
+};
+
+uint32_t Reverse( uint32_t code, uint32_t bitCount )
+{
+	uint32_t reversed{};
+	for ( uint32_t bitIdx{}; bitIdx < bitCount; ++bitIdx )
+	{
+		reversed = reversed << 1 | ( code >> bitIdx & 1 );
+	}
+	return reversed;
+}
+
+uint32_t Reverse16( uint32_t bits )
+{
+	bits = ( bits & 0xAAAA ) >> 1 | ( bits & 0x5555 ) << 1;
+	bits = ( bits & 0xCCCC ) >> 2 | ( bits & 0x3333 ) << 2;
+	bits = ( bits & 0xF0F0 ) >> 4 | ( bits & 0x0F0F ) << 4;
+	bits = ( bits & 0xFF00 ) >> 8 | ( bits & 0x00FF ) << 8;
+	return bits;
+}
+
+void Build( Huffman& huffman, const uint8_t* pLengths, uint32_t symbolCount )
+{
+	std::array<uint16_t, MaxCodeLength + 1> counts{};
+	for ( uint32_t symbol{}; symbol < symbolCount; ++symbol )
+	{
+		++counts[pLengths[symbol]];
+	}
+
+	huffman.fast.fill( 0 );
+	std::array<uint16_t, MaxCodeLength + 1> nextCodes{};
+	uint32_t code{};
+	uint32_t index{};
+	for ( uint32_t length{ 1 }; length <= MaxCodeLength; ++length )
+	{
+		huffman.firstCodes[length] = static_cast<uint16_t>( code );
+		huffman.firstIndices[length] = static_cast<uint16_t>( index );
+		nextCodes[length] = static_cast<uint16_t>( code );
+		code += counts[length];
+		index += counts[length];
+
+		// Incomplete codes are allowed, they only fail once a missing code turns up
+		if ( code > 1u << length )
+		{
+			throw error::texture::DecodeFail();
+		}
+		huffman.limits[length] = code << ( 16 - length );
+		code <<= 1;
+	}
+	huffman.limits[MaxCodeLength + 1] = 1 << 16;
+
+	for ( uint32_t symbol{}; symbol < symbolCount; ++symbol )
+	{
+		const uint32_t length{ pLengths[symbol] };
+		if ( length == 0 )
+		{
+			continue;
+		}
+
+		const uint32_t symbolCode{ nextCodes[length]++ };
+		huffman.symbols[huffman.firstIndices[length] + symbolCode - huffman.firstCodes[length]] =
+			static_cast<uint16_t>( symbol );
+		if ( length <= FastBits )
+		{
+			const uint16_t entry{ static_cast<uint16_t>( symbol << 4 | length ) };
+			const uint32_t step{ 1u << length };
+			for ( uint32_t fastIdx{ Reverse( symbolCode, length ) }; fastIdx < huffman.fast.size(); fastIdx += step )
+			{
+				huffman.fast[fastIdx] = entry;
+			}
+		}
+	}
+}
+
+// Needs 15 bits buffered
+uint32_t DecodeSymbol( BitReader& reader, const Huffman& huffman )
+{
+	const uint32_t bits{ reader.Peek() };
+	const uint32_t entry{ huffman.fast[bits & ( ( 1 << FastBits ) - 1 )] };
+	if ( entry != 0 )
+	{
+		reader.Consume( entry & 15 );
+		return entry >> 4;
+	}
+
+	const uint32_t reversed{ Reverse16( bits & 0xFFFF ) };
+	uint32_t length{ FastBits + 1 };
+	while ( reversed >= huffman.limits[length] )
+	{
+		++length;
+	}
+
+	if ( length > MaxCodeLength )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	const uint32_t code{ reversed >> ( 16 - length ) };
+	if ( code < huffman.firstCodes[length] )
+	{
+		throw error::texture::DecodeFail();
+	}
+	reader.Consume( length );
+	return huffman.symbols[huffman.firstIndices[length] + code - huffman.firstCodes[length]];
+}
+
+struct FixedCodes
+{
+	Huffman lengths{};
+	Huffman distances{};
+};
+
+const FixedCodes& GetFixedCodes()
+{
+	static const FixedCodes codes{ []() {
+		std::array<uint8_t, 288> lengths{};
+		std::fill( lengths.begin(), lengths.begin() + 144, uint8_t{ 8 } );
+		std::fill( lengths.begin() + 144, lengths.begin() + 256, uint8_t{ 9 } );
+		std::fill( lengths.begin() + 256, lengths.begin() + 280, uint8_t{ 7 } );
+		std::fill( lengths.begin() + 280, lengths.end(), uint8_t{ 8 } );
+		const std::array<uint8_t, 32> distanceLengths{ [] {
+			std::array<uint8_t, 32> result{};
+			result.fill( 5 );
+			return result;
+		}() };
+
+		FixedCodes result{};
+		Build( result.lengths, lengths.data(), static_cast<uint32_t>( lengths.size() ) );
+		Build( result.distances, distanceLengths.data(), static_cast<uint32_t>( distanceLengths.size() ) );
+		return result;
+	}() };
+	return codes;
+}
+
+void ReadDynamicCodes( BitReader& reader, Huffman& lengths, Huffman& distances )
+{
+	reader.Refill();
+	const uint32_t lengthCount{ reader.Read( 5 ) + 257 };
+	const uint32_t distanceCount{ reader.Read( 5 ) + 1 };
+	const uint32_t codeLengthCount{ reader.Read( 4 ) + 4 };
+	if ( lengthCount > 286 || distanceCount > 30 )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	std::array<uint8_t, CodeLengthOrder.size()> codeLengthLengths{};
+	for ( uint32_t codeIdx{}; codeIdx < codeLengthCount; ++codeIdx )
+	{
+		reader.Refill();
+		codeLengthLengths[CodeLengthOrder[codeIdx]] = static_cast<uint8_t>( reader.Read( 3 ) );
+	}
+	Huffman codeLengths{};
+	Build( codeLengths, codeLengthLengths.data(), static_cast<uint32_t>( codeLengthLengths.size() ) );
+
+	// Both codes' lengths are one sequence, a repeat can run from one into the other
+	std::array<uint8_t, 286 + 30> codeLengthValues{};
+	const uint32_t totalCount{ lengthCount + distanceCount };
+	uint32_t valueIdx{};
+	while ( valueIdx < totalCount )
+	{
+		reader.Refill();
+		const uint32_t symbol{ DecodeSymbol( reader, codeLengths ) };
+		if ( symbol < 16 )
+		{
+			codeLengthValues[valueIdx++] = static_cast<uint8_t>( symbol );
+			continue;
+		}
+
+		uint8_t value{};
+		uint32_t repeatCount{};
+		if ( symbol == 16 )
+		{
+			if ( valueIdx == 0 )
+			{
+				throw error::texture::DecodeFail();
+			}
+			value = codeLengthValues[valueIdx - 1];
+			repeatCount = 3 + reader.Read( 2 );
+		}
+		else
+		{
+			repeatCount = symbol == 17 ? 3 + reader.Read( 3 ) : 11 + reader.Read( 7 );
+		}
+
+		if ( repeatCount > totalCount - valueIdx )
+		{
+			throw error::texture::DecodeFail();
+		}
+		std::fill_n( codeLengthValues.begin() + valueIdx, repeatCount, value );
+		valueIdx += repeatCount;
+	}
+
+	if ( codeLengthValues[EndOfBlock] == 0 )
+	{
+		throw error::texture::DecodeFail();
+	}
+	Build( lengths, codeLengthValues.data(), lengthCount );
+	Build( distances, codeLengthValues.data() + lengthCount, distanceCount );
+}
+
+void CopyMatch( uint8_t* pOut, size_t distance, size_t length )
+{
+	const uint8_t* pSource{ pOut - distance };
+	if ( distance >= sizeof( uint64_t ) )
+	{
+		// Every 8 bytes read were written before, the last copy can run into the slack or what comes next
+		for ( size_t offset{}; offset < length; offset += sizeof( uint64_t ) )
+		{
+			std::memcpy( pOut + offset, pSource + offset, sizeof( uint64_t ) );
+		}
+	}
+	else if ( distance == 1 )
+	{
+		std::memset( pOut, *pSource, length );
+	}
+	else
+	{
+		for ( size_t offset{}; offset < length; ++offset )
+		{
+			pOut[offset] = pSource[offset];
+		}
+	}
+}
+
+// A literal, a length and a distance with their extra bits fit in the 56 bits of one refill
+void InflateBlock( BitReader& reader,
+				   const Huffman& lengths,
+				   const Huffman& distances,
+				   const uint8_t* pBegin,
+				   uint8_t*& pOut,
+				   const uint8_t* pEnd )
+{
+	for ( ;; )
+	{
+		reader.Refill();
+		uint32_t symbol{ DecodeSymbol( reader, lengths ) };
+		if ( symbol < EndOfBlock )
+		{
+			if ( pOut == pEnd )
+			{
+				throw error::texture::DecodeFail();
+			}
+			*pOut++ = static_cast<uint8_t>( symbol );
+			continue;
+		}
+
+		if ( symbol == EndOfBlock )
+		{
+			return;
+		}
+
+		symbol -= EndOfBlock + 1;
+		if ( symbol >= LengthBases.size() )
+		{
+			throw error::texture::DecodeFail();
+		}
+		const size_t length{ LengthBases[symbol] + reader.Read( LengthExtraBits[symbol] ) };
+
+		const uint32_t distanceSymbol{ DecodeSymbol( reader, distances ) };
+		if ( distanceSymbol >= DistanceBases.size() )
+		{
+			throw error::texture::DecodeFail();
+		}
+		const size_t distance{ DistanceBases[distanceSymbol] + reader.Read( DistanceExtraBits[distanceSymbol] ) };
+
+		if ( distance > static_cast<size_t>( pOut - pBegin ) || length > static_cast<size_t>( pEnd - pOut ) )
+		{
+			throw error::texture::DecodeFail();
+		}
+		CopyMatch( pOut, distance, length );
+		pOut += length;
+	}
+}
+
+// zlib's checksum of the inflated bytes, 16 at a time with SSE2
+// Over n bytes b gains n times a's starting value, 16 times every earlier group's sum and each byte weighted by how
+// many of its group's bytes, itself included, come after it
+uint32_t GetAdler32( const uint8_t* pBegin, const uint8_t* pEnd )
+{
+	const __m128i zero{ _mm_setzero_si128() };
+	const __m128i lowWeights{ _mm_set_epi16( 9, 10, 11, 12, 13, 14, 15, 16 ) };
+	const __m128i highWeights{ _mm_set_epi16( 1, 2, 3, 4, 5, 6, 7, 8 ) };
+
+	uint32_t a{ 1 };
+	uint32_t b{};
+	while ( pBegin < pEnd )
+	{
+		const size_t blockSize{ std::min( AdlerBlockSize, static_cast<size_t>( pEnd - pBegin ) ) };
+		const uint8_t* const pGroupsEnd{ pBegin + blockSize / 16 * 16 };
+		const uint8_t* const pBlockEnd{ pBegin + blockSize };
+
+		b += a * static_cast<uint32_t>( pGroupsEnd - pBegin );
+		__m128i sums{ zero };		  // 64-bit lanes
+		__m128i earlierSums{ zero };  // 64-bit lanes
+		__m128i weightedSums{ zero }; // 32-bit lanes
+		for ( ; pBegin < pGroupsEnd; pBegin += 16 )
+		{
+			const __m128i bytes{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pBegin ) ) };
+			earlierSums = _mm_add_epi64( earlierSums, sums );
+			sums = _mm_add_epi64( sums, _mm_sad_epu8( bytes, zero ) );
+			const __m128i lowWeighted{ _mm_madd_epi16( _mm_unpacklo_epi8( bytes, zero ), lowWeights ) };
+			const __m128i highWeighted{ _mm_madd_epi16( _mm_unpackhi_epi8( bytes, zero ), highWeights ) };
+			weightedSums = _mm_add_epi32( weightedSums, _mm_add_epi32( lowWeighted, highWeighted ) );
+		}
+		alignas( 16 ) uint64_t sumLanes[2]{};
+		alignas( 16 ) uint64_t earlierSumLanes[2]{};
+		alignas( 16 ) uint32_t weightedSumLanes[4]{};
+		_mm_store_si128( reinterpret_cast<__m128i*>( sumLanes ), sums );
+		_mm_store_si128( reinterpret_cast<__m128i*>( earlierSumLanes ), earlierSums );
+		_mm_store_si128( reinterpret_cast<__m128i*>( weightedSumLanes ), weightedSums );
+		a += static_cast<uint32_t>( sumLanes[0] + sumLanes[1] );
+		b += static_cast<uint32_t>( 16 * ( earlierSumLanes[0] + earlierSumLanes[1] ) ) + weightedSumLanes[0] +
+			 weightedSumLanes[1] + weightedSumLanes[2] + weightedSumLanes[3];
+
+		for ( ; pBegin < pBlockEnd; ++pBegin )
+		{
+			a += *pBegin;
+			b += a;
+		}
+		a %= AdlerModulus;
+		b %= AdlerModulus;
+	}
+	return b << 16 | a;
+}
+
+// Fills pBegin to pEnd exactly, with CopySlack bytes after pEnd to spare
+// Throws error::texture::DecodeFail when the stream is corrupt, its Adler-32 included
+void Inflate( std::span<const uint8_t> stream, uint8_t* pBegin, uint8_t* pEnd )
+{
+	// zlib header: deflate with a window of at most 32 KB and no preset dictionary
+	if ( stream.size() < 2 )
+	{
+		throw error::texture::DecodeFail();
+	}
+	const uint32_t method{ stream[0] };
+	const uint32_t flags{ stream[1] };
+	if ( ( method & 15 ) != 8 || method >> 4 > 7 || ( method << 8 | flags ) % 31 != 0 || ( flags & 32 ) != 0 )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	BitReader reader{ stream.subspan( 2 ) };
+	const std::span<const uint8_t> deflate{ stream.subspan( 2 ) };
+	Huffman lengths{};
+	Huffman distances{};
+	uint8_t* pOut{ pBegin };
+	bool isLast{};
+	while ( !isLast )
+	{
+		reader.Refill();
+		isLast = reader.Read( 1 ) != 0;
+		switch ( reader.Read( 2 ) )
+		{
+		case 0:
+		{
+			const size_t position{ reader.AlignToByte() };
+			if ( position > deflate.size() || deflate.size() - position < 4 )
+			{
+				throw error::texture::DecodeFail();
+			}
+
+			const size_t length{ size_t{ deflate[position] } | size_t{ deflate[position + 1] } << 8 };
+			const size_t lengthComplement{ size_t{ deflate[position + 2] } | size_t{ deflate[position + 3] } << 8 };
+			if ( length != ( ~lengthComplement & 0xFFFF ) || length > deflate.size() - position - 4 ||
+				 length > static_cast<size_t>( pEnd - pOut ) )
+			{
+				throw error::texture::DecodeFail();
+			}
+			std::memcpy( pOut, deflate.data() + position + 4, length );
+			pOut += length;
+			reader.Skip( 4 + length );
+			break;
+		}
+		case 1:
+			InflateBlock( reader, GetFixedCodes().lengths, GetFixedCodes().distances, pBegin, pOut, pEnd );
+			break;
+		case 2:
+			ReadDynamicCodes( reader, lengths, distances );
+			InflateBlock( reader, lengths, distances, pBegin, pOut, pEnd );
+			break;
+		default:
+			throw error::texture::DecodeFail();
+		}
+
+		if ( reader.IsOverrun() )
+		{
+			throw error::texture::DecodeFail();
+		}
+	}
+
+	if ( pOut != pEnd )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	// zlib trailer, big-endian
+	const size_t position{ reader.AlignToByte() };
+	if ( position > deflate.size() || deflate.size() - position < 4 )
+	{
+		throw error::texture::DecodeFail();
+	}
+	const uint32_t adler32{ uint32_t{ deflate[position] } << 24 | uint32_t{ deflate[position + 1] } << 16 |
+							uint32_t{ deflate[position + 2] } << 8 | uint32_t{ deflate[position + 3] } };
+	if ( adler32 != GetAdler32( pBegin, pEnd ) )
+	{
+		throw error::texture::DecodeFail();
+	}
+}
+
+// Unfiltering
+uint32_t ReadBigEndian( const char* pBytes )
+{
+	const auto* pUnsigned{ reinterpret_cast<const uint8_t*>( pBytes ) };
+	return uint32_t{ pUnsigned[0] } << 24 | uint32_t{ pUnsigned[1] } << 16 | uint32_t{ pUnsigned[2] } << 8 |
+		   uint32_t{ pUnsigned[3] };
+}
+
+__m128i LoadPixel( const uint8_t* pPixel )
+{
+	int32_t pixel{};
+	std::memcpy( &pixel, pPixel, sizeof( pixel ) );
+	return _mm_cvtsi32_si128( pixel );
+}
+
+void StorePixel( uint8_t* pPixel, __m128i pixel )
+{
+	const int32_t value{ _mm_cvtsi128_si32( pixel ) };
+	std::memcpy( pPixel, &value, sizeof( value ) );
+}
+
+uint8_t GetPaethPredictor( int left, int up, int upLeft )
+{
+	const int leftDistance{ std::abs( up - upLeft ) };
+	const int upDistance{ std::abs( left - upLeft ) };
+	const int upLeftDistance{ std::abs( left + up - 2 * upLeft ) };
+	if ( leftDistance <= upDistance && leftDistance <= upLeftDistance )
+	{
+		return static_cast<uint8_t>( left );
+	}
+	return static_cast<uint8_t>( upDistance <= upLeftDistance ? up : upLeft );
+}
+
+void UnfilterUp( const uint8_t* pFiltered, const uint8_t* pPrevious, uint8_t* pRow, size_t rowBytes )
+{
+	size_t byteIdx{};
+	for ( ; byteIdx + sizeof( __m128i ) <= rowBytes; byteIdx += sizeof( __m128i ) )
+	{
+		const __m128i filtered{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pFiltered + byteIdx ) ) };
+		const __m128i up{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pPrevious + byteIdx ) ) };
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( pRow + byteIdx ), _mm_add_epi8( filtered, up ) );
+	}
+
+	for ( ; byteIdx < rowBytes; ++byteIdx )
+	{
+		pRow[byteIdx] = static_cast<uint8_t>( pFiltered[byteIdx] + pPrevious[byteIdx] );
+	}
+}
+
+// Sub, Average and Paeth depend on the pixel to the left, four channels of 8 bits go through SSE2 a pixel at a time
+// and Sub four pixels at a time as a prefix sum; other layouts through the scalar loops
+void UnfilterSub4( const uint8_t* pFiltered, uint8_t* pRow, size_t rowBytes )
+{
+	__m128i left{ _mm_setzero_si128() };
+	size_t byteIdx{};
+	for ( ; byteIdx + sizeof( __m128i ) <= rowBytes; byteIdx += sizeof( __m128i ) )
+	{
+		__m128i sum{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pFiltered + byteIdx ) ) };
+		sum = _mm_add_epi8( sum, _mm_slli_si128( sum, 4 ) );
+		sum = _mm_add_epi8( sum, _mm_slli_si128( sum, 8 ) );
+		sum = _mm_add_epi8( sum, left );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( pRow + byteIdx ), sum );
+		left = _mm_shuffle_epi32( sum, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+	}
+
+	for ( ; byteIdx < rowBytes; byteIdx += 4 )
+	{
+		left = _mm_add_epi8( LoadPixel( pFiltered + byteIdx ), left );
+		StorePixel( pRow + byteIdx, left );
+	}
+}
+
+void UnfilterAverage4( const uint8_t* pFiltered, const uint8_t* pPrevious, uint8_t* pRow, size_t rowBytes )
+{
+	// avg rounds up, the filter rounds down
+	const __m128i one{ _mm_set1_epi8( 1 ) };
+	__m128i left{ _mm_setzero_si128() };
+	for ( size_t byteIdx{}; byteIdx < rowBytes; byteIdx += 4 )
+	{
+		const __m128i up{ LoadPixel( pPrevious + byteIdx ) };
+		const __m128i average{ _mm_sub_epi8( _mm_avg_epu8( left, up ),
+											 _mm_and_si128( _mm_xor_si128( left, up ), one ) ) };
+		left = _mm_add_epi8( LoadPixel( pFiltered + byteIdx ), average );
+		StorePixel( pRow + byteIdx, left );
+	}
+}
+
+__m128i Abs16( __m128i value )
+{
+	return _mm_max_epi16( value, _mm_sub_epi16( _mm_setzero_si128(), value ) );
+}
+
+__m128i Select( __m128i mask, __m128i ifSet, __m128i ifClear )
+{
+	return _mm_or_si128( _mm_and_si128( mask, ifSet ), _mm_andnot_si128( mask, ifClear ) );
+}
+
+void UnfilterPaeth4( const uint8_t* pFiltered, const uint8_t* pPrevious, uint8_t* pRow, size_t rowBytes )
+{
+	// Widened to 16 bits, the distances don't fit in 8
+	const __m128i zero{ _mm_setzero_si128() };
+	__m128i left{ zero };
+	__m128i upLeft{ zero };
+	for ( size_t byteIdx{}; byteIdx < rowBytes; byteIdx += 4 )
+	{
+		const __m128i up{ _mm_unpacklo_epi8( LoadPixel( pPrevious + byteIdx ), zero ) };
+		const __m128i toUp{ _mm_sub_epi16( up, upLeft ) };
+		const __m128i toLeft{ _mm_sub_epi16( left, upLeft ) };
+		const __m128i leftDistance{ Abs16( toUp ) };
+		const __m128i upDistance{ Abs16( toLeft ) };
+		const __m128i upLeftDistance{ Abs16( _mm_add_epi16( toUp, toLeft ) ) };
+		const __m128i smallest{ _mm_min_epi16( upLeftDistance, _mm_min_epi16( leftDistance, upDistance ) ) };
+
+		// Ties go to left, then up
+		__m128i predictor{ Select( _mm_cmpeq_epi16( upDistance, smallest ), up, upLeft ) };
+		predictor = Select( _mm_cmpeq_epi16( leftDistance, smallest ), left, predictor );
+
+		const __m128i filtered{ _mm_unpacklo_epi8( LoadPixel( pFiltered + byteIdx ), zero ) };
+		left = _mm_and_si128( _mm_add_epi16( filtered, predictor ), _mm_set1_epi16( 0xFF ) );
+		StorePixel( pRow + byteIdx, _mm_packus_epi16( left, left ) );
+		upLeft = up;
+	}
+}
+
+void Unfilter( uint8_t filter,
+			   const uint8_t* pFiltered,
+			   const uint8_t* pPrevious,
+			   uint8_t* pRow,
+			   size_t rowBytes,
+			   size_t pixelBytes )
+{
+	const bool isFourBytes{ pixelBytes == 4 };
+	switch ( filter )
+	{
+	case 0:
+		std::memcpy( pRow, pFiltered, rowBytes );
+		return;
+	case 1:
+		if ( isFourBytes )
+		{
+			UnfilterSub4( pFiltered, pRow, rowBytes );
+			return;
+		}
+		std::memcpy( pRow, pFiltered, pixelBytes );
+		for ( size_t byteIdx{ pixelBytes }; byteIdx < rowBytes; ++byteIdx )
+		{
+			pRow[byteIdx] = static_cast<uint8_t>( pFiltered[byteIdx] + pRow[byteIdx - pixelBytes] );
+		}
+		return;
+	case 2:
+		UnfilterUp( pFiltered, pPrevious, pRow, rowBytes );
+		return;
+	case 3:
+		if ( isFourBytes )
+		{
+			UnfilterAverage4( pFiltered, pPrevious, pRow, rowBytes );
+			return;
+		}
+		for ( size_t byteIdx{}; byteIdx < rowBytes; ++byteIdx )
+		{
+			const uint32_t left{ byteIdx >= pixelBytes ? pRow[byteIdx - pixelBytes] : uint8_t{} };
+			pRow[byteIdx] = static_cast<uint8_t>( pFiltered[byteIdx] + ( ( left + pPrevious[byteIdx] ) >> 1 ) );
+		}
+		return;
+	case 4:
+		if ( isFourBytes )
+		{
+			UnfilterPaeth4( pFiltered, pPrevious, pRow, rowBytes );
+			return;
+		}
+		for ( size_t byteIdx{}; byteIdx < rowBytes; ++byteIdx )
+		{
+			const bool hasLeft{ byteIdx >= pixelBytes };
+			const uint8_t predictor{ GetPaethPredictor( hasLeft ? pRow[byteIdx - pixelBytes] : 0,
+														pPrevious[byteIdx],
+														hasLeft ? pPrevious[byteIdx - pixelBytes] : 0 ) };
+			pRow[byteIdx] = static_cast<uint8_t>( pFiltered[byteIdx] + predictor );
+		}
+		return;
+	default:
+		throw error::texture::DecodeFail();
+	}
+}
+
+// Expanding to RGBA
+// A 16-bit sample keeps its high byte, like SDL_image does
+struct Expander
+{
+	const Header& header;
+	std::array<uint32_t, 256> palette{}; // RGBA, opaque black past the end of PLTE
+	std::array<uint32_t, 3> transparentKey{};
+	bool hasTransparentKey{};
+
+	uint32_t GetSample( const uint8_t* pRow, size_t sampleIdx ) const
+	{
+		return header.bitDepth == 16 ? uint32_t{ pRow[sampleIdx * 2] } << 8 | pRow[sampleIdx * 2 + 1]
+									 : pRow[sampleIdx];
+	}
+
+	void Expand( const uint8_t* pRow, uint8_t* pRgba ) const
+	{
+		const uint32_t shift{ header.bitDepth - 8 };
+		for ( size_t pixelIdx{}; pixelIdx < header.info.width; ++pixelIdx, pRgba += TextureData::BytesPerPixel )
+		{
+			const size_t sampleIdx{ pixelIdx * header.channelCount };
+			switch ( header.colorType )
+			{
+			case ColorType::gray:
+			{
+				const uint32_t gray{ GetSample( pRow, sampleIdx ) };
+				pRgba[0] = pRgba[1] = pRgba[2] = static_cast<uint8_t>( gray >> shift );
+				pRgba[3] = hasTransparentKey && gray == transparentKey[0] ? 0 : 255;
+				break;
+			}
+			case ColorType::rgb:
+			{
+				const uint32_t red{ GetSample( pRow, sampleIdx ) };
+				const uint32_t green{ GetSample( pRow, sampleIdx + 1 ) };
+				const uint32_t blue{ GetSample( pRow, sampleIdx + 2 ) };
+				pRgba[0] = static_cast<uint8_t>( red >> shift );
+				pRgba[1] = static_cast<uint8_t>( green >> shift );
+				pRgba[2] = static_cast<uint8_t>( blue >> shift );
+				pRgba[3] = hasTransparentKey && red == transparentKey[0] && green == transparentKey[1] &&
+								   blue == transparentKey[2]
+							   ? 0
+							   : 255;
+				break;
+			}
+			case ColorType::palette:
+				std::memcpy( pRgba, &palette[pRow[pixelIdx]], TextureData::BytesPerPixel );
+				break;
+			case ColorType::grayAlpha:
+				pRgba[0] = pRgba[1] = pRgba[2] = static_cast<uint8_t>( GetSample( pRow, sampleIdx ) >> shift );
+				pRgba[3] = static_cast<uint8_t>( GetSample( pRow, sampleIdx + 1 ) >> shift );
+				break;
+			case ColorType::rgba:
+				for ( size_t channelIdx{}; channelIdx < 4; ++channelIdx )
+				{
+					pRgba[channelIdx] = static_cast<uint8_t>( GetSample( pRow, sampleIdx + channelIdx ) >> shift );
+				}
+				break;
+			}
+		}
+	}
+};
+
+Expander MakeExpander( const Header& header, const Chunks& chunks )
+{
+	Expander expander{ header };
+	const auto* pPalette{ reinterpret_cast<const uint8_t*>( chunks.palette.data() ) };
+	const auto* pTransparency{ reinterpret_cast<const uint8_t*>( chunks.transparency.data() ) };
+	if ( header.colorType == ColorType::palette )
+	{
+		const size_t colorCount{ chunks.palette.size() / 3 };
+		if ( colorCount == 0 || colorCount > expander.palette.size() || chunks.palette.size() % 3 != 0 )
+		{
+			throw error::texture::DecodeFail();
+		}
+
+		expander.palette.fill( 0xFF000000 );
+		for ( size_t colorIdx{}; colorIdx < colorCount; ++colorIdx )
+		{
+			const uint32_t alpha{ colorIdx < chunks.transparency.size() ? pTransparency[colorIdx] : uint8_t{ 255 } };
+			expander.palette[colorIdx] = uint32_t{ pPalette[colorIdx * 3] } |
+										 uint32_t{ pPalette[colorIdx * 3 + 1] } << 8 |
+										 uint32_t{ pPalette[colorIdx * 3 + 2] } << 16 | alpha << 24;
+		}
+	}
+	else if ( !chunks.transparency.empty() &&
+			  ( header.colorType == ColorType::gray || header.colorType == ColorType::rgb ) )
+	{
+		const size_t keyCount{ header.colorType == ColorType::gray ? size_t{ 1 } : size_t{ 3 } };
+		if ( chunks.transparency.size() < keyCount * 2 )
+		{
+			throw error::texture::DecodeFail();
+		}
+
+		expander.hasTransparentKey = true;
+		for ( size_t keyIdx{}; keyIdx < keyCount; ++keyIdx )
+		{
+			expander.transparentKey[keyIdx] = uint32_t{ pTransparency[keyIdx * 2] } << 8 |
+											  pTransparency[keyIdx * 2 + 1];
+		}
+	}
+	return expander;
+}
+
+// Chunks
+uint32_t GetCrc32( std::string_view bytes )
+{
+	const auto* pByte{ reinterpret_cast<const uint8_t*>( bytes.data() ) };
+	const uint8_t* const pEnd{ pByte + bytes.size() };
+	uint32_t crc{ 0xFFFFFFFF };
+	for ( ; pEnd - pByte >= 8; pByte += 8 )
+	{
+		uint32_t low{};
+		uint32_t high{};
+		std::memcpy( &low, pByte, sizeof( low ) );
+		std::memcpy( &high, pByte + 4, sizeof( high ) );
+		low ^= crc;
+		crc = CrcTables[7][low & 255] ^ CrcTables[6][low >> 8 & 255] ^ CrcTables[5][low >> 16 & 255] ^
+			  CrcTables[4][low >> 24] ^ CrcTables[3][high & 255] ^ CrcTables[2][high >> 8 & 255] ^
+			  CrcTables[1][high >> 16 & 255] ^ CrcTables[0][high >> 24];
+	}
+	for ( ; pByte < pEnd; ++pByte )
+	{
+		crc = CrcTables[0][( crc ^ *pByte ) & 255] ^ crc >> 8;
+	}
+	return ~crc;
+}
+
+std::optional<Header> ReadHeader( std::string_view bytes )
+{
+	// IHDR always comes first
+	constexpr size_t headerChunkEnd{ Signature.size() + 8 + 13 };
+	if ( bytes.size() < headerChunkEnd || bytes.substr( 0, Signature.size() ) != Signature )
+	{
+		return std::nullopt;
+	}
+
+	const char* pChunk{ bytes.data() + Signature.size() };
+	if ( ReadBigEndian( pChunk ) != 13 || std::string_view{ pChunk + 4, 4 } != "IHDR" )
+	{
+		return std::nullopt;
+	}
+
+	const auto* pData{ reinterpret_cast<const uint8_t*>( pChunk + 8 ) };
+	Header header{};
+	header.info = { ReadBigEndian( pChunk + 8 ), ReadBigEndian( pChunk + 12 ) };
+	header.bitDepth = pData[8];
+	header.colorType = static_cast<ColorType>( pData[9] );
+	switch ( header.colorType )
+	{
+	case ColorType::gray:
+	case ColorType::palette:
+		header.channelCount = 1;
+		break;
+	case ColorType::grayAlpha:
+		header.channelCount = 2;
+		break;
+	case ColorType::rgb:
+		header.channelCount = 3;
+		break;
+	case ColorType::rgba:
+		header.channelCount = 4;
+		break;
+	default:
+		return std::nullopt;
+	}
+
+	// Compression, filter and interlace method, only the first two have a single valid value
+	const bool isHandledDepth{ header.bitDepth == 8 ||
+							   ( header.bitDepth == 16 && header.colorType != ColorType::palette ) };
+	if ( !isHandledDepth || pData[10] != 0 || pData[11] != 0 || pData[12] != 0 )
+	{
+		return std::nullopt;
+	}
+
+	if ( header.info.width == 0 || header.info.height == 0 || header.info.width > MaxDimension ||
+		 header.info.height > MaxDimension )
+	{
+		return std::nullopt;
+	}
+	return header;
+}
+
+Chunks ReadChunks( std::string_view bytes )
+{
+	Chunks chunks{};
+	size_t position{ Signature.size() };
+	while ( bytes.size() - position >= 12 )
+	{
+		const size_t length{ ReadBigEndian( bytes.data() + position ) };
+		if ( length > bytes.size() - position - 12 )
+		{
+			throw error::texture::DecodeFail();
+		}
+
+		// Critical chunks and tRNS, the one ancillary chunk read here, have to match their CRC like libpng wants them
+		// to; the others are skipped unread
+		const std::string_view type{ bytes.substr( position + 4, 4 ) };
+		const std::string_view data{ bytes.substr( position + 8, length ) };
+		const bool isCritical{ ( type[0] & 0x20 ) == 0 };
+		if ( ( isCritical || type == "tRNS" ) &&
+			 GetCrc32( bytes.substr( position + 4, 4 + length ) ) != ReadBigEndian( data.data() + length ) )
+		{
+			throw error::texture::DecodeFail();
+		}
+
+		if ( type == "IDAT" )
+		{
+			chunks.data.push_back( data );
+		}
+		else if ( type == "PLTE" )
+		{
+			chunks.palette = data;
+		}
+		else if ( type == "tRNS" )
+		{
+			chunks.transparency = data;
+		}
+		else if ( type == "IEND" )
+		{
+			break;
+		}
+		position += 12 + length;
+	}
+
+	if ( chunks.data.empty() )
+	{
+		throw error::texture::DecodeFail();
+	}
+	return chunks;
+}
+} // namespace
+
+std::optional<Info> ReadInfo( std::string_view bytes )
+{
+	const std::optional<Header> header{ ReadHeader( bytes ) };
+	return header ? std::optional<Info>{ header->info } : std::nullopt;
+}
+
+void Decode( std::string_view bytes, std::span<std::byte> rgba, size_t rowPitch )
+{
+	const std::optional<Header> header{ ReadHeader( bytes ) };
+	if ( !header )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	const size_t width{ header->info.width };
+	const size_t height{ header->info.height };
+	if ( rowPitch < width * TextureData::BytesPerPixel ||
+		 rgba.size() < rowPitch * ( height - 1 ) + width * TextureData::BytesPerPixel )
+	{
+		throw error::texture::DecodeFail();
+	}
+
+	// The zlib stream is usually split over many IDATs, it is only inflated in one piece
+	const Chunks chunks{ ReadChunks( bytes ) };
+	std::vector<uint8_t> joinedData{};
+	std::span<const uint8_t> stream{ reinterpret_cast<const uint8_t*>( chunks.data.front().data() ),
+									 chunks.data.front().size() };
+	if ( chunks.data.size() > 1 )
+	{
+		for ( const std::string_view data : chunks.data )
+		{
+			joinedData.insert( joinedData.end(), data.begin(), data.end() );
+		}
+		stream = joinedData;
+	}
+
+	// Every row starts with its filter type
+	const size_t pixelBytes{ header->channelCount * header->bitDepth / 8 };
+	const size_t rowBytes{ width * pixelBytes };
+	const size_t filteredBytes{ ( rowBytes + 1 ) * height };
+	const std::unique_ptr<uint8_t[]> pFiltered{ std::make_unique_for_overwrite<uint8_t[]>( filteredBytes +
+																						 CopySlack ) };
+	Inflate( stream, pFiltered.get(), pFiltered.get() + filteredBytes );
+
+	// 8-bit RGBA is unfiltered straight into rgba; anything else into a row of its own first, then expanded
+	const bool isRgba8{ header->colorType == ColorType::rgba && header->bitDepth == 8 };
+	const std::optional<Expander> expander{ isRgba8 ? std::nullopt
+													: std::optional<Expander>{ MakeExpander( *header, chunks ) } };
+	// Rows that are expanded take turns in these two, the second is also the row of zeros above the first
+	std::vector<uint8_t> rows( rowBytes * 2 );
+	const uint8_t* pPrevious{ rows.data() + rowBytes };
+	auto* pRgba{ reinterpret_cast<uint8_t*>( rgba.data() ) };
+	for ( size_t y{}; y < height; ++y )
+	{
+		const uint8_t* pFilteredRow{ pFiltered.get() + y * ( rowBytes + 1 ) };
+		uint8_t* pRow{ isRgba8 ? pRgba + y * rowPitch : rows.data() + ( y & 1 ) * rowBytes };
+		Unfilter( pFilteredRow[0], pFilteredRow + 1, pPrevious, pRow, rowBytes, pixelBytes );
+		if ( expander )
+		{
+			expander->Expand( pRow, pRgba + y * rowPitch );
+		}
+		pPrevious = pRow;
+	}
+}
+} // namespace png
+} // namespace dae
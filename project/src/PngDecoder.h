@@ -0,0 +1,33 @@
+#ifndef PNGDECODER_H
+#define PNGDECODER_H
+
+// Decodes PNGs straight into 8-bit RGBA, without an SDL surface in between
+// Inflate looks the Huffman codes up in tables, a whole code per lookup for all but the rare long ones; every row is
+// unfiltered with SSE2 from the inflated bytes into the caller's buffer, so the image is written out once
+// Interlaced images and bit depths below 8 aren't handled here, they are left to SDL_image; the CRCs of the chunks it
+// reads and the zlib stream's Adler-32 are checked, a corrupt file throws rather than decoding to garbage
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dae
+{
+namespace png
+{
+struct Info
+{
+	uint32_t width{};
+	uint32_t height{};
+};
+
+// The size from the image's header; nothing when the bytes aren't a PNG or hold one this decoder doesn't handle
+std::optional<Info> ReadInfo( std::string_view bytes );
+
+// Writes the image to rgba, one row every rowPitch bytes, which is at least width * 4; rgba has to hold every row
+// Throws error::texture::DecodeFail when the file is corrupt or ReadInfo turns it down
+void Decode( std::string_view bytes, std::span<std::byte> rgba, size_t rowPitch );
+} // namespace png
+} // namespace dae
+#endif
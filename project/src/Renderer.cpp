@@ -15,9 +15,12 @@
 
 using namespace dae;
 
-Renderer::Renderer( SDL_Window* pWindow )
-	: m_pWindow( pWindow )
+Renderer::Renderer( SDL_Window* pWindow, size_t textureBudgetBytes, bool isLoadBatched )
+	: m_TextureBudgetBytes( textureBudgetBytes )
+	, m_pWindow( pWindow )
 {
+	m_AssetLoader.SetBatched( isLoadBatched );
+
 	// Initialize Window
 	SDL_GetWindowSize( pWindow, &m_Width, &m_Height );
 
@@ -30,6 +33,8 @@ Renderer::Renderer( SDL_Window* pWindow )
 	else
 	{
 		m_IsInitialized = true;
+		m_pTextureStreamer = std::make_unique<TextureStreamer>( m_pDevice, m_pDeviceContext, m_TextureBudgetBytes );
+		m_pResourceCache = std::make_unique<ResourceCache>( m_pDevice, *m_pTextureStreamer );
 		std::cout << "DirectX is initialized and ready\n";
 	}
 }
@@ -76,6 +81,20 @@ Renderer::~Renderer() noexcept
 
 void Renderer::Update( const Timer& timer )
 {
+	if ( !m_IsInitialized )
+	{
+		return;
+	}
+
+	m_AssetLoader.Update();
+	// Only the startup loads are batched, levels streamed in later go up as they land
+	if ( !IsLoading() )
+	{
+		m_AssetLoader.SetBatched( false );
+	}
+
+	// The scene asked for texture levels during the last frame's update
+	error::utils::HandleThrowingFunction( [&]() { m_pTextureStreamer->Update( m_AssetLoader ); } );
 }
 
 void Renderer::Render( Scene* pScene )
@@ -90,8 +109,13 @@ void Renderer::Render( Scene* pScene )
 	m_pDeviceContext->ClearRenderTargetView( m_pRenderTargetView, color );
 	m_pDeviceContext->ClearDepthStencilView( m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0 );
 
-	// 2. Draw
-	const bool failed{ error::utils::HandleThrowingFunction( [&]() { pScene->Draw( m_pDeviceContext ); } ) };
+	// 2. Draw, a scene with nothing loaded yet is only cleared
+	const bool failed{ error::utils::HandleThrowingFunction( [&]() {
+		if ( !pScene->IsEmpty() || !IsLoading() )
+		{
+			pScene->Draw( m_pDeviceContext );
+		}
+	} ) };
 	if ( failed )
 	{
 		m_IsInitialized = false;
@@ -104,7 +128,57 @@ void Renderer::Render( Scene* pScene )
 
 void Renderer::InitScene( Scene* pScene )
 {
-	pScene->Initialize( m_pDevice, ( static_cast<float>( m_Width ) / m_Height ) );
+	if ( !m_IsInitialized )
+	{
+		return;
+	}
+
+	pScene->SetScreenHeight( static_cast<uint32_t>( m_Height ) );
+	pScene->Initialize( m_pDevice, m_AssetLoader, *m_pResourceCache, ( static_cast<float>( m_Width ) / m_Height ) );
+}
+
+void Renderer::PrintStatistics() const
+{
+	if ( !m_pResourceCache )
+	{
+		return;
+	}
+
+	const auto print{ []( const char* name, const ResourceCache::Counters& counters ) {
+		std::cout << " " << name << " " << counters.hitCount << " hits/" << counters.missCount << " misses";
+	} };
+	const ResourceCache::Statistics& statistics{ m_pResourceCache->GetStatistics() };
+	std::cout << "Resource cache:";
+	print( "textures", statistics.textures );
+	print( "effects", statistics.effects );
+	print( "samplers", statistics.samplers );
+	std::cout << std::endl;
+}
+
+void Renderer::PrintStreamingStatistics() const
+{
+	if ( !m_pTextureStreamer )
+	{
+		return;
+	}
+
+	constexpr double bytesPerMb{ 1024.0 * 1024.0 };
+	const TextureStreamer::Statistics statistics{ m_pTextureStreamer->GetStatistics() };
+	std::cout << "Texture streaming: " << statistics.residentBytes / bytesPerMb << "/"
+			  << statistics.budgetBytes / bytesPerMb << " MB resident in " << statistics.textureCount << " textures, "
+			  << statistics.pendingCount << " pending, " << statistics.streamedLevelCount << " levels streamed in, "
+			  << statistics.evictedLevelCount << " evicted" << std::endl;
+}
+
+void Renderer::PrintLoadTimeline() const
+{
+	m_AssetLoader.PrintTimeline();
+}
+
+bool Renderer::IsLoading() const
+{
+	const size_t streamingCount{ m_pTextureStreamer ? m_pTextureStreamer->GetPendingCount() : 0 };
+	return m_AssetLoader.GetPendingCount() > streamingCount;
 }
 
 void Renderer::InitializeDirectX()
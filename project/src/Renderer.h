@@ -12,6 +12,10 @@
 #include <d3dx11effect.h>
 
 // Framework Headers
+#include <memory>
+#include "AssetLoader.h"
+#include "ResourceCache.h"
+#include "TextureStreamer.h"
 #include "Timer.h"
 #include "Scene.h"
 
@@ -20,7 +24,11 @@ namespace dae
 class Renderer final
 {
 public:
-	Renderer( SDL_Window* pWindow );
+	// isLoadBatched holds the GPU objects of the scene's startup loads back until all of them are loaded, see
+	// AssetLoader::SetBatched
+	Renderer( SDL_Window* pWindow,
+			  size_t textureBudgetBytes = TextureStreamer::DefaultBudgetBytes,
+			  bool isLoadBatched = false );
 	~Renderer() noexcept;
 
 	Renderer( const Renderer& ) = delete;
@@ -28,14 +36,28 @@ public:
 	Renderer& operator=( const Renderer& ) = delete;
 	Renderer& operator=( Renderer&& ) noexcept = delete;
 
+	// Creates the GPU objects for whatever finished loading since the last frame
 	void Update( const Timer& timer );
 	void Render( Scene* pScene );
 
+	// Only requests the scene's assets, they load in the background
 	void InitScene( Scene* pScene );
 
+	// Resource cache hits and misses since startup
+	void PrintStatistics() const;
+	// Texture memory resident against the budget and the levels streamed so far
+	void PrintStreamingStatistics() const;
+	// Every load so far, on which worker and how much of it overlapped
+	void PrintLoadTimeline() const;
+
+	// Getters
+	// Texture levels streaming in don't count
+	bool IsLoading() const;
+
 private:
 	int m_Width{};
 	int m_Height{};
+	size_t m_TextureBudgetBytes{};
 
 	bool m_IsInitialized{ false };
 
@@ -59,6 +81,12 @@ private:
 	// HARDWARE RESOURCES: NON-OWNING
 	//
 
+	// SOFTWARE RESOURCES
+	AssetLoader m_AssetLoader{};
+	std::unique_ptr<TextureStreamer> m_pTextureStreamer{}; // needs the device
+	std::unique_ptr<ResourceCache> m_pResourceCache{};	   // needs the device and the streamer
+	//
+
 	// DIRECTX
 	void InitializeDirectX();
 	//
@@ -0,0 +1,234 @@
+#include <filesystem>
+#include "ResourceCache.h"
+#include "CookedTexture.h"
+#include "Hash.h"
+
+namespace dae
+{
+namespace
+{
+// Two spellings of the same file share an entry
+std::string GetPathKey( const std::filesystem::path& path )
+{
+	return std::filesystem::weakly_canonical( path ).generic_string();
+}
+
+// Cooked files keep the options they were cooked with, sources get a chain per options
+std::string GetTextureKey( const std::string& path, const cooked::texture::Options& options )
+{
+	return GetPathKey( path ) + '|' + std::to_string( cooked::texture::HashOptions( options ) );
+}
+
+std::string GetPackedTextureKey( const std::string& colorPath,
+								 const std::string& alphaPath,
+								 const cooked::texture::Options& options )
+{
+	return cooked::texture::GetPackedSourcePath( GetPathKey( colorPath ), GetPathKey( alphaPath ) ) + '|' +
+		   std::to_string( cooked::texture::HashOptions( options ) );
+}
+
+// What the load timeline shows, the file name is enough to tell them apart
+std::string GetLoadName( const std::filesystem::path& path )
+{
+	return path.filename().string();
+}
+
+// The layout picks the technique and the input layout, so effects are created once per layout
+std::string GetEffectKey( const std::wstring& path, const VertexLayout& layout )
+{
+	return GetPathKey( path ) + '|' + std::to_string( hash::HashBytes( &layout, sizeof( VertexLayout ) ) );
+}
+} // namespace
+
+ResourceCache::ResourceCache( ID3D11Device* pDevice, TextureStreamer& textureStreamer )
+	: m_TextureStreamer( textureStreamer )
+	, m_pDevice( pDevice )
+{
+}
+
+std::shared_ptr<const Texture> ResourceCache::GetTexture( const std::string& path,
+														 const cooked::texture::Options& options )
+{
+	return Get( m_Textures, m_Statistics.textures, GetTextureKey( path, options ), [&]() {
+		return m_TextureStreamer.Create( cooked::texture::Load( path, options ) );
+	} );
+}
+
+std::shared_ptr<Effect> ResourceCache::GetEffect( const std::wstring& path, const VertexLayout& layout )
+{
+	return Get( m_Effects, m_Statistics.effects, GetEffectKey( path, layout ), [&]() {
+		return std::make_shared<Effect>( m_pDevice, Effect::CompileEffect( path ), layout, GetSamplers() );
+	} );
+}
+
+std::shared_ptr<TransparentEffect> ResourceCache::GetTransparentEffect( const std::wstring& path,
+																		const VertexLayout& layout )
+{
+	return Get( m_TransparentEffects, m_Statistics.effects, GetEffectKey( path, layout ), [&]() {
+		return std::make_shared<TransparentEffect>( m_pDevice, Effect::CompileEffect( path ), layout, GetSamplers() );
+	} );
+}
+
+std::shared_ptr<const Sampler> ResourceCache::GetSampler( Sampler::FilterMode filterMode )
+{
+	return Get( m_Samplers, m_Statistics.samplers, std::to_string( static_cast<int>( filterMode ) ), [&]() {
+		return std::make_shared<const Sampler>( m_pDevice, filterMode );
+	} );
+}
+
+SamplerSet ResourceCache::GetSamplers()
+{
+	SamplerSet samplers{};
+	for ( size_t modeIdx{}; modeIdx < Sampler::FilterModeCount; ++modeIdx )
+	{
+		samplers[modeIdx] = GetSampler( static_cast<Sampler::FilterMode>( modeIdx ) );
+	}
+	return samplers;
+}
+
+void ResourceCache::RequestTexture( AssetLoader& loader,
+									const std::string& path,
+									const cooked::texture::Options& options,
+									Ready<const Texture> ready )
+{
+	Request(
+		loader,
+		m_Textures,
+		m_Statistics.textures,
+		GetTextureKey( path, options ),
+		GetLoadName( path ),
+		[path, options]() { return cooked::texture::Load( path, options ); },
+		[this]( TextureData&& texture ) { return m_TextureStreamer.Create( std::move( texture ) ); },
+		std::move( ready ) );
+}
+
+void ResourceCache::RequestPackedTexture( AssetLoader& loader,
+										  const std::string& colorPath,
+										  const std::string& alphaPath,
+										  const cooked::texture::Options& options,
+										  Ready<const Texture> ready )
+{
+	Request(
+		loader,
+		m_Textures,
+		m_Statistics.textures,
+		GetPackedTextureKey( colorPath, alphaPath, options ),
+		cooked::texture::GetPackedSourcePath( GetLoadName( colorPath ), GetLoadName( alphaPath ) ),
+		[colorPath, alphaPath, options]() { return cooked::texture::LoadPacked( colorPath, alphaPath, options ); },
+		[this]( TextureData&& texture ) { return m_TextureStreamer.Create( std::move( texture ) ); },
+		std::move( ready ) );
+}
+
+void ResourceCache::RequestEffect( AssetLoader& loader,
+								   const std::wstring& path,
+								   const VertexLayout& layout,
+								   Ready<Effect> ready )
+{
+	Request(
+		loader,
+		m_Effects,
+		m_Statistics.effects,
+		GetEffectKey( path, layout ),
+		GetLoadName( path ),
+		[path]() { return Effect::CompileEffect( path ); },
+		[this, layout]( std::vector<std::byte>&& bytecode ) {
+			return std::make_shared<Effect>( m_pDevice, bytecode, layout, GetSamplers() );
+		},
+		std::move( ready ) );
+}
+
+void ResourceCache::RequestTransparentEffect( AssetLoader& loader,
+											  const std::wstring& path,
+											  const VertexLayout& layout,
+											  Ready<TransparentEffect> ready )
+{
+	Request(
+		loader,
+		m_TransparentEffects,
+		m_Statistics.effects,
+		GetEffectKey( path, layout ),
+		GetLoadName( path ),
+		[path]() { return Effect::CompileEffect( path ); },
+		[this, layout]( std::vector<std::byte>&& bytecode ) {
+			return std::make_shared<TransparentEffect>( m_pDevice, bytecode, layout, GetSamplers() );
+		},
+		std::move( ready ) );
+}
+
+const ResourceCache::Statistics& ResourceCache::GetStatistics() const
+{
+	return m_Statistics;
+}
+
+template <typename Resource, typename Create>
+std::shared_ptr<Resource> ResourceCache::Get( Table<Resource>& table,
+											  Counters& counters,
+											  const std::string& key,
+											  Create&& create )
+{
+	std::weak_ptr<Resource>& pCached{ table.resources[key] };
+	if ( std::shared_ptr<Resource> pResource{ pCached.lock() } )
+	{
+		++counters.hitCount;
+		return pResource;
+	}
+
+	++counters.missCount;
+	std::shared_ptr<Resource> pResource{ create() };
+	pCached = pResource;
+	return pResource;
+}
+
+template <typename Resource, typename Load, typename Create>
+void ResourceCache::Request( AssetLoader& loader,
+							 Table<Resource>& table,
+							 Counters& counters,
+							 const std::string& key,
+							 std::string name,
+							 Load&& load,
+							 Create&& create,
+							 Ready<Resource> ready )
+{
+	if ( std::shared_ptr<Resource> pResource{ table.resources[key].lock() } )
+	{
+		++counters.hitCount;
+		ready( pResource );
+		return;
+	}
+
+	// Already loading for someone else, wait for that instead of loading it twice
+	const auto loading{ table.loading.find( key ) };
+	if ( loading != table.loading.end() )
+	{
+		++counters.hitCount;
+		loading->second.push_back( std::move( ready ) );
+		return;
+	}
+
+	++counters.missCount;
+	table.loading[key].push_back( std::move( ready ) );
+	loader.Enqueue(
+		std::move( name ),
+		std::forward<Load>( load ),
+		[&table, key, create = std::forward<Create>( create )]( auto&& loaded ) {
+			// Taken out first, so a throwing create doesn't leave later requests waiting on a load that is over
+			const std::vector<Ready<Resource>> waiting{ std::move( table.loading[key] ) };
+			table.loading.erase( key );
+
+			// A blocking Get may have created it while this was loading
+			std::weak_ptr<Resource>& pCached{ table.resources[key] };
+			std::shared_ptr<Resource> pResource{ pCached.lock() };
+			if ( !pResource )
+			{
+				pResource = create( std::move( loaded ) );
+				pCached = pResource;
+			}
+
+			for ( const Ready<Resource>& waiter : waiting )
+			{
+				waiter( pResource );
+			}
+		},
+		[&table, key]() { table.loading.erase( key ); } );
+}
+} // namespace dae
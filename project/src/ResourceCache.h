@@ -0,0 +1,119 @@
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+// Hands out shared textures, effects and samplers, so an asset used by many meshes is loaded and uploaded once
+// Keyed by canonical path plus whatever else the resource was created with; the cache only keeps weak references, a
+// resource is released with its last handle and loaded again the next time it is asked for
+// Only used from the render thread, loads that go through the asset loader finish there too
+// Textures are created by the texture streamer, a mesh asking for more than their tail gets it streamed in
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AssetLoader.h"
+#include "CookedTexture.h"
+#include "Effect.h"
+#include "Sampler.h"
+#include "Texture.h"
+#include "TextureStreamer.h"
+#include "VertexLayout.h"
+
+namespace dae
+{
+class ResourceCache final
+{
+public:
+	struct Counters
+	{
+		size_t hitCount{};	// includes requests that joined a load already in flight
+		size_t missCount{}; // every miss is a load and an upload
+	};
+
+	struct Statistics
+	{
+		Counters textures{};
+		Counters effects{};
+		Counters samplers{};
+	};
+
+	template <typename Resource>
+	using Ready = std::function<void( std::shared_ptr<Resource> )>;
+
+	ResourceCache( ID3D11Device* pDevice, TextureStreamer& textureStreamer );
+	ResourceCache( const ResourceCache& ) = delete;
+	ResourceCache( ResourceCache&& ) = delete;
+	ResourceCache& operator=( const ResourceCache& ) = delete;
+	ResourceCache& operator=( ResourceCache&& ) = delete;
+
+	~ResourceCache() noexcept = default;
+
+	// Methods
+	// A miss loads on the calling thread
+	std::shared_ptr<const Texture> GetTexture( const std::string& path,
+											   const cooked::texture::Options& options = {} );
+	std::shared_ptr<Effect> GetEffect( const std::wstring& path, const VertexLayout& layout );
+	std::shared_ptr<TransparentEffect> GetTransparentEffect( const std::wstring& path, const VertexLayout& layout );
+	std::shared_ptr<const Sampler> GetSampler( Sampler::FilterMode filterMode );
+	SamplerSet GetSamplers();
+
+	// A hit calls ready right away, a miss loads on the loader's workers and calls it from AssetLoader::Update
+	// ready is never called when the load fails
+	void RequestTexture( AssetLoader& loader,
+						 const std::string& path,
+						 const cooked::texture::Options& options,
+						 Ready<const Texture> ready );
+	// Packs the sources on the loader's workers, see cooked::texture::LoadPacked
+	void RequestPackedTexture( AssetLoader& loader,
+							   const std::string& colorPath,
+							   const std::string& alphaPath,
+							   const cooked::texture::Options& options,
+							   Ready<const Texture> ready );
+	void RequestEffect( AssetLoader& loader,
+						const std::wstring& path,
+						const VertexLayout& layout,
+						Ready<Effect> ready );
+	void RequestTransparentEffect( AssetLoader& loader,
+								   const std::wstring& path,
+								   const VertexLayout& layout,
+								   Ready<TransparentEffect> ready );
+
+	// Getters
+	const Statistics& GetStatistics() const;
+
+private:
+	template <typename Resource>
+	struct Table
+	{
+		std::unordered_map<std::string, std::weak_ptr<Resource>> resources{};
+		std::unordered_map<std::string, std::vector<Ready<Resource>>> loading{}; // waiting on the load in flight
+	};
+
+	// SOFTWARE RESOURCES
+	Table<const Texture> m_Textures{};
+	Table<Effect> m_Effects{};
+	Table<TransparentEffect> m_TransparentEffects{};
+	Table<const Sampler> m_Samplers{};
+	Statistics m_Statistics{};
+	TextureStreamer& m_TextureStreamer;
+	//
+
+	// HARDWARE RESOURCES: NON-OWNING
+	ID3D11Device* m_pDevice{};
+	//
+
+	template <typename Resource, typename Create>
+	std::shared_ptr<Resource> Get( Table<Resource>& table, Counters& counters, const std::string& key, Create&& create );
+	template <typename Resource, typename Load, typename Create>
+	void Request( AssetLoader& loader,
+				  Table<Resource>& table,
+				  Counters& counters,
+				  const std::string& key,
+				  std::string name,
+				  Load&& load,
+				  Create&& create,
+				  Ready<Resource> ready );
+};
+} // namespace dae
+#endif
@@ -6,38 +6,31 @@
 #undef min
 #undef max
 
-Sampler::Sampler( ID3D11Device* pDevice, ID3DX11Effect* pEffect )
+Sampler::Sampler( ID3D11Device* pDevice, FilterMode filterMode )
+	: m_FilterMode( filterMode )
 {
-	m_pSamplerVariable = pEffect->GetVariableByName( "gSampler" )->AsSampler();
-
-	if ( !m_pSamplerVariable )
-	{
-		throw error::effect::InvalidSampler();
-	}
-
-	HRESULT result{};
-
 	D3D11_SAMPLER_DESC samplerDesc{};
-	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
 	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
 	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
 	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
 
-	result = pDevice->CreateSamplerState( &samplerDesc, &m_pPointSampler );
-	if ( FAILED( result ) )
+	switch ( filterMode )
 	{
-		throw error::effect::InvalidSampler();
-	}
+	case FilterMode::point:
+		samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
+		break;
 
-	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-	result = pDevice->CreateSamplerState( &samplerDesc, &m_pLinearSampler );
-	if ( FAILED( result ) )
-	{
-		throw error::effect::InvalidSampler();
+	case FilterMode::linear:
+		samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+		break;
+
+	case FilterMode::anisotropic:
+	default:
+		samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
+		break;
 	}
 
-	samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
-	result = pDevice->CreateSamplerState( &samplerDesc, &m_pAnisotropicSampler );
+	const HRESULT result{ pDevice->CreateSamplerState( &samplerDesc, &m_pSamplerState ) };
 	if ( FAILED( result ) )
 	{
 		throw error::effect::InvalidSampler();
@@ -51,17 +44,10 @@ Sampler::Sampler( Sampler&& rhs )
 		return;
 	}
 
-	m_pSamplerVariable = rhs.m_pSamplerVariable;
-	rhs.m_pSamplerVariable = nullptr;
-
-	m_pPointSampler = rhs.m_pPointSampler;
-	rhs.m_pPointSampler = nullptr;
-
-	m_pLinearSampler = rhs.m_pLinearSampler;
-	rhs.m_pLinearSampler = nullptr;
+	m_FilterMode = rhs.m_FilterMode;
 
-	m_pAnisotropicSampler = rhs.m_pAnisotropicSampler;
-	rhs.m_pAnisotropicSampler = nullptr;
+	m_pSamplerState = rhs.m_pSamplerState;
+	rhs.m_pSamplerState = nullptr;
 }
 
 Sampler& Sampler::operator=( Sampler&& rhs )
@@ -71,78 +57,52 @@ Sampler& Sampler::operator=( Sampler&& rhs )
 		return *this;
 	}
 
-	m_pSamplerVariable = rhs.m_pSamplerVariable;
-	rhs.m_pSamplerVariable = nullptr;
+	m_FilterMode = rhs.m_FilterMode;
 
-	m_pPointSampler = rhs.m_pPointSampler;
-	rhs.m_pPointSampler = nullptr;
-
-	m_pLinearSampler = rhs.m_pLinearSampler;
-	rhs.m_pLinearSampler = nullptr;
-
-	m_pAnisotropicSampler = rhs.m_pAnisotropicSampler;
-	rhs.m_pAnisotropicSampler = nullptr;
+	m_pSamplerState = rhs.m_pSamplerState;
+	rhs.m_pSamplerState = nullptr;
 
 	return *this;
 }
 
 Sampler::~Sampler()
 {
-	if ( m_pSamplerVariable )
-	{
-		m_pSamplerVariable->Release();
-	}
-
-	if ( m_pPointSampler )
+	if ( m_pSamplerState )
 	{
-		m_pPointSampler->Release();
-	}
-
-	if ( m_pLinearSampler )
-	{
-		m_pLinearSampler->Release();
+		m_pSamplerState->Release();
 	}
+}
 
-	if ( m_pAnisotropicSampler )
-	{
-		m_pAnisotropicSampler->Release();
-	}
+ID3D11SamplerState* Sampler::GetState() const
+{
+	return m_pSamplerState;
 }
 
-void Sampler::Cycle()
+Sampler::FilterMode Sampler::GetFilterMode() const
 {
-	IncrementFilterMode();
+	return m_FilterMode;
+}
 
-	Update();
+Sampler::FilterMode Sampler::GetNextFilterMode( FilterMode filterMode )
+{
+	return std::bit_cast<FilterMode, int>( ( std::bit_cast<int, FilterMode>( filterMode ) + 1 ) %
+										   std::bit_cast<int, FilterMode>( FilterMode::count ) );
 }
 
-void Sampler::Update()
+const char* Sampler::GetFilterModeName( FilterMode filterMode )
 {
-	switch ( m_CurrentFilterMode )
+	switch ( filterMode )
 	{
 	case FilterMode::point:
-		std::cout << "Set filter mode to Point\n";
-		m_pSamplerVariable->SetSampler( 0, m_pPointSampler );
-		break;
+		return "Point";
 
 	case FilterMode::linear:
-		std::cout << "Set filter mode to Linear\n";
-		m_pSamplerVariable->SetSampler( 0, m_pLinearSampler );
-		break;
+		return "Linear";
 
 	case FilterMode::anisotropic:
-		std::cout << "Set filter mode to Anisotropic\n";
-		m_pSamplerVariable->SetSampler( 0, m_pAnisotropicSampler );
-		break;
+		return "Anisotropic";
 
 	default:
-		break;
+		return "";
 	}
 }
-
-void Sampler::IncrementFilterMode()
-{
-	m_CurrentFilterMode =
-		std::bit_cast<FilterMode, int>( ( std::bit_cast<int, FilterMode>( m_CurrentFilterMode ) + 1 ) %
-										std::bit_cast<int, FilterMode>( FilterMode::count ) );
-}
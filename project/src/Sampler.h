@@ -1,42 +1,44 @@
 #ifndef SAMPLERSTATE_H
 #define SAMPLERSTATE_H
+#include <cstddef>
 #include <d3dx11effect.h>
 
+// One sampler state, shared through the resource cache by every effect that samples with its filter mode
 class Sampler
 {
 public:
+	enum class FilterMode
+	{
+		point,
+		linear,
+		anisotropic,
+		count,
+	};
+	static constexpr size_t FilterModeCount{ static_cast<size_t>( FilterMode::count ) };
+
 	Sampler() = default;
-	Sampler( ID3D11Device* pDevice, ID3DX11Effect* pEffect );
+	Sampler( ID3D11Device* pDevice, FilterMode filterMode );
 	Sampler( const Sampler& ) = delete;
 	Sampler& operator=( const Sampler& ) = delete;
 	Sampler( Sampler&& rhs );
 	Sampler& operator=( Sampler&& rhs );
 	~Sampler();
 
-	void Cycle();
+	// Getters
+	ID3D11SamplerState* GetState() const;
+	FilterMode GetFilterMode() const;
 
-private:
-	enum class FilterMode
-	{
-		point,
-		linear,
-		anisotropic,
-		count,
-	};
+	static FilterMode GetNextFilterMode( FilterMode filterMode );
+	static const char* GetFilterModeName( FilterMode filterMode );
 
+private:
 	// SOFTWARE RESOURCES
-	FilterMode m_CurrentFilterMode{};
+	FilterMode m_FilterMode{};
 	//
 
 	// HARDWARE RESOURCES: OWNING
-	ID3DX11EffectSamplerVariable* m_pSamplerVariable{};
-	ID3D11SamplerState* m_pPointSampler{};
-	ID3D11SamplerState* m_pLinearSampler{};
-	ID3D11SamplerState* m_pAnisotropicSampler{};
+	ID3D11SamplerState* m_pSamplerState{};
 	//
-
-	void Update();
-	void IncrementFilterMode();
 };
 
 #endif
@@ -1,24 +1,180 @@
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <type_traits>
 #include <SDL_keyboard.h>
 #include <d3dx11effect.h>
 #include "Scene.h"
+#include "AssetManifest.h"
+#include "CookedMesh.h"
+#include "CookedTexture.h"
 #include "Error.h"
-#include "Utils.h"
 
 namespace dae
 {
+namespace
+{
+const std::string ResourcesDir{ "./resources/" };
+const std::string CookedDir{ "./resources/cooked/" };
+
+using Manifest = std::vector<manifest::Entry>;
+
+// Everything one mesh needs, the effect and maps are shared with every other mesh using them
+template <typename EffectType>
+struct MeshAssets
+{
+	MeshData meshData{};
+	std::shared_ptr<EffectType> pEffect{};
+	std::vector<std::shared_ptr<const Texture>> maps{};
+};
+
+// Options only apply when the map is decoded from its source
+// With an alpha path, the map is the one packed from both (see cooked::texture::GetPackedSourcePath)
+struct MapSource
+{
+	std::string path{};
+	cooked::texture::Options options{};
+	std::string alphaPath{};
+};
+
+// Only meant to load cooked data, anything the cooker didn't write is flagged so a stale or failed cook doesn't go
+// unnoticed
+void WarnNotCooked( const std::string& sourcePath )
+{
+	error::utils::SetConsoleColor( 14 );
+	std::cout << "Warning: " << sourcePath << " is not in " << CookedDir << manifest::FileName
+			  << ", loading it from the source; build the cook-assets target\n";
+	error::utils::SetConsoleColor( 7 );
+}
+
+// Assets the asset-cooker target cooked are loaded from its output, anything else from the source
+std::string ResolvePath( const Manifest& manifest, const std::string& sourcePath )
+{
+	const manifest::Entry* pEntry{ manifest::Find( manifest, sourcePath ) };
+	if ( !pEntry )
+	{
+		WarnNotCooked( sourcePath );
+		return ResourcesDir + sourcePath;
+	}
+	return CookedDir + pEntry->cookedPath;
+}
+
+// The options only matter for meshes the cooker hasn't seen
+MeshData LoadMesh( const Manifest& manifest,
+				   const std::string& sourcePath,
+				   const obj::ParseOptions& parseOptions,
+				   const cooked::CookOptions& cookOptions )
+{
+	const manifest::Entry* pEntry{ manifest::Find( manifest, sourcePath ) };
+	if ( !pEntry )
+	{
+		return cooked::LoadOBJ( ResourcesDir + sourcePath, parseOptions, cookOptions );
+	}
+
+	std::optional<MeshData> mesh{ cooked::Open( CookedDir + pEntry->cookedPath, pEntry->optionsHash ) };
+	if ( !mesh )
+	{
+		throw error::file::CouldNotOpenFile();
+	}
+	return std::move( *mesh );
+}
+
+// Every part is its own load, create runs once the last of them is ready
+// The effect is created for the mesh's vertex layout, so it is only requested once the mesh is in
+template <typename EffectType>
+void LoadMeshAssets( AssetLoader& loader,
+					 ResourceCache& cache,
+					 const std::shared_ptr<const Manifest>& pManifest,
+					 const std::string& meshPath,
+					 const obj::ParseOptions& parseOptions,
+					 const cooked::CookOptions& cookOptions,
+					 const std::string& effectPath,
+					 const std::vector<MapSource>& mapSources,
+					 const std::function<void( MeshAssets<EffectType>& )>& create )
+{
+	if ( !manifest::Find( *pManifest, meshPath ) )
+	{
+		WarnNotCooked( meshPath );
+	}
+
+	const auto pAssets{ std::make_shared<MeshAssets<EffectType>>() };
+	pAssets->maps.resize( mapSources.size() );
+	const auto pBarrier{
+		std::make_shared<LoadBarrier>( mapSources.size() + 1, [pAssets, create]() { create( *pAssets ); } ) };
+
+	loader.Enqueue(
+		std::filesystem::path{ meshPath }.filename().string(),
+		[pManifest, meshPath, parseOptions, cookOptions]() {
+			return LoadMesh( *pManifest, meshPath, parseOptions, cookOptions );
+		},
+		[&loader,
+		 &cache,
+		 effectPath = std::filesystem::path{ ResolvePath( *pManifest, effectPath ) }.wstring(),
+		 pAssets,
+		 pBarrier]( MeshData&& meshData ) {
+			pAssets->meshData = std::move( meshData );
+
+			const auto ready{ [pAssets, pBarrier]( std::shared_ptr<EffectType> pEffect ) {
+				pAssets->pEffect = std::move( pEffect );
+				pBarrier->Arrive();
+			} };
+			if constexpr ( std::is_same_v<EffectType, TransparentEffect> )
+			{
+				cache.RequestTransparentEffect( loader, effectPath, pAssets->meshData.GetLayout(), ready );
+			}
+			else
+			{
+				cache.RequestEffect( loader, effectPath, pAssets->meshData.GetLayout(), ready );
+			}
+		} );
+
+	for ( size_t mapIdx{}; mapIdx < mapSources.size(); ++mapIdx )
+	{
+		const MapSource& source{ mapSources[mapIdx] };
+		const auto ready{ [pAssets, pBarrier, mapIdx]( std::shared_ptr<const Texture> pMap ) {
+			pAssets->maps[mapIdx] = std::move( pMap );
+			pBarrier->Arrive();
+		} };
+
+		// Packed by the cooker when resources/cook.txt asks for it, on the loader's workers otherwise
+		const std::string path{ source.alphaPath.empty()
+									? source.path
+									: cooked::texture::GetPackedSourcePath( source.path, source.alphaPath ) };
+		if ( source.alphaPath.empty() || manifest::Find( *pManifest, path ) )
+		{
+			cache.RequestTexture( loader, ResolvePath( *pManifest, path ), source.options, ready );
+		}
+		else
+		{
+			WarnNotCooked( path );
+			cache.RequestPackedTexture(
+				loader, ResourcesDir + source.path, ResourcesDir + source.alphaPath, source.options, ready );
+		}
+	}
+}
+} // namespace
+
 void Scene::Update( Timer* pTimer )
 {
 	// Update Camera
 	m_Camera.Update( pTimer );
 
+	// The level has to be picked first, culling only applies to the full-detail one
 	for ( auto& mesh : m_Meshes )
 	{
+		mesh.SetLod( m_UseLods ? mesh.PickLod( m_Camera.GetPosition(), m_Camera.GetFov() ) : 0 );
 		mesh.SetWorldViewProjection( m_Camera.GetPosition(), m_Camera.GetViewMatrix(), m_Camera.GetProjectionMatrix() );
+		mesh.RequestTextureLevels( m_Camera.GetPosition(), m_Camera.GetFov(), m_ScreenHeight );
+		m_CullStatistics += mesh.GetCullStatistics();
+		m_DrawnTriangleCount += mesh.GetDrawnTriangleCount();
 	}
+	++m_StatisticsFrameCount;
 
 	for ( auto& transparentMesh : m_TransparentMeshes )
 	{
 		transparentMesh.SetWorldViewProjection( m_Camera.GetViewMatrix(), m_Camera.GetProjectionMatrix() );
+		transparentMesh.RequestTextureLevels();
 	}
 	//
 
@@ -36,12 +192,22 @@ void Scene::Update( Timer* pTimer )
 	{
 		m_F2Held = false;
 	}
+	if ( pKeyboardState[SDL_SCANCODE_F3] && !m_F3Held )
+	{
+		m_F3Held = true;
+		m_UseLods = !m_UseLods;
+		std::cout << "LODs " << ( m_UseLods ? "on" : "off" ) << std::endl;
+	}
+	if ( !pKeyboardState[SDL_SCANCODE_F3] && m_F3Held )
+	{
+		m_F3Held = false;
+	}
 	//
 }
 
 void Scene::Draw( ID3D11DeviceContext* pDeviceContext )
 {
-	if ( m_Meshes.empty() && m_TransparentMeshes.empty() )
+	if ( IsEmpty() )
 	{
 		throw error::scene::SceneIsEmpty();
 	}
@@ -59,6 +225,48 @@ void Scene::Draw( ID3D11DeviceContext* pDeviceContext )
 	}
 }
 
+bool Scene::IsEmpty() const
+{
+	return m_Meshes.empty() && m_TransparentMeshes.empty();
+}
+
+void Scene::SetScreenHeight( uint32_t screenHeight )
+{
+	m_ScreenHeight = screenHeight;
+}
+
+void Scene::PrintStatistics()
+{
+	if ( m_StatisticsFrameCount == 0 )
+	{
+		return;
+	}
+
+	const double frameCount{ static_cast<double>( m_StatisticsFrameCount ) };
+	std::cout << "Triangles: " << m_DrawnTriangleCount / frameCount << " per frame with LODs "
+			  << ( m_UseLods ? "on" : "off" );
+	for ( const Mesh& mesh : m_Meshes )
+	{
+		std::cout << ", LOD" << mesh.GetLodIdx() << "/" << mesh.GetLodCount();
+	}
+	std::cout << std::endl;
+
+	if ( m_CullStatistics.triangleCount > 0 )
+	{
+		const double triangleCount{ static_cast<double>( m_CullStatistics.triangleCount ) };
+		std::cout << "Meshlets: " << m_CullStatistics.visibleMeshletCount / frameCount << "/"
+				  << m_CullStatistics.meshletCount / frameCount << " visible in "
+				  << m_CullStatistics.rangeCount / frameCount << " draws, culled "
+				  << 100.0 * m_CullStatistics.backfaceCulledTriangles / triangleCount << "% back-facing + "
+				  << 100.0 * m_CullStatistics.frustumCulledTriangles / triangleCount << "% off-screen triangles in "
+				  << 1000.0 * m_CullStatistics.cullMs / frameCount << " us" << std::endl;
+	}
+
+	m_CullStatistics = {};
+	m_DrawnTriangleCount = 0;
+	m_StatisticsFrameCount = 0;
+}
+
 void VehicleScene::Update( Timer* pTimer )
 {
 	// const Matrix rotation{ Matrix::CreateRotationY( pTimer->GetElapsed() * 0.5f * PI ) };
@@ -69,7 +277,7 @@ void VehicleScene::Update( Timer* pTimer )
 	Scene::Update( pTimer );
 }
 
-void VehicleScene::Initialize( ID3D11Device* pDevice, float aspectRatio )
+void VehicleScene::Initialize( ID3D11Device* pDevice, AssetLoader& loader, ResourceCache& cache, float aspectRatio )
 {
 	m_Camera = Camera{ { 0.f, 0.f, -64.f }, 45.f, aspectRatio };
 
@@ -80,43 +288,62 @@ void VehicleScene::Initialize( ID3D11Device* pDevice, float aspectRatio )
 	// Comment if on C++26 -> non-magic number solution above
 	m_LightDir = { 0.577f, -0.577f, 0.577f };
 
-	std::vector<Vertex> vertices{};
-	std::vector<uint32_t> indices{};
+	const auto pManifest{ std::make_shared<const Manifest>(
+		manifest::Read( CookedDir + std::string{ manifest::FileName } ) ) };
 
-	Utils::ParseOBJ( "./resources/vehicle.obj", vertices, indices );
+	obj::ParseOptions parseOptions{};
+	parseOptions.weldVertices = true;
+
+	cooked::CookOptions cookOptions{};
+	cookOptions.packVertices = true;
+
+	// Without the cooker's output, meshes are parsed once and later runs map the .mesh files written next to them
 	const D3D11_PRIMITIVE_TOPOLOGY topology{ D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST };
-	const std::wstring effectPath{ L"./resources/Opaque.fx" };
-	const std::string diffuseMapPath{ "./resources/vehicle_diffuse.png" };
-	const std::string normalMapPath{ "./resources/vehicle_normal.png" };
-	const std::string specularMapPath{ "./resources/vehicle_specular.png" };
-	const std::string glossMapPath{ "./resources/vehicle_gloss.png" };
-
-	m_Meshes.push_back( {
-		pDevice,
-		vertices,
-		indices,
-		topology,
-		effectPath,
-		diffuseMapPath,
-		normalMapPath,
-		specularMapPath,
-		glossMapPath,
-	} );
-
-	vertices.clear();
-	indices.clear();
-
-	Utils::ParseOBJ( "./resources/fireFX.obj", vertices, indices );
-	const std::wstring partialCoverageEffectPath{ L"./resources/PartialCoverage.fx" };
-	const std::string fireDiffuseMapPath{ "./resources/fireFX_diffuse.png" };
-
-	m_TransparentMeshes.push_back( TransparentMesh{
-		pDevice,
-		vertices,
-		indices,
-		topology,
-		partialCoverageEffectPath,
-		fireDiffuseMapPath,
-	} );
+	LoadMeshAssets<Effect>( loader,
+							cache,
+							pManifest,
+							"vehicle.obj",
+							parseOptions,
+							cookOptions,
+							"Opaque.fx",
+							{ { "vehicle_diffuse.png", Mesh::DiffuseMapOptions },
+							  { "vehicle_normal.png", Mesh::NormalMapOptions },
+							  { "vehicle_specular.png", Mesh::MaterialMapOptions, "vehicle_gloss.png" } },
+							[this, pDevice, topology]( MeshAssets<Effect>& assets ) {
+								m_Meshes.push_back( Mesh{
+									pDevice,
+									assets.meshData,
+									topology,
+									assets.pEffect,
+									assets.maps[0],
+									assets.maps[1],
+									assets.maps[2],
+								} );
+							} );
+
+	// Blended without depth writes, so the authored triangle order has to be kept (see resources/cook.txt)
+	cooked::CookOptions transparentCookOptions{ cookOptions };
+	transparentCookOptions.optimizeVertexCache = false;
+	transparentCookOptions.optimizeOverdraw = false;
+	transparentCookOptions.buildMeshlets = false; // drawn whole, with back faces visible
+	transparentCookOptions.buildLods = false;
+
+	LoadMeshAssets<TransparentEffect>( loader,
+									   cache,
+									   pManifest,
+									   "fireFX.obj",
+									   parseOptions,
+									   transparentCookOptions,
+									   "PartialCoverage.fx",
+									   { { "fireFX_diffuse.png", TransparentMesh::DiffuseMapOptions } },
+									   [this, pDevice, topology]( MeshAssets<TransparentEffect>& assets ) {
+										   m_TransparentMeshes.push_back( TransparentMesh{
+											   pDevice,
+											   assets.meshData,
+											   topology,
+											   assets.pEffect,
+											   assets.maps[0],
+										   } );
+									   } );
 }
 } // namespace dae
@@ -1,7 +1,9 @@
 #ifndef SCENE_H
 #define SCENE_H
+#include "AssetLoader.h"
 #include "Camera.h"
 #include "Mesh.h"
+#include "ResourceCache.h"
 
 namespace dae
 {
@@ -13,21 +15,46 @@ public:
 	virtual void Update( Timer* pTimer );
 	virtual void Draw( ID3D11DeviceContext* pDeviceContext );
 
-	virtual void Initialize( ID3D11Device* pDevice, float aspectRatio ) = 0;
+	// Meshes are requested from the loader and show up once everything they need has loaded, the assets they share
+	// come from the cache
+	virtual void Initialize( ID3D11Device* pDevice,
+							 AssetLoader& loader,
+							 ResourceCache& cache,
+							 float aspectRatio ) = 0;
+
+	bool IsEmpty() const;
+
+	// Setters
+	// Texture levels are picked for meshes seen at this resolution
+	void SetScreenHeight( uint32_t screenHeight );
+
+	// Triangles submitted and meshlet culling per frame, averaged since the last call
+	void PrintStatistics();
 
 protected:
 	Camera m_Camera{};
 	std::vector<Mesh> m_Meshes{};
 	std::vector<TransparentMesh> m_TransparentMeshes{};
 	Vector3 m_LightDir{};
+	uint32_t m_ScreenHeight{};
+	meshlet::CullStatistics m_CullStatistics{};
+	size_t m_DrawnTriangleCount{};
+	uint32_t m_StatisticsFrameCount{};
+
+	// Toggled with F3 to compare the triangle throughput
+	bool m_UseLods{ true };
 
 	// TODO:Make this a bitmask
 	bool m_F2Held{};
+	bool m_F3Held{};
 };
 
 class TestScene : public Scene
 {
-	virtual void Initialize( ID3D11Device* pDevice, float aspectRatio ) override;
+	virtual void Initialize( ID3D11Device* pDevice,
+							 AssetLoader& loader,
+							 ResourceCache& cache,
+							 float aspectRatio ) override;
 };
 
 class VehicleScene : public Scene
@@ -35,7 +62,10 @@ class VehicleScene : public Scene
 public:
 	virtual void Update( Timer* pTimer ) override;
 
-	virtual void Initialize( ID3D11Device* pDevice, float aspectRatio ) override;
+	virtual void Initialize( ID3D11Device* pDevice,
+							 AssetLoader& loader,
+							 ResourceCache& cache,
+							 float aspectRatio ) override;
 };
 } // namespace dae
 
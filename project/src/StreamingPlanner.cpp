@@ -0,0 +1,140 @@
+#include <algorithm>
+#include "StreamingPlanner.h"
+
+namespace dae
+{
+namespace streaming
+{
+namespace
+{
+uint32_t GetLevelSize( uint32_t size, uint32_t levelIdx )
+{
+	return std::max( size >> levelIdx, uint32_t{ 1 } );
+}
+} // namespace
+
+uint32_t GetTailLevel( uint32_t width, uint32_t height, uint32_t levelCount, TextureData::Format format )
+{
+	uint32_t levelIdx{};
+	while ( levelIdx + 1 < levelCount &&
+			std::max( GetLevelSize( width, levelIdx ), GetLevelSize( height, levelIdx ) ) > TailSize )
+	{
+		++levelIdx;
+	}
+
+	if ( TextureData::IsCompressed( format ) )
+	{
+		while ( levelIdx > 0 && ( GetLevelSize( width, levelIdx ) % TextureData::BlockSize != 0 ||
+								  GetLevelSize( height, levelIdx ) % TextureData::BlockSize != 0 ) )
+		{
+			--levelIdx;
+		}
+	}
+	return levelIdx;
+}
+
+size_t GetByteSize( const TextureState& texture, uint32_t firstLevel )
+{
+	return TextureData::GetByteSize( GetLevelSize( texture.width, firstLevel ),
+									 GetLevelSize( texture.height, firstLevel ),
+									 texture.levelCount - firstLevel,
+									 texture.format );
+}
+
+size_t GetCommittedBytes( std::span<const TextureState> textures )
+{
+	size_t byteSize{};
+	for ( const TextureState& texture : textures )
+	{
+		byteSize += GetByteSize( texture, std::min( texture.residentLevel, texture.pendingLevel ) );
+	}
+	return byteSize;
+}
+
+Plan MakePlan( std::span<const TextureState> textures, size_t budgetBytes, size_t maxStreamInCount )
+{
+	Plan plan{};
+	size_t committedBytes{ GetCommittedBytes( textures ) };
+
+	// Holding more than they were asked for, whoever was requested longest ago gives theirs back first
+	std::vector<size_t> victims{};
+	std::vector<size_t> candidates{};
+	for ( size_t textureIdx{}; textureIdx < textures.size(); ++textureIdx )
+	{
+		const TextureState& texture{ textures[textureIdx] };
+		if ( texture.pendingLevel != texture.residentLevel )
+		{
+			continue;
+		}
+
+		if ( texture.residentLevel < texture.wantedLevel )
+		{
+			victims.push_back( textureIdx );
+		}
+		else if ( texture.wantedLevel < texture.residentLevel )
+		{
+			candidates.push_back( textureIdx );
+		}
+	}
+	std::stable_sort( victims.begin(), victims.end(), [&]( size_t lhs, size_t rhs ) {
+		return textures[lhs].lastRequestedFrame < textures[rhs].lastRequestedFrame;
+	} );
+
+	// The ones in view first, then whichever is furthest from what it asked for
+	std::stable_sort( candidates.begin(), candidates.end(), [&]( size_t lhs, size_t rhs ) {
+		const TextureState& left{ textures[lhs] };
+		const TextureState& right{ textures[rhs] };
+		if ( left.lastRequestedFrame != right.lastRequestedFrame )
+		{
+			return left.lastRequestedFrame > right.lastRequestedFrame;
+		}
+		return left.residentLevel - left.wantedLevel > right.residentLevel - right.wantedLevel;
+	} );
+
+	size_t victimIdx{};
+	const auto evictNext{ [&]() {
+		if ( victimIdx == victims.size() )
+		{
+			return false;
+		}
+
+		const TextureState& victim{ textures[victims[victimIdx]] };
+		committedBytes -= GetByteSize( victim, victim.residentLevel ) - GetByteSize( victim, victim.wantedLevel );
+		plan.evictions.push_back( { victims[victimIdx], victim.wantedLevel } );
+		++victimIdx;
+		return true;
+	} };
+
+	// A budget that was lowered is met before anything new comes in
+	while ( committedBytes > budgetBytes && evictNext() )
+	{
+	}
+
+	for ( size_t textureIdx : candidates )
+	{
+		if ( plan.streamIns.size() == maxStreamInCount )
+		{
+			break;
+		}
+
+		// One level at a time, the next plan asks for the one after it
+		const TextureState& texture{ textures[textureIdx] };
+		const uint32_t levelIdx{ texture.residentLevel - 1 };
+		const size_t addedBytes{ GetByteSize( texture, levelIdx ) - GetByteSize( texture, texture.residentLevel ) };
+		while ( committedBytes + addedBytes > budgetBytes && evictNext() )
+		{
+		}
+
+		// A smaller level further down may still fit
+		if ( committedBytes + addedBytes > budgetBytes )
+		{
+			continue;
+		}
+
+		committedBytes += addedBytes;
+		plan.streamIns.push_back( { textureIdx, levelIdx } );
+	}
+	return plan;
+}
+} // namespace streaming
+} // namespace dae
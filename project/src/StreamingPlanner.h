@@ -0,0 +1,61 @@
+#ifndef STREAMINGPLANNER_H
+#define STREAMINGPLANNER_H
+
+// Decides which mip levels of the streamed textures are resident, without touching the GPU
+// A texture always keeps its tail, the levels no larger than TailSize; above that it gets the levels the meshes drawn
+// with it asked for, one level per plan, as long as they fit in the budget. Room is made by taking levels back from the
+// textures that hold more than they were asked for, least recently requested first, so a texture in view is never
+// evicted to stream in another one
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "TextureData.h"
+
+namespace dae
+{
+namespace streaming
+{
+// Levels at most this wide and high are uploaded with the texture and never evicted
+constexpr uint32_t TailSize{ 64 };
+
+struct TextureState
+{
+	uint32_t width{};
+	uint32_t height{};
+	uint32_t levelCount{};
+	TextureData::Format format{};
+	uint32_t tailLevel{};	   // first level of the tail
+	uint32_t residentLevel{};  // first level on the GPU
+	uint32_t wantedLevel{};	   // what the last requests asked for, tailLevel once nothing asks anymore
+	uint32_t pendingLevel{};   // first level once the stream-in in flight lands, residentLevel when there is none
+	uint64_t lastRequestedFrame{};
+};
+
+struct Change
+{
+	size_t textureIdx{};
+	uint32_t residentLevel{}; // the new first level on the GPU
+};
+
+struct Plan
+{
+	std::vector<Change> evictions{}; // applied right away, they only drop levels
+	std::vector<Change> streamIns{}; // levels to page in before they can go up
+};
+
+// First level of the tail, clamped so a block-compressed texture's first level stays a whole number of blocks, which
+// D3D11 needs
+uint32_t GetTailLevel( uint32_t width, uint32_t height, uint32_t levelCount, TextureData::Format format );
+
+// Video memory of the levels from firstLevel down
+size_t GetByteSize( const TextureState& texture, uint32_t firstLevel );
+
+// Counts stream-ins in flight at the size they land with, so the budget holds once they do
+size_t GetCommittedBytes( std::span<const TextureState> textures );
+
+// maxStreamInCount caps the stream-ins started by this plan, textures already streaming in are left alone
+Plan MakePlan( std::span<const TextureState> textures, size_t budgetBytes, size_t maxStreamInCount );
+} // namespace streaming
+} // namespace dae
+#endif
@@ -127,7 +127,7 @@ struct Vertex final
 	ColorRGB color{};
 	Vector2 UV{};
 	Vector3 normal{};
-	Vector3 tangent{};
+	Vector4 tangent{}; // w is the handedness, the bitangent is cross( normal, tangent ) * w
 };
 
 // Global Operators
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <emmintrin.h>
+#include "MeshOptimizer.h"
+#include "TangentGenerator.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+namespace tangent
+{
+namespace
+{
+constexpr size_t BatchSize{ 4 };
+
+// Triangles or vertices per pool task, a multiple of BatchSize so batches never straddle two tasks
+constexpr size_t TaskSize{ size_t{ 1 } << 14 };
+
+// Computed as structure of arrays, then transposed so a vertex gathers each of its triangles with one aligned load
+struct alignas( 16 ) TriangleFrame
+{
+	// Unit tangent scaled by twice the triangle's area
+	float tangent[3]{};
+
+	// Twice the area, negative when the UVs are mirrored, 0 when the triangle can't contribute
+	float signedArea{};
+};
+static_assert( sizeof( TriangleFrame ) == 16 );
+
+// Tangents summed per handedness, w holds the summed area, negative on the mirrored side
+struct TangentSums
+{
+	__m128 regular{};
+	__m128 mirrored{};
+};
+
+void ForEachRange( size_t count, ThreadPool* pThreadPool, const std::function<void( size_t, size_t )>& function )
+{
+	if ( !pThreadPool )
+	{
+		function( 0, count );
+		return;
+	}
+
+	pThreadPool->ParallelFor( ( count + TaskSize - 1 ) / TaskSize, [&]( size_t taskIdx ) {
+		function( taskIdx * TaskSize, std::min( count, ( taskIdx + 1 ) * TaskSize ) );
+	} );
+}
+
+__m128 Abs( __m128 value )
+{
+	return _mm_andnot_ps( _mm_set1_ps( -0.f ), value );
+}
+
+// dP/du of every triangle, from e1 * dv2 - e2 * dv1 which is dP/du scaled by the UV determinant
+// The determinant is only used for its sign, so nothing is ever divided by a near-zero UV area
+void ComputeTriangleFrames( const std::vector<Vertex>& vertices,
+							const std::vector<uint32_t>& indices,
+							size_t triangleBegin,
+							size_t triangleEnd,
+							std::vector<TriangleFrame>& frames )
+{
+	enum Component
+	{
+		X,
+		Y,
+		Z,
+		U,
+		V,
+		ComponentCount
+	};
+
+	for ( size_t baseIdx{ triangleBegin }; baseIdx < triangleEnd; baseIdx += BatchSize )
+	{
+		// Transpose the batch's corners into lanes, lanes past the last triangle stay zero and come out degenerate
+		alignas( 16 ) float corners[3][ComponentCount][BatchSize]{};
+		for ( size_t laneIdx{}; laneIdx < BatchSize && baseIdx + laneIdx < triangleEnd; ++laneIdx )
+		{
+			for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+			{
+				const Vertex& vertex{ vertices[indices[( baseIdx + laneIdx ) * 3 + cornerIdx]] };
+				corners[cornerIdx][X][laneIdx] = vertex.position.x;
+				corners[cornerIdx][Y][laneIdx] = vertex.position.y;
+				corners[cornerIdx][Z][laneIdx] = vertex.position.z;
+				corners[cornerIdx][U][laneIdx] = vertex.UV.x;
+				corners[cornerIdx][V][laneIdx] = vertex.UV.y;
+			}
+		}
+
+		const auto edge{ [&]( size_t cornerIdx, Component component ) {
+			return _mm_sub_ps( _mm_load_ps( corners[cornerIdx][component] ), _mm_load_ps( corners[0][component] ) );
+		} };
+		const __m128 edge1X{ edge( 1, X ) };
+		const __m128 edge1Y{ edge( 1, Y ) };
+		const __m128 edge1Z{ edge( 1, Z ) };
+		const __m128 edge2X{ edge( 2, X ) };
+		const __m128 edge2Y{ edge( 2, Y ) };
+		const __m128 edge2Z{ edge( 2, Z ) };
+		const __m128 du1{ edge( 1, U ) };
+		const __m128 dv1{ edge( 1, V ) };
+		const __m128 du2{ edge( 2, U ) };
+		const __m128 dv2{ edge( 2, V ) };
+
+		const __m128 uTerm{ _mm_mul_ps( du1, dv2 ) };
+		const __m128 vTerm{ _mm_mul_ps( du2, dv1 ) };
+		const __m128 determinant{ _mm_sub_ps( uTerm, vTerm ) };
+
+		const __m128 tangentX{ _mm_sub_ps( _mm_mul_ps( edge1X, dv2 ), _mm_mul_ps( edge2X, dv1 ) ) };
+		const __m128 tangentY{ _mm_sub_ps( _mm_mul_ps( edge1Y, dv2 ), _mm_mul_ps( edge2Y, dv1 ) ) };
+		const __m128 tangentZ{ _mm_sub_ps( _mm_mul_ps( edge1Z, dv2 ), _mm_mul_ps( edge2Z, dv1 ) ) };
+		const __m128 tangentLength{ _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( tangentX, tangentX ),
+																		 _mm_mul_ps( tangentY, tangentY ) ),
+															 _mm_mul_ps( tangentZ, tangentZ ) ) ) };
+
+		const __m128 normalX{ _mm_sub_ps( _mm_mul_ps( edge1Y, edge2Z ), _mm_mul_ps( edge1Z, edge2Y ) ) };
+		const __m128 normalY{ _mm_sub_ps( _mm_mul_ps( edge1Z, edge2X ), _mm_mul_ps( edge1X, edge2Z ) ) };
+		const __m128 normalZ{ _mm_sub_ps( _mm_mul_ps( edge1X, edge2Y ), _mm_mul_ps( edge1Y, edge2X ) ) };
+		const __m128 area{ _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( normalX, normalX ),
+																 _mm_mul_ps( normalY, normalY ) ),
+													 _mm_mul_ps( normalZ, normalZ ) ) ) };
+
+		// A determinant lost in the rounding of its two products is as good as zero, its sign means nothing
+		const __m128 tolerance{ _mm_mul_ps( _mm_set1_ps( 1e-6f ), _mm_add_ps( Abs( uTerm ), Abs( vTerm ) ) ) };
+		const __m128 isUsable{ _mm_and_ps( _mm_cmpgt_ps( Abs( determinant ), tolerance ),
+										   _mm_cmpgt_ps( tangentLength, _mm_setzero_ps() ) ) };
+
+		// Mirrored UVs flip the sign of the determinant, and with it the scaled tangent
+		const __m128 sign{ _mm_or_ps( _mm_and_ps( determinant, _mm_set1_ps( -0.f ) ), _mm_set1_ps( 1.f ) ) };
+		const __m128 signedArea{ _mm_and_ps( isUsable, _mm_mul_ps( sign, area ) ) };
+		const __m128 scale{ _mm_and_ps( isUsable, _mm_div_ps( signedArea, tangentLength ) ) };
+
+		__m128 frame0{ _mm_mul_ps( tangentX, scale ) };
+		__m128 frame1{ _mm_mul_ps( tangentY, scale ) };
+		__m128 frame2{ _mm_mul_ps( tangentZ, scale ) };
+		__m128 frame3{ signedArea };
+		_MM_TRANSPOSE4_PS( frame0, frame1, frame2, frame3 );
+		_mm_store_ps( frames[baseIdx].tangent, frame0 );
+		_mm_store_ps( frames[baseIdx + 1].tangent, frame1 );
+		_mm_store_ps( frames[baseIdx + 2].tangent, frame2 );
+		_mm_store_ps( frames[baseIdx + 3].tangent, frame3 );
+	}
+}
+
+TangentSums SumTangents( const std::vector<TriangleFrame>& frames,
+						 const optimize::Adjacency& adjacency,
+						 size_t vertexIdx )
+{
+	TangentSums sums{ _mm_setzero_ps(), _mm_setzero_ps() };
+	for ( uint32_t adjacentIdx{ adjacency.offsets[vertexIdx] }; adjacentIdx < adjacency.offsets[vertexIdx + 1];
+		  ++adjacentIdx )
+	{
+		const __m128 frame{ _mm_load_ps( frames[adjacency.triangles[adjacentIdx]].tangent ) };
+		const __m128 signedArea{ _mm_shuffle_ps( frame, frame, _MM_SHUFFLE( 3, 3, 3, 3 ) ) };
+		sums.regular = _mm_add_ps( sums.regular, _mm_and_ps( _mm_cmpgt_ps( signedArea, _mm_setzero_ps() ), frame ) );
+		sums.mirrored = _mm_add_ps( sums.mirrored, _mm_and_ps( _mm_cmplt_ps( signedArea, _mm_setzero_ps() ), frame ) );
+	}
+	return sums;
+}
+
+// Broadcasts the dot product of the xyz parts
+__m128 Dot3( __m128 a, __m128 b )
+{
+	const __m128 product{ _mm_mul_ps( a, b ) };
+	return _mm_add_ps( _mm_add_ps( _mm_shuffle_ps( product, product, _MM_SHUFFLE( 0, 0, 0, 0 ) ),
+								   _mm_shuffle_ps( product, product, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ),
+					   _mm_shuffle_ps( product, product, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+}
+
+float GetArea( __m128 sum )
+{
+	return std::abs( _mm_cvtss_f32( _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+}
+
+// Gram-Schmidt against the normal, anything that doesn't survive gets a tangent built from the normal alone
+Vector4 Orthonormalize( __m128 tangentSum, const Vector3& normal, float handedness )
+{
+	__m128 unitNormal{ _mm_setr_ps( normal.x, normal.y, normal.z, 0.f ) };
+	const __m128 normalLengthSquared{ Dot3( unitNormal, unitNormal ) };
+	unitNormal = _mm_cvtss_f32( normalLengthSquared ) > 0.f
+					 ? _mm_div_ps( unitNormal, _mm_sqrt_ps( normalLengthSquared ) )
+					 : _mm_setr_ps( 0.f, 0.f, 1.f, 0.f );
+
+	const __m128 tangent{ _mm_and_ps( tangentSum, _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) ) ) };
+	const __m128 orthogonal{ _mm_sub_ps( tangent, _mm_mul_ps( unitNormal, Dot3( tangent, unitNormal ) ) ) };
+	const float lengthSquared{ _mm_cvtss_f32( Dot3( orthogonal, orthogonal ) ) };
+
+	alignas( 16 ) float values[4];
+	if ( lengthSquared > 1e-12f * _mm_cvtss_f32( Dot3( tangent, tangent ) ) && std::isfinite( lengthSquared ) )
+	{
+		_mm_store_ps( values, _mm_div_ps( orthogonal, _mm_set1_ps( std::sqrt( lengthSquared ) ) ) );
+		return { values[0], values[1], values[2], handedness };
+	}
+
+	_mm_store_ps( values, unitNormal );
+	const Vector3 fallbackNormal{ values[0], values[1], values[2] };
+	const Vector3 helper{ std::abs( fallbackNormal.x ) < 0.9f ? Vector3::UnitX : Vector3::UnitY };
+	return { Vector3::Cross( fallbackNormal, helper ).Normalized(), handedness };
+}
+} // namespace
+
+size_t GetScratchBytes( size_t vertexCount, size_t triangleCount )
+{
+	const size_t paddedCount{ ( triangleCount + BatchSize - 1 ) / BatchSize * BatchSize };
+	return paddedCount * sizeof( TriangleFrame ) + ( vertexCount + 1 ) * sizeof( uint32_t ) +
+		   triangleCount * 3 * sizeof( uint32_t ) + vertexCount * sizeof( uint8_t );
+}
+
+void Generate( std::vector<Vertex>& vertices,
+			   std::vector<uint32_t>& indices,
+			   ThreadPool* pThreadPool,
+			   GenerateStatistics* pStatistics )
+{
+	const auto start{ std::chrono::steady_clock::now() };
+
+	const size_t triangleCount{ indices.size() / 3 };
+	if ( triangleCount < MinParallelTriangleCount )
+	{
+		pThreadPool = nullptr;
+	}
+
+	// 1. One tangent per triangle, every batch writes only its own slots
+	const size_t paddedCount{ ( triangleCount + BatchSize - 1 ) / BatchSize * BatchSize };
+	std::vector<TriangleFrame> frames( paddedCount );
+	ForEachRange( triangleCount, pThreadPool, [&]( size_t triangleBegin, size_t triangleEnd ) {
+		ComputeTriangleFrames( vertices, indices, triangleBegin, triangleEnd, frames );
+	} );
+
+	const auto trianglesDone{ std::chrono::steady_clock::now() };
+
+	// 2. Every vertex sums its own triangles, the larger handedness side wins
+	const size_t vertexCount{ vertices.size() };
+	const optimize::Adjacency adjacency{ optimize::BuildAdjacency( indices, vertexCount ) };
+	std::vector<uint8_t> isSplit( vertexCount );
+	ForEachRange( vertexCount, pThreadPool, [&]( size_t vertexBegin, size_t vertexEnd ) {
+		for ( size_t vertexIdx{ vertexBegin }; vertexIdx < vertexEnd; ++vertexIdx )
+		{
+			const TangentSums sums{ SumTangents( frames, adjacency, vertexIdx ) };
+			const float regularArea{ GetArea( sums.regular ) };
+			const float mirroredArea{ GetArea( sums.mirrored ) };
+			const bool isMirrored{ mirroredArea > regularArea };
+
+			Vertex& vertex{ vertices[vertexIdx] };
+			vertex.tangent =
+				Orthonormalize( isMirrored ? sums.mirrored : sums.regular, vertex.normal, isMirrored ? -1.f : 1.f );
+			isSplit[vertexIdx] = regularArea > 0.f && mirroredArea > 0.f;
+		}
+	} );
+
+	// 3. Mirror seams, a handful of vertices on a typical mesh, so this stays serial
+	size_t splitVertexCount{};
+	for ( size_t vertexIdx{}; vertexIdx < vertexCount; ++vertexIdx )
+	{
+		if ( !isSplit[vertexIdx] )
+		{
+			continue;
+		}
+
+		const TangentSums sums{ SumTangents( frames, adjacency, vertexIdx ) };
+		const bool copyIsMirrored{ vertices[vertexIdx].tangent.w > 0.f };
+
+		Vertex copy{ vertices[vertexIdx] };
+		copy.tangent = Orthonormalize(
+			copyIsMirrored ? sums.mirrored : sums.regular, copy.normal, copyIsMirrored ? -1.f : 1.f );
+		const uint32_t copyIdx{ static_cast<uint32_t>( vertices.size() ) };
+		vertices.push_back( copy );
+		++splitVertexCount;
+
+		for ( uint32_t adjacentIdx{ adjacency.offsets[vertexIdx] }; adjacentIdx < adjacency.offsets[vertexIdx + 1];
+			  ++adjacentIdx )
+		{
+			const uint32_t triangleIdx{ adjacency.triangles[adjacentIdx] };
+			const float signedArea{ frames[triangleIdx].signedArea };
+			if ( signedArea == 0.f || ( signedArea < 0.f ) != copyIsMirrored )
+			{
+				continue;
+			}
+
+			for ( size_t cornerIdx{}; cornerIdx < 3; ++cornerIdx )
+			{
+				uint32_t& index{ indices[triangleIdx * size_t{ 3 } + cornerIdx] };
+				if ( index == vertexIdx )
+				{
+					index = copyIdx;
+				}
+			}
+		}
+	}
+
+	if ( pStatistics )
+	{
+		const auto end{ std::chrono::steady_clock::now() };
+		*pStatistics = {};
+		for ( size_t triangleIdx{}; triangleIdx < triangleCount; ++triangleIdx )
+		{
+			pStatistics->degenerateTriangleCount += frames[triangleIdx].signedArea == 0.f;
+			pStatistics->mirroredTriangleCount += frames[triangleIdx].signedArea < 0.f;
+		}
+		pStatistics->splitVertexCount = splitVertexCount;
+		pStatistics->triangleMs = std::chrono::duration<double, std::milli>( trianglesDone - start ).count();
+		pStatistics->vertexMs = std::chrono::duration<double, std::milli>( end - trianglesDone ).count();
+	}
+}
+} // namespace tangent
+} // namespace dae
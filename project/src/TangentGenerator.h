@@ -0,0 +1,44 @@
+#ifndef TANGENTGENERATOR_H
+#define TANGENTGENERATOR_H
+
+// Per-vertex tangent frames for normal mapping, built from positions, normals and UVs
+// Triangles are processed four at a time with SSE, then every vertex gathers the triangles around it, so no two
+// threads ever write to the same vertex and the result does not depend on how the work was split
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Structs.h"
+
+namespace dae
+{
+class ThreadPool;
+
+namespace tangent
+{
+// Below this the pool costs more than it saves
+constexpr size_t MinParallelTriangleCount{ size_t{ 1 } << 16 };
+
+struct GenerateStatistics
+{
+	size_t degenerateTriangleCount{}; // zero UV area, they don't contribute
+	size_t mirroredTriangleCount{};	  // UVs wound the other way, tangent.w is -1
+	size_t splitVertexCount{};		  // shared by mirrored and regular triangles
+	double triangleMs{};
+	double vertexMs{};
+};
+
+// Temporary memory Generate allocates, for callers that work within a memory budget
+size_t GetScratchBytes( size_t vertexCount, size_t triangleCount );
+
+// Sets every tangent to a unit vector orthogonal to the vertex normal, w is the handedness: the bitangent is
+// cross( normal, tangent.xyz ) * tangent.w
+// Run once the normals are final, the winding is expected to agree with them
+// Vertices without any usable triangle get an arbitrary tangent orthogonal to their normal; vertices shared by mirrored
+// and regular triangles are split, the copies are appended and the smaller side's indices are pointed at them
+void Generate( std::vector<Vertex>& vertices,
+			   std::vector<uint32_t>& indices,
+			   ThreadPool* pThreadPool = nullptr,
+			   GenerateStatistics* pStatistics = nullptr );
+} // namespace tangent
+} // namespace dae
+#endif
@@ -1,51 +1,59 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 #include "Texture.h"
-#include <SDL_image.h>
-#include <SDL_surface.h>
 #include "Error.h"
 
 namespace dae
 {
-Texture::Texture( ID3D11Device* pDevice, const std::string& texturePath )
+namespace
 {
-	HRESULT result{};
-
-	SDL_Surface* pSurface{ IMG_Load( texturePath.c_str() ) };
-
-	DXGI_FORMAT format{ DXGI_FORMAT_R8G8B8A8_UNORM };
-	D3D11_TEXTURE2D_DESC desc{};
-	desc.Width = pSurface->w;
-	desc.Height = pSurface->h;
-	desc.MipLevels = 1;
-	desc.ArraySize = 1;
-	desc.Format = format;
-	desc.SampleDesc.Count = 1;
-	desc.SampleDesc.Quality = 0;
-	desc.Usage = D3D11_USAGE_DEFAULT;
-	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-	D3D11_SUBRESOURCE_DATA texData{};
-	texData.pSysMem = pSurface->pixels;
-	texData.SysMemPitch = static_cast<UINT>( pSurface->pitch );
-	texData.SysMemSlicePitch = static_cast<UINT>( pSurface->h * pSurface->pitch );
-
-	result = pDevice->CreateTexture2D( &desc, &texData, &m_pResource );
-	if ( FAILED( result ) )
+DXGI_FORMAT GetDxgiFormat( TextureData::Format format )
+{
+	switch ( format )
 	{
-		throw error::texture::ResourceCreateFail();
+	case TextureData::Format::bc1:
+		return DXGI_FORMAT_BC1_UNORM;
+	case TextureData::Format::bc3:
+		return DXGI_FORMAT_BC3_UNORM;
+	case TextureData::Format::bc4:
+		return DXGI_FORMAT_BC4_UNORM;
+	case TextureData::Format::bc5:
+		return DXGI_FORMAT_BC5_UNORM;
+	case TextureData::Format::bc7:
+		return DXGI_FORMAT_BC7_UNORM;
+	case TextureData::Format::r8:
+		return DXGI_FORMAT_R8_UNORM;
+	case TextureData::Format::rg8:
+		return DXGI_FORMAT_R8G8_UNORM;
+	default:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
 	}
+}
+} // namespace
 
-	SDL_FreeSurface( pSurface );
+Texture::Texture( ID3D11Device* pDevice, const std::string& texturePath, const cooked::texture::Options& options )
+	: Texture( pDevice, cooked::texture::Load( texturePath, options ) )
+{
+}
 
-	D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc{};
-	resourceViewDesc.Format = format;
-	resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-	resourceViewDesc.Texture2D.MipLevels = 1;
+Texture::Texture( ID3D11Device* pDevice, const TextureData& texture )
+	: m_Width( texture.GetWidth() )
+	, m_Height( texture.GetHeight() )
+	, m_LevelCount( texture.GetLevelCount() )
+{
+	Upload( pDevice, texture, 0 );
+}
 
-	result = pDevice->CreateShaderResourceView( m_pResource, &resourceViewDesc, &m_pResourceView );
-	if ( FAILED( result ) )
-	{
-		throw error::texture::ResourceViewCreateFail();
-	}
+Texture::Texture( ID3D11Device* pDevice, TextureData&& texture, uint32_t residentLevel )
+	: m_Data( std::move( texture ) )
+	, m_Width( m_Data.GetWidth() )
+	, m_Height( m_Data.GetHeight() )
+	, m_LevelCount( m_Data.GetLevelCount() )
+{
+	Upload( pDevice, m_Data, std::min( residentLevel, m_LevelCount - 1 ) );
+	m_Data.Evict( 0, m_ResidentLevel );
 }
 
 Texture::Texture( Texture&& rhs )
@@ -55,6 +63,14 @@ Texture::Texture( Texture&& rhs )
 		return;
 	}
 
+	m_Data = std::move( rhs.m_Data );
+	m_Width = rhs.m_Width;
+	m_Height = rhs.m_Height;
+	m_LevelCount = rhs.m_LevelCount;
+	m_ResidentLevel = rhs.m_ResidentLevel;
+	m_ByteSize = rhs.m_ByteSize;
+	m_RequestedLevel = rhs.m_RequestedLevel;
+
 	m_pResource = rhs.m_pResource;
 	rhs.m_pResource = nullptr;
 
@@ -69,6 +85,14 @@ Texture& Texture::operator=( Texture&& rhs )
 		return *this;
 	}
 
+	m_Data = std::move( rhs.m_Data );
+	m_Width = rhs.m_Width;
+	m_Height = rhs.m_Height;
+	m_LevelCount = rhs.m_LevelCount;
+	m_ResidentLevel = rhs.m_ResidentLevel;
+	m_ByteSize = rhs.m_ByteSize;
+	m_RequestedLevel = rhs.m_RequestedLevel;
+
 	m_pResource = rhs.m_pResource;
 	rhs.m_pResource = nullptr;
 
@@ -91,8 +115,165 @@ Texture::~Texture() noexcept
 	}
 }
 
+void Texture::Request( uint32_t levelIdx ) const
+{
+	m_RequestedLevel = std::min( m_RequestedLevel, levelIdx );
+}
+
+std::optional<uint32_t> Texture::TakeRequest()
+{
+	const uint32_t levelIdx{ std::exchange( m_RequestedLevel, NoRequest ) };
+	if ( levelIdx == NoRequest )
+	{
+		return std::nullopt;
+	}
+	return std::min( levelIdx, m_LevelCount - 1 );
+}
+
+uint32_t Texture::PickLevel( float screenSize ) const
+{
+	// An infinite size, from a camera inside the mesh, gets the first level from the clamp below
+	if ( !( screenSize > 1.f ) )
+	{
+		return m_LevelCount - 1;
+	}
+
+	const float levelIdx{ std::floor( std::log2( static_cast<float>( m_Width ) / screenSize ) ) };
+	return static_cast<uint32_t>( std::clamp( levelIdx, 0.f, static_cast<float>( m_LevelCount - 1 ) ) );
+}
+
+Texture Texture::CreateLevels( ID3D11Device* pDevice, uint32_t levelIdx ) const
+{
+	Texture levels{};
+	levels.Upload( pDevice, m_Data, levelIdx );
+	return levels;
+}
+
+void Texture::SetResidentLevels( Texture&& levels )
+{
+	std::swap( m_pResource, levels.m_pResource );
+	std::swap( m_pResourceView, levels.m_pResourceView );
+	m_ResidentLevel = levels.m_ResidentLevel;
+	m_ByteSize = levels.m_ByteSize;
+}
+
+void Texture::EvictLevels( ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, uint32_t levelIdx )
+{
+	if ( levelIdx <= m_ResidentLevel || !m_pResource )
+	{
+		return;
+	}
+
+	// Level by level from the old resource, which stays until the new one is swapped in
+	Texture levels{};
+	levels.Upload( pDevice, m_Data, levelIdx, false );
+	for ( uint32_t levelOffset{}; levelOffset < m_LevelCount - levelIdx; ++levelOffset )
+	{
+		pDeviceContext->CopySubresourceRegion(
+			levels.m_pResource, levelOffset, 0, 0, 0, m_pResource, levelIdx - m_ResidentLevel + levelOffset, nullptr );
+	}
+
+	const uint32_t evictedLevel{ m_ResidentLevel };
+	SetResidentLevels( std::move( levels ) );
+	m_Data.Evict( evictedLevel, levelIdx );
+}
+
 ID3D11ShaderResourceView* Texture::GetSRV() const
 {
 	return m_pResourceView;
 }
+
+const TextureData& Texture::GetData() const
+{
+	return m_Data;
+}
+
+uint32_t Texture::GetWidth() const
+{
+	return m_Width;
+}
+
+uint32_t Texture::GetHeight() const
+{
+	return m_Height;
+}
+
+uint32_t Texture::GetLevelCount() const
+{
+	return m_LevelCount;
+}
+
+uint32_t Texture::GetResidentLevel() const
+{
+	return m_ResidentLevel;
+}
+
+size_t Texture::GetByteSize() const
+{
+	return m_ByteSize;
+}
+
+void Texture::Upload( ID3D11Device* pDevice, const TextureData& texture, uint32_t firstLevel, bool hasLevelData )
+{
+	HRESULT result{};
+
+	const DXGI_FORMAT format{ GetDxgiFormat( texture.GetFormat() ) };
+	const TextureData::Level first{ texture.GetLevel( firstLevel ) };
+	const uint32_t levelCount{ texture.GetLevelCount() - firstLevel };
+	D3D11_TEXTURE2D_DESC desc{};
+	desc.Width = first.width;
+	desc.Height = first.height;
+	desc.MipLevels = levelCount;
+	desc.ArraySize = 1;
+	desc.Format = format;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	// Every level goes up in the one call, the pitch of a block-compressed level is that of a row of blocks
+	std::vector<D3D11_SUBRESOURCE_DATA> levelData( levelCount );
+	for ( uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx )
+	{
+		const TextureData::Level level{ texture.GetLevel( firstLevel + levelIdx ) };
+		levelData[levelIdx].pSysMem = level.pixels.data();
+		levelData[levelIdx].SysMemPitch = level.rowPitch;
+		levelData[levelIdx].SysMemSlicePitch = static_cast<UINT>( level.pixels.size_bytes() );
+	}
+
+	ID3D11Texture2D* pResource{};
+	result = pDevice->CreateTexture2D( &desc, hasLevelData ? levelData.data() : nullptr, &pResource );
+	if ( FAILED( result ) )
+	{
+		throw error::texture::ResourceCreateFail();
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc{};
+	resourceViewDesc.Format = format;
+	resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	resourceViewDesc.Texture2D.MipLevels = levelCount;
+
+	ID3D11ShaderResourceView* pResourceView{};
+	result = pDevice->CreateShaderResourceView( pResource, &resourceViewDesc, &pResourceView );
+	if ( FAILED( result ) )
+	{
+		pResource->Release();
+		throw error::texture::ResourceViewCreateFail();
+	}
+
+	if ( m_pResourceView )
+	{
+		m_pResourceView->Release();
+	}
+
+	if ( m_pResource )
+	{
+		m_pResource->Release();
+	}
+
+	m_pResource = pResource;
+	m_pResourceView = pResourceView;
+	m_ResidentLevel = firstLevel;
+	m_ByteSize = TextureData::GetByteSize( first.width, first.height, levelCount, texture.GetFormat() );
+}
 } // namespace dae
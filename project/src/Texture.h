@@ -1,7 +1,13 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
 #include <d3d11.h>
+#include "CookedTexture.h"
+#include "TextureData.h"
 
 namespace dae
 {
@@ -9,7 +15,14 @@ class Texture
 {
 public:
 	Texture() = default;
-	Texture( ID3D11Device* pDevice, const std::string& texturePath );
+	// Cooked .tex files and DDS or KTX2 containers are mapped, as is a container next to an image; other images are
+	// decoded and get their mip chain built and compressed with options
+	Texture( ID3D11Device* pDevice, const std::string& texturePath, const cooked::texture::Options& options = {} );
+	// Block-compressed data goes up as is, every level straight from wherever it is, mapped files included
+	Texture( ID3D11Device* pDevice, const TextureData& texture );
+	// Streamed, only the levels from residentLevel down go up; the texture keeps its data for CreateLevels, with the
+	// pages of mapped levels that aren't on the GPU dropped from memory
+	Texture( ID3D11Device* pDevice, TextureData&& texture, uint32_t residentLevel );
 	Texture( const Texture& ) = delete;
 	Texture( Texture&& rhs );
 	~Texture() noexcept;
@@ -17,11 +30,52 @@ public:
 	Texture& operator=( const Texture& ) = delete;
 	Texture& operator=( Texture&& rhs );
 
+	// Methods
+	// Asks the texture streamer for the levels from levelIdx down, the most detailed request since it last looked wins
+	void Request( uint32_t levelIdx ) const;
+	// The most detailed level requested since the last call, none when nothing asked
+	std::optional<uint32_t> TakeRequest();
+	// Level whose texels land about a pixel apart when the first level's width covers screenSize pixels
+	uint32_t PickLevel( float screenSize ) const;
+	// Only for streamed textures, a texture holding just a new resource with the levels from levelIdx down
+	// Safe from any thread while the texture isn't evicted, the device is free-threaded; SetResidentLevels swaps it in
+	Texture CreateLevels( ID3D11Device* pDevice, uint32_t levelIdx ) const;
+	// Swaps in the resource of what CreateLevels returned, the old one goes away with levels
+	void SetResidentLevels( Texture&& levels );
+	// Only for streamed textures, drops the levels above levelIdx; the kept ones are copied on the GPU, so nothing is
+	// read from memory, and the pages of the dropped ones are left to the file. The old resource stays when that fails
+	void EvictLevels( ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, uint32_t levelIdx );
+
+	// Getters
 	ID3D11ShaderResourceView* GetSRV() const;
+	const TextureData& GetData() const; // empty unless streamed
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	uint32_t GetLevelCount() const;
+	uint32_t GetResidentLevel() const; // first level on the GPU
+	size_t GetByteSize() const;		   // video memory of the levels on the GPU
 
 private:
+	static constexpr uint32_t NoRequest{ std::numeric_limits<uint32_t>::max() };
+
+	// SOFTWARE RESOURCES
+	TextureData m_Data{};
+	uint32_t m_Width{};
+	uint32_t m_Height{};
+	uint32_t m_LevelCount{};
+	uint32_t m_ResidentLevel{};
+	size_t m_ByteSize{};
+	mutable uint32_t m_RequestedLevel{ NoRequest };
+	//
+
+	// HARDWARE RESOURCES: OWNING
 	ID3D11Texture2D* m_pResource{};
 	ID3D11ShaderResourceView* m_pResourceView{};
+	//
+
+	// Replaces the resource and its view only once both exist; without level data the levels are left for the caller to
+	// fill
+	void Upload( ID3D11Device* pDevice, const TextureData& texture, uint32_t firstLevel, bool hasLevelData = true );
 };
 } // namespace dae
 #endif
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include "TextureAtlas.h"
+
+namespace dae
+{
+namespace atlas
+{
+namespace
+{
+using SizeKey = std::tuple<uint32_t, uint32_t, TextureData::Format>;
+
+SizeKey GetSizeKey( const TextureData& texture )
+{
+	return { texture.GetWidth(), texture.GetHeight(), texture.GetFormat() };
+}
+
+// Levels an atlased texture has before its smaller side drops below a block, or a texel when it isn't compressed
+uint32_t GetAtlasLevelCount( const TextureData& texture )
+{
+	const uint32_t minSize{ TextureData::IsCompressed( texture.GetFormat() ) ? TextureData::BlockSize : 1 };
+	const uint32_t size{ std::min( texture.GetWidth(), texture.GetHeight() ) };
+	if ( size < minSize )
+	{
+		return 0;
+	}
+	return std::min( texture.GetLevelCount(), static_cast<uint32_t>( std::bit_width( size / minSize ) ) );
+}
+
+// Room left on an atlas page
+struct FreeRect
+{
+	uint32_t pageIdx{};
+	uint32_t x{};
+	uint32_t y{};
+	uint32_t width{};
+	uint32_t height{};
+
+	size_t GetArea() const
+	{
+		return size_t{ width } * height;
+	}
+};
+
+// The size most textures share, the larger one when two are as common
+SizeKey PickSliceSize( std::span<const TextureData* const> textures )
+{
+	std::map<SizeKey, size_t> counts{};
+	for ( const TextureData* pTexture : textures )
+	{
+		if ( pTexture )
+		{
+			++counts[GetSizeKey( *pTexture )];
+		}
+	}
+
+	const auto getArea{ []( const SizeKey& key ) {
+		return size_t{ std::get<0>( key ) } * std::get<1>( key );
+	} };
+	const auto best{ std::max_element( counts.begin(), counts.end(), [&]( const auto& lhs, const auto& rhs ) {
+		return lhs.second != rhs.second ? lhs.second < rhs.second : getArea( lhs.first ) < getArea( rhs.first );
+	} ) };
+	return best->first;
+}
+} // namespace
+
+Layout Plan( std::span<const TextureData* const> textures )
+{
+	Layout layout{};
+	layout.placements.resize( textures.size() );
+	if ( std::none_of( textures.begin(), textures.end(), []( const TextureData* pTexture ) { return pTexture; } ) )
+	{
+		return layout;
+	}
+
+	std::tie( layout.width, layout.height, layout.format ) = PickSliceSize( textures );
+	layout.levelCount = TextureData::GetFullLevelCount( layout.width, layout.height );
+
+	// A slice of their own
+	for ( size_t textureIdx{}; textureIdx < textures.size(); ++textureIdx )
+	{
+		const TextureData* pTexture{ textures[textureIdx] };
+		if ( pTexture && GetSizeKey( *pTexture ) == SizeKey{ layout.width, layout.height, layout.format } )
+		{
+			layout.placements[textureIdx] = Placement{ layout.sliceCount++ };
+			layout.levelCount = std::min( layout.levelCount, pTexture->GetLevelCount() );
+		}
+	}
+
+	// Atlased, only when both the slices and the texture are powers of two, so offsets divide down with the levels
+	std::vector<size_t> atlased{};
+	if ( std::has_single_bit( layout.width ) && std::has_single_bit( layout.height ) )
+	{
+		const uint32_t minLevelCount{ std::min( layout.levelCount, MinLevelCount ) };
+		for ( size_t textureIdx{}; textureIdx < textures.size(); ++textureIdx )
+		{
+			const TextureData* pTexture{ textures[textureIdx] };
+			if ( !pTexture || layout.placements[textureIdx] || pTexture->GetFormat() != layout.format ||
+				 !std::has_single_bit( pTexture->GetWidth() ) || !std::has_single_bit( pTexture->GetHeight() ) ||
+				 pTexture->GetWidth() > layout.width || pTexture->GetHeight() > layout.height ||
+				 GetAtlasLevelCount( *pTexture ) < minLevelCount )
+			{
+				continue;
+			}
+			atlased.push_back( textureIdx );
+			layout.levelCount = std::min( layout.levelCount, GetAtlasLevelCount( *pTexture ) );
+		}
+	}
+
+	// Largest first, each into the smallest free rectangle that starts at a multiple of its size; what is left of the
+	// rectangle is split in two, the larger part keeping its full side. Same-shape textures fill a page like a quadtree
+	std::stable_sort( atlased.begin(), atlased.end(), [&]( size_t lhs, size_t rhs ) {
+		const TextureData& left{ *textures[lhs] };
+		const TextureData& right{ *textures[rhs] };
+		const size_t leftArea{ size_t{ left.GetWidth() } * left.GetHeight() };
+		const size_t rightArea{ size_t{ right.GetWidth() } * right.GetHeight() };
+		return leftArea != rightArea ? leftArea > rightArea : left.GetHeight() > right.GetHeight();
+	} );
+
+	std::vector<FreeRect> freeRects{};
+	for ( size_t textureIdx : atlased )
+	{
+		const uint32_t width{ textures[textureIdx]->GetWidth() };
+		const uint32_t height{ textures[textureIdx]->GetHeight() };
+
+		auto best{ freeRects.end() };
+		for ( auto it{ freeRects.begin() }; it != freeRects.end(); ++it )
+		{
+			if ( it->width >= width && it->height >= height && it->x % width == 0 && it->y % height == 0 &&
+				 ( best == freeRects.end() || it->GetArea() < best->GetArea() ) )
+			{
+				best = it;
+			}
+		}
+		if ( best == freeRects.end() )
+		{
+			freeRects.push_back( { layout.pageCount++, 0, 0, layout.width, layout.height } );
+			best = std::prev( freeRects.end() );
+		}
+		const FreeRect rect{ *best };
+		freeRects.erase( best );
+
+		Placement placement{};
+		placement.sliceIdx = layout.sliceCount + rect.pageIdx;
+		placement.x = rect.x;
+		placement.y = rect.y;
+		const float sliceWidth{ static_cast<float>( layout.width ) };
+		const float sliceHeight{ static_cast<float>( layout.height ) };
+		placement.uvScale = { static_cast<float>( width ) / sliceWidth, static_cast<float>( height ) / sliceHeight };
+		placement.uvOffset = { static_cast<float>( rect.x ) / sliceWidth, static_cast<float>( rect.y ) / sliceHeight };
+		layout.placements[textureIdx] = placement;
+
+		const uint32_t rightWidth{ rect.width - width };
+		const uint32_t bottomHeight{ rect.height - height };
+		const bool isRightTall{ rightWidth > bottomHeight };
+		const FreeRect right{ rect.pageIdx, rect.x + width, rect.y, rightWidth, isRightTall ? rect.height : height };
+		const FreeRect bottom{ rect.pageIdx, rect.x, rect.y + height, isRightTall ? width : rect.width, bottomHeight };
+		for ( const FreeRect& split : { right, bottom } )
+		{
+			if ( split.GetArea() > 0 )
+			{
+				freeRects.push_back( split );
+			}
+		}
+	}
+	layout.sliceCount += layout.pageCount;
+	return layout;
+}
+
+std::vector<TextureData> Build( const Layout& layout, std::span<const TextureData* const> textures )
+{
+	const bool isCompressed{ TextureData::IsCompressed( layout.format ) };
+	const uint32_t unitSize{ isCompressed ? TextureData::BlockSize : 1 };
+	const uint32_t unitBytes{ isCompressed ? TextureData::GetBlockBytes( layout.format )
+										   : TextureData::GetTexelBytes( layout.format ) };
+
+	std::vector<std::vector<std::byte>> slicePixels( layout.sliceCount );
+	for ( std::vector<std::byte>& pixels : slicePixels )
+	{
+		pixels.resize( TextureData::GetByteSize( layout.width, layout.height, layout.levelCount, layout.format ) );
+	}
+	for ( size_t textureIdx{}; textureIdx < textures.size(); ++textureIdx )
+	{
+		if ( !layout.placements[textureIdx] )
+		{
+			continue;
+		}
+
+		// A row of blocks at a time, the texture's level lands on whole blocks of the slice's
+		const Placement& placement{ *layout.placements[textureIdx] };
+		std::byte* pSlice{ slicePixels[placement.sliceIdx].data() };
+		for ( uint32_t levelIdx{}; levelIdx < layout.levelCount; ++levelIdx )
+		{
+			const TextureData::Level level{ textures[textureIdx]->GetLevel( levelIdx ) };
+			const uint32_t sliceRowPitch{ TextureData::GetRowPitch( std::max( layout.width >> levelIdx, 1u ),
+																	 layout.format ) };
+			const size_t levelOffset{
+				TextureData::GetByteSize( layout.width, layout.height, levelIdx, layout.format ) };
+			const size_t x{ ( placement.x >> levelIdx ) / unitSize };
+			const size_t y{ ( placement.y >> levelIdx ) / unitSize };
+			std::byte* pLevel{ pSlice + levelOffset + y * sliceRowPitch + x * unitBytes };
+
+			const uint32_t rowCount{ ( level.height + unitSize - 1 ) / unitSize };
+			for ( uint32_t rowIdx{}; rowIdx < rowCount; ++rowIdx )
+			{
+				std::memcpy( pLevel + size_t{ rowIdx } * sliceRowPitch,
+							 level.pixels.data() + size_t{ rowIdx } * level.rowPitch,
+							 level.rowPitch );
+			}
+		}
+	}
+
+	std::vector<TextureData> slices{};
+	slices.reserve( layout.sliceCount );
+	for ( std::vector<std::byte>& pixels : slicePixels )
+	{
+		slices.emplace_back( layout.width, layout.height, layout.levelCount, std::move( pixels ), layout.format );
+	}
+	return slices;
+}
+
+size_t GetByteSize( const Layout& layout )
+{
+	return layout.sliceCount *
+		   TextureData::GetByteSize( layout.width, layout.height, layout.levelCount, layout.format );
+}
+} // namespace atlas
+} // namespace dae
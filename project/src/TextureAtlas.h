@@ -0,0 +1,58 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+// Lays textures out as the slices of one texture array, without touching the GPU
+// The slices take the size and format most of the textures share, those get a slice of their own. Smaller textures of
+// the same format are packed into atlas pages, more slices of the same array: each sits at a multiple of its own size,
+// so every level of it lands on whole blocks and is copied as is. Non-power-of-two sizes, other formats and larger
+// textures are left out and keep their own texture
+// A page has no room around its textures, the array stops at the level where the smallest of them is a single block
+// and UVs have to stay within 0..1, wrapping or filtering across an edge samples the neighbour
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "Structs.h"
+#include "TextureData.h"
+
+namespace dae
+{
+namespace atlas
+{
+// Atlased textures have to keep at least this many levels, one that can't is left out rather than cut the array's
+// chain short; a 1024 slice keeps its levels down to 32x32
+constexpr uint32_t MinLevelCount{ 6 };
+
+// The slice a texture went to and the part of it the texture covers, its UVs are scaled and then offset
+struct Placement
+{
+	uint32_t sliceIdx{};
+	uint32_t x{}; // in texels of the first level
+	uint32_t y{};
+	Vector2 uvScale{ 1.f, 1.f };
+	Vector2 uvOffset{};
+};
+
+struct Layout
+{
+	uint32_t width{};
+	uint32_t height{};
+	uint32_t levelCount{};
+	TextureData::Format format{};
+	uint32_t sliceCount{};
+	uint32_t pageCount{};								// slices that are atlas pages, they come last
+	std::vector<std::optional<Placement>> placements{}; // per texture, nothing for those left out
+};
+
+// Null textures are left out
+Layout Plan( std::span<const TextureData* const> textures );
+
+// One TextureData per slice, with layout's level count; the textures have to be the ones layout was planned for
+// Space no texture covers is zero
+std::vector<TextureData> Build( const Layout& layout, std::span<const TextureData* const> textures );
+
+// Video memory of the array
+size_t GetByteSize( const Layout& layout );
+} // namespace atlas
+} // namespace dae
+#endif
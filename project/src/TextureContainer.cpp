@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "TextureContainer.h"
+#include "Error.h"
+
+namespace dae
+{
+namespace container
+{
+namespace
+{
+// D3D11 can't create anything larger, and it keeps every size computation far from overflowing
+constexpr uint32_t MaxDimension{ 16384 };
+
+constexpr uint32_t MakeFourCC( char a, char b, char c, char d )
+{
+	return static_cast<uint32_t>( a ) | static_cast<uint32_t>( b ) << 8 | static_cast<uint32_t>( c ) << 16 |
+		   static_cast<uint32_t>( d ) << 24;
+}
+
+// DDS
+constexpr uint32_t DdsMagic{ MakeFourCC( 'D', 'D', 'S', ' ' ) };
+constexpr uint32_t DdsMipCountFlag{ 0x20000 };
+constexpr uint32_t DdsDepthFlag{ 0x800000 };
+constexpr uint32_t DdsFourCCFlag{ 0x4 };
+constexpr uint32_t DdsRgbFlag{ 0x40 };
+constexpr uint32_t DdsCubeMapCaps{ 0x200 };
+constexpr uint32_t DdsVolumeCaps{ 0x200000 };
+constexpr uint32_t DdsTexture2D{ 3 };
+constexpr uint32_t DdsCubeMapMisc{ 0x4 };
+
+struct DdsPixelFormat
+{
+	uint32_t size{};
+	uint32_t flags{};
+	uint32_t fourCC{};
+	uint32_t rgbBitCount{};
+	uint32_t redMask{};
+	uint32_t greenMask{};
+	uint32_t blueMask{};
+	uint32_t alphaMask{};
+};
+
+struct DdsHeader
+{
+	uint32_t size{};
+	uint32_t flags{};
+	uint32_t height{};
+	uint32_t width{};
+	uint32_t pitchOrLinearSize{};
+	uint32_t depth{};
+	uint32_t mipMapCount{};
+	uint32_t reserved1[11]{};
+	DdsPixelFormat pixelFormat{};
+	uint32_t caps{};
+	uint32_t caps2{};
+	uint32_t caps3{};
+	uint32_t caps4{};
+	uint32_t reserved2{};
+};
+static_assert( sizeof( DdsHeader ) == 124 );
+
+// Follows the header when its four-character code is "DX10"
+struct DdsHeaderDx10
+{
+	uint32_t dxgiFormat{};
+	uint32_t resourceDimension{};
+	uint32_t miscFlag{};
+	uint32_t arraySize{};
+	uint32_t miscFlags2{};
+};
+static_assert( sizeof( DdsHeaderDx10 ) == 20 );
+//
+
+// KTX2
+constexpr uint8_t Ktx2Identifier[12]{ 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+struct Ktx2Header
+{
+	uint8_t identifier[12]{};
+	uint32_t vkFormat{};
+	uint32_t typeSize{};
+	uint32_t pixelWidth{};
+	uint32_t pixelHeight{};
+	uint32_t pixelDepth{};
+	uint32_t layerCount{};
+	uint32_t faceCount{};
+	uint32_t levelCount{};
+	uint32_t supercompressionScheme{};
+
+	uint32_t dfdByteOffset{};
+	uint32_t dfdByteLength{};
+	uint32_t kvdByteOffset{};
+	uint32_t kvdByteLength{};
+	uint64_t sgdByteOffset{};
+	uint64_t sgdByteLength{};
+};
+static_assert( sizeof( Ktx2Header ) == 80 );
+
+// One per level right after the header, largest level first even though the file stores the smallest first
+struct Ktx2Level
+{
+	uint64_t byteOffset{};
+	uint64_t byteLength{};
+	uint64_t uncompressedByteLength{};
+};
+static_assert( sizeof( Ktx2Level ) == 24 );
+//
+
+template <typename T>
+bool Read( const MappedFile& file, uint64_t offset, T& value )
+{
+	if ( offset > file.GetSize() || file.GetSize() - offset < sizeof( T ) )
+	{
+		return false;
+	}
+	std::memcpy( &value, file.GetData() + offset, sizeof( T ) );
+	return true;
+}
+
+std::optional<TextureData::Format> GetDdsFormat( const DdsPixelFormat& pixelFormat )
+{
+	if ( pixelFormat.flags & DdsFourCCFlag )
+	{
+		switch ( pixelFormat.fourCC )
+		{
+		case MakeFourCC( 'D', 'X', 'T', '1' ):
+			return TextureData::Format::bc1;
+		case MakeFourCC( 'D', 'X', 'T', '5' ):
+			return TextureData::Format::bc3;
+		case MakeFourCC( 'A', 'T', 'I', '1' ):
+		case MakeFourCC( 'B', 'C', '4', 'U' ):
+			return TextureData::Format::bc4;
+		case MakeFourCC( 'A', 'T', 'I', '2' ):
+		case MakeFourCC( 'B', 'C', '5', 'U' ):
+			return TextureData::Format::bc5;
+		default:
+			return std::nullopt;
+		}
+	}
+
+	// Legacy uncompressed files describe their layout with masks, only the ones matching our byte order are taken
+	if ( !( pixelFormat.flags & DdsRgbFlag ) )
+	{
+		return std::nullopt;
+	}
+
+	if ( pixelFormat.rgbBitCount == 32 && pixelFormat.redMask == 0x000000FF && pixelFormat.greenMask == 0x0000FF00 &&
+		 pixelFormat.blueMask == 0x00FF0000 && pixelFormat.alphaMask == 0xFF000000 )
+	{
+		return TextureData::Format::rgba8;
+	}
+	if ( pixelFormat.rgbBitCount == 16 && pixelFormat.redMask == 0x00FF && pixelFormat.greenMask == 0xFF00 &&
+		 pixelFormat.blueMask == 0 && pixelFormat.alphaMask == 0 )
+	{
+		return TextureData::Format::rg8;
+	}
+	if ( pixelFormat.rgbBitCount == 8 && pixelFormat.redMask == 0xFF && pixelFormat.greenMask == 0 &&
+		 pixelFormat.blueMask == 0 && pixelFormat.alphaMask == 0 )
+	{
+		return TextureData::Format::r8;
+	}
+	return std::nullopt;
+}
+
+std::optional<TextureData::Format> GetDxgiFormat( uint32_t dxgiFormat )
+{
+	switch ( dxgiFormat )
+	{
+	case 28: // R8G8B8A8_UNORM
+	case 29: // R8G8B8A8_UNORM_SRGB
+		return TextureData::Format::rgba8;
+	case 49: // R8G8_UNORM
+		return TextureData::Format::rg8;
+	case 61: // R8_UNORM
+		return TextureData::Format::r8;
+	case 71: // BC1_UNORM
+	case 72: // BC1_UNORM_SRGB
+		return TextureData::Format::bc1;
+	case 77: // BC3_UNORM
+	case 78: // BC3_UNORM_SRGB
+		return TextureData::Format::bc3;
+	case 80: // BC4_UNORM
+		return TextureData::Format::bc4;
+	case 83: // BC5_UNORM
+		return TextureData::Format::bc5;
+	case 98: // BC7_UNORM
+	case 99: // BC7_UNORM_SRGB
+		return TextureData::Format::bc7;
+	default:
+		return std::nullopt;
+	}
+}
+
+std::optional<TextureData::Format> GetVkFormat( uint32_t vkFormat )
+{
+	switch ( vkFormat )
+	{
+	case 9:	 // R8_UNORM
+	case 15: // R8_SRGB
+		return TextureData::Format::r8;
+	case 16: // R8G8_UNORM
+	case 22: // R8G8_SRGB
+		return TextureData::Format::rg8;
+	case 37: // R8G8B8A8_UNORM
+	case 43: // R8G8B8A8_SRGB
+		return TextureData::Format::rgba8;
+	case 131: // BC1_RGB_UNORM_BLOCK
+	case 132: // BC1_RGB_SRGB_BLOCK
+	case 133: // BC1_RGBA_UNORM_BLOCK
+	case 134: // BC1_RGBA_SRGB_BLOCK
+		return TextureData::Format::bc1;
+	case 137: // BC3_UNORM_BLOCK
+	case 138: // BC3_SRGB_BLOCK
+		return TextureData::Format::bc3;
+	case 139: // BC4_UNORM_BLOCK
+		return TextureData::Format::bc4;
+	case 141: // BC5_UNORM_BLOCK
+		return TextureData::Format::bc5;
+	case 145: // BC7_UNORM_BLOCK
+	case 146: // BC7_SRGB_BLOCK
+		return TextureData::Format::bc7;
+	default:
+		return std::nullopt;
+	}
+}
+
+// Block-compressed textures have to start out a whole number of blocks for D3D11 to create them
+bool IsValidSize( uint32_t width, uint32_t height, uint32_t levelCount, TextureData::Format format )
+{
+	if ( width == 0 || height == 0 || width > MaxDimension || height > MaxDimension )
+	{
+		return false;
+	}
+
+	if ( TextureData::IsCompressed( format ) &&
+		 ( width % TextureData::BlockSize != 0 || height % TextureData::BlockSize != 0 ) )
+	{
+		return false;
+	}
+
+	return levelCount > 0 && levelCount <= TextureData::GetFullLevelCount( width, height );
+}
+
+std::optional<TextureData> OpenDds( MappedFile&& file )
+{
+	uint32_t magic{};
+	DdsHeader header{};
+	if ( !Read( file, 0, magic ) || magic != DdsMagic || !Read( file, sizeof( magic ), header ) ||
+		 header.size != sizeof( DdsHeader ) || header.pixelFormat.size != sizeof( DdsPixelFormat ) )
+	{
+		return std::nullopt;
+	}
+
+	const bool isVolume{ ( ( header.flags & DdsDepthFlag ) && header.depth > 1 ) || ( header.caps2 & DdsVolumeCaps ) };
+	if ( isVolume || ( header.caps2 & DdsCubeMapCaps ) )
+	{
+		return std::nullopt;
+	}
+
+	uint64_t pixelOffset{ sizeof( magic ) + sizeof( DdsHeader ) };
+	std::optional<TextureData::Format> format{};
+	if ( ( header.pixelFormat.flags & DdsFourCCFlag ) && header.pixelFormat.fourCC == MakeFourCC( 'D', 'X', '1', '0' ) )
+	{
+		DdsHeaderDx10 headerDx10{};
+		if ( !Read( file, pixelOffset, headerDx10 ) || headerDx10.resourceDimension != DdsTexture2D ||
+			 headerDx10.arraySize != 1 || ( headerDx10.miscFlag & DdsCubeMapMisc ) )
+		{
+			return std::nullopt;
+		}
+		pixelOffset += sizeof( DdsHeaderDx10 );
+		format = GetDxgiFormat( headerDx10.dxgiFormat );
+	}
+	else
+	{
+		format = GetDdsFormat( header.pixelFormat );
+	}
+
+	const uint32_t levelCount{ ( header.flags & DdsMipCountFlag ) ? std::max( header.mipMapCount, 1u ) : 1u };
+	if ( !format || !IsValidSize( header.width, header.height, levelCount, *format ) )
+	{
+		return std::nullopt;
+	}
+
+	// Levels follow each other largest first, exactly the way TextureData lays them out
+	const size_t pixelSize{ TextureData::GetByteSize( header.width, header.height, levelCount, *format ) };
+	if ( file.GetSize() - pixelOffset < pixelSize )
+	{
+		return std::nullopt;
+	}
+
+	const std::span<const std::byte> pixels{ reinterpret_cast<const std::byte*>( file.GetData() + pixelOffset ),
+											 pixelSize };
+	return TextureData{ std::move( file ), header.width, header.height, levelCount, pixels, *format };
+}
+
+std::optional<TextureData> OpenKtx2( MappedFile&& file )
+{
+	Ktx2Header header{};
+	if ( !Read( file, 0, header ) ||
+		 std::memcmp( header.identifier, Ktx2Identifier, sizeof( Ktx2Identifier ) ) != 0 )
+	{
+		return std::nullopt;
+	}
+
+	// Volumes, arrays and cube maps aren't 2D textures, and supercompressed levels would need decoding
+	if ( header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1 ||
+		 header.supercompressionScheme != 0 || header.typeSize != 1 )
+	{
+		return std::nullopt;
+	}
+
+	// A level count of 0 asks for mips made at load time, only the first level is stored then
+	const std::optional<TextureData::Format> format{ GetVkFormat( header.vkFormat ) };
+	const uint32_t levelCount{ std::max( header.levelCount, 1u ) };
+	if ( !format || !IsValidSize( header.pixelWidth, header.pixelHeight, levelCount, *format ) )
+	{
+		return std::nullopt;
+	}
+
+	std::vector<std::span<const std::byte>> levelPixels( levelCount );
+	for ( uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx )
+	{
+		Ktx2Level level{};
+		if ( !Read( file, sizeof( Ktx2Header ) + uint64_t{ levelIdx } * sizeof( Ktx2Level ), level ) )
+		{
+			return std::nullopt;
+		}
+
+		const uint32_t width{ std::max( header.pixelWidth >> levelIdx, 1u ) };
+		const uint32_t height{ std::max( header.pixelHeight >> levelIdx, 1u ) };
+		const size_t byteSize{ TextureData::GetByteSize( width, height, 1, *format ) };
+		if ( level.byteLength != byteSize || level.byteOffset > file.GetSize() ||
+			 file.GetSize() - level.byteOffset < byteSize )
+		{
+			return std::nullopt;
+		}
+		levelPixels[levelIdx] = { reinterpret_cast<const std::byte*>( file.GetData() + level.byteOffset ), byteSize };
+	}
+
+	return TextureData{ std::move( file ), header.pixelWidth, header.pixelHeight, std::move( levelPixels ), *format };
+}
+} // namespace
+
+bool IsContainer( const std::string& path )
+{
+	const std::filesystem::path extension{ std::filesystem::path{ path }.extension() };
+	return extension == ".dds" || extension == ".ktx2";
+}
+
+std::optional<std::string> FindNextTo( const std::string& imagePath )
+{
+	for ( const char* extension : { ".dds", ".ktx2" } )
+	{
+		const std::filesystem::path containerPath{ std::filesystem::path{ imagePath }.replace_extension( extension ) };
+		std::error_code errorCode{};
+		if ( std::filesystem::is_regular_file( containerPath, errorCode ) )
+		{
+			return containerPath.string();
+		}
+	}
+	return std::nullopt;
+}
+
+std::optional<TextureData> Open( const std::string& path )
+{
+	MappedFile file{};
+	try
+	{
+		file = MappedFile( path );
+	}
+	catch ( const error::file::FileError& )
+	{
+		return std::nullopt;
+	}
+
+	return std::filesystem::path{ path }.extension() == ".ktx2" ? OpenKtx2( std::move( file ) )
+																: OpenDds( std::move( file ) );
+}
+} // namespace container
+} // namespace dae
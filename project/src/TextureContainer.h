@@ -0,0 +1,26 @@
+#ifndef TEXTURECONTAINER_H
+#define TEXTURECONTAINER_H
+
+// DDS and KTX2 files written by other tools, mapped instead of decoded
+// Only what TextureData can hold is accepted: a single 2D image with its mip chain, in 8-bit RGBA, RG or R or one of the
+// BC formats; sRGB variants load as their UNORM counterpart, the renderer samples every texture as UNORM
+#include <optional>
+#include <string>
+#include "TextureData.h"
+
+namespace dae
+{
+namespace container
+{
+// By extension, .dds or .ktx2
+bool IsContainer( const std::string& path );
+
+// A container with the image's name in the same directory, the .dds when there are both
+std::optional<std::string> FindNextTo( const std::string& imagePath );
+
+// Maps the file and points every level straight into the mapping, nothing is decoded or copied
+// Returns nothing when the file is missing, malformed or holds something TextureData can't
+std::optional<TextureData> Open( const std::string& path );
+} // namespace container
+} // namespace dae
+#endif
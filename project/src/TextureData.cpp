@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <bit>
+#include "TextureData.h"
+
+namespace dae
+{
+TextureData::TextureData( uint32_t width,
+						  uint32_t height,
+						  uint32_t levelCount,
+						  std::vector<std::byte>&& pixels,
+						  Format format )
+	: m_Pixels( std::move( pixels ) )
+	, m_PixelView( m_Pixels )
+	, m_Width( width )
+	, m_Height( height )
+	, m_LevelCount( levelCount )
+	, m_Format( format )
+{
+}
+
+TextureData::TextureData( MappedFile&& file,
+						  uint32_t width,
+						  uint32_t height,
+						  uint32_t levelCount,
+						  std::span<const std::byte> pixels,
+						  Format format )
+	: m_File( std::move( file ) )
+	, m_PixelView( pixels )
+	, m_Width( width )
+	, m_Height( height )
+	, m_LevelCount( levelCount )
+	, m_Format( format )
+{
+}
+
+TextureData::TextureData( MappedFile&& file,
+						  uint32_t width,
+						  uint32_t height,
+						  std::vector<std::span<const std::byte>>&& levelPixels,
+						  Format format )
+	: m_File( std::move( file ) )
+	, m_LevelViews( std::move( levelPixels ) )
+	, m_Width( width )
+	, m_Height( height )
+	, m_LevelCount( static_cast<uint32_t>( m_LevelViews.size() ) )
+	, m_Format( format )
+{
+}
+
+uint32_t TextureData::GetFullLevelCount( uint32_t width, uint32_t height )
+{
+	return std::bit_width( std::max( width, height ) );
+}
+
+size_t TextureData::GetByteSize( uint32_t width, uint32_t height, uint32_t levelCount, Format format )
+{
+	size_t byteSize{};
+	for ( uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx )
+	{
+		const uint32_t levelHeight{ std::max( height >> levelIdx, 1u ) };
+		const uint32_t rowCount{ IsCompressed( format ) ? ( levelHeight + BlockSize - 1 ) / BlockSize : levelHeight };
+		byteSize += size_t{ GetRowPitch( std::max( width >> levelIdx, 1u ), format ) } * rowCount;
+	}
+	return byteSize;
+}
+
+uint32_t TextureData::GetRowPitch( uint32_t width, Format format )
+{
+	if ( !IsCompressed( format ) )
+	{
+		return width * GetTexelBytes( format );
+	}
+	return ( width + BlockSize - 1 ) / BlockSize * GetBlockBytes( format );
+}
+
+uint32_t TextureData::GetBlockBytes( Format format )
+{
+	switch ( format )
+	{
+	case Format::bc1:
+	case Format::bc4:
+		return 8;
+
+	case Format::bc3:
+	case Format::bc5:
+	case Format::bc7:
+		return 16;
+
+	default:
+		return 0;
+	}
+}
+
+uint32_t TextureData::GetTexelBytes( Format format )
+{
+	switch ( format )
+	{
+	case Format::rgba8:
+		return BytesPerPixel;
+
+	case Format::r8:
+		return 1;
+
+	case Format::rg8:
+		return 2;
+
+	default:
+		return 0;
+	}
+}
+
+bool TextureData::IsCompressed( Format format )
+{
+	return GetBlockBytes( format ) > 0;
+}
+
+uint32_t TextureData::GetWidth() const
+{
+	return m_Width;
+}
+
+uint32_t TextureData::GetHeight() const
+{
+	return m_Height;
+}
+
+uint32_t TextureData::GetRowPitch() const
+{
+	return GetRowPitch( m_Width, m_Format );
+}
+
+uint32_t TextureData::GetLevelCount() const
+{
+	return m_LevelCount;
+}
+
+TextureData::Format TextureData::GetFormat() const
+{
+	return m_Format;
+}
+
+TextureData::Level TextureData::GetLevel( uint32_t levelIdx ) const
+{
+	Level level{};
+	level.width = std::max( m_Width >> levelIdx, 1u );
+	level.height = std::max( m_Height >> levelIdx, 1u );
+	level.rowPitch = GetRowPitch( level.width, m_Format );
+	level.pixels = !m_LevelViews.empty() ? m_LevelViews[levelIdx]
+										 : m_PixelView.subspan( GetByteSize( m_Width, m_Height, levelIdx, m_Format ),
+																GetByteSize( level.width, level.height, 1, m_Format ) );
+	return level;
+}
+
+std::span<const std::byte> TextureData::GetPixels() const
+{
+	return m_PixelView;
+}
+
+bool TextureData::IsMapped() const
+{
+	return m_File.GetData() != nullptr;
+}
+
+std::vector<std::byte> TextureData::CopyPixels() const
+{
+	std::vector<std::byte> pixels{};
+	pixels.reserve( GetByteSize( m_Width, m_Height, m_LevelCount, m_Format ) );
+	for ( uint32_t levelIdx{}; levelIdx < m_LevelCount; ++levelIdx )
+	{
+		const std::span<const std::byte> levelPixels{ GetLevel( levelIdx ).pixels };
+		pixels.insert( pixels.end(), levelPixels.begin(), levelPixels.end() );
+	}
+	return pixels;
+}
+
+void TextureData::Evict( uint32_t firstLevel, uint32_t endLevel ) const
+{
+	if ( !IsMapped() )
+	{
+		return;
+	}
+
+	const std::byte* pFileData{ reinterpret_cast<const std::byte*>( m_File.GetData() ) };
+	for ( uint32_t levelIdx{ firstLevel }; levelIdx < std::min( endLevel, m_LevelCount ); ++levelIdx )
+	{
+		const std::span<const std::byte> pixels{ GetLevel( levelIdx ).pixels };
+		m_File.Evict( static_cast<size_t>( pixels.data() - pFileData ), pixels.size() );
+	}
+}
+} // namespace dae
@@ -0,0 +1,108 @@
+#ifndef TEXTUREDATA_H
+#define TEXTUREDATA_H
+
+// CPU-side pixels of a texture, either owned or viewed straight out of a mapped cooked file
+// Pixels are 8-bit RGBA, RG or R with tightly packed rows, or rows of 4x4 blocks for the block-compressed formats; the
+// first row is the top of the image
+// Mip levels follow each other largest first, each one half the size of the one before it, rounded down; only textures
+// viewed out of a container that orders them differently (KTX2) keep them apart
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "MappedFile.h"
+
+namespace dae
+{
+class TextureData final
+{
+public:
+	static constexpr uint32_t BytesPerPixel{ 4 };
+	static constexpr uint32_t BlockSize{ 4 };
+
+	// The DXGI formats of the same name, UNORM; values are stored in cooked files, so new ones go last
+	enum class Format
+	{
+		rgba8,
+		bc1, // rgb, 8 bytes per block
+		bc3, // rgba, 16 bytes per block
+		bc4, // r, 8 bytes per block
+		bc5, // rg, 16 bytes per block
+		bc7, // rgba, 16 bytes per block
+		r8,
+		rg8,
+		count
+	};
+
+	struct Level
+	{
+		uint32_t width{};
+		uint32_t height{};
+		uint32_t rowPitch{}; // of a row of blocks for the block-compressed formats
+		std::span<const std::byte> pixels{};
+	};
+
+	TextureData() = default;
+	TextureData( uint32_t width,
+				 uint32_t height,
+				 uint32_t levelCount,
+				 std::vector<std::byte>&& pixels,
+				 Format format = Format::rgba8 );
+	TextureData( MappedFile&& file,
+				 uint32_t width,
+				 uint32_t height,
+				 uint32_t levelCount,
+				 std::span<const std::byte> pixels,
+				 Format format = Format::rgba8 );
+	// Each level's pixels wherever they sit in the mapping, largest first
+	TextureData( MappedFile&& file,
+				 uint32_t width,
+				 uint32_t height,
+				 std::vector<std::span<const std::byte>>&& levelPixels,
+				 Format format = Format::rgba8 );
+	TextureData( const TextureData& ) = delete;
+	TextureData( TextureData&& ) = default; // the vector and the mapping keep their addresses when moved
+	TextureData& operator=( const TextureData& ) = delete;
+	TextureData& operator=( TextureData&& ) = default;
+
+	~TextureData() noexcept = default;
+
+	// Levels down to 1x1
+	static uint32_t GetFullLevelCount( uint32_t width, uint32_t height );
+	static size_t GetByteSize( uint32_t width, uint32_t height, uint32_t levelCount, Format format = Format::rgba8 );
+	static uint32_t GetRowPitch( uint32_t width, Format format );
+	static uint32_t GetBlockBytes( Format format ); // 0 for the uncompressed formats
+	static uint32_t GetTexelBytes( Format format ); // 0 for the block-compressed formats
+	static bool IsCompressed( Format format );
+
+	// Getters
+	// Width, height and row pitch are the first level's
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	uint32_t GetRowPitch() const;
+	uint32_t GetLevelCount() const;
+	Format GetFormat() const;
+	Level GetLevel( uint32_t levelIdx ) const;
+	std::span<const std::byte> GetPixels() const; // every level, empty when they aren't back to back
+	bool IsMapped() const;
+
+	// Every level back to back in a vector of its own, whatever the levels point into
+	std::vector<std::byte> CopyPixels() const;
+	// Drops the pages of the levels in [firstLevel, endLevel) from the working set when they are mapped, touching them
+	// again reads them back from the file; owned pixels stay where they are
+	void Evict( uint32_t firstLevel, uint32_t endLevel ) const;
+
+private:
+	// SOFTWARE RESOURCES
+	std::vector<std::byte> m_Pixels{};
+	MappedFile m_File{};
+	std::span<const std::byte> m_PixelView{};
+	std::vector<std::span<const std::byte>> m_LevelViews{}; // only when the levels aren't back to back
+	uint32_t m_Width{};
+	uint32_t m_Height{};
+	uint32_t m_LevelCount{};
+	Format m_Format{};
+	//
+};
+} // namespace dae
+#endif
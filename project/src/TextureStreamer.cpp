@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include "TextureStreamer.h"
+
+namespace dae
+{
+TextureStreamer::TextureStreamer( ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, size_t budgetBytes )
+	: m_BudgetBytes( budgetBytes )
+	, m_pDevice( pDevice )
+	, m_pDeviceContext( pDeviceContext )
+{
+}
+
+std::shared_ptr<Texture> TextureStreamer::Create( TextureData&& texture )
+{
+	auto pEntry{ std::make_unique<Entry>() };
+	streaming::TextureState& state{ pEntry->state };
+	state.width = texture.GetWidth();
+	state.height = texture.GetHeight();
+	state.levelCount = texture.GetLevelCount();
+	state.format = texture.GetFormat();
+	state.tailLevel = streaming::GetTailLevel( state.width, state.height, state.levelCount, state.format );
+	state.residentLevel = state.tailLevel;
+	state.wantedLevel = state.tailLevel;
+	state.pendingLevel = state.tailLevel;
+	state.lastRequestedFrame = m_FrameIdx;
+
+	const auto pTexture{ std::make_shared<Texture>( m_pDevice, std::move( texture ), state.tailLevel ) };
+	pEntry->pTexture = pTexture;
+	m_Entries.push_back( std::move( pEntry ) );
+	return pTexture;
+}
+
+void TextureStreamer::Update( AssetLoader& loader )
+{
+	++m_FrameIdx;
+
+	std::erase_if( m_Entries, []( const std::unique_ptr<Entry>& pEntry ) {
+		return pEntry->pTexture.expired() && pEntry->state.pendingLevel == pEntry->state.residentLevel;
+	} );
+
+	// Nothing asking for a texture anymore means it only needs its tail
+	std::vector<streaming::TextureState> states( m_Entries.size() );
+	for ( size_t entryIdx{}; entryIdx < m_Entries.size(); ++entryIdx )
+	{
+		Entry& entry{ *m_Entries[entryIdx] };
+		const std::shared_ptr<Texture> pTexture{ entry.pTexture.lock() };
+		const std::optional<uint32_t> levelIdx{ pTexture ? pTexture->TakeRequest() : std::nullopt };
+		entry.state.wantedLevel = levelIdx ? std::min( *levelIdx, entry.state.tailLevel ) : entry.state.tailLevel;
+		if ( levelIdx )
+		{
+			entry.state.lastRequestedFrame = m_FrameIdx;
+		}
+		states[entryIdx] = entry.state;
+	}
+
+	const streaming::Plan plan{ streaming::MakePlan(
+		states, m_BudgetBytes, MaxPendingCount - std::min( m_PendingCount, MaxPendingCount ) ) };
+
+	for ( const streaming::Change& eviction : plan.evictions )
+	{
+		Entry& entry{ *m_Entries[eviction.textureIdx] };
+		if ( const std::shared_ptr<Texture> pTexture{ entry.pTexture.lock() } )
+		{
+			pTexture->EvictLevels( m_pDevice, m_pDeviceContext, eviction.residentLevel );
+			m_EvictedLevelCount += eviction.residentLevel - entry.state.residentLevel;
+			entry.state.residentLevel = eviction.residentLevel;
+			entry.state.pendingLevel = eviction.residentLevel;
+		}
+	}
+
+	for ( const streaming::Change& streamIn : plan.streamIns )
+	{
+		StreamIn( loader, *m_Entries[streamIn.textureIdx], streamIn.residentLevel );
+	}
+}
+
+TextureStreamer::Statistics TextureStreamer::GetStatistics() const
+{
+	Statistics statistics{};
+	for ( const std::unique_ptr<Entry>& pEntry : m_Entries )
+	{
+		if ( const std::shared_ptr<Texture> pTexture{ pEntry->pTexture.lock() } )
+		{
+			statistics.residentBytes += pTexture->GetByteSize();
+			++statistics.textureCount;
+		}
+	}
+	statistics.budgetBytes = m_BudgetBytes;
+	statistics.pendingCount = m_PendingCount;
+	statistics.streamedLevelCount = m_StreamedLevelCount;
+	statistics.evictedLevelCount = m_EvictedLevelCount;
+	return statistics;
+}
+
+size_t TextureStreamer::GetPendingCount() const
+{
+	return m_PendingCount;
+}
+
+void TextureStreamer::StreamIn( AssetLoader& loader, Entry& entry, uint32_t levelIdx )
+{
+	// The job keeps the texture, and with it the data it reads, alive; the entry outlives it either way
+	// Textures streaming in are never evicted, so nothing else touches their data until the job lands
+	const std::shared_ptr<Texture> pTexture{ entry.pTexture.lock() };
+	if ( !pTexture )
+	{
+		return;
+	}
+
+	++m_PendingCount;
+	entry.state.pendingLevel = levelIdx;
+
+	const auto land{ [this, &entry]() {
+		--m_PendingCount;
+		return std::exchange( entry.state.pendingLevel, entry.state.residentLevel );
+	} };
+	loader.Enqueue(
+		"stream-in of level " + std::to_string( levelIdx ),
+		[pTexture, pDevice = m_pDevice, levelIdx]() { return pTexture->CreateLevels( pDevice, levelIdx ); },
+		[this, &entry, land]( Texture&& levels ) {
+			const uint32_t firstLevel{ land() };
+			if ( const std::shared_ptr<Texture> pStreamed{ entry.pTexture.lock() } )
+			{
+				pStreamed->SetResidentLevels( std::move( levels ) );
+				m_StreamedLevelCount += entry.state.residentLevel - firstLevel;
+				entry.state.residentLevel = firstLevel;
+				entry.state.pendingLevel = firstLevel;
+			}
+		},
+		[land]() { land(); } );
+}
+} // namespace dae
@@ -0,0 +1,84 @@
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+// Keeps the mip levels of the textures it creates under a video memory budget, StreamingPlanner.h decides which
+// Textures start out with only their tail; every frame the levels the meshes requested are planned. Evictions copy the
+// kept levels into a smaller resource on the GPU right away, stream-ins create the larger resource on the asset
+// loader's workers and the render thread only swaps it in
+// D3D11 can't drop or add levels of a texture in place, so the new resource replaces the old one; the pages of mapped
+// levels that aren't on the GPU are dropped as well, so the budget holds for memory too
+// Only used from the render thread
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <d3d11.h>
+#include "AssetLoader.h"
+#include "StreamingPlanner.h"
+#include "Texture.h"
+#include "TextureData.h"
+
+namespace dae
+{
+class TextureStreamer final
+{
+public:
+	struct Statistics
+	{
+		size_t residentBytes{};
+		size_t budgetBytes{};
+		size_t textureCount{};
+		size_t pendingCount{};		 // stream-ins in flight
+		size_t streamedLevelCount{}; // since startup
+		size_t evictedLevelCount{};	 // since startup
+	};
+
+	static constexpr size_t DefaultBudgetBytes{ size_t{ 64 } << 20 };
+	// Each stream-in is a single level
+	static constexpr size_t MaxPendingCount{ 4 };
+
+	TextureStreamer( ID3D11Device* pDevice,
+					 ID3D11DeviceContext* pDeviceContext,
+					 size_t budgetBytes = DefaultBudgetBytes );
+	TextureStreamer( const TextureStreamer& ) = delete;
+	TextureStreamer( TextureStreamer&& ) = delete;
+	TextureStreamer& operator=( const TextureStreamer& ) = delete;
+	TextureStreamer& operator=( TextureStreamer&& ) = delete;
+
+	~TextureStreamer() noexcept = default;
+
+	// Methods
+	// Uploads the tail only, the texture keeps its data for the levels above it
+	std::shared_ptr<Texture> Create( TextureData&& texture );
+	// Plans with the requests made since the last call, call once per frame
+	void Update( AssetLoader& loader );
+
+	// Getters
+	Statistics GetStatistics() const;
+	size_t GetPendingCount() const;
+
+private:
+	struct Entry
+	{
+		std::weak_ptr<Texture> pTexture{};
+		streaming::TextureState state{};
+	};
+
+	// SOFTWARE RESOURCES
+	std::vector<std::unique_ptr<Entry>> m_Entries{}; // stream-ins in flight point at theirs
+	uint64_t m_FrameIdx{};
+	size_t m_BudgetBytes{};
+	size_t m_PendingCount{};
+	size_t m_StreamedLevelCount{};
+	size_t m_EvictedLevelCount{};
+	//
+
+	// HARDWARE RESOURCES: NON-OWNING
+	ID3D11Device* m_pDevice{};
+	ID3D11DeviceContext* m_pDeviceContext{};
+	//
+
+	void StreamIn( AssetLoader& loader, Entry& entry, uint32_t levelIdx );
+};
+} // namespace dae
+#endif
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include "ThreadPool.h"
+
+namespace dae
+{
+ThreadPool::ThreadPool( uint32_t threadCount )
+{
+	threadCount = std::max( threadCount, 1u );
+
+	m_Threads.reserve( threadCount );
+	for ( uint32_t threadIdx{}; threadIdx < threadCount; ++threadIdx )
+	{
+		m_Threads.emplace_back( [this]() { WorkerLoop(); } );
+	}
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+	{
+		const std::lock_guard lock{ m_Mutex };
+		m_IsStopping = true;
+	}
+	m_TaskAvailable.notify_all();
+
+	for ( auto& thread : m_Threads )
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::ParallelFor( size_t count, const std::function<void( size_t )>& function )
+{
+	if ( count == 0 )
+	{
+		return;
+	}
+
+	if ( count == 1 )
+	{
+		function( 0 );
+		return;
+	}
+
+	// Workers grab indices from a shared counter, the caller joins in as one of them
+	std::atomic<size_t> nextIndex{};
+	const auto work{ [&]() {
+		for ( size_t index{ nextIndex++ }; index < count; index = nextIndex++ )
+		{
+			function( index );
+		}
+	} };
+
+	const size_t helperCount{ std::min( count, m_Threads.size() ) - 1 };
+	std::vector<std::future<void>> helpers{};
+	helpers.reserve( helperCount );
+	for ( size_t helperIdx{}; helperIdx < helperCount; ++helperIdx )
+	{
+		helpers.push_back( Enqueue( work ) );
+	}
+
+	// Helpers reference this stack frame, so every one of them has to finish before anything is rethrown
+	std::exception_ptr pException{};
+	try
+	{
+		work();
+	}
+	catch ( ... )
+	{
+		pException = std::current_exception();
+		nextIndex = count;
+	}
+
+	// Don't just block while helpers are still queued, keep the queue moving
+	for ( auto& helper : helpers )
+	{
+		while ( helper.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+		{
+			if ( !RunPendingTask() )
+			{
+				helper.wait();
+			}
+		}
+
+		try
+		{
+			helper.get();
+		}
+		catch ( ... )
+		{
+			if ( !pException )
+			{
+				pException = std::current_exception();
+			}
+		}
+	}
+
+	if ( pException )
+	{
+		std::rethrow_exception( pException );
+	}
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+	return static_cast<uint32_t>( m_Threads.size() );
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while ( true )
+	{
+		std::function<void()> task{};
+		{
+			std::unique_lock lock{ m_Mutex };
+			m_TaskAvailable.wait( lock, [this]() { return m_IsStopping || !m_Tasks.empty(); } );
+
+			if ( m_Tasks.empty() )
+			{
+				return;
+			}
+
+			task = std::move( m_Tasks.front() );
+			m_Tasks.pop();
+		}
+
+		task();
+	}
+}
+
+bool ThreadPool::RunPendingTask()
+{
+	std::function<void()> task{};
+	{
+		const std::lock_guard lock{ m_Mutex };
+		if ( m_Tasks.empty() )
+		{
+			return false;
+		}
+
+		task = std::move( m_Tasks.front() );
+		m_Tasks.pop();
+	}
+
+	task();
+	return true;
+}
+} // namespace dae
@@ -0,0 +1,70 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// Fixed-size pool of worker threads pulling from a shared task queue
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dae
+{
+class ThreadPool final
+{
+public:
+	explicit ThreadPool( uint32_t threadCount = std::thread::hardware_concurrency() );
+	ThreadPool( const ThreadPool& ) = delete;
+	ThreadPool( ThreadPool&& ) = delete;
+	ThreadPool& operator=( const ThreadPool& ) = delete;
+	ThreadPool& operator=( ThreadPool&& ) = delete;
+
+	~ThreadPool() noexcept;
+
+	// Methods
+	template <typename Function>
+	std::future<std::invoke_result_t<Function>> Enqueue( Function&& function );
+
+	// Runs function( index ) for every index in [0, count) and blocks until all of them are done
+	// The calling thread helps out, so this is safe to use from inside a task
+	void ParallelFor( size_t count, const std::function<void( size_t )>& function );
+
+	// Getters
+	uint32_t GetThreadCount() const;
+
+private:
+	// SOFTWARE RESOURCES
+	std::vector<std::thread> m_Threads{};
+	std::queue<std::function<void()>> m_Tasks{};
+	std::mutex m_Mutex{};
+	std::condition_variable m_TaskAvailable{};
+	bool m_IsStopping{};
+	//
+
+	void WorkerLoop();
+	bool RunPendingTask();
+};
+
+template <typename Function>
+std::future<std::invoke_result_t<Function>> ThreadPool::Enqueue( Function&& function )
+{
+	using Result = std::invoke_result_t<Function>;
+
+	// std::function needs a copyable callable, the task itself is move-only
+	auto pTask{ std::make_shared<std::packaged_task<Result()>>( std::forward<Function>( function ) ) };
+	std::future<Result> future{ pTask->get_future() };
+	{
+		const std::lock_guard lock{ m_Mutex };
+		m_Tasks.emplace( [pTask]() { ( *pTask )(); } );
+	}
+	m_TaskAvailable.notify_one();
+
+	return future;
+}
+} // namespace dae
+#endif
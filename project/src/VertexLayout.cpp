@@ -0,0 +1,56 @@
+#include <cstddef>
+#include "VertexLayout.h"
+#include "Structs.h"
+
+namespace dae
+{
+VertexLayout VertexLayout::CreateDefault()
+{
+	VertexLayout layout{};
+	layout.stride = sizeof( Vertex );
+	layout.attributeCount = 5;
+
+	layout.attributes[0] = { VertexSemantic::position, VertexAttributeFormat::float3, offsetof( Vertex, position ) };
+	layout.attributes[1] = { VertexSemantic::color, VertexAttributeFormat::float3, offsetof( Vertex, color ) };
+	layout.attributes[2] = { VertexSemantic::texcoord, VertexAttributeFormat::float2, offsetof( Vertex, UV ) };
+	layout.attributes[3] = { VertexSemantic::normal, VertexAttributeFormat::float3, offsetof( Vertex, normal ) };
+	layout.attributes[4] = { VertexSemantic::tangent, VertexAttributeFormat::float4, offsetof( Vertex, tangent ) };
+
+	return layout;
+}
+
+VertexLayout VertexLayout::CreatePacked( bool halfPositions, bool unormUVs )
+{
+	VertexLayout layout{};
+	layout.attributeCount = 3;
+
+	uint16_t offset{};
+	layout.attributes[0] = { VertexSemantic::position,
+							 halfPositions ? VertexAttributeFormat::half4 : VertexAttributeFormat::float3,
+							 offset };
+	offset += halfPositions ? 8 : 12;
+
+	layout.attributes[1] = { VertexSemantic::normalTangent, VertexAttributeFormat::snorm8x4, offset };
+	offset += 4;
+
+	layout.attributes[2] = { VertexSemantic::texcoord,
+							 unormUVs ? VertexAttributeFormat::unorm16x2 : VertexAttributeFormat::half2,
+							 offset };
+	offset += 4;
+
+	layout.stride = offset;
+	return layout;
+}
+
+bool VertexLayout::IsPacked() const
+{
+	for ( uint32_t attributeIdx{}; attributeIdx < attributeCount && attributeIdx < MaxAttributes; ++attributeIdx )
+	{
+		if ( attributes[attributeIdx].semantic == VertexSemantic::normalTangent )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+} // namespace dae
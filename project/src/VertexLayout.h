@@ -0,0 +1,60 @@
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+
+// API-independent description of a vertex buffer's contents
+// Stored in cooked assets and turned into a D3D11 input layout by the effects
+#include <cstdint>
+
+namespace dae
+{
+enum class VertexSemantic : uint8_t
+{
+	position,
+	color,
+	texcoord,
+	normal,
+	tangent,
+	normalTangent, // octahedral normal in xy, tangent angle around the normal in z, handedness in w
+};
+
+enum class VertexAttributeFormat : uint8_t
+{
+	float2,
+	float3,
+	float4,
+	half2,
+	half4, // half3 does not exist as a vertex format, w is padding
+	unorm16x2,
+	snorm8x4,
+};
+
+struct VertexAttribute
+{
+	VertexSemantic semantic{};
+	VertexAttributeFormat format{};
+	uint16_t offset{};
+
+	bool operator==( const VertexAttribute& ) const = default;
+};
+
+struct VertexLayout
+{
+	static constexpr uint32_t MaxAttributes{ 8 };
+
+	uint32_t stride{};
+	uint32_t attributeCount{};
+	VertexAttribute attributes[MaxAttributes]{};
+
+	bool operator==( const VertexLayout& ) const = default;
+
+	bool IsPacked() const;
+
+	// Layout of the Vertex struct
+	static VertexLayout CreateDefault();
+
+	// 20 bytes, or 16 with half positions, color is dropped
+	// UNORM UVs only cover [0, 1], meshes with UVs outside that range need half UVs
+	static VertexLayout CreatePacked( bool halfPositions, bool unormUVs );
+};
+} // namespace dae
+#endif
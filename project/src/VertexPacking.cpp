@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include "VertexPacking.h"
+
+namespace dae
+{
+namespace packing
+{
+namespace
+{
+float SignNotZero( float value )
+{
+	return value < 0.f ? -1.f : 1.f;
+}
+
+float DecodeSnorm8( int8_t value )
+{
+	return std::max( value / 127.f, -1.f );
+}
+
+int8_t EncodeSnorm8( float value )
+{
+	return static_cast<int8_t>( std::lround( std::clamp( value, -1.f, 1.f ) * 127.f ) );
+}
+
+uint16_t EncodeUnorm16( float value )
+{
+	return static_cast<uint16_t>( std::lround( std::clamp( value, 0.f, 1.f ) * 65535.f ) );
+}
+
+// Broken tangents (degenerate UVs) still have to encode to something orthogonal to the normal
+Vector3 SanitizeTangent( const Vector3& tangent, const Vector3& normal )
+{
+	const float length{ tangent.Magnitude() };
+	if ( std::isfinite( length ) && length > 1e-6f )
+	{
+		return tangent / length;
+	}
+
+	const Vector3 helper{ std::abs( normal.x ) < 0.9f ? Vector3{ 1.f, 0.f, 0.f } : Vector3{ 0.f, 1.f, 0.f } };
+	return Vector3::Cross( normal, helper ).Normalized();
+}
+
+// Rounding each component separately can be off by a step, try the four grid points around the exact encoding
+std::array<float, 2> EncodeOctahedralSnorm8( const Vector3& direction )
+{
+	const Vector2 exact{ EncodeOctahedral( direction ) };
+
+	std::array<float, 2> best{};
+	float bestDot{ -2.f };
+	for ( const float x : { std::floor( exact.x * 127.f ), std::ceil( exact.x * 127.f ) } )
+	{
+		for ( const float y : { std::floor( exact.y * 127.f ), std::ceil( exact.y * 127.f ) } )
+		{
+			const Vector2 candidate{ DecodeSnorm8( EncodeSnorm8( x / 127.f ) ), DecodeSnorm8( EncodeSnorm8( y / 127.f ) ) };
+			const float dot{ Vector3::Dot( DecodeOctahedral( candidate ), direction ) };
+			if ( dot > bestDot )
+			{
+				bestDot = dot;
+				best = { candidate.x, candidate.y };
+			}
+		}
+	}
+	return best;
+}
+
+std::array<float, 4> ReadSemantic( const Vertex& vertex, VertexSemantic semantic )
+{
+	switch ( semantic )
+	{
+	case VertexSemantic::position:
+		return { vertex.position.x, vertex.position.y, vertex.position.z, 1.f };
+	case VertexSemantic::color:
+		return { vertex.color.r, vertex.color.g, vertex.color.b, 1.f };
+	case VertexSemantic::texcoord:
+		return { vertex.UV.x, vertex.UV.y, 0.f, 0.f };
+	case VertexSemantic::normal:
+		return { vertex.normal.x, vertex.normal.y, vertex.normal.z, 0.f };
+	case VertexSemantic::tangent:
+		return { vertex.tangent.x, vertex.tangent.y, vertex.tangent.z, vertex.tangent.w };
+	case VertexSemantic::normalTangent:
+	{
+		const Vector3 normal{ vertex.normal.Normalized() };
+		const std::array<float, 2> encodedNormal{ EncodeOctahedralSnorm8( normal ) };
+
+		// The angle is measured around the normal the shader will decode, so only the angle itself gets rounded
+		const Vector3 decodedNormal{ DecodeOctahedral( { encodedNormal[0], encodedNormal[1] } ) };
+		const Vector3 tangent{ SanitizeTangent( vertex.tangent, decodedNormal ) };
+		Vector3 axisX{};
+		Vector3 axisY{};
+		BuildTangentBasis( decodedNormal, axisX, axisY );
+		const float angle{ std::atan2( Vector3::Dot( tangent, axisY ), Vector3::Dot( tangent, axisX ) ) };
+
+		const float handedness{ SignNotZero( vertex.tangent.w ) };
+		return { encodedNormal[0], encodedNormal[1], angle / std::numbers::pi_v<float>, handedness };
+	}
+	}
+	return {};
+}
+
+void WriteSemantic( Vertex& vertex, VertexSemantic semantic, const std::array<float, 4>& values )
+{
+	switch ( semantic )
+	{
+	case VertexSemantic::position:
+		vertex.position = { values[0], values[1], values[2] };
+		break;
+	case VertexSemantic::color:
+		vertex.color = { values[0], values[1], values[2] };
+		break;
+	case VertexSemantic::texcoord:
+		vertex.UV = { values[0], values[1] };
+		break;
+	case VertexSemantic::normal:
+		vertex.normal = { values[0], values[1], values[2] };
+		break;
+	case VertexSemantic::tangent:
+		vertex.tangent = { values[0], values[1], values[2], values[3] };
+		break;
+	case VertexSemantic::normalTangent:
+	{
+		vertex.normal = DecodeOctahedral( { values[0], values[1] } );
+
+		Vector3 axisX{};
+		Vector3 axisY{};
+		BuildTangentBasis( vertex.normal, axisX, axisY );
+		const float angle{ values[2] * std::numbers::pi_v<float> };
+		vertex.tangent = { axisX * std::cos( angle ) + axisY * std::sin( angle ), SignNotZero( values[3] ) };
+		break;
+	}
+	}
+}
+
+void WriteFormat( std::byte* pDestination, VertexAttributeFormat format, const std::array<float, 4>& values )
+{
+	switch ( format )
+	{
+	case VertexAttributeFormat::float2:
+		std::memcpy( pDestination, values.data(), 2 * sizeof( float ) );
+		break;
+	case VertexAttributeFormat::float3:
+		std::memcpy( pDestination, values.data(), 3 * sizeof( float ) );
+		break;
+	case VertexAttributeFormat::float4:
+		std::memcpy( pDestination, values.data(), 4 * sizeof( float ) );
+		break;
+	case VertexAttributeFormat::half2:
+	case VertexAttributeFormat::half4:
+	{
+		const size_t count{ format == VertexAttributeFormat::half2 ? size_t{ 2 } : size_t{ 4 } };
+		for ( size_t componentIdx{}; componentIdx < count; ++componentIdx )
+		{
+			const uint16_t half{ FloatToHalf( values[componentIdx] ) };
+			std::memcpy( pDestination + componentIdx * sizeof( uint16_t ), &half, sizeof( uint16_t ) );
+		}
+		break;
+	}
+	case VertexAttributeFormat::unorm16x2:
+		for ( size_t componentIdx{}; componentIdx < 2; ++componentIdx )
+		{
+			const uint16_t unorm{ EncodeUnorm16( values[componentIdx] ) };
+			std::memcpy( pDestination + componentIdx * sizeof( uint16_t ), &unorm, sizeof( uint16_t ) );
+		}
+		break;
+	case VertexAttributeFormat::snorm8x4:
+		for ( size_t componentIdx{}; componentIdx < 4; ++componentIdx )
+		{
+			const int8_t snorm{ EncodeSnorm8( values[componentIdx] ) };
+			std::memcpy( pDestination + componentIdx, &snorm, sizeof( int8_t ) );
+		}
+		break;
+	}
+}
+
+std::array<float, 4> ReadFormat( const std::byte* pSource, VertexAttributeFormat format )
+{
+	std::array<float, 4> values{};
+	switch ( format )
+	{
+	case VertexAttributeFormat::float2:
+		std::memcpy( values.data(), pSource, 2 * sizeof( float ) );
+		break;
+	case VertexAttributeFormat::float3:
+		std::memcpy( values.data(), pSource, 3 * sizeof( float ) );
+		break;
+	case VertexAttributeFormat::float4:
+		std::memcpy( values.data(), pSource, 4 * sizeof( float ) );
+		break;
+	case VertexAttributeFormat::half2:
+	case VertexAttributeFormat::half4:
+	{
+		const size_t count{ format == VertexAttributeFormat::half2 ? size_t{ 2 } : size_t{ 4 } };
+		for ( size_t componentIdx{}; componentIdx < count; ++componentIdx )
+		{
+			uint16_t half{};
+			std::memcpy( &half, pSource + componentIdx * sizeof( uint16_t ), sizeof( uint16_t ) );
+			values[componentIdx] = HalfToFloat( half );
+		}
+		break;
+	}
+	case VertexAttributeFormat::unorm16x2:
+		for ( size_t componentIdx{}; componentIdx < 2; ++componentIdx )
+		{
+			uint16_t unorm{};
+			std::memcpy( &unorm, pSource + componentIdx * sizeof( uint16_t ), sizeof( uint16_t ) );
+			values[componentIdx] = unorm / 65535.f;
+		}
+		break;
+	case VertexAttributeFormat::snorm8x4:
+		for ( size_t componentIdx{}; componentIdx < 4; ++componentIdx )
+		{
+			int8_t snorm{};
+			std::memcpy( &snorm, pSource + componentIdx, sizeof( int8_t ) );
+			values[componentIdx] = DecodeSnorm8( snorm );
+		}
+		break;
+	}
+	return values;
+}
+} // namespace
+
+uint16_t FloatToHalf( float value )
+{
+	const uint32_t bits{ std::bit_cast<uint32_t>( value ) };
+	const uint16_t sign{ static_cast<uint16_t>( ( bits >> 16 ) & 0x8000u ) };
+	const uint32_t magnitude{ bits & 0x7FFFFFFFu };
+
+	// NaN stays NaN, infinity and everything that rounds past 65504 becomes infinity
+	if ( magnitude > 0x7F800000u )
+	{
+		return sign | 0x7E00u;
+	}
+	if ( magnitude >= 0x477FF000u )
+	{
+		return sign | 0x7C00u;
+	}
+
+	// Subnormal halves are multiples of 2^-24, nearbyint rounds to even
+	if ( magnitude < 0x38800000u )
+	{
+		const float scaled{ std::bit_cast<float>( magnitude ) * 16777216.f };
+		return sign | static_cast<uint16_t>( std::nearbyint( scaled ) );
+	}
+
+	// Rebias the exponent from 127 to 15 and round the mantissa from 23 to 10 bits
+	uint32_t half{ ( magnitude - 0x38000000u ) >> 13 };
+	const uint32_t remainder{ magnitude & 0x1FFFu };
+	if ( remainder > 0x1000u || ( remainder == 0x1000u && ( half & 1u ) ) )
+	{
+		++half;
+	}
+	return sign | static_cast<uint16_t>( half );
+}
+
+float HalfToFloat( uint16_t value )
+{
+	const uint32_t sign{ static_cast<uint32_t>( value & 0x8000u ) << 16 };
+	const uint32_t exponent{ ( value >> 10 ) & 0x1Fu };
+	const uint32_t mantissa{ value & 0x3FFu };
+
+	if ( exponent == 0 )
+	{
+		const float magnitude{ mantissa / 16777216.f };
+		return sign ? -magnitude : magnitude;
+	}
+	if ( exponent == 31 )
+	{
+		return std::bit_cast<float>( sign | 0x7F800000u | ( mantissa << 13 ) );
+	}
+	return std::bit_cast<float>( sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 ) );
+}
+
+Vector2 EncodeOctahedral( const Vector3& direction )
+{
+	const float length{ std::abs( direction.x ) + std::abs( direction.y ) + std::abs( direction.z ) };
+	if ( !std::isfinite( length ) || length == 0.f )
+	{
+		return {};
+	}
+
+	Vector2 encoded{ direction.x / length, direction.y / length };
+	if ( direction.z < 0.f )
+	{
+		encoded = { ( 1.f - std::abs( encoded.y ) ) * SignNotZero( encoded.x ),
+					( 1.f - std::abs( encoded.x ) ) * SignNotZero( encoded.y ) };
+	}
+	return encoded;
+}
+
+Vector3 DecodeOctahedral( const Vector2& encoded )
+{
+	Vector3 direction{ encoded.x, encoded.y, 1.f - std::abs( encoded.x ) - std::abs( encoded.y ) };
+	if ( direction.z < 0.f )
+	{
+		direction.x = ( 1.f - std::abs( encoded.y ) ) * SignNotZero( encoded.x );
+		direction.y = ( 1.f - std::abs( encoded.x ) ) * SignNotZero( encoded.y );
+	}
+	return direction.Normalized();
+}
+
+void BuildTangentBasis( const Vector3& normal, Vector3& axisX, Vector3& axisY )
+{
+	const float sign{ SignNotZero( normal.z ) };
+	const float a{ -1.f / ( sign + normal.z ) };
+	const float b{ normal.x * normal.y * a };
+	axisX = { 1.f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x };
+	axisY = { b, sign + normal.y * normal.y * a, -normal.y };
+}
+
+VertexLayout ChoosePackedLayout( std::span<const Vertex> vertices, bool halfPositions )
+{
+	const bool unormUVs{ std::all_of( vertices.begin(), vertices.end(), []( const Vertex& vertex ) {
+		return vertex.UV.x >= 0.f && vertex.UV.x <= 1.f && vertex.UV.y >= 0.f && vertex.UV.y <= 1.f;
+	} ) };
+	return VertexLayout::CreatePacked( halfPositions, unormUVs );
+}
+
+std::vector<std::byte> Pack( std::span<const Vertex> vertices, const VertexLayout& layout )
+{
+	std::vector<std::byte> data( vertices.size() * layout.stride );
+	for ( size_t vertexIdx{}; vertexIdx < vertices.size(); ++vertexIdx )
+	{
+		std::byte* pVertex{ data.data() + vertexIdx * layout.stride };
+		for ( uint32_t attributeIdx{}; attributeIdx < layout.attributeCount; ++attributeIdx )
+		{
+			const VertexAttribute& attribute{ layout.attributes[attributeIdx] };
+			WriteFormat( pVertex + attribute.offset,
+						 attribute.format,
+						 ReadSemantic( vertices[vertexIdx], attribute.semantic ) );
+		}
+	}
+	return data;
+}
+
+Vertex Unpack( const std::byte* pVertex, const VertexLayout& layout )
+{
+	Vertex vertex{};
+	for ( uint32_t attributeIdx{}; attributeIdx < layout.attributeCount; ++attributeIdx )
+	{
+		const VertexAttribute& attribute{ layout.attributes[attributeIdx] };
+		WriteSemantic( vertex, attribute.semantic, ReadFormat( pVertex + attribute.offset, attribute.format ) );
+	}
+	return vertex;
+}
+} // namespace packing
+} // namespace dae
@@ -0,0 +1,36 @@
+#ifndef VERTEXPACKING_H
+#define VERTEXPACKING_H
+
+// Converts between the Vertex struct and the byte layouts a VertexLayout describes
+// Decoding mirrors what the input assembler and the packed vertex shaders do
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Structs.h"
+#include "VertexLayout.h"
+
+namespace dae
+{
+namespace packing
+{
+// IEEE 754 binary16, round to nearest even
+uint16_t FloatToHalf( float value );
+float HalfToFloat( uint16_t value );
+
+// Unit vector to the [-1, 1] square, the lower hemisphere is folded over the diagonals
+Vector2 EncodeOctahedral( const Vector3& direction );
+Vector3 DecodeOctahedral( const Vector2& encoded );
+
+// Orthonormal basis around a unit normal without branching on a helper axis (Duff et al. 2017)
+// Packed tangents are stored as their angle from axisX towards axisY, Opaque.fx builds the same basis to decode them
+void BuildTangentBasis( const Vector3& normal, Vector3& axisX, Vector3& axisY );
+
+// Packed layout with UNORM UVs when every UV fits in [0, 1]
+VertexLayout ChoosePackedLayout( std::span<const Vertex> vertices, bool halfPositions );
+
+std::vector<std::byte> Pack( std::span<const Vertex> vertices, const VertexLayout& layout );
+Vertex Unpack( const std::byte* pVertex, const VertexLayout& layout );
+} // namespace packing
+} // namespace dae
+#endif
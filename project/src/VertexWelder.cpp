@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <bit>
+#include "VertexWelder.h"
+
+namespace dae
+{
+VertexWelder::VertexWelder( size_t maxKeyCount )
+{
+	const size_t slotCount{ GetSlotCount( maxKeyCount ) };
+	m_Slots.resize( slotCount );
+	m_Mask = slotCount - 1;
+}
+
+uint32_t VertexWelder::Insert( uint32_t position, uint32_t UV, uint32_t normal, bool& isNew )
+{
+	// Linear probing
+	for ( size_t slotIdx{ Hash( position, UV, normal ) & m_Mask };; slotIdx = ( slotIdx + 1 ) & m_Mask )
+	{
+		Slot& slot{ m_Slots[slotIdx] };
+		if ( slot.id == EmptySlot )
+		{
+			slot.position = position;
+			slot.UV = UV;
+			slot.normal = normal;
+			slot.id = m_VertexCount++;
+
+			isNew = true;
+			return slot.id;
+		}
+
+		if ( slot.position == position && slot.UV == UV && slot.normal == normal )
+		{
+			isNew = false;
+			return slot.id;
+		}
+	}
+}
+
+uint32_t VertexWelder::GetVertexCount() const
+{
+	return m_VertexCount;
+}
+
+size_t VertexWelder::GetMemoryBytes( size_t maxKeyCount )
+{
+	return GetSlotCount( maxKeyCount ) * sizeof( Slot );
+}
+
+size_t VertexWelder::GetSlotCount( size_t maxKeyCount )
+{
+	// Keep the load factor at or below one half so probe sequences stay short
+	return std::bit_ceil( std::max( maxKeyCount * 2, size_t{ 16 } ) );
+}
+
+size_t VertexWelder::Hash( uint32_t position, uint32_t UV, uint32_t normal )
+{
+	// Multiply-xorshift mix, the index triples are highly correlated so every bit has to count
+	uint64_t hash{ position * 0x9E3779B97F4A7C15ull };
+	hash ^= UV * 0xC2B2AE3D27D4EB4Full + ( hash >> 29 );
+	hash ^= normal * 0x165667B19E3779F9ull + ( hash >> 32 );
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	return static_cast<size_t>( hash );
+}
+} // namespace dae
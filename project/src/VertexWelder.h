@@ -0,0 +1,47 @@
+#ifndef VERTEXWELDER_H
+#define VERTEXWELDER_H
+
+// Open-addressing hash table that maps (position, UV, normal) index triples to shared vertex ids
+// Sized up front for the worst case (every key unique), so it never rehashes
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+class VertexWelder final
+{
+public:
+	explicit VertexWelder( size_t maxKeyCount );
+
+	// Returns the id of the key, new keys get the next free id
+	uint32_t Insert( uint32_t position, uint32_t UV, uint32_t normal, bool& isNew );
+
+	// Getters
+	uint32_t GetVertexCount() const;
+
+	// Size of the table a welder for maxKeyCount keys allocates
+	static size_t GetMemoryBytes( size_t maxKeyCount );
+
+private:
+	static constexpr uint32_t EmptySlot{ UINT32_MAX };
+
+	// 16 bytes, four slots per cache line
+	struct Slot
+	{
+		uint32_t position{};
+		uint32_t UV{};
+		uint32_t normal{};
+		uint32_t id{ EmptySlot };
+	};
+
+	// SOFTWARE RESOURCES
+	std::vector<Slot> m_Slots{};
+	size_t m_Mask{};
+	uint32_t m_VertexCount{};
+	//
+
+	static size_t Hash( uint32_t position, uint32_t UV, uint32_t normal );
+	static size_t GetSlotCount( size_t maxKeyCount );
+};
+} // namespace dae
+#endif
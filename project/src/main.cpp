@@ -16,8 +16,12 @@
 //
 
 // Standard includes
+#include <charconv>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <string_view>
 
 // Project includes
 #include "Timer.h"
@@ -42,15 +46,31 @@ void SetCoutColor( int color )
 
 int main( int argc, char* args[] )
 {
-	// Unreferenced parameters
-	(void)argc;
-	(void)args;
-
 // Leak detection
 #if defined( _DEBUG )
 	LeakDetector detector{};
 #endif
 
+	// --texture-budget <MB> caps the video memory streamed textures may take
+	// --batch-loads creates the GPU objects of the startup loads in one go, once the workers loaded all of them
+	size_t textureBudgetMb{ TextureStreamer::DefaultBudgetBytes >> 20 };
+	bool isLoadBatched{};
+	for ( int argIdx{ 1 }; argIdx < argc; ++argIdx )
+	{
+		if ( std::string_view{ args[argIdx] } == "--texture-budget" && argIdx + 1 < argc )
+		{
+			const char* pValue{ args[argIdx + 1] };
+			std::from_chars( pValue, pValue + std::strlen( pValue ), textureBudgetMb );
+		}
+		isLoadBatched |= std::string_view{ args[argIdx] } == "--batch-loads";
+	}
+
+	// Load times are measured from here, the first frame only waits for the window and the device
+	const auto startTime{ std::chrono::steady_clock::now() };
+	const auto getMsSinceStart{ [startTime]() {
+		return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - startTime ).count();
+	} };
+
 	// Create window + surfaces
 	SDL_Init( SDL_INIT_VIDEO );
 
@@ -71,7 +91,7 @@ int main( int argc, char* args[] )
 
 	// Initialize "framework"
 	Timer timer{};
-	Renderer renderer{ pWindow };
+	Renderer renderer{ pWindow, textureBudgetMb << 20, isLoadBatched };
 
 	// Initialize scene
 	std::vector<std::unique_ptr<Scene>> scenePtrs{};
@@ -89,6 +109,8 @@ int main( int argc, char* args[] )
 	timer.Start();
 	float printTimer = 0.f;
 	bool isLooping = true;
+	bool isFirstFrame = true;
+	bool isFullyLoaded = false;
 	while ( isLooping )
 	{
 		//--------- Get input events ---------
@@ -115,6 +137,19 @@ int main( int argc, char* args[] )
 		//--------- Render ---------
 		renderer.Render( scenePtrs[sceneIdx].get() );
 
+		if ( isFirstFrame )
+		{
+			isFirstFrame = false;
+			std::cout << "First frame after " << getMsSinceStart() << " ms" << std::endl;
+		}
+		if ( !isFullyLoaded && !renderer.IsLoading() )
+		{
+			isFullyLoaded = true;
+			std::cout << "Fully loaded after " << getMsSinceStart() << " ms" << std::endl;
+			renderer.PrintStatistics();
+			renderer.PrintLoadTimeline();
+		}
+
 		//--------- Timer ----------
 		timer.Update();
 		printTimer += timer.GetElapsed();
@@ -122,6 +157,8 @@ int main( int argc, char* args[] )
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << timer.GetdFPS() << std::endl;
+			scenePtrs[sceneIdx]->PrintStatistics();
+			renderer.PrintStreamingStatistics();
 		}
 	}
 	timer.Stop();